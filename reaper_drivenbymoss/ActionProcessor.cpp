@@ -21,7 +21,7 @@ ActionProcessor::ActionProcessor(Model& aModel) : OscProcessor(aModel), selectio
 
 
 /** {@inheritDoc} */
-void ActionProcessor::Process(std::deque<std::string>& path) noexcept
+void ActionProcessor::Process(const OscPath& path) noexcept
 {
 	const char* part = SafeGet(path, 0);
 	if (std::strcmp(part, "select") == 0)
@@ -42,14 +42,14 @@ void ActionProcessor::Process(std::deque<std::string>& path) noexcept
 
 
 /** {@inheritDoc} */
-void ActionProcessor::Process(std::deque<std::string>& path, int value) noexcept
+void ActionProcessor::Process(const OscPath& path, int value) noexcept
 {
 	Main_OnCommandEx(value, 0, ReaperUtils::GetProject());
 }
 
 
 /** {@inheritDoc} */
-void ActionProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void ActionProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	int id = std::atoi(value.c_str());
 	if (id <= 0)
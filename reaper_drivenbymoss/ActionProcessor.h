@@ -15,12 +15,17 @@ class ActionProcessor : public OscProcessor
 public:
 	ActionProcessor(Model& aModel);
 
-	void Process(std::deque<std::string>& path) noexcept override;
-	void Process(std::deque<std::string>& path, int value) noexcept override;
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override;
+	bool DependsOnProject() const noexcept override
+	{
+		return true;
+	}
 
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path) noexcept override;
+	void Process(const OscPath& path, int value) noexcept override;
+	void Process(const OscPath& path, const std::string& value) noexcept override;
+
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 
 	void CollectData(std::ostringstream& ss);
 
@@ -0,0 +1,296 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "ClassDataSharing.h"
+#include "ReaDebug.h"
+
+
+namespace
+{
+	const char* CLASSPATH_OPTION{ "-Djava.class.path=" };
+	// Stored in front of the hash if the archive could not be created or used
+	const char* FAILED_MARKER{ "failed:" };
+#ifdef _WIN32
+	const char CLASSPATH_SEPARATOR{ ';' };
+#else
+	const char CLASSPATH_SEPARATOR{ ':' };
+#endif
+
+	const std::uint64_t FNV_OFFSET_BASIS{ 14695981039346656037ULL };
+	const std::uint64_t FNV_PRIME{ 1099511628211ULL };
+
+	/**
+	 * Add text to a FNV-1a hash.
+	 *
+	 * @param hash The hash to update
+	 * @param text The text to add
+	 */
+	void AddToHash(std::uint64_t& hash, const std::string& text) noexcept
+	{
+		for (const char c : text)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= FNV_PRIME;
+		}
+		// Separate the texts
+		hash ^= 0xFF;
+		hash *= FNV_PRIME;
+	}
+
+	/**
+	 * Get the size and the modification time of a file.
+	 *
+	 * @param path The path of the file
+	 * @return The size and time as text, empty if the file does not exist
+	 */
+	std::string GetFileInfo(const std::string& path)
+	{
+#ifdef _WIN32
+		struct _stat64 info {};
+		if (_stat64(path.c_str(), &info) != 0)
+			return "";
+#else
+		struct stat info {};
+		if (stat(path.c_str(), &info) != 0)
+			return "";
+#endif
+		std::ostringstream ss;
+		ss << static_cast<long long>(info.st_size) << "/" << static_cast<long long>(info.st_mtime);
+		return ss.str();
+	}
+}
+
+
+/**
+ * Check if the archive matches the JAR files and select the options of the JVM accordingly.
+ *
+ * @param libDir The folder which contains the drivenbymoss-libs folder
+ * @param classpath The class path option of the JVM
+ * @param jvmLibraryPath The path of the JVM library
+ */
+void ClassDataSharing::Prepare(const std::string& libDir, const std::string& classpath, const std::string& jvmLibraryPath)
+{
+	this->options.clear();
+	this->state = State::DISABLED;
+	if (!ENABLE_CLASS_DATA_SHARING || libDir.empty() || classpath.empty())
+		return;
+
+	this->archivePath = libDir + "drivenbymoss-libs.jsa";
+	this->hashPath = this->archivePath + ".hash";
+	this->hash = this->CreateHash(classpath, jvmLibraryPath);
+
+	const std::string storedHash = this->ReadHash();
+	if (storedHash == FAILED_MARKER + this->hash)
+	{
+		ReaDebug::Log("DrivenByMoss: Class data sharing is disabled since it failed before with the same JAR files.\n");
+		return;
+	}
+	if (storedHash == this->hash && !GetFileInfo(this->archivePath).empty())
+	{
+		this->options.push_back("-XX:SharedArchiveFile=" + this->archivePath);
+		this->state = State::USED;
+		return;
+	}
+
+	// The JAR files have changed or there is no archive yet
+	std::remove(this->hashPath.c_str());
+	std::remove(this->archivePath.c_str());
+	this->options.push_back("-XX:+RecordDynamicDumpInfo");
+	this->state = State::RECORDING;
+	ReaDebug::Log("DrivenByMoss: Class data sharing archive is created on shutdown.\n");
+}
+
+
+/**
+ * Dump all loaded classes into the archive, if it needs to be created. Should be called before
+ * the JVM is shut down, when all relevant classes are loaded.
+ *
+ * @param env The JNI environment
+ */
+void ClassDataSharing::CreateArchive(JNIEnv& env)
+{
+	if (this->state != State::RECORDING)
+		return;
+	// Only try once per run
+	this->state = State::DISABLED;
+
+	if (env.PushLocalFrame(16) != 0)
+	{
+		env.ExceptionClear();
+		return;
+	}
+	const bool success = this->InvokeDiagnosticCommand(env, "vmCds", "dynamic_dump", this->archivePath.c_str());
+	env.PopLocalFrame(nullptr);
+	if (!success || GetFileInfo(this->archivePath).empty())
+	{
+		ReaDebug::Log("DrivenByMoss: Could not create class data sharing archive.\n");
+		// Do not record and dump again on every run
+		std::remove(this->archivePath.c_str());
+		this->WriteHash(FAILED_MARKER + this->hash);
+		return;
+	}
+
+	if (!this->WriteHash(this->hash))
+		return;
+	this->state = State::CREATED;
+	ReaDebug::Log("DrivenByMoss: Class data sharing archive created.\n");
+}
+
+
+/**
+ * Stop using the archive, since the JVM could not be started with its options. The archive is
+ * not used or recorded again until the JAR files or the JVM library change.
+ */
+void ClassDataSharing::Disable()
+{
+	if (this->state == State::DISABLED)
+		return;
+	this->options.clear();
+	this->state = State::DISABLED;
+	std::remove(this->archivePath.c_str());
+	this->WriteHash(FAILED_MARKER + this->hash);
+}
+
+
+/**
+ * Get the name of the state to be used in the statistics.
+ *
+ * @return The name
+ */
+const char* ClassDataSharing::GetStateName() const noexcept
+{
+	switch (this->state.load())
+	{
+	case State::USED:
+		return "used";
+	case State::RECORDING:
+		return "recording";
+	case State::CREATED:
+		return "created";
+	default:
+		return "disabled";
+	}
+}
+
+
+/**
+ * Create a hash from the class path, the sizes and modification times of the JAR files and the
+ * JVM library.
+ *
+ * @param classpath The class path option of the JVM
+ * @param jvmLibraryPath The path of the JVM library
+ * @return The hash as a hex string
+ */
+std::string ClassDataSharing::CreateHash(const std::string& classpath, const std::string& jvmLibraryPath) const
+{
+	std::uint64_t value{ FNV_OFFSET_BASIS };
+	AddToHash(value, classpath);
+	AddToHash(value, jvmLibraryPath);
+	AddToHash(value, GetFileInfo(jvmLibraryPath));
+
+	std::string jars{ classpath };
+	const std::string prefix{ CLASSPATH_OPTION };
+	if (jars.compare(0, prefix.length(), prefix) == 0)
+		jars.erase(0, prefix.length());
+	std::istringstream stream(jars);
+	std::string jar;
+	while (std::getline(stream, jar, CLASSPATH_SEPARATOR))
+		AddToHash(value, GetFileInfo(jar));
+
+	std::ostringstream ss;
+	ss << std::hex << value;
+	return ss.str();
+}
+
+
+/**
+ * Read the hash which was stored with the archive.
+ *
+ * @return The hash, empty if there is none
+ */
+std::string ClassDataSharing::ReadHash() const
+{
+	std::ifstream file(this->hashPath, std::ios::binary);
+	std::string text;
+	if (file.good())
+		std::getline(file, text);
+	return text;
+}
+
+
+/**
+ * Store the hash, or the failure marker, next to the archive.
+ *
+ * @param text The text to store
+ * @return True if successful
+ */
+bool ClassDataSharing::WriteHash(const std::string& text) const
+{
+	std::ofstream file(this->hashPath, std::ios::binary | std::ios::trunc);
+	file << text;
+	if (file.good())
+		return true;
+	ReaDebug() << "Could not write class data sharing hash: " << this->hashPath;
+	return false;
+}
+
+
+/**
+ * Execute a diagnostic command of the running JVM with the diagnostic command MBean.
+ *
+ * @param env The JNI environment
+ * @param operation The name of the command operation, e.g. vmCds for VM.cds
+ * @param argument1 The first argument of the command
+ * @param argument2 The second argument of the command
+ * @return True if successful
+ */
+bool ClassDataSharing::InvokeDiagnosticCommand(JNIEnv& env, const char* operation, const char* argument1, const char* argument2) const
+{
+	jclass factoryClass = env.FindClass("java/lang/management/ManagementFactory");
+	jclass objectNameClass = factoryClass == nullptr ? nullptr : env.FindClass("javax/management/ObjectName");
+	jclass serverClass = objectNameClass == nullptr ? nullptr : env.FindClass("javax/management/MBeanServer");
+	jclass stringClass = serverClass == nullptr ? nullptr : env.FindClass("java/lang/String");
+	jclass objectClass = stringClass == nullptr ? nullptr : env.FindClass("java/lang/Object");
+	if (objectClass == nullptr)
+	{
+		// The Java runtime does not contain the management module
+		env.ExceptionClear();
+		return false;
+	}
+
+	const jmethodID getServer = env.GetStaticMethodID(factoryClass, "getPlatformMBeanServer", "()Ljavax/management/MBeanServer;");
+	const jmethodID objectNameConstructor = env.GetMethodID(objectNameClass, "<init>", "(Ljava/lang/String;)V");
+	const jmethodID invoke = env.GetMethodID(serverClass, "invoke", "(Ljavax/management/ObjectName;Ljava/lang/String;[Ljava/lang/Object;[Ljava/lang/String;)Ljava/lang/Object;");
+	if (getServer == nullptr || objectNameConstructor == nullptr || invoke == nullptr)
+	{
+		env.ExceptionClear();
+		return false;
+	}
+
+	jobject server = env.CallStaticObjectMethod(factoryClass, getServer);
+	jobject objectName = env.NewObject(objectNameClass, objectNameConstructor, env.NewStringUTF("com.sun.management:type=DiagnosticCommand"));
+	jobjectArray arguments = env.NewObjectArray(2, stringClass, nullptr);
+	jobjectArray parameters = env.NewObjectArray(1, objectClass, nullptr);
+	jobjectArray signature = env.NewObjectArray(1, stringClass, env.NewStringUTF("[Ljava.lang.String;"));
+	if (env.ExceptionCheck() || server == nullptr || objectName == nullptr || arguments == nullptr || parameters == nullptr || signature == nullptr)
+	{
+		env.ExceptionClear();
+		return false;
+	}
+	env.SetObjectArrayElement(arguments, 0, env.NewStringUTF(argument1));
+	env.SetObjectArrayElement(arguments, 1, env.NewStringUTF(argument2));
+	env.SetObjectArrayElement(parameters, 0, arguments);
+
+	env.CallObjectMethod(server, invoke, objectName, env.NewStringUTF(operation), parameters, signature);
+	if (env.ExceptionCheck())
+	{
+		env.ExceptionClear();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_CLASSDATASHARING_H_
+#define _DBM_CLASSDATASHARING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "WrapperJNI.h"
+
+
+/**
+ * Manages an application class data sharing (CDS) archive of the classes of DrivenByMoss, which
+ * speeds up the startup of the JVM.
+ *
+ * The archive is stored next to the drivenbymoss-libs folder. It is validated with a hash of the
+ * class path, the size and modification time of the JAR files and of the JVM library, which is
+ * stored in a file next to it. If the hash does not match or the archive is missing, the JVM is
+ * started without the archive and it is created when Reaper shuts down. Delete the archive to
+ * create it again.
+ *
+ * If the archive could not be dumped or the JVM did not start with the options of the archive, a
+ * marker is stored instead of the hash. It is not tried again until the JAR files or the JVM
+ * library change.
+ *
+ * The archive cannot be created with -XX:ArchiveClassesAtExit since the JVM is never destroyed,
+ * instead it is dumped with the diagnostic command VM.cds of the running JVM.
+ */
+class ClassDataSharing
+{
+public:
+	/** The state of the archive. */
+	enum class State
+	{
+		DISABLED, USED, RECORDING, CREATED
+	};
+
+
+	ClassDataSharing() = default;
+	ClassDataSharing(const ClassDataSharing&) = delete;
+	ClassDataSharing& operator=(const ClassDataSharing&) = delete;
+	ClassDataSharing(ClassDataSharing&&) = delete;
+	ClassDataSharing& operator=(ClassDataSharing&&) = delete;
+	~ClassDataSharing() {};
+
+	void Prepare(const std::string& libDir, const std::string& classpath, const std::string& jvmLibraryPath);
+	void CreateArchive(JNIEnv& env);
+	void Disable();
+
+	/**
+	 * Get the options to add to the JVM.
+	 *
+	 * @return The options, the strings must not be modified
+	 */
+	std::vector<std::string>& GetOptions() noexcept
+	{
+		return this->options;
+	}
+
+	/**
+	 * Get the state of the archive.
+	 *
+	 * @return The state
+	 */
+	State GetState() const noexcept
+	{
+		return this->state.load();
+	}
+
+	const char* GetStateName() const noexcept;
+
+private:
+	std::string archivePath;
+	std::string hashPath;
+	std::string hash;
+	std::vector<std::string> options;
+	std::atomic<State> state{ State::DISABLED };
+
+	std::string CreateHash(const std::string& classpath, const std::string& jvmLibraryPath) const;
+	std::string ReadHash() const;
+	bool WriteHash(const std::string& text) const;
+	bool InvokeDiagnosticCommand(JNIEnv& env, const char* operation, const char* argument1, const char* argument2) const;
+};
+
+#endif /* _DBM_CLASSDATASHARING_H_ */
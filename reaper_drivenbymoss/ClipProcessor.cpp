@@ -2,6 +2,7 @@
 // Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
 
 #include "ClipProcessor.h"
+#include "MidiTransform.h"
 #include "ReaperUtils.h"
 #include "ReaDebug.h"
 
@@ -18,7 +19,7 @@ ClipProcessor::ClipProcessor(Model& aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void ClipProcessor::Process(std::deque<std::string>& path) noexcept
+void ClipProcessor::Process(const OscPath& path) noexcept
 {
 	if (path.empty())
 		return;
@@ -30,25 +31,25 @@ void ClipProcessor::Process(std::deque<std::string>& path) noexcept
 	if (item == nullptr)
 		return;
 
-	const char* cmd = SafeGet(path, 0);
-
-	if (std::strcmp(cmd, "clear") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("clear"):
 	{
 		// Remove all MIDI events from the clip (midi item)
 		this->ClearNotes(project, item, -1, -1);
 		return;
 	}
 
-	if (std::strcmp(cmd, "duplicate") == 0)
+	case OscPath::Hash("duplicate"):
 	{
 		// Item: Duplicate items
 		Main_OnCommandEx(DUPLICATE_ITEMS, 0, project);
 		return;
 	}
 
-	if (std::strcmp(cmd, "duplicateContent") == 0)
+	case OscPath::Hash("duplicateContent"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 
 		PreventUIRefresh(1);
 
@@ -64,32 +65,36 @@ void ClipProcessor::Process(std::deque<std::string>& path) noexcept
 
 		PreventUIRefresh(-1);
 
-		Undo_EndBlock2(project, "Duplicate content of clip", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Duplicate content of clip", UNDO_STATE_ALL);
 		return;
 	}
 
-	if (std::strcmp(cmd, "note") == 0)
+	case OscPath::Hash("note"):
 	{
 		if (path.size() < 3)
 			return;
-		const int pitch = std::atoi(SafeGet(path, 1));
+		const int pitch = path.GetInt(1);
 		const char* noteCmd = SafeGet(path, 2);
 
 		// Clear all notes with a specific pitch
 		if (std::strcmp(noteCmd, "clear") == 0)
 		{
-			const int channel = atoi(SafeGet(path, 3));
+			const int channel = path.GetInt(3);
 			this->ClearNotes(project, item, channel, pitch);
 			return;
 		}
 
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
 /** {@inheritDoc} */
-void ClipProcessor::Process(std::deque<std::string>& path, double value) noexcept
+void ClipProcessor::Process(const OscPath& path, double value) noexcept
 {
 	if (path.empty())
 		return;
@@ -101,9 +106,9 @@ void ClipProcessor::Process(std::deque<std::string>& path, double value) noexcep
 	if (item == nullptr)
 		return;
 
-	const char* cmd = SafeGet(path, 0);
-
-	if (std::strcmp(cmd, "start") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("start"):
 	{
 		PreventUIRefresh(1);
 		double itemStart = GetMediaItemInfo_Value(item, "D_POSITION");
@@ -117,7 +122,7 @@ void ClipProcessor::Process(std::deque<std::string>& path, double value) noexcep
 		return;
 	}
 
-	if (std::strcmp(cmd, "end") == 0)
+	case OscPath::Hash("end"):
 	{
 		PreventUIRefresh(1);
 		const double itemStart = GetMediaItemInfo_Value(item, "D_POSITION");
@@ -132,59 +137,68 @@ void ClipProcessor::Process(std::deque<std::string>& path, double value) noexcep
 		return;
 	}
 
-	if (std::strcmp(cmd, "transpose") == 0)
+	case OscPath::Hash("transpose"):
 	{
 		this->TransposeClip(project, item, static_cast<int>(value));
 		return;
 	}
 
-	if (std::strcmp(cmd, "note") == 0)
+	case OscPath::Hash("note"):
 	{
 		if (path.size() < 3)
 			return;
-		const int pitch = std::atoi(SafeGet(path, 1));
-		const char* noteCmd = SafeGet(path, 2);
+		const int pitch = path.GetInt(1);
 
 		MediaItem_Take* take = GetActiveTake(item);
 		if (take == nullptr)
 			return;
 		const double ppqPosClipStart = MIDI_GetPPQPosFromProjQN(take, 0);
 		const double ppqPosStart = MIDI_GetPPQPosFromProjQN(take, value) - ppqPosClipStart;
-		const int channel = atoi(SafeGet(path, 3));
+		const int channel = path.GetInt(3);
 
-		if (std::strcmp(noteCmd, "clear") == 0)
+		switch (path.GetHash(2))
+		{
+		case OscPath::Hash("clear"):
 		{
 			this->ClearNote(project, item, channel, pitch, ppqPosStart);
 			return;
 		}
 
 		// Clear all notes at a specific position
-		if (std::strcmp(noteCmd, "clearPosition") == 0)
+		case OscPath::Hash("clearPosition"):
 		{
 			this->ClearNotesAtPosition(project, item, channel, ppqPosStart);
 			return;
 		}
 
-		if (std::strcmp(noteCmd, "moveY") == 0)
+		case OscPath::Hash("moveY"):
 		{
-			const int newPitch = atoi(SafeGet(path, 4));
+			const int newPitch = path.GetInt(4);
 			this->MoveNoteY(project, item, channel, pitch, newPitch, ppqPosStart);
 			return;
 		}
 
+		default:
+			break;
+		}
+
 		return;
 	}
 
-	if (std::strcmp(cmd, "loop") == 0)
+	case OscPath::Hash("loop"):
 	{
 		SetMediaItemInfo_Value(item, "B_LOOPSRC", value > 0);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
 /** {@inheritDoc} */
-void ClipProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void ClipProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	if (path.empty())
 		return;
@@ -196,27 +210,27 @@ void ClipProcessor::Process(std::deque<std::string>& path, const std::string& va
 	if (item == nullptr)
 		return;
 
-	const char* cmd = SafeGet(path, 0);
-
-	if (std::strcmp(cmd, "color") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("color"):
 	{
 		SetColorOfClip(project, item, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "name") == 0)
+	case OscPath::Hash("name"):
 	{
 		SetNameOfClip(project, item, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "insertFile") == 0)
+	case OscPath::Hash("insertFile"):
 	{
 		InsertMedia(value.c_str(), 3);
 		return;
 	}
 
-	if (std::strcmp(cmd, "note") == 0)
+	case OscPath::Hash("note"):
 	{
 		if (path.size() < 3)
 			return;
@@ -225,8 +239,7 @@ void ClipProcessor::Process(std::deque<std::string>& path, const std::string& va
 		if (take == nullptr || !TakeIsMIDI(take))
 			return;
 
-		const int pitch = std::atoi(SafeGet(path, 1));
-		const char* noteCmd = SafeGet(path, 2);
+		const int pitch = path.GetInt(1);
 
 		std::vector<std::string> parts = this->SplitString(value, ' ');
 		if (parts.size() != 5)
@@ -243,30 +256,32 @@ void ClipProcessor::Process(std::deque<std::string>& path, const std::string& va
 		const double ppqPosStart = MIDI_GetPPQPosFromProjQN(take, pos) - ppqPosClipStart;
 		const double ppqPosEnd = MIDI_GetPPQPosFromProjQN(take, pos + length) - ppqPosClipStart;
 
-		if (std::strcmp(noteCmd, "toggle") == 0)
+		switch (path.GetHash(2))
+		{
+		case OscPath::Hash("toggle"):
 		{
 			PreventUIRefresh(1);
 			if (!ClearNote(project, item, channel, pitch, ppqPosStart))
 			{
 				MIDI_InsertNote(take, false, isMuted, ppqPosStart, ppqPosEnd, channel, pitch, velocity, nullptr);
 				UpdateItemInProject(item);
-				Undo_OnStateChange_Item(project, "Insert note", item);
+				this->model.GetUndoBatch().OnItemStateChange(project, "Insert note", item);
 			}
 			PreventUIRefresh(-1);
 			return;
 		}
 
-		if (std::strcmp(noteCmd, "set") == 0)
+		case OscPath::Hash("set"):
 		{
 			PreventUIRefresh(1);
 			MIDI_InsertNote(take, false, isMuted, ppqPosStart, ppqPosEnd, channel, pitch, velocity, nullptr);
 			UpdateItemInProject(item);
-			Undo_OnStateChange_Item(project, "Insert note", item);
+			this->model.GetUndoBatch().OnItemStateChange(project, "Insert note", item);
 			PreventUIRefresh(-1);
 			return;
 		}
 
-		if (std::strcmp(noteCmd, "update") == 0)
+		case OscPath::Hash("update"):
 		{
 			const int id = GetNoteIndex(take, channel, pitch, ppqPosStart);
 			if (id < 0)
@@ -274,13 +289,21 @@ void ClipProcessor::Process(std::deque<std::string>& path, const std::string& va
 			PreventUIRefresh(1);
 			MIDI_SetNote(take, id, nullptr, &isMuted, &ppqPosStart, &ppqPosEnd, &channel, &pitch, &velocity, nullptr);
 			UpdateItemInProject(item);
-			Undo_OnStateChange_Item(project, "Change note", item);
+			this->model.GetUndoBatch().OnItemStateChange(project, "Change note", item);
 			PreventUIRefresh(-1);
 			return;
 		}
 
+		default:
+			break;
+		}
+
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
@@ -313,7 +336,7 @@ void ClipProcessor::SetColorOfClip(ReaProject* project, MediaItem* item, const s
 	PreventUIRefresh(1);
 	SetMediaItemInfo_Value(item, "I_CUSTOMCOLOR", ColorToNative(red, green, blue) | SET_COLOR);
 	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Set clip color", item);
+	this->model.GetUndoBatch().OnItemStateChange(project, "Set clip color", item);
 	PreventUIRefresh(-1);
 }
 
@@ -339,7 +362,7 @@ void ClipProcessor::SetNameOfClip(ReaProject* project, MediaItem* item, const st
 	DISABLE_WARNING_NO_C_STYLE_CONVERSION
 	GetSetMediaItemTakeInfo(take, "P_NAME", (void*) value.c_str());
 	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Set name of active take", item);
+	this->model.GetUndoBatch().OnItemStateChange(project, "Set name of active take", item);
 	PreventUIRefresh(-1);
 }
 
@@ -359,24 +382,13 @@ void ClipProcessor::TransposeClip(ReaProject* project, MediaItem* item, int tran
 
 	PreventUIRefresh(1);
 
-	int noteCount{ 0 };
+	MidiTransform transform;
+	transform.Transpose(transpose);
 	for (int i = 0; i < takes; i++)
-	{
-		MediaItem_Take* take = GetTake(item, i);
-		if (take && TakeIsMIDI(take) && MIDI_CountEvts(take, &noteCount, nullptr, nullptr))
-		{
-			for (int n = 0; n < noteCount; n++)
-			{
-				int pitch;
-				MIDI_GetNote(take, n, nullptr, nullptr, nullptr, nullptr, nullptr, &pitch, nullptr);
-				pitch += transpose;
-				MIDI_SetNote(take, n, nullptr, nullptr, nullptr, nullptr, nullptr, &pitch, nullptr, nullptr);
-			}
-		}
-	}
+		transform.Apply(GetTake(item, i));
 
 	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Transpose selected midi item notes", item);
+	this->model.GetUndoBatch().OnItemStateChange(project, "Transpose selected midi item notes", item);
 	PreventUIRefresh(-1);
 }
 
@@ -395,31 +407,16 @@ void ClipProcessor::ClearNotes(ReaProject* project, MediaItem* item, int channel
 	if (take == nullptr || !TakeIsMIDI(take))
 		return;
 
-	int noteCount;
-	if (MIDI_CountEvts(take, &noteCount, nullptr, nullptr) == 0)
-		return;
+	MidiTransform transform;
+	transform.DeleteNotes(channel, pitch);
 
 	PreventUIRefresh(1);
 
-	if (channel == -1 && pitch == -1)
+	if (transform.Apply(take))
 	{
-		for (int id = noteCount - 1; id >= 0; id--)
-			MIDI_DeleteNote(take, id);
+		UpdateItemInProject(item);
+		this->model.GetUndoBatch().OnItemStateChange(project, "Delete notes", item);
 	}
-	else
-	{
-		int midiChannel{ 0 };
-		int notePitch{ 0 };
-		for (int id = noteCount - 1; id >= 0; id--)
-		{
-			MIDI_GetNote(take, id, nullptr, nullptr, nullptr, nullptr, &midiChannel, &notePitch, nullptr);
-			if (channel == midiChannel && pitch == notePitch)
-				MIDI_DeleteNote(take, id);
-		}
-	}
-
-	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Delete notes", item);
 
 	PreventUIRefresh(-1);
 }
@@ -449,7 +446,7 @@ bool ClipProcessor::ClearNote(ReaProject* project, MediaItem* item, int channel,
 
 	MIDI_DeleteNote(take, id);
 	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Delete note", item);
+	this->model.GetUndoBatch().OnItemStateChange(project, "Delete note", item);
 	
 	PreventUIRefresh(-1);
 
@@ -474,15 +471,12 @@ bool ClipProcessor::ClearNotesAtPosition(ReaProject* project, MediaItem* item, i
 
 	PreventUIRefresh(1);
 
-	for (int note = 0; note < 128; note++)
-	{
-		const int id = GetNoteIndex(take, channel, note, position);
-		if (id >= 0)
-			MIDI_DeleteNote(take, id);
-	}
+	// The indices are in descending order, therefore deleting does not change the following ones
+	for (const int id : this->noteIndex.FindAll(take, channel, position))
+		MIDI_DeleteNote(take, id);
 
 	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Delete notes at position", item);
+	this->model.GetUndoBatch().OnItemStateChange(project, "Delete notes at position", item);
 
 	PreventUIRefresh(-1);
 
@@ -514,7 +508,7 @@ bool ClipProcessor::MoveNoteY(ReaProject* project, MediaItem* item, int channel,
 	PreventUIRefresh(1);
 	MIDI_SetNote(take, id, nullptr, nullptr, nullptr, nullptr, nullptr, &newPitch, nullptr, nullptr);
 	UpdateItemInProject(item);
-	Undo_OnStateChange_Item(project, "Change note pitch", item);
+	this->model.GetUndoBatch().OnItemStateChange(project, "Change note pitch", item);
 
 	PreventUIRefresh(-1);
 
@@ -533,20 +527,7 @@ bool ClipProcessor::MoveNoteY(ReaProject* project, MediaItem* item, int channel,
  * @param position The position of the note to delete
  * @return The index of the note or -1 if not found
  */
-int ClipProcessor::GetNoteIndex(MediaItem_Take* take, int channel, int pitch, double position) noexcept
+int ClipProcessor::GetNoteIndex(MediaItem_Take* take, int channel, int pitch, double position)
 {
-	int noteCount;
-	if (MIDI_CountEvts(take, &noteCount, nullptr, nullptr) == 0)
-		return -1;
-
-	int midiChannel{ 0 };
-	int notePitch{ 0 };
-	double startppqpos{ -1 };
-	for (int id = 0; id < noteCount; id++)
-	{
-		MIDI_GetNote(take, id, nullptr, nullptr, &startppqpos, nullptr, &midiChannel, &notePitch, nullptr);
-		if (channel == midiChannel && pitch == notePitch && std::abs(startppqpos - position) < 0.0001)
-			return id;
-	}
-	return -1;
+	return this->noteIndex.Find(take, channel, pitch, position);
 }
@@ -5,6 +5,7 @@
 #define _DBM_CLIPPROCESSOR_H_
 
 #include "OscProcessor.h"
+#include "NoteIndex.h"
 
 
 /**
@@ -15,19 +16,26 @@ class ClipProcessor : public OscProcessor
 public:
 	ClipProcessor(Model& aModel);
 
-	void Process(std::deque<std::string>& path) noexcept override;
+	void Process(const OscPath& path) noexcept override;
 
-	void Process(std::deque<std::string>& path, int value) noexcept override
+	void Process(const OscPath& path, int value) noexcept override
 	{
 		Process(path, static_cast<double> (value));
 	};
 
-	void Process(std::deque<std::string>& path, double value) noexcept override;
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override;
+	void Process(const OscPath& path, double value) noexcept override;
+	void Process(const OscPath& path, const std::string& value) noexcept override;
 
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
 
 private:
+	NoteIndex noteIndex;
+
 	void SetColorOfClip(ReaProject* project, MediaItem* item, const std::string& value) noexcept;
 	void SetNameOfClip(ReaProject* project, MediaItem* item, const std::string& value) noexcept;
 	void TransposeClip(ReaProject* project, MediaItem* clip, int transpose) noexcept;
@@ -35,7 +43,7 @@ private:
 	bool ClearNote(ReaProject* project, MediaItem* item, int channel, int pitch, double position) noexcept;
 	bool ClearNotesAtPosition(ReaProject* project, MediaItem* item, int channel, double position) noexcept;
 	bool MoveNoteY(ReaProject* project, MediaItem* item, int channel, int pitch, int newPitch, double position) noexcept;
-	int GetNoteIndex(MediaItem_Take* take, int channel, int pitch, double position) noexcept;
+	int GetNoteIndex(MediaItem_Take* take, int channel, int pitch, double position);
 };
 
 #endif /* _DBM_CLIPPROCESSOR_H_ */
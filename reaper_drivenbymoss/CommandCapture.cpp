@@ -0,0 +1,457 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <cstring>
+#include <iterator>
+
+#include "CommandCapture.h"
+#include "ReaDebug.h"
+
+
+namespace
+{
+	/** Identifies a capture file. */
+	const char MAGIC[8]{ 'D', 'B', 'M', 'C', 'A', 'P', '1', '\0' };
+	/** The slowest supported playback speed. */
+	constexpr double MIN_SPEED{ 0.01 };
+
+	template<typename T>
+	bool ReadValue(const std::vector<char>& buffer, std::size_t& position, T& value) noexcept
+	{
+		if (buffer.size() - position < sizeof(T))
+			return false;
+		std::memcpy(&value, buffer.data() + position, sizeof(T));
+		position += sizeof(T);
+		return true;
+	}
+}
+
+
+/**
+ * Destructor. Writes the rest of a running recording.
+ */
+CommandCapture::~CommandCapture()
+{
+	try
+	{
+		this->StopRecording();
+	}
+	catch (...)
+	{
+		// Ignore on shutdown
+	}
+}
+
+
+/**
+ * Start recording into a file. A running recording is stopped first.
+ *
+ * @param path The path of the file, an existing file is overwritten
+ * @return True if the file could be created
+ */
+bool CommandCapture::StartRecording(const std::string& path)
+{
+	this->StopRecording();
+
+	this->file.open(path, std::ios::binary | std::ios::trunc);
+	if (!this->file)
+	{
+		ReaDebug() << "Could not create capture file: " << path;
+		return false;
+	}
+	this->file.write(MAGIC, sizeof(MAGIC));
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	this->stringIDs.clear();
+	this->pending.clear();
+	this->recordedFrames = 0;
+	this->recordedBytes = sizeof(MAGIC);
+	this->recordStart = std::chrono::steady_clock::now();
+	this->isRecording.store(true);
+	return true;
+}
+
+
+/**
+ * Stop recording and close the file.
+ */
+void CommandCapture::StopRecording()
+{
+	if (!this->file.is_open())
+		return;
+
+	this->isRecording.store(false);
+	this->Flush();
+	this->file.close();
+	ReaDebug() << "Capture finished: " << static_cast<std::int64_t>(this->recordedFrames) << " frames, " << static_cast<std::int64_t>(this->recordedBytes) << " bytes";
+}
+
+
+/**
+ * Record a command without a value.
+ *
+ * @param processor The processor
+ * @param command The command
+ */
+void CommandCapture::Record(const std::string& processor, const std::string& command)
+{
+	if (!this->isRecording.load() || processor == CAPTURE_PROCESSOR)
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	std::size_t frameStart{ 0 };
+	if (this->BeginCommand(processor, command, CommandDecoder::RecordType::NO_ARG, frameStart))
+		this->EndFrame(frameStart);
+}
+
+
+/**
+ * Record a command with a string value.
+ *
+ * @param processor The processor
+ * @param command The command
+ * @param value The value
+ */
+void CommandCapture::Record(const std::string& processor, const std::string& command, const std::string& value)
+{
+	if (!this->isRecording.load() || processor == CAPTURE_PROCESSOR)
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	std::size_t frameStart{ 0 };
+	if (!this->BeginCommand(processor, command, CommandDecoder::RecordType::STRING_ARG, frameStart))
+		return;
+	if (this->AppendString(value))
+		this->EndFrame(frameStart);
+	else
+		this->pending.resize(frameStart);
+}
+
+
+/**
+ * Record a command with several string values.
+ *
+ * @param processor The processor
+ * @param command The command
+ * @param values The values
+ */
+void CommandCapture::Record(const std::string& processor, const std::string& command, const std::vector<std::string>& values)
+{
+	if (!this->isRecording.load() || processor == CAPTURE_PROCESSOR || values.size() > MAX_STRING_ID)
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	std::size_t frameStart{ 0 };
+	if (!this->BeginCommand(processor, command, CommandDecoder::RecordType::STRING_ARGS, frameStart))
+		return;
+	this->Append(static_cast<std::uint16_t>(values.size()));
+	for (const std::string& value : values)
+	{
+		if (!this->AppendString(value))
+		{
+			this->pending.resize(frameStart);
+			return;
+		}
+	}
+	this->EndFrame(frameStart);
+}
+
+
+/**
+ * Record a command with an integer value.
+ *
+ * @param processor The processor
+ * @param command The command
+ * @param value The value
+ */
+void CommandCapture::Record(const std::string& processor, const std::string& command, int value)
+{
+	if (!this->isRecording.load() || processor == CAPTURE_PROCESSOR)
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	std::size_t frameStart{ 0 };
+	if (!this->BeginCommand(processor, command, CommandDecoder::RecordType::INT_ARG, frameStart))
+		return;
+	this->Append(static_cast<std::int32_t>(value));
+	this->EndFrame(frameStart);
+}
+
+
+/**
+ * Record a command with a double value.
+ *
+ * @param processor The processor
+ * @param command The command
+ * @param value The value
+ */
+void CommandCapture::Record(const std::string& processor, const std::string& command, double value)
+{
+	if (!this->isRecording.load() || processor == CAPTURE_PROCESSOR)
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	std::size_t frameStart{ 0 };
+	if (!this->BeginCommand(processor, command, CommandDecoder::RecordType::DOUBLE_ARG, frameStart))
+		return;
+	this->Append(value);
+	this->EndFrame(frameStart);
+}
+
+
+/**
+ * Record a MIDI message. Incoming messages are recorded when they are handed to Java, outgoing
+ * ones when they are sent to the output port.
+ *
+ * @param type MIDI_INPUT or MIDI_OUTPUT
+ * @param deviceId The ID of the MIDI device
+ * @param data The bytes of the message
+ * @param size The number of bytes
+ */
+void CommandCapture::RecordMidi(FrameType type, std::uint32_t deviceId, const std::uint8_t* data, std::uint32_t size)
+{
+	if (!this->isRecording.load() || data == nullptr)
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->recordMutex);
+	const std::size_t frameStart = this->BeginFrame(type);
+	this->Append(deviceId);
+	this->pending.insert(this->pending.end(), data, data + size);
+	this->EndFrame(frameStart);
+}
+
+
+/**
+ * Write all recorded frames to the file. The lock is only held to swap the buffers, therefore the
+ * threads which record commands are not blocked by the file access.
+ */
+void CommandCapture::Flush()
+{
+	if (!this->file.is_open())
+		return;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->recordMutex);
+		if (this->pending.empty())
+			return;
+		this->pending.swap(this->writeBuffer);
+	}
+
+	// Cannot avoid this for writing binary data
+	DISABLE_WARNING_REINTERPRET_CAST
+	this->file.write(reinterpret_cast<const char*>(this->writeBuffer.data()), static_cast<std::streamsize>(this->writeBuffer.size()));
+	this->file.flush();
+	this->recordedBytes += this->writeBuffer.size();
+	this->writeBuffer.clear();
+}
+
+
+/**
+ * Load a capture and start playing it back.
+ *
+ * @param path The path of the capture file
+ * @param speed The speed of the playback, 1 is the original speed, 2 is twice as fast
+ * @return True if the capture could be loaded
+ */
+bool CommandCapture::StartReplay(const std::string& path, double speed)
+{
+	this->StopReplay();
+	// Do not record the commands of the playback again
+	this->StopRecording();
+
+	std::ifstream input(path, std::ios::binary);
+	if (!input)
+	{
+		ReaDebug() << "Could not open capture file: " << path;
+		return false;
+	}
+	const std::vector<char> buffer{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+	if (buffer.size() < sizeof(MAGIC) || std::memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) != 0)
+	{
+		ReaDebug() << "Not a capture file: " << path;
+		return false;
+	}
+
+	std::size_t position = sizeof(MAGIC);
+	while (position < buffer.size())
+	{
+		Frame frame{};
+		std::uint8_t type{ 0 };
+		std::int64_t micros{ 0 };
+		std::uint32_t length{ 0 };
+		if (!ReadValue(buffer, position, type) || !ReadValue(buffer, position, micros) || !ReadValue(buffer, position, length) || buffer.size() - position < length)
+		{
+			ReaDebug() << "Capture file is truncated, playing the first " << this->replayFrames.size() << " frames.";
+			break;
+		}
+		const std::size_t end = position + length;
+		frame.type = static_cast<FrameType>(type);
+		frame.micros = micros;
+		if (frame.type != FrameType::COMMANDS && !ReadValue(buffer, position, frame.deviceId))
+		{
+			position = end;
+			continue;
+		}
+		frame.data.assign(buffer.begin() + static_cast<std::ptrdiff_t>(position), buffer.begin() + static_cast<std::ptrdiff_t>(end));
+		this->replayFrames.push_back(std::move(frame));
+		position = end;
+	}
+
+	this->replaySpeed = speed < MIN_SPEED ? MIN_SPEED : speed;
+	this->replayStart = std::chrono::steady_clock::now();
+	return !this->replayFrames.empty();
+}
+
+
+/**
+ * Stop a running playback.
+ */
+void CommandCapture::StopReplay() noexcept
+{
+	this->replayFrames.clear();
+	this->replayIndex = 0;
+}
+
+
+/**
+ * Hand all frames to the handler which are due.
+ *
+ * @param handler Executes a frame
+ * @return True if the last frame was played and the playback finished
+ */
+bool CommandCapture::Replay(const std::function<void(const Frame&)>& handler)
+{
+	if (this->replayFrames.empty())
+		return false;
+
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - this->replayStart;
+	const double position = elapsed.count() * this->replaySpeed;
+	while (this->replayIndex < this->replayFrames.size() && this->replayFrames.at(this->replayIndex).micros <= position)
+	{
+		handler(this->replayFrames.at(this->replayIndex));
+		this->replayIndex++;
+	}
+
+	if (this->replayIndex < this->replayFrames.size())
+		return false;
+	this->StopReplay();
+	return true;
+}
+
+
+/**
+ * Start a command frame and add the command record. The processor and command are defined first
+ * if they were not used before. Must be called while holding the lock.
+ *
+ * @param processor The processor
+ * @param command The command
+ * @param type The type of the record
+ * @param frameStart Is set to the start of the frame
+ * @return False if the command cannot be recorded, nothing was added in that case
+ */
+bool CommandCapture::BeginCommand(const std::string& processor, const std::string& command, CommandDecoder::RecordType type, std::size_t& frameStart)
+{
+	frameStart = this->BeginFrame(FrameType::COMMANDS);
+	std::uint16_t processorID{ 0 };
+	std::uint16_t commandID{ 0 };
+	if (!this->GetStringID(processor, processorID) || !this->GetStringID(command, commandID))
+	{
+		this->pending.resize(frameStart);
+		return false;
+	}
+	this->Append(static_cast<std::uint8_t>(type));
+	this->Append(processorID);
+	this->Append(commandID);
+	return true;
+}
+
+
+/**
+ * Start a new frame. The length of the payload is set by EndFrame.
+ *
+ * @param type The type of the frame
+ * @return The position of the frame in the pending buffer
+ */
+std::size_t CommandCapture::BeginFrame(FrameType type)
+{
+	const std::size_t frameStart = this->pending.size();
+	const std::chrono::microseconds micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->recordStart);
+	this->Append(static_cast<std::uint8_t>(type));
+	this->Append(static_cast<std::int64_t>(micros.count()));
+	this->Append(std::uint32_t{ 0 });
+	return frameStart;
+}
+
+
+/**
+ * Set the length of the payload of a frame.
+ *
+ * @param frameStart The position of the frame in the pending buffer
+ */
+void CommandCapture::EndFrame(std::size_t frameStart)
+{
+	const std::uint32_t length = static_cast<std::uint32_t>(this->pending.size() - frameStart - FRAME_HEADER_SIZE);
+	std::memcpy(this->pending.data() + frameStart + FRAME_HEADER_SIZE - sizeof(length), &length, sizeof(length));
+	this->recordedFrames++;
+}
+
+
+/**
+ * Get the ID of a string. A DEFINE record is added if the string was not used before.
+ *
+ * @param text The string
+ * @param id Is set to the ID
+ * @return False if there are no more IDs
+ */
+bool CommandCapture::GetStringID(const std::string& text, std::uint16_t& id)
+{
+	const auto it = this->stringIDs.find(text);
+	if (it != this->stringIDs.end())
+	{
+		id = it->second;
+		return true;
+	}
+
+	if (this->stringIDs.size() > MAX_STRING_ID)
+	{
+		ReaDebug() << "Capture contains too many different commands, stopping to record commands.";
+		return false;
+	}
+	id = static_cast<std::uint16_t>(this->stringIDs.size());
+	this->Append(static_cast<std::uint8_t>(CommandDecoder::RecordType::DEFINE));
+	this->Append(id);
+	if (!this->AppendString(text))
+		return false;
+	this->stringIDs.emplace(text, id);
+	return true;
+}
+
+
+/**
+ * Add a string with its length.
+ *
+ * @param text The string
+ * @return False if the string is too long
+ */
+bool CommandCapture::AppendString(const std::string& text)
+{
+	if (text.size() > MAX_STRING_ID)
+		return false;
+	this->Append(static_cast<std::uint16_t>(text.size()));
+	this->pending.insert(this->pending.end(), text.begin(), text.end());
+	return true;
+}
+
+
+/**
+ * Add a number in the native byte order.
+ *
+ * @param value The value to add
+ */
+template<typename T>
+void CommandCapture::Append(T value)
+{
+	const std::size_t position = this->pending.size();
+	this->pending.resize(position + sizeof(T));
+	std::memcpy(this->pending.data() + position, &value, sizeof(T));
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_COMMANDCAPTURE_H_
+#define _DBM_COMMANDCAPTURE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CommandDecoder.h"
+
+
+/**
+ * Records all commands which are received from Java and all incoming and outgoing MIDI messages
+ * into a file and plays such a capture back. This allows to reproduce the load of a real session.
+ *
+ * The file starts with the 8 bytes "DBMCAP1\0" followed by frames. All numbers are in the native
+ * byte order. Each frame has the type (uint8), the time since the start of the capture in
+ * microseconds (int64), the length of the payload (uint32) and the payload:
+ *
+ * COMMANDS:    Records in the format of the CommandDecoder, strings are defined on first use
+ * MIDI_INPUT:  device ID (uint32), the bytes of the MIDI message
+ * MIDI_OUTPUT: device ID (uint32), the bytes of the MIDI message
+ *
+ * Commands can be recorded from any thread, everything else must be called from the main thread.
+ */
+class CommandCapture
+{
+public:
+	/** The types of the frames. */
+	enum class FrameType : std::uint8_t
+	{
+		COMMANDS = 0,
+		MIDI_INPUT = 1,
+		MIDI_OUTPUT = 2
+	};
+
+	/** A frame read from a capture file. */
+	struct Frame
+	{
+		FrameType type;
+		long long micros;
+		std::uint32_t deviceId;
+		std::vector<std::uint8_t> data;
+	};
+
+
+	CommandCapture() = default;
+	CommandCapture(const CommandCapture&) = delete;
+	CommandCapture& operator=(const CommandCapture&) = delete;
+	CommandCapture(CommandCapture&&) = delete;
+	CommandCapture& operator=(CommandCapture&&) = delete;
+	~CommandCapture();
+
+	bool StartRecording(const std::string& path);
+	void StopRecording();
+
+	/**
+	 * Check if a capture is recorded.
+	 *
+	 * @return True if recording
+	 */
+	bool IsRecording() const noexcept
+	{
+		return this->isRecording.load();
+	}
+
+	void Record(const std::string& processor, const std::string& command);
+	void Record(const std::string& processor, const std::string& command, const std::string& value);
+	void Record(const std::string& processor, const std::string& command, const std::vector<std::string>& values);
+	void Record(const std::string& processor, const std::string& command, int value);
+	void Record(const std::string& processor, const std::string& command, double value);
+	void RecordMidi(FrameType type, std::uint32_t deviceId, const std::uint8_t* data, std::uint32_t size);
+	void Flush();
+
+	bool StartReplay(const std::string& path, double speed);
+	void StopReplay() noexcept;
+	bool Replay(const std::function<void(const Frame&)>& handler);
+
+	/**
+	 * Check if a capture is played back.
+	 *
+	 * @return True if playing
+	 */
+	bool IsReplaying() const noexcept
+	{
+		return !this->replayFrames.empty();
+	}
+
+	/**
+	 * Get the index of the next frame to play back.
+	 *
+	 * @return The index, 0 if the playback has not started yet
+	 */
+	std::size_t GetReplayPosition() const noexcept
+	{
+		return this->replayIndex;
+	}
+
+private:
+	/** The processor which controls the capture, its commands are not recorded. */
+	static constexpr const char* CAPTURE_PROCESSOR{ "capture" };
+	/** The number of bytes of the header of a frame. */
+	static const std::size_t FRAME_HEADER_SIZE{ 13 };
+	/** The highest ID of a string, IDs are sent as uint16. */
+	static const std::size_t MAX_STRING_ID{ 0xFFFF };
+
+	std::atomic<bool> isRecording{ false };
+	std::mutex recordMutex;
+	std::chrono::steady_clock::time_point recordStart{};
+	std::unordered_map<std::string, std::uint16_t> stringIDs;
+	// Filled from all threads, written to the file on the main thread
+	std::vector<std::uint8_t> pending;
+	std::vector<std::uint8_t> writeBuffer;
+	std::ofstream file;
+	unsigned long long recordedFrames{ 0 };
+	unsigned long long recordedBytes{ 0 };
+
+	std::vector<Frame> replayFrames;
+	std::size_t replayIndex{ 0 };
+	double replaySpeed{ 1.0 };
+	std::chrono::steady_clock::time_point replayStart{};
+
+	bool BeginCommand(const std::string& processor, const std::string& command, CommandDecoder::RecordType type, std::size_t& frameStart);
+	void EndFrame(std::size_t frameStart);
+	bool GetStringID(const std::string& text, std::uint16_t& id);
+	std::size_t BeginFrame(FrameType type);
+	bool AppendString(const std::string& text);
+
+	template<typename T>
+	void Append(T value);
+};
+
+#endif /* _DBM_COMMANDCAPTURE_H_ */
@@ -0,0 +1,170 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <cstring>
+
+#include "CommandDecoder.h"
+#include "OscParser.h"
+#include "ReaDebug.h"
+
+
+/**
+ * Decode all records of a batch and execute the commands. Stops at the first malformed record.
+ *
+ * @param data The encoded records
+ * @param length The number of bytes of the records
+ * @param oscParser The parser which executes the commands
+ * @return True if all records were decoded
+ */
+bool CommandDecoder::Decode(const std::uint8_t* data, std::size_t length, const OscParser& oscParser)
+{
+	if (data == nullptr)
+		return false;
+
+	const std::lock_guard<std::mutex> lock(this->decodeMutex);
+
+	Reader reader(data, length);
+	while (reader.HasMore())
+	{
+		std::uint8_t type{ 0 };
+		std::uint16_t processorID{ 0 };
+		std::uint16_t commandID{ 0 };
+		// For a definition this is the ID of the string
+		if (!reader.Read(type) || !reader.Read(processorID))
+			return false;
+
+		if (type == static_cast<std::uint8_t>(RecordType::DEFINE))
+		{
+			const char* text;
+			std::size_t textLength;
+			if (!reader.ReadString(text, textLength))
+				return false;
+			if (processorID >= this->strings.size())
+				this->strings.resize(processorID + 1);
+			this->strings.at(processorID).assign(text, textLength);
+			continue;
+		}
+
+		if (!reader.Read(commandID))
+			return false;
+		const std::string* processor = this->GetString(processorID);
+		const std::string* command = this->GetString(commandID);
+		if (processor == nullptr || command == nullptr)
+		{
+			ReaDebug() << "Undefined ID in binary command: " << processorID << " " << commandID;
+			return false;
+		}
+
+		switch (static_cast<RecordType>(type))
+		{
+		case RecordType::NO_ARG:
+			oscParser.Process(*processor, *command);
+			break;
+
+		case RecordType::INT_ARG:
+		{
+			std::int32_t value{ 0 };
+			if (!reader.Read(value))
+				return false;
+			oscParser.Process(*processor, *command, static_cast<int>(value));
+			break;
+		}
+
+		case RecordType::DOUBLE_ARG:
+		{
+			double value{ 0 };
+			if (!reader.Read(value))
+				return false;
+			oscParser.Process(*processor, *command, value);
+			break;
+		}
+
+		case RecordType::STRING_ARG:
+		{
+			const char* text;
+			std::size_t textLength;
+			if (!reader.ReadString(text, textLength))
+				return false;
+			this->stringValue.assign(text, textLength);
+			oscParser.Process(*processor, *command, this->stringValue);
+			break;
+		}
+
+		case RecordType::STRING_ARGS:
+		{
+			std::uint16_t count{ 0 };
+			if (!reader.Read(count))
+				return false;
+			this->stringValues.resize(count);
+			for (std::string& value : this->stringValues)
+			{
+				const char* text;
+				std::size_t textLength;
+				if (!reader.ReadString(text, textLength))
+					return false;
+				value.assign(text, textLength);
+			}
+			oscParser.Process(*processor, *command, this->stringValues);
+			break;
+		}
+
+		default:
+			ReaDebug() << "Unknown binary command record type: " << static_cast<int>(type);
+			return false;
+		}
+
+		this->decodedCommands++;
+	}
+	return true;
+}
+
+
+/**
+ * Get the string which was defined for an ID.
+ *
+ * @param id The ID
+ * @return The string or null if the ID is not defined
+ */
+const std::string* CommandDecoder::GetString(std::uint16_t id) const noexcept
+{
+	return id < this->strings.size() ? &this->strings[id] : nullptr;
+}
+
+
+/**
+ * Read a value in native byte order. The position in the buffer does not need to be aligned.
+ *
+ * @param value Where to store the value
+ * @return False if the buffer does not contain enough bytes
+ */
+template<typename T>
+bool CommandDecoder::Reader::Read(T& value) noexcept
+{
+	if (this->length - this->position < sizeof(T))
+		return false;
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	std::memcpy(&value, this->data + this->position, sizeof(T));
+	this->position += sizeof(T);
+	return true;
+}
+
+
+/**
+ * Read a string which is prefixed by its length. The string is not copied.
+ *
+ * @param text Points to the first character of the string afterwards
+ * @param textLength The number of bytes of the string
+ * @return False if the buffer does not contain enough bytes
+ */
+bool CommandDecoder::Reader::ReadString(const char*& text, std::size_t& textLength) noexcept
+{
+	std::uint16_t stringLength{ 0 };
+	if (!this->Read(stringLength) || this->length - this->position < stringLength)
+		return false;
+	DISABLE_WARNING_REINTERPRET_CAST
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	text = reinterpret_cast<const char*>(this->data + this->position);
+	textLength = stringLength;
+	this->position += stringLength;
+	return true;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_COMMANDDECODER_H_
+#define _DBM_COMMANDDECODER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class OscParser;
+
+
+/**
+ * Decodes a batch of commands which were written by Java into a direct byte buffer and hands
+ * them to the OSC parser. All numbers are in the native byte order. A batch is a sequence of
+ * records, each starts with the record type (1 byte):
+ *
+ * DEFINE:      id (uint16), length (uint16), UTF-8 bytes - Assigns a string to an ID
+ * NO_ARG:      processor ID (uint16), command ID (uint16)
+ * INT_ARG:     processor ID (uint16), command ID (uint16), value (int32)
+ * DOUBLE_ARG:  processor ID (uint16), command ID (uint16), value (float64)
+ * STRING_ARG:  processor ID (uint16), command ID (uint16), length (uint16), UTF-8 bytes
+ * STRING_ARGS: processor ID (uint16), command ID (uint16), count (uint16), count x (length (uint16), UTF-8 bytes)
+ *
+ * Processor names and command paths are only sent once with a DEFINE record and afterwards
+ * referenced by their ID. The definitions are kept until the extension is unloaded.
+ */
+class CommandDecoder
+{
+public:
+	/** The types of the records. */
+	enum class RecordType : std::uint8_t
+	{
+		DEFINE = 0,
+		NO_ARG = 1,
+		INT_ARG = 2,
+		DOUBLE_ARG = 3,
+		STRING_ARG = 4,
+		STRING_ARGS = 5
+	};
+
+
+	CommandDecoder() = default;
+	CommandDecoder(const CommandDecoder&) = delete;
+	CommandDecoder& operator=(const CommandDecoder&) = delete;
+	CommandDecoder(CommandDecoder&&) = delete;
+	CommandDecoder& operator=(CommandDecoder&&) = delete;
+	~CommandDecoder() {};
+
+	bool Decode(const std::uint8_t* data, std::size_t length, const OscParser& oscParser);
+
+	/**
+	 * Get the number of commands which were decoded.
+	 *
+	 * @return The number of commands
+	 */
+	unsigned long long GetDecodedCommands() const noexcept
+	{
+		return this->decodedCommands.load();
+	}
+
+private:
+	/** Reads values from the buffer and checks the bounds. */
+	class Reader
+	{
+	public:
+		Reader(const std::uint8_t* aData, std::size_t aLength) noexcept : data(aData), length(aLength)
+		{
+			// Intentionally empty
+		}
+
+		bool HasMore() const noexcept
+		{
+			return this->position < this->length;
+		}
+
+		template<typename T>
+		bool Read(T& value) noexcept;
+		bool ReadString(const char*& text, std::size_t& textLength) noexcept;
+
+	private:
+		const std::uint8_t* data;
+		std::size_t length;
+		std::size_t position{ 0 };
+	};
+
+	std::mutex decodeMutex;
+	std::vector<std::string> strings;
+	// Re-used to prevent allocations
+	std::string stringValue;
+	std::vector<std::string> stringValues;
+	std::atomic<unsigned long long> decodedCommands{ 0 };
+
+	const std::string* GetString(std::uint16_t id) const noexcept;
+};
+
+#endif /* _DBM_COMMANDDECODER_H_ */
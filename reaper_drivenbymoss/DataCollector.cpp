@@ -24,8 +24,6 @@ DataCollector::DataCollector(Model& aModel) :
 	deviceSiblingsBypass(Model::DEVICE_BANK_SIZE, 0),
 	deviceSiblingsPosition(Model::DEVICE_BANK_SIZE, 0)
 {
-	this->trackStateChunk = std::make_unique<char[]>(BUFFER_SIZE);
-
 	for (int i = 0; i < 8; i++)
 		this->eqBandTypes.push_back("-1");
 }
@@ -36,7 +34,7 @@ DataCollector::DataCollector(Model& aModel) :
  */
 DataCollector::~DataCollector()
 {
-	this->trackStateChunk.reset();
+	// Intentionally empty
 }
 
 
@@ -48,6 +46,8 @@ DataCollector::~DataCollector()
  */
 std::string DataCollector::CollectData(const bool& dump, ActionProcessor& actionProcessor)
 {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
 	std::ostringstream ss;
 
 	actionProcessor.CollectData(ss);
@@ -64,30 +64,292 @@ std::string DataCollector::CollectData(const bool& dump, ActionProcessor& action
 
 	this->slowCounter = (this->slowCounter + 1) % SLOW_UPDATE;
 
+	// The snapshot only contains the data of one project
+	if (project != this->snapshotProject)
+	{
+		this->snapshot.Clear();
+		this->snapshotProject = project;
+		this->isSnapshotRecording = false;
+	}
+	const ElementCounts countsBefore = this->GetCounts();
+
+	// A dump re-reads all parameter names, e.g. for plugins which rename their parameters dynamically.
+	// If all data was sent once, the dump is created from the snapshot of the sent data, followed
+	// by the changes of this pass. Otherwise, the data is collected from Reaper
+	const bool dumpFromSnapshot = dump && this->isDumpFromSnapshotEnabled && this->snapshot.IsComplete();
+	std::string snapshotDump;
+	if (dumpFromSnapshot)
+	{
+		this->dumpSequence++;
+		std::ostringstream dumpStream;
+		dumpStream << "/dump/begin " << this->dumpSequence << "\n" << this->snapshot.Serialize() << "/dump/end " << this->dumpSequence << "\n";
+		snapshotDump = dumpStream.str();
+	}
+#ifdef _DEBUG
+	// Debug builds collect the dump from Reaper as well, if the snapshot is complete, and compare
+	// it with the snapshot when it is finished. This sends the data of a dump twice
+	const bool dumpFromReaper = dump;
+	if (dump && this->snapshot.IsComplete())
+		this->expectedSnapshot = this->snapshot.Serialize();
+#else
+	const bool dumpFromReaper = dump && !dumpFromSnapshot;
+#endif
+	if (dump)
+	{
+		this->parameterCache.Clear();
+		if (dumpFromReaper)
+			this->StartDump(ss);
+	}
+	this->parameterCache.NextTick(project);
+
+	// All envelopes are evaluated at the same position
+	this->automationContext = AutomationContext::Create(project);
+
+	// A running dump is split into slices over several calls, all other data is sent as changes
+	this->dumpDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->model.dumpBudget);
+	this->dumpSlicesInPass = 0;
+
+	std::chrono::steady_clock::time_point stageStart = std::chrono::steady_clock::now();
+	bool dumpSlice = this->IsDumpSlice(DumpStage::PROJECT);
 	if (IsActive("project"))
-		CollectProjectData(ss, project, dump);
+		CollectProjectData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::PROJECT, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::TRANSPORT);
 	if (IsActive("transport"))
-		CollectTransportData(ss, project, dump);
+		CollectTransportData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::TRANSPORT, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::TRACK);
 	if (IsActive("track"))
-		CollectTrackData(ss, project, dump);
+		CollectTrackData(ss, project, dumpSlice);
+	else if (dumpSlice)
+		this->dumpStage = DumpStage::DEVICE;
+	this->AddStageTime(DumpStage::TRACK, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::DEVICE);
 	if (IsActive("device"))
-		CollectDeviceData(ss, project, track, dump || hasTrackChanged);
+		CollectDeviceData(ss, project, track, dumpSlice || hasTrackChanged);
+	this->AddStageTime(DumpStage::DEVICE, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::MASTER);
 	if (IsActive("master"))
-		CollectMasterTrackData(ss, project, dump);
+		CollectMasterTrackData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::MASTER, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::BROWSER);
 	if (IsActive("browser"))
-		CollectBrowserData(ss, track, dump);
+		CollectBrowserData(ss, track, dumpSlice);
+	this->AddStageTime(DumpStage::BROWSER, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::MARKER);
 	if (IsActive("marker"))
-		CollectMarkerData(ss, project, dump);
+		CollectMarkerData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::MARKER, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::CLIP);
 	if (IsActive("clip"))
-		CollectClipData(ss, project, dump);
+		CollectClipData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::CLIP, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::SESSION);
 	if (IsActive("session"))
-		CollectSessionData(ss, project, dump);
+		CollectSessionData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::SESSION, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::NOTEREPEAT);
 	if (IsActive("noterepeat"))
-		CollectNoteRepeatData(ss, project, dump);
+		CollectNoteRepeatData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::NOTEREPEAT, stageStart);
+	dumpSlice = this->IsDumpSlice(DumpStage::GROOVE);
 	if (IsActive("groove"))
-		CollectGrooveData(ss, project, dump);
+		CollectGrooveData(ss, project, dumpSlice);
+	this->AddStageTime(DumpStage::GROOVE, stageStart);
+
+	const bool isDumpComplete = this->dumpStage == DumpStage::COMPLETE;
+	if (isDumpComplete)
+	{
+		ss << "/dump/end " << this->dumpSequence << "\n";
+		this->dumpStage = DumpStage::IDLE;
+	}
+
+	std::string result = ss.str();
+	this->UpdateSnapshot(result, countsBefore, isDumpComplete);
+	if (dumpFromSnapshot)
+		result.insert(0, snapshotDump);
+	this->AddTickStatistics(start, dump || this->dumpSlicesInPass > 0, result.size());
+	return result;
+}
+
+
+/**
+ * Get the statistics about the collection of the data.
+ *
+ * @param reset If true, all values are reset
+ * @return The statistics
+ */
+DataCollector::Statistics DataCollector::GetStatistics(bool reset)
+{
+	Statistics statistics;
+	statistics.delta = this->deltaTimer.GetValues(reset);
+	statistics.dump = this->dumpTimer.GetValues(reset);
+	statistics.bytes = reset ? this->bytes.exchange(0) : this->bytes.load();
+	statistics.maxBytes = reset ? this->maxBytes.exchange(0) : this->maxBytes.load();
+	for (std::size_t i = 0; i < STAGE_COUNT; i++)
+		statistics.stages[i] = this->stageTimers[i].GetValues(reset);
+	return statistics;
+}
+
+
+/**
+ * Get the name of a stage, which is also the name of the processor to enable or disable it.
+ *
+ * @param stage The index of the stage
+ * @return The name or an empty text if the index is out of range
+ */
+const char* DataCollector::GetStageName(std::size_t stage) noexcept
+{
+	static const std::array<const char*, STAGE_COUNT> STAGE_NAMES{ { "project", "transport", "track", "device", "master", "browser", "marker", "clip", "session", "noterepeat", "groove" } };
+	return stage < STAGE_COUNT ? STAGE_NAMES[stage] : "";
+}
+
+
+/**
+ * Add the time of a stage to the statistics.
+ *
+ * @param stage The stage
+ * @param stageStart The start time of the stage, is set to the current time afterwards
+ */
+void DataCollector::AddStageTime(DumpStage stage, std::chrono::steady_clock::time_point& stageStart) noexcept
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now - stageStart).count();
+	stageStart = now;
+
+	this->stageTimers[static_cast<std::size_t>(stage)].Record(nanos);
+}
+
+
+/**
+ * Add the values of a call to the statistics.
+ *
+ * @param start The time when the call started
+ * @param isDump True if (a part of) a dump was collected
+ * @param size The number of bytes of the collected data
+ */
+void DataCollector::AddTickStatistics(const std::chrono::steady_clock::time_point& start, bool isDump, std::size_t size) noexcept
+{
+	const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	if (isDump)
+		this->dumpTimer.Record(nanos);
+	else
+		this->deltaTimer.Record(nanos);
+
+	this->bytes.fetch_add(size, std::memory_order_relaxed);
+	if (size > this->maxBytes.load(std::memory_order_relaxed))
+		this->maxBytes.store(size, std::memory_order_relaxed);
+}
+
+
+/**
+ * Start a new dump of all data. A dump which is still running is restarted.
+ *
+ * @param ss The stream where to append the formatted data
+ */
+void DataCollector::StartDump(std::ostringstream& ss)
+{
+	this->dumpSequence++;
+	this->dumpStage = DumpStage::PROJECT;
+	this->dumpTrackOffset = 0;
+	ss << "/dump/begin " << this->dumpSequence << "\n";
+
+	// The snapshot is filled again from the dump
+	this->snapshot.Clear();
+	this->isSnapshotRecording = true;
+}
+
+
+/**
+ * Get the number of tracks, markers, scenes, devices and parameters which were sent last.
+ *
+ * @return The numbers
+ */
+DataCollector::ElementCounts DataCollector::GetCounts() const noexcept
+{
+	return { { this->model.trackCount, this->model.markerCount, this->model.sceneCount, this->model.deviceCount, this->model.deviceParamCount,
+		this->model.eqParamCount, this->model.trackFxParamCount, this->model.masterFxParamCount, this->instrumentParameterCount } };
+}
+
 
-	return ss.str();
+/**
+ * Apply the data of a pass to the snapshot. While a dump from Reaper is running, the data is added
+ * to the snapshot, afterwards the changes are only added to its journal. If the number of
+ * elements or the number of sends of a track was reduced, the snapshot contains addresses which
+ * are no longer sent and is dropped.
+ *
+ * @param data The collected data of the pass
+ * @param countsBefore The numbers of elements before the pass
+ * @param isDumpComplete True if the pass finished a dump
+ */
+void DataCollector::UpdateSnapshot(const std::string& data, const ElementCounts& countsBefore, bool isDumpComplete)
+{
+	const ElementCounts counts = this->GetCounts();
+	bool isReduced = this->hasRemovedSends;
+	this->hasRemovedSends = false;
+	for (std::size_t i = 0; i < counts.size(); i++)
+		isReduced = isReduced || counts[i] < countsBefore[i];
+	if (isReduced)
+	{
+		this->snapshot.Clear();
+		this->isSnapshotRecording = false;
+#ifdef _DEBUG
+		this->expectedSnapshot.clear();
+#endif
+		return;
+	}
+
+	if (!this->isSnapshotRecording)
+	{
+		this->snapshot.Append(data);
+		return;
+	}
+
+	this->snapshot.Update(data);
+	if (!isDumpComplete)
+		return;
+	this->snapshot.SetComplete();
+	this->isSnapshotRecording = false;
+
+#ifdef _DEBUG
+	if (this->expectedSnapshot.empty())
+		return;
+	std::string firstDifference;
+	const std::size_t differences = this->snapshot.Compare(this->expectedSnapshot, firstDifference);
+	if (differences > 0)
+		ReaDebug() << "Snapshot differs from the dump in " << differences << " addresses, e.g. " << firstDifference;
+	this->expectedSnapshot.clear();
+#endif
+}
+
+
+/**
+ * Check if the data of the given stage needs to be dumped in the current pass. The first slice
+ * of a pass is always dumped, further slices only as long as the time budget is not used up.
+ * The stage is advanced to the next one, except for the tracks which are dumped in several slices.
+ *
+ * @param stage The stage to check
+ * @return True if all data of the stage needs to be collected
+ */
+bool DataCollector::IsDumpSlice(DumpStage stage)
+{
+	if (this->dumpStage != stage || !this->IsInDumpBudget())
+		return false;
+	this->dumpSlicesInPass++;
+	if (stage != DumpStage::TRACK)
+		this->dumpStage = static_cast<DumpStage> (static_cast<int> (stage) + 1);
+	return true;
+}
+
+
+/**
+ * Check if the time budget for dumping in the current pass is not yet used up.
+ *
+ * @return True if there is time left or nothing was dumped yet in this pass
+ */
+bool DataCollector::IsInDumpBudget() const
+{
+	return this->dumpSlicesInPass == 0 || this->model.dumpBudget <= 0 || std::chrono::steady_clock::now() < this->dumpDeadline;
 }
 
 
@@ -306,8 +568,9 @@ void DataCollector::CollectDeviceData(std::ostringstream& ss, ReaProject* projec
 	// Cursor device parameters
 	const int paramCount = this->deviceExists ? TrackFX_GetNumParams(track, deviceIndex) : 0;
 	this->model.deviceParamCount = Collectors::CollectIntValue(ss, "/device/param/count", this->model.deviceParamCount, paramCount, dump);
+	ParameterCache::FxMetadata* deviceFx = paramCount > 0 ? this->parameterCache.GetFx(track, deviceIndex) : nullptr;
 	for (int index = 0; index < paramCount; index++)
-		this->model.GetParameter(index)->CollectData(ss, track, deviceIndex, dump);
+		this->model.GetParameter(index)->CollectData(ss, deviceFx, track, deviceIndex, dump);
 
 	// 
 	// First instrument (primary) data
@@ -322,8 +585,9 @@ void DataCollector::CollectDeviceData(std::ostringstream& ss, ReaProject* projec
 
 	const int instParamCount = this->instrumentExists ? TrackFX_GetNumParams(track, instrumentIndex) : 0;
 	this->instrumentParameterCount = Collectors::CollectIntValue(ss, "/primary/param/count", this->instrumentParameterCount, instParamCount, dump);
+	ParameterCache::FxMetadata* instrumentFx = instParamCount > 0 ? this->parameterCache.GetFx(track, instrumentIndex) : nullptr;
 	for (int index = 0; index < instParamCount; index++)
-		this->model.GetInstrumentParameter(index)->CollectData(ss, track, instrumentIndex, dump);
+		this->model.GetInstrumentParameter(index)->CollectData(ss, instrumentFx, track, instrumentIndex, dump);
 
 	// 
 	// First ReaEQ data
@@ -367,10 +631,11 @@ void DataCollector::CollectDeviceData(std::ostringstream& ss, ReaProject* projec
 		}
 	}
 
+	ParameterCache::FxMetadata* eqFx = eqParamCount > 0 ? this->parameterCache.GetFx(track, eqIndex) : nullptr;
 	for (int index = 0; index < eqParamCount; index++)
 	{
 		const std::unique_ptr<Parameter>& parameter = this->model.GetEqParameter(index);
-		parameter->CollectData(ss, track, eqIndex, dump);
+		parameter->CollectData(ss, eqFx, track, eqIndex, dump);
 	}
 
 	// Track FX Parameter
@@ -378,11 +643,21 @@ void DataCollector::CollectDeviceData(std::ostringstream& ss, ReaProject* projec
 	this->model.trackFxParamCount = Collectors::CollectIntValue(ss, "/track/fx/param/count", this->model.trackFxParamCount, trackFxParamCount, dump);
 	int fxindexOut = 0;
 	int parmidxOut = 0;
+	// The parameters of the same FX are consecutive, only look it up when the FX changes
+	int cachedFxIndex = -1;
+	ParameterCache::FxMetadata* cachedFx = nullptr;
 	for (int index = 0; index < trackFxParamCount; index++)
 	{
 		const std::unique_ptr<Parameter>& parameter = this->model.GetTrackFXParameter(index);
 		if (GetTCPFXParm(project, track, index, &fxindexOut, &parmidxOut))
-			parameter->CollectData(ss, track, fxindexOut, parmidxOut, dump);
+		{
+			if (fxindexOut != cachedFxIndex)
+			{
+				cachedFxIndex = fxindexOut;
+				cachedFx = this->parameterCache.GetFx(track, fxindexOut);
+			}
+			parameter->CollectData(ss, cachedFx, track, fxindexOut, parmidxOut, dump);
+		}
 		else
 			parameter->ClearData(ss, dump);
 	}
@@ -394,29 +669,38 @@ void DataCollector::CollectDeviceData(std::ostringstream& ss, ReaProject* projec
  *
  * @param ss The stream where to append the formatted data
  * @param project The current Reaper project
- * @param dump If true all data is collected not only the changed one since the last call
+ * @param dump If true, the next slice of tracks is dumped, starting at the first track not dumped yet.
+ *             As many tracks are dumped as the time budget allows but at least one.
  */
 void DataCollector::CollectTrackData(std::ostringstream& ss, ReaProject* project, const bool& dump)
 {
-	const int count = CountTracks(project);
-	int trackIndex{ 0 };
-	int trackState{};
+	const std::shared_ptr<const VisibleTracks> visibleTracks = this->model.GetTrackIndexMap().Get(project);
+	const int count = visibleTracks->GetCount();
 	std::string playingNotes{ "" };
+	bool isSliceOpen = dump;
 
 	const bool isActive = IsActive("playingnotes");
 
-	for (int index = 0; index < count; index++)
+	for (int trackIndex = 0; trackIndex < count; trackIndex++)
 	{
-		MediaTrack* mediaTrack = GetTrack(project, index);
-		if (mediaTrack == nullptr)
-			continue;
+		MediaTrack* mediaTrack = visibleTracks->GetTrack(trackIndex);
+
+		bool dumpTrack{ false };
+		if (isSliceOpen && trackIndex >= this->dumpTrackOffset)
+		{
+			isSliceOpen = trackIndex == this->dumpTrackOffset || this->IsInDumpBudget();
+			if (isSliceOpen)
+			{
+				dumpTrack = true;
+				this->dumpTrackOffset = trackIndex + 1;
+			}
+		}
 
-		// Ignore track if hidden
-		GetTrackState(mediaTrack, &trackState);
-		if ((trackState & 1024) > 0)
-			continue;
 		const std::unique_ptr<Track>& track = this->model.GetTrack(trackIndex);
-		track->CollectData(ss, project, mediaTrack, trackIndex, this->slowCounter == 0, dump);
+		const int sendCount = track->GetSendCount();
+		track->CollectData(ss, project, mediaTrack, trackIndex, this->automationContext, this->slowCounter == 0, dumpTrack);
+		if (track->GetSendCount() < sendCount)
+			this->hasRemovedSends = true;
 
 		// Only collect note information, if enabled, track is active and playback is on
 		if (isActive && this->play > 0 && track->isSelected > 0)
@@ -424,12 +708,14 @@ void DataCollector::CollectTrackData(std::ostringstream& ss, ReaProject* project
 			std::ostringstream das;
 			das << "/track/" << trackIndex << "/playingnotes";
 			playingNotes = this->CollectPlayingNotes(project, mediaTrack);
-			this->playingNotesStr = Collectors::CollectStringValue(ss, das.str().c_str(), this->playingNotesStr, playingNotes.c_str(), dump);
+			this->playingNotesStr = Collectors::CollectStringValue(ss, das.str().c_str(), this->playingNotesStr, playingNotes.c_str(), dumpTrack);
 		}
-
-		trackIndex++;
 	}
-	this->model.trackCount = Collectors::CollectIntValue(ss, "/track/count", this->model.trackCount, trackIndex, dump);
+	this->model.trackCount = Collectors::CollectIntValue(ss, "/track/count", this->model.trackCount, count, dump);
+
+	// All tracks dumped?
+	if (isSliceOpen)
+		this->dumpStage = DumpStage::DEVICE;
 }
 
 std::string DataCollector::CollectPlayingNotes(ReaProject* project, MediaTrack* track)
@@ -479,21 +765,21 @@ std::string DataCollector::CollectPlayingNotes(ReaProject* project, MediaTrack*
 void DataCollector::CollectMasterTrackData(std::ostringstream& ss, ReaProject* project, const bool& dump)
 {
 	MediaTrack* master = GetMasterTrack(project);
-	const double cursorPos = ReaperUtils::GetCursorPosition(project);
+	this->masterAutomation.Update(master, this->automationContext);
 
 	int trackState;
 	GetTrackState(master, &trackState);
 
 	this->masterSelected = Collectors::CollectIntValue(ss, "/master/select", this->masterSelected, (trackState & 2) > 0, dump);
-	this->masterMute = Collectors::CollectIntValue(ss, "/master/mute", this->masterMute, this->GetMasterMute(master, cursorPos, trackState), dump);
+	this->masterMute = Collectors::CollectIntValue(ss, "/master/mute", this->masterMute, this->GetMasterMute(master, trackState), dump);
 	this->masterSolo = Collectors::CollectIntValue(ss, "/master/solo", this->masterSolo, (trackState & 16) > 0 ? 1 : 0, dump);
 
 	// Master track volume and pan
-	const double volDB = this->GetMasterVolume(master, cursorPos);
+	const double volDB = this->GetMasterVolume(master);
 	this->model.masterVolume = Collectors::CollectDoubleValue(ss, "/master/volume", this->model.masterVolume, DB2SLIDER(volDB) / 1000.0, dump);
 	this->masterVolumeStr = Collectors::CollectStringValue(ss, "/master/volume/str", this->masterVolumeStr, Collectors::FormatDB(volDB).c_str(), dump);
 
-	const double panVal = this->GetMasterPan(master, cursorPos);
+	const double panVal = this->GetMasterPan(master);
 	this->model.masterPan = Collectors::CollectDoubleValue(ss, "/master/pan", this->model.masterPan, (panVal + 1) / 2, dump);
 	this->masterPanStr = Collectors::CollectStringValue(ss, "/master/pan/str", this->masterPanStr, Collectors::FormatPan(panVal).c_str(), dump);
 
@@ -521,11 +807,20 @@ void DataCollector::CollectMasterTrackData(std::ostringstream& ss, ReaProject* p
 	int parmidxOut = 0;
 	const int masterFxParamCount = CountTCPFXParms(project, master);
 	this->model.masterFxParamCount = Collectors::CollectIntValue(ss, "/master/fx/param/count", this->model.masterFxParamCount, masterFxParamCount, dump);
+	int cachedFxIndex = -1;
+	ParameterCache::FxMetadata* cachedFx = nullptr;
 	for (int index = 0; index < masterFxParamCount; index++)
 	{
 		const std::unique_ptr<Parameter>& parameter = this->model.GetMasterFXParameter(index);
 		if (GetTCPFXParm(project, master, index, &fxindexOut, &parmidxOut))
-			parameter->CollectData(ss, master, fxindexOut, parmidxOut, dump);
+		{
+			if (fxindexOut != cachedFxIndex)
+			{
+				cachedFxIndex = fxindexOut;
+				cachedFx = this->parameterCache.GetFx(master, fxindexOut);
+			}
+			parameter->CollectData(ss, cachedFx, master, fxindexOut, parmidxOut, dump);
+		}
 		else
 			parameter->ClearData(ss, dump);
 	}
@@ -715,24 +1010,17 @@ void DataCollector::CollectSessionData(std::ostringstream& ss, ReaProject* proje
 {
 	// Only collect clip data if document has changed
 	const int state = GetProjectStateChangeCount(project);
-	if (this->projectState == state)
+	if (this->projectState == state && !dump)
 		return;
 	this->projectState = state;
 
 	std::ostringstream clipStr;
 
-	int count = CountTracks(project);
-	int trackIndex{ 0 };
-	int trackState{};
-	for (int index = 0; index < count; index++)
+	const std::shared_ptr<const VisibleTracks> visibleTracks = this->model.GetTrackIndexMap().Get(project);
+	int count = visibleTracks->GetCount();
+	for (int trackIndex = 0; trackIndex < count; trackIndex++)
 	{
-		MediaTrack* mediaTrack = GetTrack(project, index);
-		if (mediaTrack == nullptr)
-			continue;
-		// Ignore track if hidden
-		GetTrackState(mediaTrack, &trackState);
-		if ((trackState & 1024) > 0)
-			continue;
+		MediaTrack* mediaTrack = visibleTracks->GetTrack(trackIndex);
 
 		int red { 0 };
 		int green { 0 };
@@ -780,8 +1068,6 @@ void DataCollector::CollectSessionData(std::ostringstream& ss, ReaProject* proje
 			realCount++;
 		}
 		clipStr << trackIndex << ";" << realCount << ";" << allClipStr.str();
-
-		trackIndex++;
 	}
 	this->formattedClips = Collectors::CollectStringValue(ss, "/clip/all", this->formattedClips, clipStr.str(), dump);
 
@@ -832,44 +1118,28 @@ void DataCollector::CollectNoteRepeatData(std::ostringstream& ss, ReaProject* pr
 }
 
 
-double DataCollector::GetMasterVolume(MediaTrack* master, double position) const noexcept
+double DataCollector::GetMasterVolume(MediaTrack* master) const noexcept
 {
-	if (GetMediaTrackInfo_Value(master, "I_AUTOMODE") > 0)
-	{
-		TrackEnvelope* envelope = GetTrackEnvelopeByName(master, "Volume");
-		if (envelope != nullptr)
-			return ReaperUtils::ValueToDB(ReaperUtils::GetEnvelopeValueAtPosition(envelope, position));
-	}
+	if (this->masterAutomation.automationMode > 0 && this->masterAutomation.volumeEnvelope != nullptr)
+		return ReaperUtils::ValueToDB(ReaperUtils::GetEnvelopeValueAtPosition(this->masterAutomation.volumeEnvelope, this->automationContext.position, this->automationContext.sampleRate));
 	return ReaperUtils::ValueToDB(GetMediaTrackInfo_Value(master, "D_VOL"));
 }
 
 
-double DataCollector::GetMasterPan(MediaTrack* master, double position) const noexcept
+double DataCollector::GetMasterPan(MediaTrack* master) const noexcept
 {
-	if (GetMediaTrackInfo_Value(master, "I_AUTOMODE") > 0)
-	{
-		TrackEnvelope* envelope = GetTrackEnvelopeByName(master, "Pan");
-		if (envelope != nullptr)
-		{
-			// Higher values are left!
-			return -1 * ReaperUtils::GetEnvelopeValueAtPosition(envelope, position);
-		}
-	}
+	// Higher values are left!
+	if (this->masterAutomation.automationMode > 0 && this->masterAutomation.panEnvelope != nullptr)
+		return -1 * ReaperUtils::GetEnvelopeValueAtPosition(this->masterAutomation.panEnvelope, this->automationContext.position, this->automationContext.sampleRate);
 	return GetMediaTrackInfo_Value(master, "D_PAN");
 }
 
 
-int DataCollector::GetMasterMute(MediaTrack* master, double position, int trackState) const noexcept
+int DataCollector::GetMasterMute(MediaTrack* master, int trackState) const noexcept
 {
-	if (GetMediaTrackInfo_Value(master, "I_AUTOMODE") > 0)
-	{
-		TrackEnvelope* envelope = GetTrackEnvelopeByName(master, "Mute");
-		if (envelope != nullptr)
-		{
-			// The envelope is inverted!
-			return ReaperUtils::GetEnvelopeValueAtPosition(envelope, position) > 0 ? 0 : 1;
-		}
-	}
+	// The envelope is inverted!
+	if (this->masterAutomation.automationMode > 0 && this->masterAutomation.muteEnvelope != nullptr)
+		return ReaperUtils::GetEnvelopeValueAtPosition(this->masterAutomation.muteEnvelope, this->automationContext.position, this->automationContext.sampleRate) > 0 ? 0 : 1;
 	return (trackState & 8) > 0 ? 1 : 0;
 }
 
@@ -4,16 +4,21 @@
 #ifndef _DBM_DATACOLLECTOR_H_
 #define _DBM_DATACOLLECTOR_H_
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <mutex>
-#include <regex>
 #include <string>
 #include <sstream>
 #include <vector>
 
 #include "Model.h"
 #include "ActionProcessor.h"
+#include "ModelSnapshot.h"
+#include "ParameterCache.h"
+#include "StageTimer.h"
+#include "TrackAutomation.h"
 
 
 /**
@@ -23,6 +28,19 @@ class DataCollector
 {
 public:
 	static const int TIME_LENGTH{ 20 };
+	/** The number of stages which are measured separately. */
+	static const std::size_t STAGE_COUNT{ 11 };
+
+	/** Statistics about the collection of the data. */
+	struct Statistics
+	{
+		StageTimer::Values delta;
+		StageTimer::Values dump;
+		unsigned long long bytes{ 0 };
+		std::size_t maxBytes{ 0 };
+		// The time spent in each stage, in the order of collection, see GetStageName
+		std::array<StageTimer::Values, STAGE_COUNT> stages{};
+	};
 
 	DataCollector(Model& aModel);
 	virtual ~DataCollector();
@@ -33,32 +51,75 @@ public:
 
 	std::string CollectData(const bool& dump, ActionProcessor& actionProcessor);
 
+	/**
+	 * Enable or disable creating dumps from the snapshot of the sent data. If disabled, all dumps
+	 * are collected from Reaper, which allows to compare both.
+	 *
+	 * @param enable True to enable
+	 */
+	void EnableDumpFromSnapshot(bool enable) noexcept
+	{
+		this->isDumpFromSnapshotEnabled = enable;
+	}
+
 	void EnableUpdate(std::string processor, bool enable);
 	void DelayUpdate(std::string processor);
 
+	Statistics GetStatistics(bool reset);
+	static const char* GetStageName(std::size_t stage) noexcept;
+
 private:
 	const static int DELAY{ 300 };
+	/** The number of tracks, markers, scenes, devices and parameters. */
+	using ElementCounts = std::array<int, 9>;
 	static const int SLOW_UPDATE{ 16 };
 
+	/** The stages of a dump in the order in which they are collected. */
+	enum class DumpStage
+	{
+		PROJECT, TRANSPORT, TRACK, DEVICE, MASTER, BROWSER, MARKER, CLIP, SESSION, NOTEREPEAT, GROOVE, COMPLETE, IDLE
+	};
+
 	std::map<std::string, bool> disableUpdateMap;
 	std::map<std::string, long long> delayUpdateMap;
 	std::mutex delayMutex;
 
 	int slowCounter{ 0 };
 
+	// State of a dump which is spread over several passes
+	DumpStage dumpStage{ DumpStage::IDLE };
+	int dumpSequence{ 0 };
+	int dumpTrackOffset{ 0 };
+	int dumpSlicesInPass{ 0 };
+	std::chrono::steady_clock::time_point dumpDeadline{};
+
+	// Statistics, only written by the main thread
+	StageTimer deltaTimer;
+	StageTimer dumpTimer;
+	std::atomic<unsigned long long> bytes{ 0 };
+	std::atomic<std::size_t> maxBytes{ 0 };
+	std::array<StageTimer, STAGE_COUNT> stageTimers{};
+
 
 	Model& model;
+	ParameterCache parameterCache;
+	ModelSnapshot snapshot;
+	// The project of the snapshot
+	ReaProject* snapshotProject{ nullptr };
+	// True while a dump from Reaper fills the snapshot
+	bool isSnapshotRecording{ false };
+	bool isDumpFromSnapshotEnabled{ true };
+	// Set if a track sent fewer sends than before in the current pass
+	bool hasRemovedSends{ false };
+#ifdef _DEBUG
+	// The snapshot which was sent as a dump, to compare it with the dump from Reaper
+	std::string expectedSnapshot;
+#endif
+	AutomationContext automationContext;
+	TrackAutomation masterAutomation;
 	MediaTrack* selectedTrack{ nullptr };
 	int projectState{ -1 };
 
-	const static int BUFFER_SIZE{ 65535 };
-	std::unique_ptr<char[]> trackStateChunk;
-
-
-	const std::regex trackLockPattern{ "LOCK (\\d+)" };
-	const std::regex presetHeaderPattern{ "\\[Preset(.*)\\]" };
-	const std::regex presetNamePattern{ "Name=(.*)" };
-
 	// Global values
 	std::string preRoll{};
 	std::string preRollMeasures{};
@@ -160,6 +221,14 @@ private:
 	double swingAmount{ 0 };
 
 
+	void StartDump(std::ostringstream& ss);
+	ElementCounts GetCounts() const noexcept;
+	void UpdateSnapshot(const std::string& data, const ElementCounts& countsBefore, bool isDumpComplete);
+	bool IsDumpSlice(DumpStage stage);
+	bool IsInDumpBudget() const;
+	void AddStageTime(DumpStage stage, std::chrono::steady_clock::time_point& stageStart) noexcept;
+	void AddTickStatistics(const std::chrono::steady_clock::time_point& start, bool isDump, std::size_t size) noexcept;
+
 	bool IsActive(std::string processor);
 	bool CheckDelay(std::string processor);
 
@@ -178,9 +247,9 @@ private:
 	std::string CollectClipNotes(ReaProject* project, MediaItem* item);
 	std::string CollectPlayingNotes(ReaProject* project, MediaTrack* track);
 
-	double GetMasterVolume(MediaTrack* master, double position) const noexcept;
-	double GetMasterPan(MediaTrack* master, double position) const noexcept;
-	int GetMasterMute(MediaTrack* master, double position, int trackState) const noexcept;
+	double GetMasterVolume(MediaTrack* master) const noexcept;
+	double GetMasterPan(MediaTrack* master) const noexcept;
+	int GetMasterMute(MediaTrack* master, int trackState) const noexcept;
 
 	MediaItem_Take* GetMidiTakeAtPlayPosition(ReaProject* project, MediaTrack* track) const noexcept;
 	void ReplaceCommaWithDot(std::string& str);
@@ -29,7 +29,7 @@ int DeviceProcessor::GetDeviceSelection() noexcept
 
 
 /** {@inheritDoc} */
-void DeviceProcessor::Process(std::deque<std::string>& path) noexcept
+void DeviceProcessor::Process(const OscPath& path) noexcept
 {
 	if (path.empty())
 		return;
@@ -37,7 +37,9 @@ void DeviceProcessor::Process(std::deque<std::string>& path) noexcept
 
 	int devicePosition = this->GetDeviceSelection();
 
-	if (std::strcmp(part, "page") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("page"):
 	{
 		part = SafeGet(path, 1);
 		if (std::strcmp(part, "+") == 0)
@@ -52,63 +54,71 @@ void DeviceProcessor::Process(std::deque<std::string>& path) noexcept
 		return;
 	}
 
-	if (std::strcmp(part, "+") == 0)
+	case OscPath::Hash("+"):
 	{
 		this->model.SetDeviceSelection(devicePosition + 1);
 		return;
 	}
 
-	if (std::strcmp(part, "-") == 0)
+	case OscPath::Hash("-"):
 	{
 		this->model.SetDeviceSelection(devicePosition - 1);
 		return;
 	}
 
+	default:
+		break;
+	}
+
 	ReaProject* project = ReaperUtils::GetProject();
 	MediaTrack* track = GetSelectedTrack2(project, 0, true);
 	if (track == nullptr)
 		return;
 
-	const int fx = atoi(part) - 1;
-
-	const char* cmd = SafeGet(path, 1);
+	const int fx = path.GetInt(0) - 1;
 
-	if (std::strcmp(cmd, "remove") == 0)
+	switch (path.GetHash(1))
+	{
+	case OscPath::Hash("remove"):
 	{
 		PreventUIRefresh(1);
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		TrackFX_Delete(track, fx);
 		// Make sure a device is selected
 		const int max = TrackFX_GetCount(track);
 		this->model.SetDeviceSelection(fx < max ? devicePosition : max - 1);
-		Undo_EndBlock2(project, "Delete device", UNDO_STATE_FX);
+		this->model.GetUndoBatch().EndBlock(project, "Delete device", UNDO_STATE_FX);
 		PreventUIRefresh(-1);
 		return;
 	}
 
-	if (std::strcmp(cmd, "duplicate") == 0)
+	case OscPath::Hash("duplicate"):
 	{
 		TrackFX_CopyToTrack(track, fx, track, fx + 1, false);
 		return;
 	}
 
-	if (std::strcmp(cmd, "movePrev") == 0)
+	case OscPath::Hash("movePrev"):
 	{
 		if (fx > 0)
 			TrackFX_CopyToTrack(track, fx, track, fx - 1, true);
 		return;
 	}
 
-	if (std::strcmp(cmd, "moveNext") == 0)
+	case OscPath::Hash("moveNext"):
 	{
 		TrackFX_CopyToTrack(track, fx, track, fx + 1, true);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
 /** {@inheritDoc} */
-void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
+void DeviceProcessor::Process(const OscPath& path, int value) noexcept
 {
 	if (path.empty())
 		return;
@@ -119,7 +129,11 @@ void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
 	if (track == nullptr)
 		return;
 
-	if (std::strcmp(part, "selected") == 0)
+	const int devicePosition = this->GetDeviceSelection();
+
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("selected"):
 	{
 		const int fxSel = value - 1;
 		if (fxSel >= 0 && fxSel < TrackFX_GetCount(track))
@@ -127,7 +141,7 @@ void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
 		return;
 	}
 
-	if (std::strcmp(part, "page") == 0)
+	case OscPath::Hash("page"):
 	{
 		part = SafeGet(path, 1);
 		if (std::strcmp(part, "selected") == 0)
@@ -135,22 +149,20 @@ void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
 		return;
 	}
 
-	const int devicePosition = this->GetDeviceSelection();
-
-	if (std::strcmp(part, "preset") == 0)
+	case OscPath::Hash("preset"):
 	{
 		TrackFX_SetPresetByIndex(track, devicePosition, value);
 		return;
 	}
 
-	if (std::strcmp(part, "bypass") == 0)
+	case OscPath::Hash("bypass"):
 	{
 		if (devicePosition >= 0)
 			TrackFX_SetEnabled(track, devicePosition, value > 0 ? 0 : 1);
 		return;
 	}
 
-	if (std::strcmp(part, "window") == 0)
+	case OscPath::Hash("window"):
 	{
 		if (devicePosition < 0)
 			return;
@@ -159,7 +171,7 @@ void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
 		return;
 	}
 
-	if (std::strcmp(part, "expand") == 0)
+	case OscPath::Hash("expand"):
 	{
 		if (devicePosition < 0)
 			return;
@@ -170,13 +182,17 @@ void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
 		return;
 	}
 
-	if (std::strcmp(part, "param") == 0)
+	case OscPath::Hash("param"):
 	{
 		Process(path, static_cast<double> (value));
 		return;
 	}
 
-	const int fx = atoi(part) - 1;
+	default:
+		break;
+	}
+
+	const int fx = path.GetInt(0) - 1;
 
 	const char* cmd = SafeGet(path, 1);
 	if (std::strcmp(cmd, "bypass") == 0)
@@ -189,7 +205,7 @@ void DeviceProcessor::Process(std::deque<std::string>& path, int value) noexcept
 
 
 /** {@inheritDoc} */
-void DeviceProcessor::Process(std::deque<std::string>& path, double value) noexcept
+void DeviceProcessor::Process(const OscPath& path, double value) noexcept
 {
 	if (path.empty())
 		return;
@@ -203,7 +219,7 @@ void DeviceProcessor::Process(std::deque<std::string>& path, double value) noexc
 	if (std::strcmp(part, "param") == 0 && std::strcmp(SafeGet(path, 2), "value") == 0)
 	{
 		const int devicePosition = this->GetDeviceSelection();
-		const int paramNo = atoi(SafeGet(path, 1));
+		const int paramNo = path.GetInt(1);
 		PreventUIRefresh(1);
 		TrackFX_SetParamNormalized(track, devicePosition, paramNo, value);
 		PreventUIRefresh(-1);
@@ -212,7 +228,7 @@ void DeviceProcessor::Process(std::deque<std::string>& path, double value) noexc
 
 
 /** {@inheritDoc} */
-void DeviceProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void DeviceProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	if (path.empty())
 		return;
@@ -232,7 +248,7 @@ void DeviceProcessor::Process(std::deque<std::string>& path, const std::string&
 			const int position = TrackFX_AddByName(track, deviceName, false, -1);
 			if (position < 0)
 				return;
-			const int insert = atoi(SafeGet(path, 1));
+			const int insert = path.GetInt(1);
 			TrackFX_CopyToTrack(track, position, track, insert, true);
 		}
 		catch (...)
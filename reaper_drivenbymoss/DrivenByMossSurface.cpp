@@ -4,6 +4,7 @@
 
 #include "ReaDebug.h"
 #include "DrivenByMossSurface.h"
+#include "RtWatchdog.h"
 
 // Singleton, deleted from Reaper
 DrivenByMossSurface* surfaceInstance = nullptr;
@@ -24,6 +25,8 @@ DrivenByMossSurface::DrivenByMossSurface(std::unique_ptr<JvmManager>& aJvmManage
  */
 DrivenByMossSurface::~DrivenByMossSurface()
 {
+	this->javaSender.Stop();
+
 	// Do not destroy the JVM if this is not a real shutdown (= when triggered from closing the configuration dialog)
 	if (this->isShutdown)
 	{
@@ -43,6 +46,9 @@ void DrivenByMossSurface::Shutdown()
 
 	try
 	{
+		// No more updates, the controllers are shut down
+		this->javaSender.Stop();
+
 		// Send final cleanup
 		if (jvmManager)
 			jvmManager->ShutdownControllers();
@@ -80,28 +86,49 @@ const char* DrivenByMossSurface::GetConfigString() noexcept
  */
 void DrivenByMossSurface::Run()
 {
-	if (this->jvmManager == nullptr || !this->jvmManager->IsRunning() || this->isShutdown)
+	if (this->jvmManager == nullptr || this->isShutdown)
 		return;
 
+	// While the JVM starts, the incoming MIDI messages are collected in the batch of the sender,
+	// which is handed to Java when it is running, instead of overflowing the queues of the audio
+	// hook. The commands from Java stay in the function executor.
+	if (!this->jvmManager->IsRunning())
+	{
+		if (this->jvmManager->IsStarting())
+			this->SendMIDIEventsToJava();
+		return;
+	}
+
 	// Infrastructure needs to startup here to ensure that the Reaper audio layer is up 
 	// and running otherwise there might be a deadlock on Macos
 	if (!this->isInfrastructureUp)
 	{
 		if (Audio_IsRunning() == 0)
+		{
+			this->SendMIDIEventsToJava();
 			return;
+		}
 		const std::lock_guard<std::mutex> lock(this->startInfrastructureMutex);
 		if (!this->isInfrastructureUp)
 		{
 			this->jvmManager->StartInfrastructure();
+			this->javaSender.Start();
 			this->isInfrastructureUp = true;
 		}
 	}
 
+	const StageTimer::Scope runScope(this->profiler.GetTimer(Profiler::Timer::RUN));
+	this->profiler.EnableMidiTracing(this->model.midiTracing);
+
 	try
 	{
+		this->ReplayCapture();
 		this->SendMIDIEventsToJava();
+		this->javaSender.Flush();
 		surfaceInstance->SendMIDIEventsToOutputs();
-		this->functionExecutor.ExecuteFunctions();
+		const StageTimer::Scope executeScope(this->profiler.GetTimer(Profiler::Timer::EXECUTE_FUNCTIONS));
+		this->functionExecutor.ExecuteFunctions(this->model.GetUndoBatch(), this->model.executionBudget);
+		this->model.GetCommandCapture().Flush();
 	}
 	catch (const std::exception& ex)
 	{
@@ -113,6 +140,10 @@ void DrivenByMossSurface::Run()
 	}
 
 	this->oscParser.GetActionProcessor().CheckActionSelection();
+	this->OutputStatistics();
+#ifdef DBM_RT_WATCHDOG
+	RtWatchdog::LogNewViolations();
+#endif
 
 	// Only update each 2nd call (about 60ms)
 	this->updateModel = !this->updateModel;
@@ -121,13 +152,137 @@ void DrivenByMossSurface::Run()
 
 	std::string data = this->CollectData(this->model.ShouldDump());
 	if (data.length() > 0)
-		this->jvmManager.get()->UpdateModel(data);
+	{
+		this->profiler.Count(Profiler::Counter::BYTES_TO_JAVA, data.length());
+		this->javaSender.QueueUpdate(std::move(data));
+		this->javaSender.Flush();
+	}
+}
+
+
+/**
+ * Get the statistics of all measured tasks as a JSON object.
+ *
+ * @param reset If true, the timers and maximum values are reset afterwards
+ * @return The JSON formatted statistics
+ */
+std::string DrivenByMossSurface::GetStatistics(bool reset)
+{
+	std::ostringstream ss;
+	ss << "{";
+	this->profiler.WriteJson(ss, reset);
+
+	const DataCollector::Statistics collect = this->dataCollector.GetStatistics(reset);
+	ss << ",\"collect\":{\"delta\":";
+	collect.delta.WriteJson(ss);
+	ss << ",\"dump\":";
+	collect.dump.WriteJson(ss);
+	ss << ",\"bytes\":" << collect.bytes << ",\"maxBytes\":" << collect.maxBytes << ",\"stages\":{";
+	for (std::size_t i = 0; i < DataCollector::STAGE_COUNT; i++)
+	{
+		ss << (i == 0 ? "\"" : ",\"") << DataCollector::GetStageName(i) << "\":";
+		collect.stages[i].WriteJson(ss);
+	}
+	ss << "}}";
+
+	const FunctionExecutor::Statistics executor = this->functionExecutor.GetStatistics(reset);
+	ss << ",\"executor\":{\"depth\":" << executor.depth << ",\"maxDepth\":" << executor.maxDepth << ",\"deferredDepth\":" << executor.deferredDepth
+		<< ",\"maxWaitMicros\":" << executor.maxWaitMicros << ",\"executed\":" << executor.executed << ",\"overflowed\":" << executor.overflowed
+		<< ",\"deferred\":" << executor.deferred << ",\"coalesced\":" << this->oscParser.GetCoalescedCommands() << "}";
+
+	ss << ",\"startup\":";
+	if (this->jvmManager)
+		this->jvmManager->WriteStartupJson(ss);
+	else
+		ss << "{}";
+	ss << ",\"sender\":{\"midiBacklog\":" << this->javaSender.GetMidiBacklog() << ",\"updateBacklog\":" << this->javaSender.GetUpdateBacklog() << "}";
+
+	UndoBatch& undoBatch = this->model.GetUndoBatch();
+	ss << ",\"undo\":{\"batches\":" << undoBatch.GetBatchCount() << ",\"changes\":" << undoBatch.GetChangeCount() << "}";
+
+#ifdef DBM_RT_WATCHDOG
+	ss << ",\"rtWatchdog\":";
+	RtWatchdog::WriteJson(ss, reset);
+#endif
+	ss << "}";
+	return ss.str();
+}
+
+
+/**
+ * Decode a batch of commands which were sent from Java and hand them to the parser.
+ *
+ * @param decoder The decoder which keeps the definitions of the processors and commands
+ * @param data The encoded commands
+ * @param length The number of bytes of the commands
+ */
+void DrivenByMossSurface::ProcessCommands(CommandDecoder& decoder, const std::uint8_t* data, std::size_t length)
+{
+	const StageTimer::Scope scope(this->profiler.GetTimer(Profiler::Timer::PROCESS_COMMANDS));
+	if (!decoder.Decode(data, length, this->oscParser))
+		ReaDebug() << "Could not decode all binary commands.";
+}
+
+
+/**
+ * Write the statistics to the Reaper console, if enabled.
+ */
+void DrivenByMossSurface::OutputStatistics()
+{
+	if (this->model.statisticsInterval <= 0)
+		return;
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now < this->nextStatisticsOutput)
+		return;
+	this->nextStatisticsOutput = now + std::chrono::seconds(this->model.statisticsInterval);
+	const std::string statistics = this->GetStatistics(true) + "\n";
+	ShowConsoleMsg(statistics.c_str());
+}
+
+
+/**
+ * Play back the due frames of a capture. Commands are executed like the ones received from Java,
+ * incoming MIDI is sent to Java like the messages from the audio thread. It is not added to the
+ * queues of the audio thread since they only support one producer. The recorded outgoing MIDI is
+ * only a reference of the original session and therefore not sent. The statistics are reset when
+ * the playback starts and logged when it has finished.
+ */
+void DrivenByMossSurface::ReplayCapture()
+{
+	CommandCapture& capture = this->model.GetCommandCapture();
+	if (!capture.IsReplaying())
+		return;
+	if (capture.GetReplayPosition() == 0)
+		this->GetStatistics(true);
+
+	const bool finished = capture.Replay([this](const CommandCapture::Frame& frame)
+		{
+			const std::uint8_t* data = frame.data.data();
+			const std::size_t size = frame.data.size();
+			switch (frame.type)
+			{
+			case CommandCapture::FrameType::COMMANDS:
+				this->replayDecoder.Decode(data, size, this->oscParser);
+				break;
+
+			case CommandCapture::FrameType::MIDI_INPUT:
+				if (size > 0)
+					this->SendMIDIEventToJava(frame.deviceId, data, static_cast<uint32_t>(size), 0, 0);
+				break;
+
+			default:
+				break;
+			}
+		});
+
+	if (finished)
+		ReaDebug() << "Capture played back: " << this->GetStatistics(true);
 }
 
 
 void DrivenByMossSurface::SetTrackListChange() noexcept
 {
-	// Not used
+	this->model.GetTrackIndexMap().Invalidate();
 }
 
 void DrivenByMossSurface::SetSurfaceVolume(MediaTrack* trackid, double volume) noexcept
@@ -180,12 +335,10 @@ bool DrivenByMossSurface::GetTouchState(MediaTrack* trackid, int isPan)
 	if (trackid == GetMasterTrack(ReaperUtils::GetProject()))
 		return isPan ? model.isMasterPanTouch : model.isMasterVolumeTouch;
 
-	const int position = static_cast<int>(GetMediaTrackInfo_Value(trackid, "IP_TRACKNUMBER")) - 1;
-	if (position < 0)
-		return false;
-
-	const std::unique_ptr<Track>& trackPtr = model.GetTrack(position);
-	return isPan ? trackPtr->isPanTouch : trackPtr->isVolumeTouch;
+	// Called very often and not only from the main thread, therefore only use the map of the last
+	// update which also contains the touch states
+	const std::shared_ptr<const VisibleTracks> visibleTracks = model.GetTrackIndexMap().GetCurrent();
+	return visibleTracks && visibleTracks->IsTouched(trackid, isPan != 0);
 }
 
 void DrivenByMossSurface::SetAutoMode(int mode) noexcept
@@ -219,18 +372,34 @@ void DrivenByMossSurface::SendMIDIEventsToJava()
 	while ((m3 = this->incomingMidiQueue3.pop()) != nullptr)
 	{
 		uint8_t raw[3] = { m3->status, m3->data1, m3->data2 };
-		jvmManager->OnMIDIEvent(m3->deviceId, raw, 3);
+		this->SendMIDIEventToJava(m3->deviceId, raw, 3, m3->traceId, m3->timestamp);
 	}
 
-	// --- SysEx ≤ 1 024 ------------------------------------------
+	// --- SysEx ≤ 1 024 ------------------------------------------
 	std::unique_ptr<MidiSyx1k> m1k;
 	while ((m1k = this->incomingMidiQueue1k.pop()) != nullptr)
-		jvmManager->OnMIDIEvent(m1k->deviceId, m1k->data, m1k->size);
+		this->SendMIDIEventToJava(m1k->deviceId, m1k->data, m1k->size, m1k->traceId, m1k->timestamp);
 
-	// --- SysEx ≤ 65 536 -----------------------------------------
+	// --- SysEx ≤ 65 536 -----------------------------------------
 	std::unique_ptr <MidiSyx64k> m64k;
 	while ((m64k = this->incomingMidiQueue64k.pop()) != nullptr)
-		jvmManager->OnMIDIEvent(m64k->deviceId, m64k->data, m64k->size);
+		this->SendMIDIEventToJava(m64k->deviceId, m64k->data, m64k->size, m64k->traceId, m64k->timestamp);
+}
+
+
+/**
+ * Queue one MIDI message for Java.
+ *
+ * @param deviceId The ID of the device which received the message
+ * @param data The bytes of the message
+ * @param size The number of bytes
+ * @param traceId The trace ID of the message
+ * @param timestamp The time when the message was queued, 0 if it is not traced
+ */
+void DrivenByMossSurface::SendMIDIEventToJava(uint32_t deviceId, const uint8_t* data, uint32_t size, uint32_t traceId, int64_t timestamp)
+{
+	this->model.GetCommandCapture().RecordMidi(CommandCapture::FrameType::MIDI_INPUT, deviceId, data, size);
+	this->javaSender.QueueMidi(deviceId, data, size, traceId, timestamp);
 }
 
 
@@ -242,25 +411,47 @@ void DrivenByMossSurface::SendMIDIEventsToOutputs()
 	// ---------- 3‑byte ----------
 	std::unique_ptr<Midi3> m3;
 	while ((m3 = this->outgoingMidiQueue3.pop()) != nullptr)
-		HandleShortMidi(m3->deviceId, m3->status, m3->data1, m3->data2);
+	{
+		if (HandleShortMidi(m3->deviceId, m3->status, m3->data1, m3->data2))
+			this->TraceOutput(m3->traceId, m3->timestamp);
+	}
 
 	// ---------- ≤ 1 024 ----------
 	std::unique_ptr<MidiSyx1k> m1k;
 	while ((m1k = this->outgoingMidiQueue1k.pop()) != nullptr)
-		HandleSysex(m1k->deviceId, m1k->data, m1k->size);
+	{
+		if (HandleSysex(m1k->deviceId, m1k->data, m1k->size))
+			this->TraceOutput(m1k->traceId, m1k->timestamp);
+	}
 
 	// ---------- ≤ 65 536 ----------
 	std::unique_ptr<MidiSyx64k> m64;
 	while ((m64 = this->outgoingMidiQueue64k.pop()) != nullptr)
-		HandleSysex(m64->deviceId, m64->data, m64->size);
+	{
+		if (HandleSysex(m64->deviceId, m64->data, m64->size))
+			this->TraceOutput(m64->traceId, m64->timestamp);
+	}
 }
 
 
-void DrivenByMossSurface::HandleShortMidi(uint32_t deviceId, uint8_t status, uint8_t data1, uint8_t data2)
+/**
+ * Measure the latency of a MIDI message which was sent to an output port.
+ *
+ * @param traceId The trace ID of the incoming message to which this is the response
+ * @param timestamp The time when the message was queued, 0 if it is not traced
+ */
+void DrivenByMossSurface::TraceOutput(uint32_t traceId, int64_t timestamp) noexcept
+{
+	if (timestamp != 0)
+		this->profiler.TraceOutput(traceId, timestamp, Profiler::GetTimestamp());
+}
+
+
+bool DrivenByMossSurface::HandleShortMidi(uint32_t deviceId, uint8_t status, uint8_t data1, uint8_t data2)
 {
 	midi_Output* midiout = GetMidiOutput(deviceId);
 	if (midiout == nullptr)
-		return;
+		return false;
 
 	MIDI_event_t event{};
 	event.frame_offset = 0;
@@ -269,14 +460,18 @@ void DrivenByMossSurface::HandleShortMidi(uint32_t deviceId, uint8_t status, uin
 	event.midi_message[1] = data1;
 	event.midi_message[2] = data2;
 	midiout->SendMsg(&event, -1);
+	this->profiler.Count(Profiler::Counter::MIDI_TO_OUTPUTS);
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	this->model.GetCommandCapture().RecordMidi(CommandCapture::FrameType::MIDI_OUTPUT, deviceId, event.midi_message, 3);
+	return true;
 }
 
 
-void DrivenByMossSurface::HandleSysex(uint32_t deviceId, const uint8_t* data, uint32_t size)
+bool DrivenByMossSurface::HandleSysex(uint32_t deviceId, const uint8_t* data, uint32_t size)
 {
 	midi_Output* midiout = GetMidiOutput(deviceId);
 	if (midiout == nullptr)
-		return;
+		return false;
 
 	// Dynamically allocate memory for the MIDI_event_t and the data
 	// Subtract 4 because MIDI_event_t already includes the first 4 bytes
@@ -300,4 +495,7 @@ void DrivenByMossSurface::HandleSysex(uint32_t deviceId, const uint8_t* data, ui
 	std::memcpy(evt->midi_message, data, size);
 
 	midiout->SendMsg(evt, -1);
+	this->profiler.Count(Profiler::Counter::MIDI_TO_OUTPUTS);
+	this->model.GetCommandCapture().RecordMidi(CommandCapture::FrameType::MIDI_OUTPUT, deviceId, data, size);
+	return true;
 }
\ No newline at end of file
@@ -7,12 +7,15 @@
 #include <mutex>
 #include <gsl/span>
 
+#include "CommandDecoder.h"
 #include "FunctionExecutor.h"
 #include "OscParser.h"
+#include "JavaSender.h"
 #include "JvmManager.h"
 #include "DataCollector.h"
 #include "ReaderWriterQueue.h"
 #include "MidiMessages.h"
+#include "Profiler.h"
 
 
 /**
@@ -68,6 +71,14 @@ public:
 		return this->dataCollector;
 	}
 
+	Profiler& GetProfiler() noexcept
+	{
+		return this->profiler;
+	}
+
+	std::string GetStatistics(bool reset);
+	void ProcessCommands(CommandDecoder& decoder, const std::uint8_t* data, std::size_t length);
+
 	const char* GetTypeString() noexcept override;
 	const char* GetDescString() noexcept override;
 	const char* GetConfigString() noexcept override;
@@ -97,7 +108,9 @@ public:
 		m->status = status;
 		m->data1 = d1;
 		m->data2 = d2;
-		this->incomingMidiQueue3.push(std::move(m));
+		this->profiler.TraceIncoming(*m);
+		if (!this->incomingMidiQueue3.push(std::move(m)))
+			this->profiler.Count(Profiler::Counter::MIDI_DROPPED);
 	}
 
 	inline void EnqueueSysex1k(uint32_t dev, const uint8_t* buf, uint32_t len)
@@ -112,7 +125,9 @@ public:
 		const gsl::span<uint8_t> destinationSpan(m->data);
 		const gsl::span<const uint8_t> sourceSpan(buf, len);
 		std::copy(sourceSpan.begin(), sourceSpan.end(), destinationSpan.begin());
-		incomingMidiQueue1k.push(std::move(m));
+		this->profiler.TraceIncoming(*m);
+		if (!this->incomingMidiQueue1k.push(std::move(m)))
+			this->profiler.Count(Profiler::Counter::MIDI_DROPPED);
 	}
 
 	inline void EnqueueSysex64k(uint32_t dev, const uint8_t* buf, uint32_t len)
@@ -127,7 +142,9 @@ public:
 		const gsl::span<uint8_t> destinationSpan(m->data);
 		const gsl::span<const uint8_t> sourceSpan(buf, len);
 		std::copy(sourceSpan.begin(), sourceSpan.end(), destinationSpan.begin());
-		incomingMidiQueue64k.push(std::move(m));
+		this->profiler.TraceIncoming(*m);
+		if (!this->incomingMidiQueue64k.push(std::move(m)))
+			this->profiler.Count(Profiler::Counter::MIDI_DROPPED);
 	}
 
 	void SendMIDIEventsToOutputs();
@@ -139,6 +156,10 @@ private:
 	OscParser oscParser{ model };
 	DataCollector dataCollector{ model };
 	bool updateModel{ false };
+	Profiler profiler;
+	JavaSender javaSender{ jvmManager, profiler };
+	CommandDecoder replayDecoder;
+	std::chrono::steady_clock::time_point nextStatisticsOutput{};
 	std::mutex startInfrastructureMutex;
 
 	std::string CollectData(bool dump)
@@ -147,9 +168,13 @@ private:
 	};
 
 	void SendMIDIEventsToJava();
+	void SendMIDIEventToJava(uint32_t deviceId, const uint8_t* data, uint32_t size, uint32_t traceId, int64_t timestamp);
+	void OutputStatistics();
+	void ReplayCapture();
 
-	void HandleShortMidi(uint32_t deviceId, uint8_t status, uint8_t data1, uint8_t data2);
-	void HandleSysex(uint32_t deviceId, const uint8_t* data, uint32_t size);
+	bool HandleShortMidi(uint32_t deviceId, uint8_t status, uint8_t data1, uint8_t data2);
+	bool HandleSysex(uint32_t deviceId, const uint8_t* data, uint32_t size);
+	void TraceOutput(uint32_t traceId, int64_t timestamp) noexcept;
 };
 
 
@@ -27,7 +27,7 @@ int EqDeviceProcessor::GetDeviceSelection() noexcept
 
 
 /** {@inheritDoc} */
-void EqDeviceProcessor::Process(std::deque<std::string>& path) noexcept
+void EqDeviceProcessor::Process(const OscPath& path) noexcept
 {
 	if (path.empty())
 		return;
@@ -46,7 +46,7 @@ void EqDeviceProcessor::Process(std::deque<std::string>& path) noexcept
 
 
 /** {@inheritDoc} */
-void EqDeviceProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void EqDeviceProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	if (path.empty())
 		return;
@@ -62,7 +62,7 @@ void EqDeviceProcessor::Process(std::deque<std::string>& path, const std::string
 		if (eqIndex < 0)
 			return;
 
-		const int bandNo = atoi(SafeGet(path, 1));
+		const int bandNo = path.GetInt(1);
 
 		try
 		{
@@ -14,8 +14,8 @@ class EqDeviceProcessor : public DeviceProcessor
 public:
 	EqDeviceProcessor(Model& aModel);
 
-	void Process(std::deque<std::string>& path) noexcept override;
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override;
+	void Process(const OscPath& path) noexcept override;
+	void Process(const OscPath& path, const std::string& value) noexcept override;
 
 protected:
 	int GetDeviceSelection() noexcept override;
@@ -1,28 +1,353 @@
 // Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
 // Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
 
+#include <cstdint>
+#include <iterator>
+
 #include "FunctionExecutor.h"
+#include "ReaDebug.h"
+
+
+namespace
+{
+	// The upper limits of the buckets of the histograms, the last bucket contains all larger values
+	const std::array<long long, FunctionExecutor::EXECUTION_TIME_BUCKETS - 1> EXECUTION_TIME_LIMITS{ { 1000, 2000, 5000, 10000, 20000, 50000, 100000 } };
+	const std::array<std::size_t, FunctionExecutor::DEFERRED_BUCKETS - 1> DEFERRED_LIMITS{ { 0, 1, 4, 16, 64 } };
+}
+
+
+/**
+ * Constructor.
+ */
+FunctionExecutor::FunctionExecutor() noexcept : cells(CAPACITY)
+{
+	for (std::size_t i = 0; i < CAPACITY; i++)
+		this->cells[i].sequence.store(i, std::memory_order_relaxed);
+	// Never grows, therefore deferring does not allocate on the main thread
+	this->deferredTasks.reserve(DEFERRED_CAPACITY);
+}
+
+
+/**
+ * Add a function for execution. Does not block unless the queue is full.
+ *
+ * @param queuedTask The task to add for execution
+ */
+void FunctionExecutor::Enqueue(QueuedTask&& queuedTask)
+{
+	queuedTask.enqueued = std::chrono::steady_clock::now();
+
+	// Keep the order as long as there are functions in the overflow list
+	if (!this->hasOverflow.load(std::memory_order_acquire) && this->TryEnqueue(queuedTask))
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->overflowMutex);
+	this->overflow.push_back(std::move(queuedTask));
+	this->hasOverflow.store(true, std::memory_order_release);
+	this->overflowed.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * Try to store the task in a free cell of the queue.
+ *
+ * @param queuedTask The task to store, moved into the cell on success
+ * @return False if the queue is full
+ */
+bool FunctionExecutor::TryEnqueue(QueuedTask& queuedTask) noexcept
+{
+	std::size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true)
+	{
+		cell = &this->cells[position & (CAPACITY - 1)];
+		const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		const std::intptr_t difference = static_cast<std::intptr_t> (sequence) - static_cast<std::intptr_t> (position);
+		if (difference == 0)
+		{
+			if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			return false;
+		else
+			position = this->enqueuePosition.load(std::memory_order_relaxed);
+	}
+
+	cell->queuedTask = std::move(queuedTask);
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+
+/**
+ * Execute all functions which were added until now. Functions which are added while executing,
+ * are executed on the next call. This is also true for the overflow list, which is only executed
+ * when all functions of the queue which were added before it have been executed. No lock is held
+ * while a function is executed.
+ * Consecutive batched functions are executed inside of one undo batch. The batch is closed
+ * before a function which is not batched is executed to keep the order of the changes.
+ * Functions which are neither deferrable nor have a dependency (transport) are executed first,
+ * right when they are taken from the queue. All other functions are appended to the functions
+ * which were deferred by the previous calls and executed afterwards in their order. When the
+ * time budget is used up, the next deferrable function is deferred to the next call and all
+ * functions after it with the same dependency (deferrable or not) as well, since they might
+ * depend on it (e.g. selecting a track which is added by the deferred function). At least one
+ * deferrable function is executed on each call and functions which are not deferrable are never
+ * stopped by the budget. If DEFERRED_CAPACITY functions are waiting, the remaining ones stay in
+ * the queue.
+ *
+ * @param undoBatch The undo batch to use
+ * @param budgetMillis The time in milliseconds which can be used for executing deferrable
+ *        functions, 0 or less for no limit
+ */
+void FunctionExecutor::ExecuteFunctions(UndoBatch& undoBatch, int budgetMillis)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	// Read the overflow flag before the end of the queue: the functions in the overflow list are
+	// newer than all functions up to the end
+	const bool hasOverflowTasks = this->hasOverflow.load(std::memory_order_acquire);
+	const std::size_t end = this->enqueuePosition.load(std::memory_order_acquire);
+	std::size_t position = this->dequeuePosition.load(std::memory_order_relaxed);
+
+	const std::size_t depth = end - position;
+	if (depth > this->maxDepth.load(std::memory_order_relaxed))
+		this->maxDepth.store(depth, std::memory_order_relaxed);
+	if (depth == 0 && this->deferredTasks.empty() && !hasOverflowTasks)
+		return;
+
+	while (position != end && this->deferredTasks.size() < DEFERRED_CAPACITY)
+	{
+		Cell& cell = this->cells[position & (CAPACITY - 1)];
+		// Stop if the producer has not yet finished to store the task
+		if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+			break;
+
+		QueuedTask queuedTask = std::move(cell.queuedTask);
+		cell.sequence.store(position + CAPACITY, std::memory_order_release);
+		position++;
+		this->dequeuePosition.store(position, std::memory_order_relaxed);
+
+		this->Dispatch(queuedTask, now, undoBatch);
+	}
+
+	// The overflow list needs to wait for the next call if a producer has not finished to store its
+	// function or has added one to the queue in the meantime (it checked the overflow flag before
+	// it was set), since these functions are older
+	if (hasOverflowTasks && position == end && end == this->enqueuePosition.load(std::memory_order_acquire))
+	{
+		std::vector<QueuedTask> overflowTasks;
+		{
+			// Take only as many functions as can be deferred, the others wait for the next call
+			const std::lock_guard<std::mutex> lock(this->overflowMutex);
+			const std::size_t space = DEFERRED_CAPACITY - this->deferredTasks.size();
+			if (this->overflow.size() <= space)
+			{
+				overflowTasks.swap(this->overflow);
+				this->hasOverflow.store(false, std::memory_order_release);
+			}
+			else
+			{
+				const std::vector<QueuedTask>::iterator last = this->overflow.begin() + space;
+				overflowTasks.assign(std::make_move_iterator(this->overflow.begin()), std::make_move_iterator(last));
+				this->overflow.erase(this->overflow.begin(), last);
+			}
+		}
+		for (QueuedTask& overflowTask : overflowTasks)
+			this->Dispatch(overflowTask, now, undoBatch);
+	}
+
+	// Transport has been executed, now execute the functions which were deferred on previous calls
+	// followed by the ones of this call in their order
+	this->deadline = budgetMillis > 0 ? now + std::chrono::milliseconds(budgetMillis) : std::chrono::steady_clock::time_point::max();
+	this->hasExecutedDeferrable = false;
+	this->blockedCount = 0;
+	this->isAllBlocked = false;
+	this->ExecuteDeferred(now, undoBatch);
+
+	undoBatch.Close();
+
+	const std::size_t deferredCount = this->deferredTasks.size();
+	this->deferredDepth.store(deferredCount, std::memory_order_relaxed);
+	if (deferredCount > 0)
+		this->deferred.fetch_add(deferredCount, std::memory_order_relaxed);
+	this->UpdateHistograms(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count(), deferredCount);
+}
+
+
+/**
+ * Get the statistics of the queue.
+ *
+ * @param reset If true, the maximum values and histograms are reset
+ * @return The statistics
+ */
+FunctionExecutor::Statistics FunctionExecutor::GetStatistics(bool reset)
+{
+	Statistics statistics;
+	statistics.depth = this->enqueuePosition.load(std::memory_order_relaxed) - this->dequeuePosition.load(std::memory_order_relaxed);
+	statistics.maxDepth = reset ? this->maxDepth.exchange(0) : this->maxDepth.load();
+	statistics.deferredDepth = this->deferredDepth.load();
+	statistics.maxWaitMicros = reset ? this->maxWaitMicros.exchange(0) : this->maxWaitMicros.load();
+	statistics.executed = this->executed.load();
+	statistics.overflowed = this->overflowed.load();
+	statistics.deferred = this->deferred.load();
+	for (std::size_t i = 0; i < EXECUTION_TIME_BUCKETS; i++)
+		statistics.executionTimes[i] = reset ? this->executionTimes[i].exchange(0) : this->executionTimes[i].load();
+	for (std::size_t i = 0; i < DEFERRED_BUCKETS; i++)
+		statistics.deferredCounts[i] = reset ? this->deferredCounts[i].exchange(0) : this->deferredCounts[i].load();
+	return statistics;
+}
+
+
+/**
+ * Execute a task which was taken from the queue right away, if it can neither be deferred nor
+ * depends on other tasks. Otherwise, put it at the end of the deferred tasks, which are executed
+ * after all tasks were taken from the queue.
+ *
+ * @param queuedTask The task
+ * @param now The time when the execution of the current batch started
+ * @param undoBatch The undo batch to use
+ */
+void FunctionExecutor::Dispatch(QueuedTask& queuedTask, const std::chrono::steady_clock::time_point& now, UndoBatch& undoBatch)
+{
+	if (queuedTask.dependency == nullptr && !queuedTask.isDeferrable)
+		this->Execute(queuedTask, now, undoBatch);
+	else
+		this->deferredTasks.push_back(std::move(queuedTask));
+}
+
+
+/**
+ * Execute the deferred tasks in the order they were added. These are the tasks which were
+ * deferred on previous calls followed by the ones which were added by the current call. Tasks
+ * which need to be deferred again since the budget is used up stay in the list and block the
+ * later tasks with the same dependency.
+ *
+ * @param now The time when the execution of the current batch started
+ * @param undoBatch The undo batch to use
+ */
+void FunctionExecutor::ExecuteDeferred(const std::chrono::steady_clock::time_point& now, UndoBatch& undoBatch)
+{
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < this->deferredTasks.size(); i++)
+	{
+		QueuedTask& queuedTask = this->deferredTasks[i];
+		if (this->IsBlocked(queuedTask.dependency) || this->IsBudgetUsedUp(queuedTask))
+		{
+			this->Block(queuedTask.dependency);
+			if (kept != i)
+				this->deferredTasks[kept] = std::move(queuedTask);
+			kept++;
+		}
+		else
+			this->Execute(queuedTask, now, undoBatch);
+	}
+	// Does not release the reserved memory
+	this->deferredTasks.erase(this->deferredTasks.begin() + kept, this->deferredTasks.end());
+}
+
+
+/**
+ * Check if a task needs to wait for a deferred task with the same dependency.
+ *
+ * @param dependency The dependency of the task
+ * @return True if a task with the same dependency is deferred
+ */
+bool FunctionExecutor::IsBlocked(const void* dependency) const noexcept
+{
+	if (dependency == nullptr)
+		return false;
+	if (this->isAllBlocked)
+		return true;
+	for (std::size_t i = 0; i < this->blockedCount; i++)
+	{
+		if (this->blockedDependencies[i] == dependency)
+			return true;
+	}
+	return false;
+}
+
+
+/**
+ * Block all later tasks with the given dependency for the rest of the current call. If there are
+ * too many different dependencies, all tasks with a dependency are blocked.
+ *
+ * @param dependency The dependency of a deferred task
+ */
+void FunctionExecutor::Block(const void* dependency) noexcept
+{
+	if (dependency == nullptr || this->IsBlocked(dependency))
+		return;
+	if (this->blockedCount < BLOCKED_CAPACITY)
+		this->blockedDependencies[this->blockedCount++] = dependency;
+	else
+		this->isAllBlocked = true;
+}
 
 
 /**
- * Add a function for execution.
+ * Check if a task needs to be deferred to the next call since the time budget is used up. Only
+ * deferrable tasks are affected and at least one of them is executed on each call.
  *
- * @param f The function too add for execution
+ * @param queuedTask The task
+ * @return True if the task needs to be deferred
  */
-void FunctionExecutor::AddFunction(std::function<void(void)> f)
+bool FunctionExecutor::IsBudgetUsedUp(const QueuedTask& queuedTask) const
 {
-	const std::lock_guard<std::mutex> lock(this->execMutex);
-	this->tasks.push_back(f);
+	return queuedTask.isDeferrable && this->hasExecutedDeferrable && std::chrono::steady_clock::now() >= this->deadline;
 }
 
 
 /**
- * Execute all registered functions.
+ * Execute one task and update the wait statistics.
+ *
+ * @param queuedTask The task to execute
+ * @param now The time when the execution of the current batch started
+ * @param undoBatch The undo batch to use
  */
-void FunctionExecutor::ExecuteFunctions()
+void FunctionExecutor::Execute(QueuedTask& queuedTask, const std::chrono::steady_clock::time_point& now, UndoBatch& undoBatch)
 {
-	const std::lock_guard<std::mutex> lock(this->execMutex);
-	for (auto &task : this->tasks)
-		task();
-	this->tasks.clear();
+	const long long wait = std::chrono::duration_cast<std::chrono::microseconds>(now - queuedTask.enqueued).count();
+	if (wait > this->maxWaitMicros.load(std::memory_order_relaxed))
+		this->maxWaitMicros.store(wait, std::memory_order_relaxed);
+	this->executed.fetch_add(1, std::memory_order_relaxed);
+	if (queuedTask.isDeferrable)
+		this->hasExecutedDeferrable = true;
+
+	try
+	{
+		if (queuedTask.isBatched)
+			undoBatch.Open();
+		else
+			undoBatch.Close();
+		queuedTask.task();
+	}
+	catch (const std::exception& ex)
+	{
+		ReaDebug() << "Could not execute function: " << ex.what();
+	}
+	catch (...)
+	{
+		ReaDebug() << "Could not execute function.";
+	}
+}
+
+
+/**
+ * Add the values of a call to the histograms.
+ *
+ * @param executionMicros The time the call took in microseconds
+ * @param deferredCount The number of functions which were deferred to the next call
+ */
+void FunctionExecutor::UpdateHistograms(long long executionMicros, std::size_t deferredCount) noexcept
+{
+	std::size_t bucket = 0;
+	while (bucket < EXECUTION_TIME_BUCKETS - 1 && executionMicros > EXECUTION_TIME_LIMITS[bucket])
+		bucket++;
+	this->executionTimes[bucket].fetch_add(1, std::memory_order_relaxed);
+
+	bucket = 0;
+	while (bucket < DEFERRED_BUCKETS - 1 && deferredCount > DEFERRED_LIMITS[bucket])
+		bucket++;
+	this->deferredCounts[bucket].fetch_add(1, std::memory_order_relaxed);
 }
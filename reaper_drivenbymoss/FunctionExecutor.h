@@ -4,23 +4,149 @@
 #ifndef _DBM_FUNCTIONEXECUTOR_H_
 #define _DBM_FUNCTIONEXECUTOR_H_
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <mutex>
 #include <vector>
-#include <functional>
+
+#include "InlineTask.h"
+#include "UndoBatch.h"
 
 
 /**
- * Executes all registered functions in a thread safe way.
+ * Executes all registered functions in a thread safe way. Functions can be added from any thread
+ * without locking (multiple producers) and are executed on the main thread (single consumer). If
+ * the queue is full, functions are stored in an overflow list which is protected by a mutex.
+ * Functions which change the project can be executed as a batch which creates only one undo point
+ * and refreshes the UI once. Deferrable functions are only executed as long as the time budget of
+ * the call is not used up, the rest is executed on the next call. Functions with the same
+ * dependency (e.g. all commands which change the project) are executed in the order in which they
+ * were added, therefore a function which is not deferrable waits if a deferred function with the
+ * same dependency was added before it. Functions without a dependency (e.g. transport commands)
+ * are never deferred and are executed before all deferred functions.
  */
 class FunctionExecutor
 {
 public:
-	void AddFunction(std::function<void(void)> f);
-	void ExecuteFunctions();
+	/** The number of buckets of the execution time histogram. */
+	static const std::size_t EXECUTION_TIME_BUCKETS{ 8 };
+	/** The number of buckets of the deferred functions histogram. */
+	static const std::size_t DEFERRED_BUCKETS{ 6 };
+
+	/** Statistics about the queue. */
+	struct Statistics
+	{
+		std::size_t depth{ 0 };
+		std::size_t maxDepth{ 0 };
+		std::size_t deferredDepth{ 0 };
+		long long maxWaitMicros{ 0 };
+		unsigned long long executed{ 0 };
+		unsigned long long overflowed{ 0 };
+		unsigned long long deferred{ 0 };
+		// Number of calls which took up to 1, 2, 5, 10, 20, 50, 100 and more milliseconds
+		std::array<unsigned long long, EXECUTION_TIME_BUCKETS> executionTimes{};
+		// Number of calls which left 0, 1, up to 4, 16, 64 and more functions for the next call
+		std::array<unsigned long long, DEFERRED_BUCKETS> deferredCounts{};
+	};
+
+
+	FunctionExecutor() noexcept;
+	FunctionExecutor(const FunctionExecutor&) = delete;
+	FunctionExecutor& operator=(const FunctionExecutor&) = delete;
+	FunctionExecutor(FunctionExecutor&&) = delete;
+	FunctionExecutor& operator=(FunctionExecutor&&) = delete;
+	~FunctionExecutor() {};
+
+
+	/**
+	 * Add a function for execution.
+	 *
+	 * @param f The function to add for execution
+	 * @param isBatched True to execute the function as part of an undo batch, false to execute
+	 *        it outside of it, e.g. for latency critical transport commands
+	 * @param isDeferrable True if the execution can be moved to the next call if the time budget
+	 *        is used up, false to execute the function on this call unless it depends on a
+	 *        deferred function
+	 * @param dependency Functions with the same dependency keep their order if one of them is
+	 *        deferred, null if the function does not depend on other functions
+	 */
+	template<typename F>
+	void AddFunction(F&& f, bool isBatched = false, bool isDeferrable = false, const void* dependency = nullptr)
+	{
+		QueuedTask queuedTask;
+		queuedTask.task.Set(std::forward<F>(f));
+		queuedTask.isBatched = isBatched;
+		queuedTask.isDeferrable = isDeferrable;
+		queuedTask.dependency = dependency;
+		this->Enqueue(std::move(queuedTask));
+	}
+
+	void ExecuteFunctions(UndoBatch& undoBatch, int budgetMillis);
+
+	Statistics GetStatistics(bool reset);
 
 private:
-	std::mutex execMutex;
-	std::vector<std::function<void(void)>> tasks;
+	/** Must be a power of 2. */
+	static const std::size_t CAPACITY{ 1024 };
+	/** The maximum number of deferred functions, further functions wait in the queue. */
+	static const std::size_t DEFERRED_CAPACITY{ 1024 };
+	/** The maximum number of different dependencies which can be blocked at once. */
+	static const std::size_t BLOCKED_CAPACITY{ 32 };
+
+	struct QueuedTask
+	{
+		InlineTask task;
+		std::chrono::steady_clock::time_point enqueued{};
+		const void* dependency{ nullptr };
+		bool isBatched{ false };
+		bool isDeferrable{ false };
+	};
+
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence{ 0 };
+		QueuedTask queuedTask;
+	};
+
+	std::vector<Cell> cells;
+	std::atomic<std::size_t> enqueuePosition{ 0 };
+	std::atomic<std::size_t> dequeuePosition{ 0 };
+
+	std::atomic<bool> hasOverflow{ false };
+	std::mutex overflowMutex;
+	std::vector<QueuedTask> overflow;
+
+	// Only accessed by the consumer, the capacity is reserved in the constructor. Contains the
+	// tasks which were deferred and the ones of the current call which are executed after them
+	std::vector<QueuedTask> deferredTasks;
+	std::chrono::steady_clock::time_point deadline{};
+	bool hasExecutedDeferrable{ false };
+	// The dependencies of the functions which are deferred on the current call
+	std::array<const void*, BLOCKED_CAPACITY> blockedDependencies{};
+	std::size_t blockedCount{ 0 };
+	bool isAllBlocked{ false };
+
+	// Statistics, only written by the consumer apart from the overflow counter
+	std::atomic<std::size_t> maxDepth{ 0 };
+	std::atomic<std::size_t> deferredDepth{ 0 };
+	std::atomic<long long> maxWaitMicros{ 0 };
+	std::atomic<unsigned long long> executed{ 0 };
+	std::atomic<unsigned long long> overflowed{ 0 };
+	std::atomic<unsigned long long> deferred{ 0 };
+	std::array<std::atomic<unsigned long long>, EXECUTION_TIME_BUCKETS> executionTimes{};
+	std::array<std::atomic<unsigned long long>, DEFERRED_BUCKETS> deferredCounts{};
+
+	void Enqueue(QueuedTask&& queuedTask);
+	bool TryEnqueue(QueuedTask& queuedTask) noexcept;
+	void Dispatch(QueuedTask& queuedTask, const std::chrono::steady_clock::time_point& now, UndoBatch& undoBatch);
+	bool IsBudgetUsedUp(const QueuedTask& queuedTask) const;
+	void ExecuteDeferred(const std::chrono::steady_clock::time_point& now, UndoBatch& undoBatch);
+	bool IsBlocked(const void* dependency) const noexcept;
+	void Block(const void* dependency) noexcept;
+	void Execute(QueuedTask& queuedTask, const std::chrono::steady_clock::time_point& now, UndoBatch& undoBatch);
+	void UpdateHistograms(long long executionMicros, std::size_t deferredCount) noexcept;
 };
 
 #endif /* _DBM_FUNCTIONEXECUTOR_H_ */
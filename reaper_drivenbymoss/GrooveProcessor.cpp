@@ -20,26 +20,30 @@ GrooveProcessor::GrooveProcessor(Model &aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void GrooveProcessor::Process(std::deque<std::string>& path, double value) noexcept
+void GrooveProcessor::Process(const OscPath& path, double value) noexcept
 {
 	if (path.empty())
 		return;
 
 	ReaProject* project = ReaperUtils::GetProject();
 
-	const char* cmd = SafeGet(path, 0);
-
-	if (std::strcmp(cmd, "active") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("active"):
 	{
 		int swingmodeInOutOptional = value > 0 ? 1 : 0;
 		GetSetProjectGrid(project, true, nullptr, &swingmodeInOutOptional, nullptr);
 		return;
 	}
 
-	if (std::strcmp(cmd, "amount") == 0)
+	case OscPath::Hash("amount"):
 	{
 		double swingamtInOutOptional = value;
 		GetSetProjectGrid(project, true, nullptr, nullptr, &swingamtInOutOptional);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
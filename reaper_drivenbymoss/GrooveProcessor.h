@@ -15,11 +15,11 @@ class GrooveProcessor : public OscProcessor
 public:
 	GrooveProcessor(Model &aModel);
 
-	void Process(std::deque<std::string>& path, double value) noexcept override;
+	void Process(const OscPath& path, double value) noexcept override;
 
-	void Process(std::deque<std::string>& path) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path) noexcept  override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
 };
 
 #endif /* _DBM_GROOVEPROCESSOR_H_ */
@@ -19,7 +19,7 @@ IniFileProcessor::IniFileProcessor(Model& aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void IniFileProcessor::Process(std::deque<std::string>& path, int value) noexcept
+void IniFileProcessor::Process(const OscPath& path, int value) noexcept
 {
 	if (path.size() != 2)
 		return;
@@ -0,0 +1,190 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_INLINETASK_H_
+#define _DBM_INLINETASK_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "CodeAnalysis.h"
+
+
+/**
+ * A callable without parameters and return value which stores the function object inside of the
+ * task if it fits into the inline storage. Only larger function objects are put on the heap.
+ */
+class InlineTask
+{
+public:
+	/** Large enough for the queued commands of the OSC parser (see OscParser::QueuedCommand). */
+	static const std::size_t CAPACITY{ 128 };
+
+
+	InlineTask() noexcept = default;
+
+	InlineTask(const InlineTask&) = delete;
+	InlineTask& operator=(const InlineTask&) = delete;
+
+	InlineTask(InlineTask&& other) noexcept
+	{
+		this->MoveFrom(other);
+	}
+
+	InlineTask& operator=(InlineTask&& other) noexcept
+	{
+		if (this != &other)
+		{
+			this->Reset();
+			this->MoveFrom(other);
+		}
+		return *this;
+	}
+
+	~InlineTask()
+	{
+		this->Reset();
+	}
+
+
+	/**
+	 * Store a function object, replaces the current one.
+	 *
+	 * @param function The function object to store
+	 */
+	template<typename F>
+	void Set(F&& function)
+	{
+		using Function = typename std::decay<F>::type;
+		this->Reset();
+		Store<Function>(std::forward<F>(function), std::integral_constant<bool, IsInline<Function>()>());
+	}
+
+
+	/**
+	 * Execute the stored function, if any.
+	 */
+	void operator()()
+	{
+		if (this->operations != nullptr)
+			this->operations->invoke(this->Storage());
+	}
+
+
+	/**
+	 * Check if a function object is stored.
+	 *
+	 * @return True if a function object is stored
+	 */
+	bool IsSet() const noexcept
+	{
+		return this->operations != nullptr;
+	}
+
+
+	/**
+	 * Destroy the stored function object.
+	 */
+	void Reset() noexcept
+	{
+		if (this->operations == nullptr)
+			return;
+		this->operations->destroy(this->Storage());
+		this->operations = nullptr;
+	}
+
+
+private:
+	struct Operations
+	{
+		void (*invoke)(void* storage);
+		void (*destroy)(void* storage);
+		void (*move)(void* destination, void* source);
+	};
+
+	/** Wraps a function object which is too large for the inline storage. */
+	template<typename F>
+	struct HeapFunction
+	{
+		std::unique_ptr<F> function;
+
+		void operator()()
+		{
+			(*this->function)();
+		}
+	};
+
+	template<typename F>
+	struct OperationsFor
+	{
+		static void Invoke(void* storage)
+		{
+			(*static_cast<F*> (storage))();
+		}
+
+		static void Destroy(void* storage) noexcept
+		{
+			static_cast<F*> (storage)->~F();
+		}
+
+		static void Move(void* destination, void* source) noexcept
+		{
+			DISABLE_WARNING_DONT_USE_NEW
+			new (destination) F(std::move(*static_cast<F*> (source)));
+			static_cast<F*> (source)->~F();
+		}
+
+		static const Operations* Get() noexcept
+		{
+			static const Operations operations{ &Invoke, &Destroy, &Move };
+			return &operations;
+		}
+	};
+
+	template<typename F>
+	static constexpr bool IsInline()
+	{
+		return sizeof(F) <= CAPACITY && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<F>::value;
+	}
+
+	alignas(std::max_align_t) unsigned char storage[CAPACITY];
+	const Operations* operations{ nullptr };
+
+
+	void* Storage() noexcept
+	{
+		DISABLE_WARNING_ARRAY_POINTER_DECAY
+		return this->storage;
+	}
+
+	template<typename F, typename Arg>
+	void Store(Arg&& function, std::true_type)
+	{
+		DISABLE_WARNING_DONT_USE_NEW
+		new (this->Storage()) F(std::forward<Arg>(function));
+		this->operations = OperationsFor<F>::Get();
+	}
+
+	template<typename F, typename Arg>
+	void Store(Arg&& function, std::false_type)
+	{
+		using Wrapper = HeapFunction<F>;
+		DISABLE_WARNING_DONT_USE_NEW
+		new (this->Storage()) Wrapper{ std::make_unique<F>(std::forward<Arg>(function)) };
+		this->operations = OperationsFor<Wrapper>::Get();
+	}
+
+	void MoveFrom(InlineTask& other) noexcept
+	{
+		if (other.operations == nullptr)
+			return;
+		other.operations->move(this->Storage(), other.Storage());
+		this->operations = other.operations;
+		other.operations = nullptr;
+	}
+};
+
+#endif /* _DBM_INLINETASK_H_ */
@@ -0,0 +1,316 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <chrono>
+
+#include "JavaSender.h"
+#include "ReaDebug.h"
+
+
+/**
+ * Constructor.
+ *
+ * @param aJvmManager The JVM manager to call Java
+ * @param aProfiler Measures the calls
+ */
+JavaSender::JavaSender(std::unique_ptr<JvmManager>& aJvmManager, Profiler& aProfiler) noexcept : jvmManager(aJvmManager), profiler(aProfiler)
+{
+	// Intentionally empty
+}
+
+
+/**
+ * Destructor. Stops the thread.
+ */
+JavaSender::~JavaSender()
+{
+	try
+	{
+		this->Stop();
+	}
+	catch (...)
+	{
+		// Ignore on shutdown
+	}
+}
+
+
+/**
+ * Start the thread which calls Java. Does nothing if it is already running.
+ */
+void JavaSender::Start()
+{
+	if (this->isRunning.exchange(true))
+		return;
+	this->thread = std::thread(&JavaSender::Run, this);
+}
+
+
+/**
+ * Stop the thread and wait for it to finish. Data which was not yet sent is discarded.
+ */
+void JavaSender::Stop()
+{
+	if (!this->isRunning.exchange(false))
+		return;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->wakeMutex);
+	}
+	this->wakeCondition.notify_one();
+	if (this->thread.joinable())
+		this->thread.join();
+
+	// The queues do not delete the remaining items
+	while (this->midiQueue.pop() != nullptr)
+	{
+		// Discard
+	}
+	while (this->updateQueue.pop() != nullptr)
+	{
+		// Discard
+	}
+	this->midiBatch.reset();
+	this->update.reset();
+	this->pendingUpdate.Clear();
+}
+
+
+/**
+ * Add an incoming MIDI message to the current batch. The message is dropped if the batch is full,
+ * which happens only if it cannot be handed to the thread for a long time. Must be called from the
+ * main thread.
+ *
+ * @param deviceId The ID of the device which received the message
+ * @param data The bytes of the message
+ * @param size The number of bytes
+ * @param traceId The trace ID of the message
+ * @param timestamp The time when the message was queued, 0 if it is not traced
+ */
+void JavaSender::QueueMidi(std::uint32_t deviceId, const std::uint8_t* data, std::uint32_t size, std::uint32_t traceId, std::int64_t timestamp)
+{
+	if (!this->midiBatch)
+		this->midiBatch = std::make_unique<MidiBatch>();
+	else if (this->midiBatch->events.size() >= MAX_BATCH_EVENTS)
+	{
+		this->profiler.Count(Profiler::Counter::MIDI_DROPPED);
+		return;
+	}
+	this->midiBatch->events.push_back({ deviceId, traceId, timestamp, this->midiBatch->data.size(), size });
+	this->midiBatch->data.insert(this->midiBatch->data.end(), data, data + size);
+}
+
+
+/**
+ * Add a model update. If the previous update could not be handed to the thread yet, the update is
+ * merged into it. Must be called from the main thread.
+ *
+ * @param data The changed values
+ */
+void JavaSender::QueueUpdate(std::string&& data)
+{
+	if (!this->update)
+	{
+		this->update = std::make_unique<std::string>(std::move(data));
+		return;
+	}
+
+	if (this->pendingUpdate.IsEmpty())
+		this->pendingUpdate.Add(*this->update);
+	this->pendingUpdate.Add(data);
+	this->profiler.Count(Profiler::Counter::UPDATES_MERGED);
+}
+
+
+/**
+ * Hand the current MIDI batch and model update to the thread. If a queue is full the data is kept
+ * and following data is added to it. Must be called from the main thread.
+ */
+void JavaSender::Flush()
+{
+	bool hasQueued{ false };
+	if (this->midiBatch && !this->midiQueue.full())
+	{
+		this->midiQueue.push(std::move(this->midiBatch));
+		hasQueued = true;
+	}
+	if (this->update && !this->updateQueue.full())
+	{
+		if (!this->pendingUpdate.IsEmpty())
+			this->pendingUpdate.MoveTo(*this->update);
+		this->updateQueue.push(std::move(this->update));
+		hasQueued = true;
+	}
+	if (!hasQueued)
+		return;
+
+	// Only held by the thread while it checks for work, never while calling Java
+	{
+		const std::lock_guard<std::mutex> lock(this->wakeMutex);
+	}
+	this->wakeCondition.notify_one();
+}
+
+
+/**
+ * The loop of the thread.
+ */
+void JavaSender::Run()
+{
+	while (this->isRunning.load())
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->wakeMutex);
+			this->wakeCondition.wait_for(lock, std::chrono::milliseconds(MAX_WAIT_MILLIS), [this]() { return this->HasWork(); });
+		}
+		if (!this->isRunning.load())
+			break;
+
+		try
+		{
+			if (!this->jvmManager || !this->jvmManager->IsRunning())
+				continue;
+			this->SendMidi();
+			this->SendUpdates();
+		}
+		catch (const std::exception& ex)
+		{
+			ReaDebug() << "Could not send data to Java: " << ex.what();
+		}
+		catch (...)
+		{
+			ReaDebug() << "Could not send data to Java.";
+		}
+	}
+
+	if (this->jvmManager)
+		this->jvmManager->DetachCurrentThread();
+}
+
+
+/**
+ * Check if there is something to send or the thread should stop.
+ *
+ * @return True if the thread has something to do
+ */
+bool JavaSender::HasWork() const noexcept
+{
+	return !this->isRunning.load() || !this->midiQueue.empty() || !this->updateQueue.empty();
+}
+
+
+/**
+ * Send all queued MIDI messages to Java.
+ */
+void JavaSender::SendMidi()
+{
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	std::unique_ptr<MidiBatch> batch;
+	while ((batch = this->midiQueue.pop()) != nullptr)
+	{
+		const JvmManager::LocalFrame frame(*this->jvmManager, LOCAL_FRAME_CAPACITY);
+		for (const MidiBatch::Event& event : batch->events)
+		{
+			std::uint8_t* message = batch->data.data() + event.offset;
+			const int size = static_cast<int>(event.size);
+			const StageTimer::Scope scope(this->profiler.GetTimer(Profiler::Timer::MIDI_TO_JAVA));
+			this->profiler.Count(Profiler::Counter::MIDI_TO_JAVA);
+			if (event.timestamp == 0)
+			{
+				this->jvmManager->OnMIDIEvent(static_cast<int>(event.deviceId), message, size);
+				continue;
+			}
+
+			const std::int64_t sent = Profiler::GetTimestamp();
+			this->profiler.TraceToJava(event.traceId, event.timestamp, sent);
+			this->jvmManager->OnMIDIEvent(static_cast<int>(event.deviceId), message, size);
+			this->profiler.TraceReturnFromJava(sent, Profiler::GetTimestamp());
+		}
+	}
+}
+
+
+/**
+ * Send all queued model updates to Java with one call.
+ */
+void JavaSender::SendUpdates()
+{
+	std::unique_ptr<std::string> data = this->updateQueue.pop();
+	if (!data)
+		return;
+
+	std::unique_ptr<std::string> next = this->updateQueue.pop();
+	if (next)
+	{
+		this->mergedUpdate.Add(*data);
+		do
+		{
+			this->mergedUpdate.Add(*next);
+			this->profiler.Count(Profiler::Counter::UPDATES_MERGED);
+		} while ((next = this->updateQueue.pop()) != nullptr);
+		this->mergedUpdate.MoveTo(*data);
+	}
+
+	const StageTimer::Scope scope(this->profiler.GetTimer(Profiler::Timer::UPDATE_MODEL));
+	const JvmManager::LocalFrame frame(*this->jvmManager, LOCAL_FRAME_CAPACITY);
+	this->jvmManager->UpdateModel(*data);
+}
+
+
+/**
+ * Add the lines of an update. The value of an address which was already added in the current
+ * section replaces the previous one. A dump marker starts a new section. Events are always added.
+ *
+ * @param data The lines of changed values in the format 'address value'
+ */
+void JavaSender::UpdateMerger::Add(const std::string& data)
+{
+	std::size_t start = 0;
+	while (start < data.length())
+	{
+		std::size_t end = data.find('\n', start);
+		if (end == std::string::npos)
+			end = data.length();
+		if (end == start)
+		{
+			start++;
+			continue;
+		}
+
+		std::string line = data.substr(start, end - start);
+		line.push_back('\n');
+		if (data.compare(start, 6, "/dump/") == 0)
+		{
+			this->addressIndex.clear();
+			this->lines.push_back(std::move(line));
+		}
+		else if (data.compare(start, 8, "/action/") == 0)
+			this->lines.push_back(std::move(line));
+		else
+		{
+			const std::size_t separator = data.find(' ', start);
+			const std::size_t addressEnd = separator == std::string::npos || separator > end ? end : separator;
+			const auto result = this->addressIndex.emplace(data.substr(start, addressEnd - start), this->lines.size());
+			if (result.second)
+				this->lines.push_back(std::move(line));
+			else
+				this->lines.at(result.first->second) = std::move(line);
+		}
+
+		start = end + 1;
+	}
+}
+
+
+/**
+ * Replace the given data with the merged lines and remove them from the merger.
+ *
+ * @param data Where to store the merged lines
+ */
+void JavaSender::UpdateMerger::MoveTo(std::string& data)
+{
+	data.clear();
+	for (const std::string& line : this->lines)
+		data.append(line);
+	this->Clear();
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_JAVASENDER_H_
+#define _DBM_JAVASENDER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "JvmManager.h"
+#include "Profiler.h"
+#include "ReaderWriterQueue.h"
+
+
+/**
+ * Hands the model updates and the incoming MIDI messages to Java on a dedicated thread, which is
+ * attached to the JVM once. The main thread only queues the data and never waits for Java.
+ *
+ * If Java falls behind, the queued model updates are merged into one call. The updates contain
+ * lines of changed values, therefore only the latest value of each address needs to be sent. The
+ * dump markers are kept in order and values are not merged across them, since a dump is split into
+ * several updates. Events (actions) are never merged. If a queue is full, the main thread keeps the
+ * data and merges the following data into it until there is space again, which bounds the backlog
+ * by the size of the model.
+ */
+class JavaSender
+{
+public:
+	JavaSender(std::unique_ptr<JvmManager>& aJvmManager, Profiler& aProfiler) noexcept;
+	JavaSender(const JavaSender&) = delete;
+	JavaSender& operator=(const JavaSender&) = delete;
+	JavaSender(JavaSender&&) = delete;
+	JavaSender& operator=(JavaSender&&) = delete;
+	~JavaSender();
+
+	void Start();
+	void Stop();
+
+	void QueueMidi(std::uint32_t deviceId, const std::uint8_t* data, std::uint32_t size, std::uint32_t traceId, std::int64_t timestamp);
+	void QueueUpdate(std::string&& data);
+	void Flush();
+
+	/**
+	 * Get the number of MIDI batches which were not yet sent to Java.
+	 *
+	 * @return The number of batches, approximated
+	 */
+	std::size_t GetMidiBacklog() const noexcept
+	{
+		return this->midiQueue.unsafe_size();
+	}
+
+	/**
+	 * Get the number of model updates which were not yet sent to Java.
+	 *
+	 * @return The number of updates, approximated
+	 */
+	std::size_t GetUpdateBacklog() const noexcept
+	{
+		return this->updateQueue.unsafe_size();
+	}
+
+private:
+	/** The longest time the thread sleeps without being notified, as a safety net. */
+	static const int MAX_WAIT_MILLIS{ 100 };
+	/** The number of local references which are expected while sending a batch to Java. */
+	static const jint LOCAL_FRAME_CAPACITY{ 16 };
+	/** The most MIDI messages which are kept in a batch, e.g. while the JVM is starting. */
+	static const std::size_t MAX_BATCH_EVENTS{ 16384 };
+
+	/**
+	 * Merges model updates. Keeps the latest value of each address at the position where the
+	 * address was added first. Dump markers start a new section in which addresses are added again.
+	 */
+	class UpdateMerger
+	{
+	public:
+		void Add(const std::string& data);
+		void MoveTo(std::string& data);
+
+		bool IsEmpty() const noexcept
+		{
+			return this->lines.empty();
+		}
+
+		void Clear() noexcept
+		{
+			this->lines.clear();
+			this->addressIndex.clear();
+		}
+
+	private:
+		std::vector<std::string> lines;
+		// The addresses of the current section and the index of their line
+		std::unordered_map<std::string, std::size_t> addressIndex;
+	};
+
+	/** The MIDI messages received during one call of the main thread. */
+	struct MidiBatch
+	{
+		struct Event
+		{
+			std::uint32_t deviceId;
+			std::uint32_t traceId;
+			std::int64_t timestamp;
+			std::size_t offset;
+			std::uint32_t size;
+		};
+
+		std::vector<Event> events;
+		std::vector<std::uint8_t> data;
+	};
+
+	std::unique_ptr<JvmManager>& jvmManager;
+	Profiler& profiler;
+
+	std::thread thread;
+	std::atomic<bool> isRunning{ false };
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+
+	// Single producer (main thread), single consumer (sender thread)
+	ReaderWriterQueue<MidiBatch, 64> midiQueue;
+	ReaderWriterQueue<std::string, 16> updateQueue;
+
+	// Only used by the main thread: the data which is not yet queued
+	std::unique_ptr<MidiBatch> midiBatch;
+	std::unique_ptr<std::string> update;
+	UpdateMerger pendingUpdate;
+
+	// Only used by the sender thread
+	UpdateMerger mergedUpdate;
+
+	void Run();
+	bool HasWork() const noexcept;
+	void SendMidi();
+	void SendUpdates();
+};
+
+#endif /* _DBM_JAVASENDER_H_ */
@@ -10,6 +10,7 @@
 #include <dlfcn.h>
 #endif
 
+#include <atomic>
 #include <vector>
 #include <sstream>
 #include <iostream>
@@ -21,8 +22,16 @@
 #include "ReaDebug.h"
 #include "ReaperUtils.h"
 #include "StringUtils.h"
+#include "ThreadEnv.h"
 
-#define CURRENT_JNI_VERSION  JNI_VERSION_21
+
+namespace
+{
+	// Set on the thread which starts the JVM
+	thread_local bool isStartupThread{ false };
+
+	const std::array<const char*, JvmManager::STARTUP_PHASE_COUNT> STARTUP_PHASE_NAMES{ { "libraryLoad", "jvmCreate", "classLoad", "registerNatives", "appStart" } };
+}
 
 
 /**
@@ -33,7 +42,8 @@
 JvmManager::JvmManager(bool enableDebug) : jvmCmdOptions("-agentlib:jdwp=transport=dt_socket,address=8989,server=y,suspend=y"), jvm(nullptr), jvmLibHandle(nullptr)
 {
 	this->debug = enableDebug;
-	this->options = std::make_unique<JavaVMOption[]>(this->debug ? 2 : 1);
+	for (std::atomic<long long>& nanos : this->startupNanos)
+		nanos.store(-1);
 }
 
 
@@ -42,6 +52,8 @@ JvmManager::JvmManager(bool enableDebug) : jvmCmdOptions("-agentlib:jdwp=transpo
  */
 JvmManager::~JvmManager()
 {
+	this->WaitForStartup();
+
 	if (this->jvm != nullptr)
 	{
         ReaDebug::Log("DrivenByMoss: Shutting down JVM.\n");
@@ -70,6 +82,7 @@ void JvmManager::ShutdownControllers()
 	ReaDebug::Log("DrivenByMoss: Shutting down controllers.\n");
 
 	this->isCleanShutdown = true;
+	this->WaitForStartup();
 
 	try
 	{
@@ -79,6 +92,11 @@ void JvmManager::ShutdownControllers()
 			env->CallStaticVoidMethod(this->controllerClass, this->methodIDShutdown);
 			this->HandleException(*env, "Could not call shutdown.");
 		}
+		if (env != nullptr)
+		{
+			// All classes of the application are loaded at this point
+			this->classDataSharing.CreateArchive(*env);
+		}
 	}
 	catch (...)
 	{
@@ -88,19 +106,49 @@ void JvmManager::ShutdownControllers()
 
 
 /**
- * Start and initialise the JVM.
+ * Start and initialise the JVM on the startup thread. Returns immediately.
  *
- * @param functions The C++ functions to register with JNI
+ * @param functions The C++ functions to register with JNI, 20 functions are expected
  */
 DISABLE_WARNING_ARRAY_POINTER_DECAY
-void JvmManager::Init(void* functions[])
+void JvmManager::InitAsync(void* functions[])
 {
 	if (this->isInitialised)
 		return;
+	this->isInitialised = true;
+
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	this->callbackFunctions.assign(functions, functions + 20);
+	this->isStarting.store(true);
+	this->startupThread = std::thread([this]()
+		{
+			isStartupThread = true;
+			try
+			{
+				this->Init(this->callbackFunctions.data());
+			}
+			catch (...)
+			{
+				ReaDebug::Log("DrivenByMoss: JVM startup failed.\n");
+			}
+			this->RunDeferredCalls();
+			// Releases the local references of the startup and the deferred calls
+			this->DetachCurrentThread();
+		});
+}
+
 
+/**
+ * Start and initialise the JVM. Called on the startup thread.
+ *
+ * @param functions The C++ functions to register with JNI
+ */
+DISABLE_WARNING_ARRAY_POINTER_DECAY
+void JvmManager::Init(void* functions[])
+{
     ReaDebug::Log("DrivenByMoss: Creating JVM.\n");
     
-	this->isInitialised = true;
+	this->startupStart = std::chrono::steady_clock::now();
 	this->Create();
 	if (this->jvm == nullptr)
     {
@@ -115,15 +163,117 @@ void JvmManager::Init(void* functions[])
 	}
 
 	ReaDebug::Log("DrivenByMoss: Registering CPP callbacks.\n");
+	std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
 	this->RegisterMethods(*env, functions);
+	this->MeasureStartupPhase(StartupPhase::REGISTER_NATIVES, phaseStart);
     
 	if (ENABLE_JAVA_START)
     {
         ReaDebug::Log("DrivenByMoss: Starting application.\n");
 		this->StartApp(*env);
+		this->MeasureStartupPhase(StartupPhase::APP_START, phaseStart);
     }
     
-    ReaDebug::Log("DrivenByMoss: JVM startup finished.\n");
+	std::ostringstream ss;
+	this->WriteStartupJson(ss);
+	ReaDebug::Log("DrivenByMoss: JVM startup finished: " + ss.str() + "\n");
+}
+
+
+/**
+ * Execute the calls which arrived during the startup and switch to running afterwards. If the
+ * startup failed, the calls are discarded. Called on the startup thread.
+ */
+void JvmManager::RunDeferredCalls()
+{
+	const bool hasStarted = this->jvm != nullptr && this->controllerClass != nullptr;
+	std::vector<std::function<void()>> calls;
+	while (true)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(this->startupMutex);
+			calls.swap(this->deferredCalls);
+			if (calls.empty() || !hasStarted)
+			{
+				this->deferredDocumentSettings.clear();
+				this->isRunning.store(hasStarted);
+				this->isStarting.store(false);
+				return;
+			}
+		}
+
+		for (const std::function<void()>& call : calls)
+			call();
+		calls.clear();
+	}
+}
+
+
+/**
+ * Defers a call until the application is running, if it is still starting up.
+ *
+ * @param call The call to execute after the startup
+ * @param documentSettings If not null, the document settings which are reported until the startup
+ *                         has finished
+ * @return True if the call was deferred, false if it needs to be executed now
+ */
+bool JvmManager::DeferUntilRunning(std::function<void()>&& call, const std::string* documentSettings)
+{
+	if (!this->isStarting.load() || isStartupThread)
+		return false;
+	const std::lock_guard<std::mutex> lock(this->startupMutex);
+	if (!this->isStarting.load())
+		return false;
+	this->deferredCalls.push_back(std::move(call));
+	if (documentSettings != nullptr)
+		this->deferredDocumentSettings = *documentSettings;
+	return true;
+}
+
+
+/**
+ * Wait until the startup thread has finished.
+ */
+void JvmManager::WaitForStartup()
+{
+	if (this->startupThread.joinable())
+		this->startupThread.join();
+}
+
+
+/**
+ * Store the duration of a startup phase.
+ *
+ * @param phase The phase which ended
+ * @param phaseStart The start of the phase, is set to the current time afterwards
+ */
+void JvmManager::MeasureStartupPhase(StartupPhase phase, std::chrono::steady_clock::time_point& phaseStart)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	this->startupNanos[static_cast<std::size_t>(phase)].store(std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart).count());
+	phaseStart = now;
+}
+
+
+/**
+ * Append the durations of the startup phases as a JSON object. A phase which did not finish has
+ * the duration -1.
+ *
+ * @param ss The stream to append to
+ */
+void JvmManager::WriteStartupJson(std::ostringstream& ss) const
+{
+	ss << "{";
+	long long total{ 0 };
+	for (std::size_t i = 0; i < STARTUP_PHASE_COUNT; i++)
+	{
+		const long long nanos = this->startupNanos[i].load();
+		if (nanos > 0)
+			total += nanos;
+		ss << (i == 0 ? "\"" : ",\"") << STARTUP_PHASE_NAMES[i] << "Nanos\":" << nanos;
+	}
+	ss << ",\"totalNanos\":" << total << ",\"firstUpdateModelNanos\":" << this->firstUpdateNanos.load();
+	ss << ",\"classDataSharing\":\"" << this->classDataSharing.GetStateName() << "\"}";
 }
 
 
@@ -137,30 +287,46 @@ void JvmManager::Create()
 		return;
 	this->javaHomePath = libDir + "java-runtime";
 
+	std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
 	if (!LoadJvmLibrary())
 		return;
+	this->MeasureStartupPhase(StartupPhase::LIBRARY_LOAD, phaseStart);
 
 	this->classpath = this->CreateClasspath(libDir);
 	if (this->classpath.empty())
 		return;
 
+	// The archive would not match the classes while debugging
+	if (!this->debug)
+		this->classDataSharing.Prepare(libDir, this->classpath, this->LookupJvmLibrary(this->javaHomePath));
+	std::vector<std::string>& cdsOptions = this->classDataSharing.GetOptions();
+
+	const int optionCount = (this->debug ? 2 : 1) + static_cast<int>(cdsOptions.size());
+	this->options = std::make_unique<JavaVMOption[]>(optionCount);
 	JavaVMOption* const  opts = this->options.get();
 	if (opts == nullptr)
 		return;
 	DISABLE_WARNING_NO_POINTER_ARITHMETIC
 	DISABLE_WARNING_USE_GSL_AT
 	opts[0].optionString = &this->classpath[0];
+	int optionIndex = 1;
 	if (this->debug)
 	{
 		DISABLE_WARNING_NO_POINTER_ARITHMETIC
 		DISABLE_WARNING_USE_GSL_AT
-		opts[1].optionString = &this->jvmCmdOptions[0];
+		opts[optionIndex++].optionString = &this->jvmCmdOptions[0];
+	}
+	for (std::string& option : cdsOptions)
+	{
+		DISABLE_WARNING_NO_POINTER_ARITHMETIC
+		DISABLE_WARNING_USE_GSL_AT
+		opts[optionIndex++].optionString = &option[0];
 	}
 
 	// Minimum required Java version
 	JavaVMInitArgs vm_args{};
 	vm_args.version = CURRENT_JNI_VERSION;
-	vm_args.nOptions = this->debug ? 2 : 1;
+	vm_args.nOptions = optionCount;
 	vm_args.options = this->options.get();
 	// Invalid options make the JVM init fail
 	vm_args.ignoreUnrecognized = JNI_FALSE;
@@ -188,14 +354,31 @@ void JvmManager::Create()
 	DISABLE_WARNING_REINTERPRET_CAST
 	// Note: If the next line crashes in debugger make sure that jdwp.dll and dt_socket.dll are from the same JDK!
 	// Simply copy the whole JDK
-	const jint rc = JNI_CreateJavaVM(&this->jvm, reinterpret_cast<void**> (&env), &vm_args);
+	jint rc = JNI_CreateJavaVM(&this->jvm, reinterpret_cast<void**> (&env), &vm_args);
+	if (rc != JNI_OK && !cdsOptions.empty())
+	{
+		// The JVM does not know the options of the class data sharing archive or cannot use it,
+		// start it without them. They are the last ones in the array.
+		ReaDebug() << "DrivenByMoss: Could not start Java Virtual Machine with class data sharing. Error code: " << rc << ". Starting without it.";
+		vm_args.nOptions -= static_cast<jint>(cdsOptions.size());
+		this->classDataSharing.Disable();
+		this->jvm = nullptr;
+		env = nullptr;
+		DISABLE_WARNING_REINTERPRET_CAST
+		rc = JNI_CreateJavaVM(&this->jvm, reinterpret_cast<void**> (&env), &vm_args);
+	}
 	if (rc != JNI_OK)
 	{
 		ReaDebug() << "ERROR: Could not start Java Virtual Machine. Error code: " << rc << " Classpath: " << classpath;
 		return;
 	}
+	this->MeasureStartupPhase(StartupPhase::JVM_CREATE, phaseStart);
+
+	// The creating thread is attached by the JVM, it detaches when the startup has finished
+	ThreadEnv::SetAttached(this->jvm, env);
 
 	RetrieveMethods(*env);
+	this->MeasureStartupPhase(StartupPhase::CLASS_LOAD, phaseStart);
 }
 
 
@@ -297,6 +480,22 @@ void JvmManager::RegisterMethods(JNIEnv& env, void* functions[])
 	const int result = env.RegisterNatives(mainFrameClass, methods, sizeof(methods) / sizeof(*methods));
 	if (result != 0)
 		this->HandleException(env, "ERROR: Could not register native functions");
+
+	// Optional, only available with newer Java versions of the application
+	const JNINativeMethod optionalMethods[]
+	{
+		{ (char*)"processCommands", (char*)"(Ljava/nio/ByteBuffer;I)V", functions[18] },
+		{ (char*)"getStatistics", (char*)"(Z)Ljava/lang/String;", functions[19] }
+	};
+	// Register one by one, since all fail if one of them is missing
+	for (const JNINativeMethod& method : optionalMethods)
+	{
+		if (env.RegisterNatives(mainFrameClass, &method, 1) != 0)
+		{
+			env.ExceptionClear();
+			ReaDebug::Log(std::string("DrivenByMoss: Optional method not supported by the application: ") + method.name + "\n");
+		}
+	}
 }
 
 
@@ -350,6 +549,8 @@ void JvmManager::StartInfrastructure()
  */
 void JvmManager::DisplayWindow()
 {
+	if (this->DeferUntilRunning([this]() { this->DisplayWindow(); }))
+		return;
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDDisplayWindow == nullptr)
 		return;
@@ -363,6 +564,8 @@ void JvmManager::DisplayWindow()
  */
 void JvmManager::DisplayProjectWindow()
 {
+	if (this->DeferUntilRunning([this]() { this->DisplayProjectWindow(); }))
+		return;
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDDisplayProjectWindow == nullptr)
 		return;
@@ -376,6 +579,8 @@ void JvmManager::DisplayProjectWindow()
  */
 void JvmManager::DisplayParameterWindow()
 {
+	if (this->DeferUntilRunning([this]() { this->DisplayParameterWindow(); }))
+		return;
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDDisplayParameterWindow == nullptr)
 		return;
@@ -389,6 +594,8 @@ void JvmManager::DisplayParameterWindow()
  */
 void JvmManager::RestartControllers()
 {
+	if (this->DeferUntilRunning([this]() { this->RestartControllers(); }))
+		return;
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDResetController == nullptr)
 		return;
@@ -408,8 +615,18 @@ void JvmManager::UpdateModel(const std::string& data)
 	if (env == nullptr || methodIDUpdateModel == nullptr)
 		return;
 	jstring dataUTF = env->NewStringUTF(data.c_str());
+	if (dataUTF == nullptr)
+		return;
 	env->CallStaticVoidMethod(this->controllerClass, methodIDUpdateModel, dataUTF);
+	env->DeleteLocalRef(dataUTF);
 	this->HandleException(*env, "ERROR: Could not call updateModel.");
+
+	if (this->firstUpdateNanos.load() < 0)
+	{
+		const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->startupStart).count();
+		this->firstUpdateNanos.store(nanos);
+		ReaDebug() << "DrivenByMoss: First model update sent after " << static_cast<std::int64_t>(nanos / 1000000) << " ms (class data sharing: " << this->classDataSharing.GetStateName() << ").";
+	}
 }
 
 
@@ -418,6 +635,9 @@ void JvmManager::UpdateModel(const std::string& data)
  */
 void JvmManager::SetDefaultDocumentSettings()
 {
+	const std::string noSettings{};
+	if (this->DeferUntilRunning([this]() { this->SetDefaultDocumentSettings(); }, &noSettings))
+		return;
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDSetDefaultDocumentSettings == nullptr)
 		return;
@@ -433,6 +653,12 @@ void JvmManager::SetDefaultDocumentSettings()
  */
 std::string JvmManager::GetFormattedDocumentSettings()
 {
+	if (this->isStarting.load())
+	{
+		const std::lock_guard<std::mutex> lock(this->startupMutex);
+		if (this->isStarting.load())
+			return this->deferredDocumentSettings;
+	}
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDGetFormattedDocumentSettings == nullptr)
 		return "";
@@ -444,9 +670,13 @@ std::string JvmManager::GetFormattedDocumentSettings()
 	jboolean isCopy;
 	const char* data = env->GetStringUTFChars(jdata, &isCopy);
 	if (data == nullptr)
+	{
+		env->DeleteLocalRef(jdata);
 		return "";
+	}
 	std::string result{ data };
 	env->ReleaseStringUTFChars(jdata, data);
+	env->DeleteLocalRef(jdata);
 	return result;
 }
 
@@ -458,11 +688,18 @@ std::string JvmManager::GetFormattedDocumentSettings()
  */
 void JvmManager::SetFormattedDocumentSettings(const std::string& data)
 {
+	// The data might be followed by zeros
+	const std::string settings{ data.c_str() };
+	if (this->DeferUntilRunning([this, settings]() { this->SetFormattedDocumentSettings(settings); }, &settings))
+		return;
 	JNIEnv* env = this->GetEnv();
 	if (env == nullptr || this->methodIDSetFormattedDocumentSettings == nullptr)
 		return;
 	jstring dataUTF = env->NewStringUTF(data.c_str());
+	if (dataUTF == nullptr)
+		return;
 	env->CallStaticVoidMethod(this->controllerClass, this->methodIDSetFormattedDocumentSettings, dataUTF);
+	env->DeleteLocalRef(dataUTF);
 	this->HandleException(*env, "ERROR: Could not call setFormattedDocumentSettings.");
 }
 
@@ -490,6 +727,43 @@ void JvmManager::OnMIDIEvent(int deviceID, unsigned char* message, int size)
 }
 
 
+/**
+ * Detach the current thread from the JVM. Must be called before a native thread, which is owned by
+ * the extension and called Java, ends.
+ */
+void JvmManager::DetachCurrentThread()
+{
+	ThreadEnv::Detach(this->jvm);
+}
+
+
+/**
+ * Constructor. Creates a frame for local references with the given capacity. Does nothing if the
+ * JVM is not running.
+ *
+ * @param jvmManager The JVM manager
+ * @param capacity The number of local references which are expected in the frame
+ */
+JvmManager::LocalFrame::LocalFrame(JvmManager& jvmManager, jint capacity) : env(jvmManager.GetEnv())
+{
+	if (this->env != nullptr && this->env->PushLocalFrame(capacity) != 0)
+	{
+		this->env->ExceptionClear();
+		this->env = nullptr;
+	}
+}
+
+
+/**
+ * Destructor. Deletes all local references which were created in the frame.
+ */
+JvmManager::LocalFrame::~LocalFrame()
+{
+	if (this->env != nullptr)
+		this->env->PopLocalFrame(nullptr);
+}
+
+
 /**
  * Get the full path to the DLL. Uses the trick to retrieve it from a local function.
  *
@@ -648,8 +922,12 @@ void JvmManager::AddToTreeMap(JNIEnv& env, jobject treeMap, jint key, const std:
 {
 	jobject keyObject = env.NewObject(this->integerClass, this->integerConstructor, key);
 	jstring valueObject = env.NewStringUTF(value.c_str());
-	env.CallObjectMethod(treeMap, this->treeMapPutMethod, keyObject, valueObject);
+	jobject previous = env.CallObjectMethod(treeMap, this->treeMapPutMethod, keyObject, valueObject);
 	this->HandleException(env, "ERROR: Could not add entry to TreeMap.");
+	if (previous != nullptr)
+		env.DeleteLocalRef(previous);
+	env.DeleteLocalRef(valueObject);
+	env.DeleteLocalRef(keyObject);
 }
 
 
@@ -789,29 +1067,12 @@ jmethodID JvmManager::RetrieveMethod(JNIEnv& env, const char* name, const char*
 }
 
 
+/**
+ * Get the JNI environment of the current thread, see ThreadEnv.
+ *
+ * @return The environment or null if the JVM is not running or the thread could not be attached
+ */
 JNIEnv* JvmManager::GetEnv()
 {
-	if (this->jvm == nullptr)
-		return nullptr;
-
-	// This is correct since it is a pointer to a pointer!
-	JNIEnv* env = nullptr;
-	const jint result = this->jvm->GetEnv(reinterpret_cast<void**>(&env), CURRENT_JNI_VERSION);
-	if (result == JNI_OK)
-		return env;
-
-	if (result == JNI_EDETACHED)
-	{
-		// The JNI specification guarantees that JavaVM::AttachCurrentThread() is thread-safe. 
-		// Each native thread can safely call it, even concurrently with others.
-		if (this->jvm->AttachCurrentThread(reinterpret_cast<void**>(&env), nullptr) != 0)
-		{
-			ReaDebug::Log("DrivenByMoss: Could not attach current thread to JVM!\n");
-			return nullptr;
-		}
-		return env;
-	}
-
-	// JNI_EVERSION or other fatal error
-	return nullptr;
+	return ThreadEnv::Get(this->jvm);
 }
\ No newline at end of file
@@ -4,16 +4,28 @@
 #ifndef _DBM_JVMMANAGER_H_
 #define _DBM_JVMMANAGER_H_
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 
+#include "ClassDataSharing.h"
 #include "CodeAnalysis.h"
 #include "WrapperJNI.h"
 
 
 /**
  * Manages the start and stop of a Java Virtual Machine.
+ *
+ * The JVM is created and the application is started on a separate thread to not block the startup
+ * of Reaper. Calls which arrive in the meantime are deferred until the application is running.
+ * The classes of the application are loaded from a class data sharing archive, if available.
  */
 class JvmManager
 {
@@ -25,14 +37,41 @@ public:
 	JvmManager& operator=(JvmManager&&) = delete;
 	~JvmManager();
 
-	void Init(void* functions[]);
+	/**
+	 * The phases of the startup. CLASS_LOAD looks up the Java classes and methods which are
+	 * called, REGISTER_NATIVES registers the C++ callbacks.
+	 */
+	enum class StartupPhase
+	{
+		LIBRARY_LOAD, JVM_CREATE, CLASS_LOAD, REGISTER_NATIVES, APP_START
+	};
+	static const std::size_t STARTUP_PHASE_COUNT{ 5 };
+
+	void InitAsync(void* functions[]);
 	void ShutdownControllers();
 
+	/**
+	 * Check if the JVM is created and the application is started.
+	 *
+	 * @return True if running
+	 */
 	bool IsRunning() const noexcept
 	{
-		return this->isInitialised && this->jvm != nullptr;
+		return this->isRunning.load();
+	}
+
+	/**
+	 * Check if the JVM is still starting up on the startup thread.
+	 *
+	 * @return True if starting
+	 */
+	bool IsStarting() const noexcept
+	{
+		return this->isStarting.load();
 	}
 
+	void WriteStartupJson(std::ostringstream& ss) const;
+
 	const std::string& GetJavaHomePath() const noexcept
 	{
 		return this->javaHomePath;
@@ -54,6 +93,26 @@ public:
 	void AddToTreeMap(JNIEnv& env, jobject treeMap, jint key, const std::string& value);
 
 	void OnMIDIEvent(int deviceID, unsigned char* message, int size);
+	void DetachCurrentThread();
+
+	/**
+	 * Deletes all local references, which are created by the calls to Java on the current thread,
+	 * when it is destroyed. Native threads which are attached to the JVM never return to Java,
+	 * therefore their local references are otherwise never released.
+	 */
+	class LocalFrame
+	{
+	public:
+		LocalFrame(JvmManager& jvmManager, jint capacity);
+		LocalFrame(const LocalFrame&) = delete;
+		LocalFrame& operator=(const LocalFrame&) = delete;
+		LocalFrame(LocalFrame&&) = delete;
+		LocalFrame& operator=(LocalFrame&&) = delete;
+		~LocalFrame();
+
+	private:
+		JNIEnv* env;
+	};
 
 private:
 	std::string javaHomePath;
@@ -76,6 +135,21 @@ private:
 	bool isInitialised{ false };
 	bool isCleanShutdown{ false };
 
+	std::thread startupThread;
+	std::vector<void*> callbackFunctions;
+	std::atomic<bool> isStarting{ false };
+	std::atomic<bool> isRunning{ false };
+	// Guards the deferred calls and the transition to running
+	std::mutex startupMutex;
+	std::vector<std::function<void()>> deferredCalls;
+	std::string deferredDocumentSettings;
+	std::chrono::steady_clock::time_point startupStart{};
+	// The duration of each phase, -1 if it did not finish
+	std::array<std::atomic<long long>, STARTUP_PHASE_COUNT> startupNanos{};
+	// The time from the start until the first model update was sent, -1 if none was sent yet
+	std::atomic<long long> firstUpdateNanos{ -1 };
+	ClassDataSharing classDataSharing;
+
 	jclass treeMapClass{ nullptr };
 	jmethodID treeMapConstructor{ nullptr };
 	jmethodID treeMapPutMethod{ nullptr };
@@ -97,6 +171,12 @@ private:
 	jmethodID methodIDSetFormattedDocumentSettings{ nullptr };
 	jmethodID methodIDOnMIDIEvent{ nullptr };
 
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	void Init(void* functions[]);
+	void RunDeferredCalls();
+	bool DeferUntilRunning(std::function<void()>&& call, const std::string* documentSettings = nullptr);
+	void WaitForStartup();
+	void MeasureStartupPhase(StartupPhase phase, std::chrono::steady_clock::time_point& phaseStart);
 	void Create();
 	DISABLE_WARNING_ARRAY_POINTER_DECAY
 	void RegisterMethods(JNIEnv& env, void* functions[]);
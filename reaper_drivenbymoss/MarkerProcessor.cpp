@@ -20,7 +20,7 @@ MarkerProcessor::MarkerProcessor(Model &aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void MarkerProcessor::Process(std::deque<std::string> &path)
+void MarkerProcessor::Process(const OscPath& path)
 {
 	if (path.empty())
 		return;
@@ -30,47 +30,53 @@ void MarkerProcessor::Process(std::deque<std::string> &path)
 
 	if (std::strcmp(part, "add") == 0)
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		PreventUIRefresh(1);
 		const double position = ReaperUtils::GetCursorPosition(project);
 		std::ostringstream markerName;
 		markerName << "Marker " << (this->model.markerCount + 1);
 		AddProjectMarker(project, false, position, 0, markerName.str().c_str(), 0);
 		PreventUIRefresh(-1);
-		Undo_EndBlock2(project, "Add project marker", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Add project marker", UNDO_STATE_ALL);
 		return;
 	}
 
 	if (path.size() < 2)
 		return;
 
-	const int index = atoi(part);
-	const char *cmd = SafeGet(path, 1);
+	const int index = path.GetInt(0);
+	const std::uint64_t cmd = path.GetHash(1);
 
 	const std::vector<int> markers = Marker::GetMarkers(project);
 	if (index < 0 || index >= gsl::narrow_cast<int> (markers.size()))
 		return;
 	const int markerID = markers.at(index);
 
-	const bool isLaunch = std::strcmp(cmd, "launch") == 0;
-	if (std::strcmp(cmd, "select") == 0 || isLaunch)
+	switch (cmd)
+	{
+	case OscPath::Hash("select"):
+	case OscPath::Hash("launch"):
 	{
 		double position;
 		const int result = EnumProjectMarkers2(project, markerID, nullptr, &position, nullptr, nullptr, nullptr);
 		if (result)
 		{
 			SetEditCurPos2(project, position, true, true);
-			if (isLaunch && (GetPlayStateEx(project) & 1) == 0)
+			if (cmd == OscPath::Hash("launch") && (GetPlayStateEx(project) & 1) == 0)
 				CSurf_OnPlay();
 		}
 		return;
 	}
-	
-	if (std::strcmp(cmd, "remove") == 0)
+
+	case OscPath::Hash("remove"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		DeleteProjectMarkerByIndex(project, markerID);
-		Undo_EndBlock2(project, "Delete project marker", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Delete project marker", UNDO_STATE_ALL);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
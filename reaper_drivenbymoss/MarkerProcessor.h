@@ -15,11 +15,16 @@ class MarkerProcessor : public OscProcessor
 public:
 	MarkerProcessor(Model& aModel);
 
-	void Process(std::deque<std::string>& path) override;
+	void Process(const OscPath& path) override;
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
 };
 
 #endif /* _DBM_MARKERPROCESSOR_H_ */
@@ -20,14 +20,15 @@ MastertrackProcessor::MastertrackProcessor(Model& aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void MastertrackProcessor::Process(std::deque<std::string>& path, int value) noexcept
+void MastertrackProcessor::Process(const OscPath& path, int value) noexcept
 {
 	if (path.empty())
 		return;
-	const char* cmd = SafeGet(path, 0);
 	MediaTrack* track = GetMasterTrack(ReaperUtils::GetProject());
 
-	if (std::strcmp(cmd, "select") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("select"):
 	{
 		SetOnlyTrackSelected(track);
 		SetMixerScroll(track);
@@ -35,32 +36,37 @@ void MastertrackProcessor::Process(std::deque<std::string>& path, int value) noe
 		return;
 	}
 
-	if (std::strcmp(cmd, "solo") == 0)
+	case OscPath::Hash("solo"):
 	{
 		SetMediaTrackInfo_Value(track, "I_SOLO", value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "mute") == 0)
+	case OscPath::Hash("mute"):
 	{
 		SetMediaTrackInfo_Value(track, "B_MUTE", value);
 		return;
 	}
 
+	default:
+		break;
+	}
+
 	Process(path, static_cast<double>(value));
 }
 
 
 /** {@inheritDoc} */
-void MastertrackProcessor::Process(std::deque<std::string>& path, double value) noexcept
+void MastertrackProcessor::Process(const OscPath& path, double value) noexcept
 {
 	if (path.empty())
 		return;
-	const char* cmd = SafeGet(path, 0);
 	ReaProject* project = ReaperUtils::GetProject();
 	MediaTrack* track = GetMasterTrack(project);
 
-	if (std::strcmp(cmd, "volume") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("volume"):
 	{
 		if (path.size() == 1)
 		{
@@ -77,7 +83,7 @@ void MastertrackProcessor::Process(std::deque<std::string>& path, double value)
 		return;
 	}
 
-	if (strcmp(cmd, "pan") == 0)
+	case OscPath::Hash("pan"):
 	{
 		if (path.size() == 1)
 		{
@@ -95,11 +101,11 @@ void MastertrackProcessor::Process(std::deque<std::string>& path, double value)
 	}
 
 	// Parse master FX parameter value
-	if (std::strcmp(cmd, "param") == 0)
+	case OscPath::Hash("param"):
 	{
 		if (path.empty())
 			return;
-		const int fxParamNo = atoi(SafeGet(path, 1));
+		const int fxParamNo = path.GetInt(1);
 		int fxindexOut;
 		int parmidxOut;
 		if (!GetTCPFXParm(project, track, fxParamNo, &fxindexOut, &parmidxOut))
@@ -108,10 +114,14 @@ void MastertrackProcessor::Process(std::deque<std::string>& path, double value)
 			TrackFX_SetParamNormalized(track, fxindexOut, parmidxOut, value);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 /** {@inheritDoc} */
-void MastertrackProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void MastertrackProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	if (path.empty())
 		return;
@@ -149,9 +159,9 @@ void MastertrackProcessor::SetColorOfTrack(ReaProject* project, MediaTrack* trac
 	}
 
 	PreventUIRefresh(1);
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 	// Note: SetTrackColor is not working for the master track
 	SetMediaTrackInfo_Value(track, "I_CUSTOMCOLOR", ColorToNative(red, green, blue) | SET_COLOR);
-	Undo_EndBlock2(project, "Set master track color", UNDO_STATE_ALL);
+	this->model.GetUndoBatch().EndBlock(project, "Set master track color", UNDO_STATE_ALL);
 	PreventUIRefresh(-1);
 }
@@ -16,12 +16,17 @@ class MastertrackProcessor : public OscProcessor
 public:
 	MastertrackProcessor(Model &aModel);
 
-	void Process(std::deque<std::string> &path, int value) noexcept override;
-	void Process(std::deque<std::string> &path, double value) noexcept override;
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override;
+	void Process(const OscPath& path, int value) noexcept override;
+	void Process(const OscPath& path, double value) noexcept override;
+	void Process(const OscPath& path, const std::string& value) noexcept override;
 
-	void Process(std::deque<std::string>& path) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
 
 private:
 	void SetColorOfTrack(ReaProject* project, MediaTrack* track, const std::string& value) noexcept;
@@ -0,0 +1,257 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "CodeAnalysis.h"
+#include "DrivenByMossSurface.h"
+#include "MidiInputHook.h"
+#include "RtWatchdog.h"
+
+
+/**
+ * Start reading the events of a MIDI input in the audio hook.
+ *
+ * @param deviceID The ID of the MIDI input
+ */
+void MidiInputHook::OpenInput(int deviceID)
+{
+	this->activeMidiInputs.insert(deviceID);
+}
+
+
+/**
+ * Stop reading the events of a MIDI input.
+ *
+ * @param deviceID The ID of the MIDI input
+ */
+void MidiInputHook::CloseInput(int deviceID) noexcept
+{
+	this->activeMidiInputs.erase(deviceID);
+}
+
+
+/**
+ * Set the MIDI filters for a note input.
+ *
+ * @param deviceID The ID of the MIDI input to which the note input belongs
+ * @param noteInputIndex The index of the note input to which the filters belong
+ * @param filters The filters, each has 1 (status) or 2 (status and data1) bytes
+ */
+void MidiInputHook::SetFilters(int deviceID, int noteInputIndex, FilterSet filters)
+{
+	if (noteInputIndex < 0 || noteInputIndex >= static_cast<int>(MAX_NOTE_INPUTS))
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->deviceDataMutex);
+	std::shared_ptr<DeviceMap> updated = this->CopyDeviceData();
+	DeviceNoteData& deviceData = (*updated)[deviceID];
+	deviceData.noteInputs[noteInputIndex].filters = std::move(filters);
+	deviceData.BuildFilterLookup();
+	std::atomic_store(&this->deviceDataSnapshot, updated);
+}
+
+
+/**
+ * Set the MIDI key translation table for a note input.
+ *
+ * @param deviceID The ID of the MIDI input to which the note input belongs
+ * @param noteInputIndex The index of the note input to which the table belongs
+ * @param table The translation table
+ */
+void MidiInputHook::SetKeyTranslationTable(int deviceID, int noteInputIndex, const std::array<int, 128>& table)
+{
+	if (noteInputIndex < 0 || noteInputIndex >= static_cast<int>(MAX_NOTE_INPUTS))
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->deviceDataMutex);
+	std::shared_ptr<DeviceMap> updated = this->CopyDeviceData();
+	DeviceNoteData& deviceData = (*updated)[deviceID];
+	deviceData.noteInputs[noteInputIndex].keyTable = table;
+	deviceData.BuildKeyLookup();
+	std::atomic_store(&this->deviceDataSnapshot, updated);
+}
+
+
+/**
+ * Set the MIDI velocity translation table for a note input.
+ *
+ * @param deviceID The ID of the MIDI input to which the note input belongs
+ * @param noteInputIndex The index of the note input to which the table belongs
+ * @param table The translation table
+ */
+void MidiInputHook::SetVelocityTranslationTable(int deviceID, int noteInputIndex, const std::array<int, 128>& table)
+{
+	if (noteInputIndex < 0 || noteInputIndex >= static_cast<int>(MAX_NOTE_INPUTS))
+		return;
+
+	const std::lock_guard<std::mutex> lock(this->deviceDataMutex);
+	std::shared_ptr<DeviceMap> updated = this->CopyDeviceData();
+	DeviceNoteData& deviceData = (*updated)[deviceID];
+	deviceData.noteInputs[noteInputIndex].velocityTable = table;
+	deviceData.BuildVelocityLookup();
+	std::atomic_store(&this->deviceDataSnapshot, updated);
+}
+
+
+/**
+ * Queue a MIDI event which is added to the events of a MIDI input in the next audio buffer.
+ *
+ * @param deviceID The ID of the MIDI input
+ * @param event The event
+ */
+void MidiInputHook::SendToReaper(int deviceID, const MIDI_event_t& event)
+{
+	this->localMidiEventDispatcher.Push(deviceID, event);
+}
+
+
+/**
+ * Reads from the opened MIDI inputs and queues the events to be sent to Java as well as matching
+ * them against the registered note input filters. Events which do not match are removed from the
+ * input. Adds the MIDI events which Java sends to Reaper. Called from the audio hook before the
+ * update of the audio buffer.
+ *
+ * @param surface The surface which sends the events to Java
+ * @param length The length of the buffer (only used by the watchdog)
+ * @param sampleRate The sample rate (only used by the watchdog)
+ */
+void MidiInputHook::OnAudioBuffer(DrivenByMossSurface& surface, int length, double sampleRate)
+{
+	const StageTimer::Scope scope(surface.GetProfiler().GetTimer(Profiler::Timer::AUDIO_BUFFER));
+#ifdef DBM_RT_WATCHDOG
+	const RtWatchdog::Scope watchdogScope(length, sampleRate);
+#endif
+
+	if (this->getMidiInput == nullptr)
+		return;
+
+	for (const auto& deviceID : this->activeMidiInputs)
+	{
+		midi_Input* midiin = this->getMidiInput(deviceID);
+		if (!midiin)
+			continue;
+
+		auto snapshot = std::atomic_load(&this->deviceDataSnapshot);
+		if (!snapshot)
+			continue;
+
+		const auto deviceIt = snapshot->find(deviceID);
+		if (deviceIt == snapshot->end())
+			continue;
+
+		MIDI_eventlist* list = midiin->GetReadBuf();
+		if (!list)
+			continue;
+
+		const auto& deviceData = deviceIt->second;
+
+		int position = 0;
+		int nextPosition = 0;
+		MIDI_event_t* event;
+		// Copy the events out of the audio thread to be sent to the Java side
+		while ((event = list->EnumItems(&nextPosition)) != nullptr)
+		{
+			const int size = event->size;
+			if (size == 0)
+				continue;
+
+			if (size > 3)
+			{
+				if (size < 1024)
+					surface.EnqueueSysex1k(deviceID, event->midi_message, event->size);
+				else
+					surface.EnqueueSysex64k(deviceID, event->midi_message, event->size);
+				continue;
+			}
+
+			const uint8_t status = event->midi_message[0];
+			// Ignore active sensing
+			if (status == 0 || status == 0xFE)
+				continue;
+
+			const uint8_t data1 = (size > 1) ? event->midi_message[1] : 0;
+			const uint8_t data2 = (size > 2) ? event->midi_message[2] : 0;
+			surface.EnqueueMidi3(deviceID, status, data1, data2);
+			// Apply note input filters
+			if (!ProcessMidiEvents(deviceData, event))
+			{
+				list->DeleteItem(position);
+				nextPosition = position;
+			}
+			else
+				position = nextPosition;
+		}
+
+		// Add events to be sent to Reaper
+		this->localMidiEventDispatcher.ProcessDeviceQueue(deviceID, list);
+	}
+}
+
+
+/**
+ * Create a copy of the current snapshot of the device data to be modified. Must be called while
+ * holding the lock.
+ *
+ * @return The copy
+ */
+std::shared_ptr<MidiInputHook::DeviceMap> MidiInputHook::CopyDeviceData()
+{
+	const std::shared_ptr<DeviceMap> current = std::atomic_load(&this->deviceDataSnapshot);
+	if (!current)
+		return std::make_shared<DeviceMap>();
+	return std::make_shared<DeviceMap>(*current);
+}
+
+
+/**
+ * Matches the incoming MIDI event against the registered note input filters.
+ *
+ * @param deviceData The ID of the device to which to match the event
+ * @param event The event to match/filter
+ */
+bool MidiInputHook::ProcessMidiEvents(const DeviceNoteData& deviceData, MIDI_event_t* event) noexcept
+{
+	const unsigned char data1 = event->size > 1 ? event->midi_message[1] : 0;
+	if (data1 >= 128)
+		return false;
+
+	// Do not use gsl:at for performance reasons!
+	DISABLE_WARNING_USE_GSL_AT
+	DISABLE_WARNING_ACCESS_ARRAYS_WITH_CONST
+
+	const unsigned char status = event->midi_message[0];
+	const int statusType = status & 0xF0;
+	const bool isNote = statusType == 0x90 || statusType == 0x80 || statusType == 0xA0;
+
+	for (size_t noteIdx = 0; noteIdx < MAX_NOTE_INPUTS; ++noteIdx)
+	{
+		// Note: to be 100% correct this would require the creation of a new MIDI event since
+		// theoretically multiple note inputs could be present and events could be modified differently
+		// If this becomes a use-case it would need to be implemented with a pre-allocated pool or ring 
+		// buffer of MIDI_event_t
+
+		if (deviceData.filterMatch[noteIdx][status][data1])
+		{
+			if (isNote)
+			{
+				if (deviceData.keyLookup[noteIdx][data1] < 0)
+					continue;
+
+				event->midi_message[1] = deviceData.keyLookup[noteIdx][data1];
+
+				const unsigned char data2 = event->size > 2 ? event->midi_message[2] : 0;
+
+				if (deviceData.velocityLookup[noteIdx][data2] < 0)
+					continue;
+
+				if (data2 >= 128)
+					return false;
+
+				event->midi_message[2] = deviceData.velocityLookup[noteIdx][data2];
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
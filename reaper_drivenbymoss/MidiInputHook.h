@@ -0,0 +1,74 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_MIDIINPUTHOOK_H_
+#define _DBM_MIDIINPUTHOOK_H_
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "LocalMidiEventDispatcher.h"
+#include "MidiProcessingStructures.h"
+
+class DrivenByMossSurface;
+
+
+/**
+ * Handles the MIDI inputs in the audio hook. Reads the events of the opened MIDI inputs, queues
+ * them to be sent to Java, matches them against the note input filters of the device and adds the
+ * events which Java sends to Reaper. The filters and translation tables are set from the main
+ * thread and published as an immutable snapshot, the audio thread only reads the snapshot.
+ */
+class MidiInputHook
+{
+public:
+	/** Reaper's (undocumented) function to get a MIDI input. */
+	using MidiInputFunction = midi_Input* (*)(int idx);
+
+	MidiInputHook() = default;
+	MidiInputHook(const MidiInputHook&) = delete;
+	MidiInputHook& operator=(const MidiInputHook&) = delete;
+	MidiInputHook(MidiInputHook&&) = delete;
+	MidiInputHook& operator=(MidiInputHook&&) = delete;
+	~MidiInputHook() {};
+
+	/**
+	 * Set the function to get the MIDI inputs.
+	 *
+	 * @param function The function
+	 */
+	void SetMidiInputFunction(MidiInputFunction function) noexcept
+	{
+		this->getMidiInput = function;
+	}
+
+	void OpenInput(int deviceID);
+	void CloseInput(int deviceID) noexcept;
+	void SetFilters(int deviceID, int noteInputIndex, FilterSet filters);
+	void SetKeyTranslationTable(int deviceID, int noteInputIndex, const std::array<int, 128>& table);
+	void SetVelocityTranslationTable(int deviceID, int noteInputIndex, const std::array<int, 128>& table);
+	void SendToReaper(int deviceID, const MIDI_event_t& event);
+
+	void OnAudioBuffer(DrivenByMossSurface& surface, int length, double sampleRate);
+
+private:
+	using DeviceMap = std::unordered_map<int, DeviceNoteData>;
+
+	MidiInputFunction getMidiInput{ nullptr };
+	std::set<int> activeMidiInputs;
+
+	// Atomic shared snapshot (lock-free access)
+	std::shared_ptr<DeviceMap> deviceDataSnapshot;
+	std::mutex deviceDataMutex; // only needed for writes, not reads
+
+	// Java to internal Reaper
+	LocalMidiEventDispatcher localMidiEventDispatcher{};
+
+	std::shared_ptr<DeviceMap> CopyDeviceData();
+	static bool ProcessMidiEvents(const DeviceNoteData& deviceData, MIDI_event_t* event) noexcept;
+};
+
+#endif /* _DBM_MIDIINPUTHOOK_H_ */
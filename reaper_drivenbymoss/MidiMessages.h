@@ -16,6 +16,8 @@ struct Midi3 {
     uint8_t  status;   // first byte – 0x8n..0xEn or 0xF8..0xFF
     uint8_t  data1;    // 0 if not used
     uint8_t  data2;    // 0 if not used
+    uint32_t traceId;  // 0 if not traced
+    int64_t  timestamp; // ns when queued, 0 if not traced
 };
 static_assert(std::is_trivially_copyable<Midi3>::value, "");
 
@@ -27,6 +29,8 @@ constexpr jsize kSyx1k_Max = 1'024;
 struct MidiSyx1k {
     uint32_t deviceId;
     uint32_t size;                  // 1 … 1 024
+    uint32_t traceId;               // 0 if not traced
+    int64_t  timestamp;             // ns when queued, 0 if not traced
     uint8_t  data[kSyx1k_Max];
 };
 static_assert(std::is_trivially_copyable<MidiSyx1k>::value, "");
@@ -39,6 +43,8 @@ constexpr jsize kSyx64k_Max = 65'536;
 struct MidiSyx64k {
     uint32_t deviceId;
     uint32_t size;                  // 1 … 65 536
+    uint32_t traceId;               // 0 if not traced
+    int64_t  timestamp;             // ns when queued, 0 if not traced
     uint8_t  data[kSyx64k_Max];
 };
 static_assert(std::is_trivially_copyable<MidiSyx64k>::value, "");
@@ -0,0 +1,500 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+#include "MidiTransform.h"
+
+
+namespace
+{
+	// The size of the offset, flags and length of an event record
+	const std::size_t RECORD_HEADER_SIZE = sizeof(int) + 1 + sizeof(int);
+
+	int Clamp(long value, int minimum, int maximum) noexcept
+	{
+		return static_cast<int>(std::max(static_cast<long>(minimum), std::min(static_cast<long>(maximum), value)));
+	}
+
+	void AppendRecord(std::vector<char>& buffer, int offset, char flags, const std::string& message)
+	{
+		const int length = static_cast<int>(message.size());
+		const std::size_t start = buffer.size();
+		buffer.resize(start + RECORD_HEADER_SIZE);
+		std::memcpy(&buffer[start], &offset, sizeof(int));
+		buffer[start + sizeof(int)] = flags;
+		std::memcpy(&buffer[start + sizeof(int) + 1], &length, sizeof(int));
+		buffer.insert(buffer.end(), message.begin(), message.end());
+	}
+}
+
+
+/**
+ * Add a transposition of all notes. Notes are limited to the range of 0 to 127.
+ *
+ * @param semitones The number of semitones to transpose up or down (negative)
+ * @return This transform
+ */
+MidiTransform& MidiTransform::Transpose(int semitones)
+{
+	this->stages.push_back({ StageType::TRANSPOSE, -1, -1, semitones, 0, 0, 0, 0 });
+	return *this;
+}
+
+
+/**
+ * Add a quantization of the start of all notes. The length of the notes is kept.
+ *
+ * @param origin The position of the first grid line in PPQ
+ * @param grid The distance of the grid lines in PPQ
+ * @param swing Moves every second grid line by up to half of the grid (0..1)
+ * @param strength How far the notes are moved towards the grid (0..1)
+ * @return This transform
+ */
+MidiTransform& MidiTransform::Quantize(double origin, double grid, double swing, double strength)
+{
+	if (grid > 0)
+		this->stages.push_back({ StageType::QUANTIZE, -1, -1, 0, origin, grid, strength, swing });
+	return *this;
+}
+
+
+/**
+ * Add a scaling of the velocity of all notes. Velocities are limited to the range of 1 to 127.
+ *
+ * @param factor The factor to apply to the velocities
+ * @return This transform
+ */
+MidiTransform& MidiTransform::ScaleVelocity(double factor)
+{
+	this->stages.push_back({ StageType::SCALE_VELOCITY, -1, -1, 0, 0, 0, factor, 0 });
+	return *this;
+}
+
+
+/**
+ * Add the deletion of all notes of a channel and pitch.
+ *
+ * @param channel The MIDI channel of the notes, -1 for all channels
+ * @param pitch The pitch of the notes, -1 for all pitches
+ * @return This transform
+ */
+MidiTransform& MidiTransform::DeleteNotes(int channel, int pitch)
+{
+	this->stages.push_back({ StageType::DELETE_NOTES, channel, pitch, 0, 0, 0, 0, 0 });
+	return *this;
+}
+
+
+/**
+ * Add the deletion of a note. If there are several identical notes only the first is deleted.
+ *
+ * @param channel The MIDI channel of the note
+ * @param pitch The pitch of the note
+ * @param position The start of the note in PPQ
+ * @return This transform
+ */
+MidiTransform& MidiTransform::DeleteNote(int channel, int pitch, double position)
+{
+	this->stages.push_back({ StageType::DELETE_NOTE, channel, pitch, 0, position, 0, 0, 0 });
+	return *this;
+}
+
+
+/**
+ * Add the insertion of a note. The note is not affected by the transformations added afterwards.
+ *
+ * @param channel The MIDI channel of the note
+ * @param pitch The pitch of the note
+ * @param velocity The velocity of the note
+ * @param position The start of the note in PPQ
+ * @param length The length of the note in PPQ
+ * @return This transform
+ */
+MidiTransform& MidiTransform::InsertNote(int channel, int pitch, int velocity, double position, double length)
+{
+	this->stages.push_back({ StageType::INSERT_NOTE, channel, pitch, velocity, position, length, 0, 0 });
+	return *this;
+}
+
+
+/**
+ * Apply all transformations to a MIDI take.
+ *
+ * @param take The take
+ * @return True if the events of the take were changed
+ */
+bool MidiTransform::Apply(MediaItem_Take* take)
+{
+	if (take == nullptr || !TakeIsMIDI(take) || this->stages.empty())
+		return false;
+
+	std::vector<char> buffer(INITIAL_BUFFER_SIZE);
+	for (;;)
+	{
+		int size = static_cast<int>(buffer.size());
+		if (MIDI_GetAllEvts(take, buffer.data(), &size) && size >= 0 && size < static_cast<int>(buffer.size()))
+		{
+			buffer.resize(size);
+			break;
+		}
+		if (static_cast<int>(buffer.size()) >= MAX_BUFFER_SIZE)
+			return false;
+		buffer.resize(std::min(MAX_BUFFER_SIZE, std::max(size, static_cast<int>(buffer.size()) * 2)));
+	}
+
+	if (!this->Apply(buffer))
+		return false;
+	return MIDI_SetAllEvts(take, buffer.data(), static_cast<int>(buffer.size()));
+}
+
+
+/**
+ * Apply all transformations to a buffer in the format of MIDI_GetAllEvts.
+ *
+ * @param buffer The events, contains the transformed events afterwards
+ * @return True if the events were changed, false if not or if the buffer could not be decoded
+ */
+bool MidiTransform::Apply(std::vector<char>& buffer)
+{
+	if (!this->Decode(buffer))
+		return false;
+
+	// The final all-notes-off marks the end of the source and must stay behind all other events
+	const std::size_t endIndex = !this->events.empty() && IsEndOfSource(this->events.back()) ? this->events.size() - 1 : this->events.size();
+
+	this->isChanged = false;
+	this->needsSort = false;
+	this->Pair();
+	for (const Stage& stage : this->stages)
+		this->ApplyStage(stage);
+	if (!this->isChanged)
+		return false;
+
+	if (this->needsSort)
+	{
+		auto last = this->events.end();
+		if (endIndex < this->events.size())
+		{
+			// Inserted notes were added after it
+			const auto end = this->events.begin() + static_cast<std::ptrdiff_t>(endIndex);
+			std::rotate(end, end + 1, this->events.end());
+			--last;
+		}
+		std::stable_sort(this->events.begin(), last, [](const Event& a, const Event& b)
+			{
+				return a.position < b.position || (a.position == b.position && GetOrder(a) < GetOrder(b));
+			});
+	}
+	this->Encode(buffer);
+	return true;
+}
+
+
+/**
+ * Decode the events of a buffer. Positions are converted from relative to absolute. Records which
+ * only span long intervals are dropped, bezier data is attached to the preceding event.
+ *
+ * @param buffer The buffer in the format of MIDI_GetAllEvts
+ * @return False if the buffer is malformed
+ */
+bool MidiTransform::Decode(const std::vector<char>& buffer)
+{
+	this->events.clear();
+
+	const char* data = buffer.data();
+	const std::size_t size = buffer.size();
+	std::size_t index{ 0 };
+	long long position{ 0 };
+	while (index < size)
+	{
+		if (size - index < RECORD_HEADER_SIZE)
+			return false;
+		int offset{ 0 };
+		int length{ 0 };
+		DISABLE_WARNING_NO_POINTER_ARITHMETIC
+		std::memcpy(&offset, data + index, sizeof(int));
+		const char flags = buffer[index + sizeof(int)];
+		DISABLE_WARNING_NO_POINTER_ARITHMETIC
+		std::memcpy(&length, data + index + sizeof(int) + 1, sizeof(int));
+		const std::size_t start = index;
+		index += RECORD_HEADER_SIZE;
+		if (length < 0 || size - index < static_cast<std::size_t>(length))
+			return false;
+
+		position += offset;
+		DISABLE_WARNING_NO_POINTER_ARITHMETIC
+		const char* message = data + index;
+		index += length;
+		if (length == 0)
+			continue;
+
+		// Meta event 0x0F with 'CCBZ' contains the bezier curve of the previous event
+		if (length > 6 && static_cast<unsigned char>(message[0]) == 0xFF && message[1] == 0x0F && std::strncmp(message + 2, "CCBZ", 4) == 0 && !this->events.empty())
+		{
+			std::string& attached = this->events.back().attached;
+			const std::size_t attachedStart = attached.size();
+			DISABLE_WARNING_NO_POINTER_ARITHMETIC
+			attached.append(data + start, index - start);
+			// Always directly follows its event
+			std::memset(&attached[attachedStart], 0, sizeof(int));
+			continue;
+		}
+
+		this->events.push_back({ position, flags, std::string(message, length), std::string(), -1, false });
+	}
+	return true;
+}
+
+
+/**
+ * Encode all events which are not deleted. Positions must be sorted.
+ *
+ * @param buffer The buffer to fill in the format of MIDI_SetAllEvts
+ */
+void MidiTransform::Encode(std::vector<char>& buffer) const
+{
+	buffer.clear();
+
+	const std::string empty;
+	long long lastPosition{ 0 };
+	for (const Event& event : this->events)
+	{
+		if (event.isDeleted)
+			continue;
+		const long long position = std::max(lastPosition, event.position);
+		long long offset = position - lastPosition;
+		// Add empty events if the interval does not fit into the offset
+		while (offset > INT_MAX)
+		{
+			AppendRecord(buffer, INT_MAX, 0, empty);
+			offset -= INT_MAX;
+		}
+		AppendRecord(buffer, static_cast<int>(offset), event.flags, event.message);
+		buffer.insert(buffer.end(), event.attached.begin(), event.attached.end());
+		lastPosition = position;
+	}
+}
+
+
+/**
+ * Find the note-off of each note-on. Like in Reaper the first note-off of the same channel and
+ * pitch ends the earliest open note.
+ */
+void MidiTransform::Pair()
+{
+	std::unordered_map<int, std::deque<int>> openNotes;
+	const int size = static_cast<int>(this->events.size());
+	for (int i = 0; i < size; i++)
+	{
+		Event& event = this->events[i];
+		if (!IsNote(event))
+			continue;
+		const int key = (static_cast<unsigned char>(event.message[0]) & 0x0F) * 128 + (event.message[1] & 0x7F);
+		std::deque<int>& open = openNotes[key];
+		if (IsNoteOn(event))
+			open.push_back(i);
+		else if (!open.empty())
+		{
+			event.partner = open.front();
+			this->events[open.front()].partner = i;
+			open.pop_front();
+		}
+	}
+}
+
+
+/**
+ * Apply one transformation to all events.
+ *
+ * @param stage The transformation
+ */
+void MidiTransform::ApplyStage(const Stage& stage)
+{
+	switch (stage.type)
+	{
+	case StageType::TRANSPOSE:
+		if (stage.value == 0)
+			return;
+		for (Event& event : this->events)
+		{
+			const int status = static_cast<unsigned char>(event.message[0]) & 0xF0;
+			// Includes polyphonic aftertouch
+			if (event.isDeleted || event.message.size() < 3 || status < 0x80 || status > 0xA0)
+				continue;
+			event.message[1] = static_cast<char>(Clamp(static_cast<long>(event.message[1] & 0x7F) + stage.value, 0, 127));
+			this->isChanged = true;
+		}
+		break;
+
+	case StageType::SCALE_VELOCITY:
+		for (Event& event : this->events)
+		{
+			if (event.isDeleted || !IsNoteOn(event))
+				continue;
+			event.message[2] = static_cast<char>(Clamp(std::lround((event.message[2] & 0x7F) * stage.factor), 1, 127));
+			this->isChanged = true;
+		}
+		break;
+
+	case StageType::DELETE_NOTES:
+	case StageType::DELETE_NOTE:
+	{
+		const long long position = std::llround(stage.position);
+		for (Event& event : this->events)
+		{
+			if (event.isDeleted || !IsNoteOn(event))
+				continue;
+			if (stage.channel >= 0 && (static_cast<unsigned char>(event.message[0]) & 0x0F) != stage.channel)
+				continue;
+			if (stage.pitch >= 0 && (event.message[1] & 0x7F) != stage.pitch)
+				continue;
+			if (stage.type == StageType::DELETE_NOTE && event.position != position)
+				continue;
+			event.isDeleted = true;
+			if (event.partner >= 0)
+				this->events[event.partner].isDeleted = true;
+			this->isChanged = true;
+			if (stage.type == StageType::DELETE_NOTE)
+				break;
+		}
+		break;
+	}
+
+	case StageType::QUANTIZE:
+		this->Quantize(stage);
+		break;
+
+	case StageType::INSERT_NOTE:
+		this->InsertNote(stage);
+		break;
+	}
+}
+
+
+/**
+ * Move the start of all notes towards the grid. The note-offs are moved by the same distance.
+ *
+ * @param stage The quantize transformation
+ */
+void MidiTransform::Quantize(const Stage& stage)
+{
+	const double origin = stage.position;
+	const double grid = stage.length;
+	const double strength = std::max(0.0, std::min(1.0, stage.factor));
+	const double swing = std::max(0.0, std::min(1.0, stage.swing)) * grid / 2.0;
+
+	for (Event& event : this->events)
+	{
+		if (event.isDeleted || !IsNoteOn(event))
+			continue;
+
+		const double line = std::round((event.position - origin) / grid);
+		double target = origin + line * grid;
+		if (std::fmod(std::abs(line), 2.0) == 1.0)
+			target += swing;
+		const long long delta = std::llround((target - event.position) * strength);
+		if (delta == 0)
+			continue;
+
+		event.position = std::max(0LL, event.position + delta);
+		if (event.partner >= 0)
+		{
+			Event& noteOff = this->events[event.partner];
+			noteOff.position = std::max(event.position, noteOff.position + delta);
+		}
+		this->isChanged = true;
+		this->needsSort = true;
+	}
+}
+
+
+/**
+ * Add the note-on and note-off of a new note.
+ *
+ * @param stage The insert transformation
+ */
+void MidiTransform::InsertNote(const Stage& stage)
+{
+	const char channel = static_cast<char>(stage.channel & 0x0F);
+	const char pitch = static_cast<char>(Clamp(stage.pitch, 0, 127));
+	const char velocity = static_cast<char>(Clamp(stage.value, 1, 127));
+	const long long start = std::max(0LL, std::llround(stage.position));
+	const long long end = std::max(start, std::llround(stage.position + stage.length));
+
+	const int index = static_cast<int>(this->events.size());
+	this->events.push_back({ start, 0, std::string{ static_cast<char>(0x90 | channel), pitch, velocity }, std::string(), index + 1, false });
+	this->events.push_back({ end, 0, std::string{ static_cast<char>(0x80 | channel), pitch, 0 }, std::string(), index, false });
+	this->isChanged = true;
+	this->needsSort = true;
+}
+
+
+/**
+ * Check if an event is a note-on. Note-ons with a velocity of 0 are note-offs.
+ *
+ * @param event The event
+ * @return True if it is a note-on
+ */
+bool MidiTransform::IsNoteOn(const Event& event) noexcept
+{
+	return event.message.size() >= 3 && (static_cast<unsigned char>(event.message[0]) & 0xF0) == 0x90 && event.message[2] != 0;
+}
+
+
+/**
+ * Check if an event is a note-off.
+ *
+ * @param event The event
+ * @return True if it is a note-off
+ */
+bool MidiTransform::IsNoteOff(const Event& event) noexcept
+{
+	if (event.message.size() < 3)
+		return false;
+	const int status = static_cast<unsigned char>(event.message[0]) & 0xF0;
+	return status == 0x80 || (status == 0x90 && event.message[2] == 0);
+}
+
+
+/**
+ * Check if an event is a note-on or note-off.
+ *
+ * @param event The event
+ * @return True if it is a note event
+ */
+bool MidiTransform::IsNote(const Event& event) noexcept
+{
+	return IsNoteOn(event) || IsNoteOff(event);
+}
+
+
+/**
+ * Check if an event is the all-notes-off controller which Reaper adds at the end of a source.
+ *
+ * @param event The event
+ * @return True if it is an all-notes-off
+ */
+bool MidiTransform::IsEndOfSource(const Event& event) noexcept
+{
+	return event.message.size() >= 3 && (static_cast<unsigned char>(event.message[0]) & 0xF0) == 0xB0 && event.message[1] == 123;
+}
+
+
+/**
+ * Get the order of events at the same position. Notes are ended before new ones start.
+ *
+ * @param event The event
+ * @return The order, lower values come first
+ */
+int MidiTransform::GetOrder(const Event& event) noexcept
+{
+	if (IsNoteOff(event))
+		return 0;
+	return IsNoteOn(event) ? 2 : 1;
+}
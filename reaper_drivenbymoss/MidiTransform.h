@@ -0,0 +1,109 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_MIDITRANSFORM_H_
+#define _DBM_MIDITRANSFORM_H_
+
+#include <string>
+#include <vector>
+
+#include "ReaperUtils.h"
+
+
+/**
+ * Edits all notes of a MIDI take in one pass. The events of the take are read at once with
+ * MIDI_GetAllEvts, the added transformations are applied in the order in which they were added
+ * and the result is written back with one call to MIDI_SetAllEvts. Positions are in PPQ of the
+ * take. Note-on and note-off events of a note are always changed together.
+ */
+class MidiTransform
+{
+public:
+	MidiTransform() = default;
+	MidiTransform(const MidiTransform&) = delete;
+	MidiTransform& operator=(const MidiTransform&) = delete;
+	MidiTransform(MidiTransform&&) = delete;
+	MidiTransform& operator=(MidiTransform&&) = delete;
+	~MidiTransform() {};
+
+	MidiTransform& Transpose(int semitones);
+	MidiTransform& Quantize(double origin, double grid, double swing, double strength);
+	MidiTransform& ScaleVelocity(double factor);
+	MidiTransform& DeleteNotes(int channel, int pitch);
+	MidiTransform& DeleteNote(int channel, int pitch, double position);
+	MidiTransform& InsertNote(int channel, int pitch, int velocity, double position, double length);
+
+	bool Apply(MediaItem_Take* take);
+	bool Apply(std::vector<char>& buffer);
+
+	/**
+	 * Check if there are no transformations.
+	 *
+	 * @return True if there are none
+	 */
+	bool IsEmpty() const noexcept
+	{
+		return this->stages.empty();
+	}
+
+private:
+	/** The initial size of the buffer for reading the events of a take. */
+	static const int INITIAL_BUFFER_SIZE{ 64 * 1024 };
+	/** Takes with more events are not edited. */
+	static const int MAX_BUFFER_SIZE{ 256 * 1024 * 1024 };
+
+	enum class StageType
+	{
+		TRANSPOSE,
+		QUANTIZE,
+		SCALE_VELOCITY,
+		DELETE_NOTES,
+		DELETE_NOTE,
+		INSERT_NOTE
+	};
+
+	// One transformation, the meaning of the values depends on the type
+	struct Stage
+	{
+		StageType type;
+		int channel;
+		int pitch;
+		int value;
+		double position;
+		double length;
+		double factor;
+		double swing;
+	};
+
+	struct Event
+	{
+		long long position;
+		char flags;
+		std::string message;
+		// Further records which belong to this event, e.g. the bezier data of a CC
+		std::string attached;
+		// The index of the note-off of a note-on and vice versa, -1 if none
+		int partner;
+		bool isDeleted;
+	};
+
+	std::vector<Stage> stages;
+	std::vector<Event> events;
+	bool isChanged{ false };
+	bool needsSort{ false };
+
+	bool Decode(const std::vector<char>& buffer);
+	void Encode(std::vector<char>& buffer) const;
+	void Pair();
+	void ApplyStage(const Stage& stage);
+	void Quantize(const Stage& stage);
+	void InsertNote(const Stage& stage);
+
+	static bool IsNoteOn(const Event& event) noexcept;
+	static bool IsNoteOff(const Event& event) noexcept;
+	static bool IsNote(const Event& event) noexcept;
+	static bool IsEndOfSource(const Event& event) noexcept;
+	static int GetOrder(const Event& event) noexcept;
+};
+
+#endif /* _DBM_MIDITRANSFORM_H_ */
@@ -34,27 +34,13 @@ bool Model::ShouldDump()
 	return d;
 }
 
-void Model::AddFunction(std::function<void(void)> f)
+/**
+ * Logs that a function could not be added for execution.
+ */
+void Model::LogAddFunctionError() noexcept
 {
-	try
-	{
-		functionExecutor.AddFunction(f);
-	}
-	catch (const std::exception& ex)
-	{
-		ReaDebug::Log("Could not add function. Cause: ");
-		ReaDebug::Log(ex.what());
-		ReaDebug::Log("\n");
-	}
-	catch (const std::string& ex)
-	{
-		ReaDebug::Log("Could not add function. Cause: " + ex + "\n");
-	}
-	catch (...)
-	{
-		ReaDebug::Log("Could not add function.\n");
-	}
-};
+	ReaDebug::Log("Could not add function.\n");
+}
 
 
 /**
@@ -7,10 +7,13 @@
 #include <vector>
 #include <mutex>
 
+#include "CommandCapture.h"
 #include "FunctionExecutor.h"
 #include "Marker.h"
 #include "Track.h"
 #include "Parameter.h"
+#include "TrackIndexMap.h"
+#include "UndoBatch.h"
 
 
 /**
@@ -42,6 +45,15 @@ public:
 
 	int pinnedTrackIndex{ -1 };
 
+	// The time in milliseconds a dump may take per update before it is continued with the next one, 0 for no limit
+	int dumpBudget{ 10 };
+	// The time in milliseconds which deferrable commands may take per update, 0 for no limit
+	int executionBudget{ 15 };
+	// The interval in seconds in which the statistics are written to the Reaper console, 0 to disable
+	int statisticsInterval{ 0 };
+	// Measure the latency of the MIDI messages
+	bool midiTracing{ false };
+
 
 	explicit Model(FunctionExecutor& aFunctionExecutor) noexcept;
 	Model(const Model&) = delete;
@@ -51,7 +63,28 @@ public:
 	virtual ~Model() = default;
 
 
-	void AddFunction(std::function<void(void)> f);
+	/**
+	 * Add a function which will be executed on the main thread.
+	 *
+	 * @param f The function to execute
+	 * @param isBatched True to execute the function as part of an undo batch
+	 * @param isDeferrable True if the function can be executed on the next update if the time
+	 *        budget is used up
+	 * @param dependency Functions with the same dependency keep their order, null for none
+	 */
+	template<typename F>
+	void AddFunction(F&& f, bool isBatched = false, bool isDeferrable = false, const void* dependency = nullptr) noexcept
+	{
+		try
+		{
+			this->functionExecutor.AddFunction(std::forward<F>(f), isBatched, isDeferrable, dependency);
+		}
+		catch (...)
+		{
+			// Cannot use ReaDebug here since it would add a function as well
+			LogAddFunctionError();
+		}
+	}
 
 	std::unique_ptr<Track>& GetTrack(const int index);
 	std::unique_ptr<Marker>& GetMarker(const int index);
@@ -68,8 +101,31 @@ public:
 	int GetDeviceSelection() noexcept;
 	void SetDeviceSelection(int position) noexcept;
 
+	FunctionExecutor& GetFunctionExecutor() noexcept
+	{
+		return this->functionExecutor;
+	}
+
+	UndoBatch& GetUndoBatch() noexcept
+	{
+		return this->undoBatch;
+	}
+
+	TrackIndexMap& GetTrackIndexMap() noexcept
+	{
+		return this->trackIndexMap;
+	}
+
+	CommandCapture& GetCommandCapture() noexcept
+	{
+		return this->commandCapture;
+	}
+
 private:
 	FunctionExecutor& functionExecutor;
+	UndoBatch undoBatch;
+	TrackIndexMap trackIndexMap;
+	CommandCapture commandCapture;
 	std::vector<std::unique_ptr<Track>> tracks;
 	std::vector<std::unique_ptr<Marker>> markers;
 	std::vector<std::unique_ptr<Marker>> regions;
@@ -84,6 +140,8 @@ private:
 	std::mutex parameterlock;
 	std::mutex dumplock;
 	bool dump{ false };
+
+	static void LogAddFunctionError() noexcept;
 };
 
 #endif /* _DBM_MODEL_H_ */
@@ -0,0 +1,152 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "ModelSnapshot.h"
+
+
+namespace
+{
+	/**
+	 * Call the handler for each line of collected data with the format 'address value'. Events
+	 * which must not be repeated (action selection) and dump markers are skipped.
+	 *
+	 * @param data The collected data
+	 * @param handler Called with the address and the line including the line separator
+	 */
+	template<typename Handler>
+	void ForEachLine(const std::string& data, Handler handler)
+	{
+		std::size_t start = 0;
+		while (start < data.length())
+		{
+			std::size_t end = data.find('\n', start);
+			if (end == std::string::npos)
+				end = data.length();
+
+			if (end > start && data.compare(start, 8, "/action/") != 0 && data.compare(start, 6, "/dump/") != 0)
+			{
+				const std::size_t separator = data.find(' ', start);
+				const std::size_t addressEnd = separator == std::string::npos || separator > end ? end : separator;
+				handler(data.substr(start, addressEnd - start), data.substr(start, end - start + 1));
+			}
+
+			start = end + 1;
+		}
+	}
+}
+
+
+/**
+ * Apply the lines of a collection pass to the snapshot.
+ *
+ * @param data The collected data
+ */
+void ModelSnapshot::Update(const std::string& data)
+{
+	ForEachLine(data, [this](std::string&& address, std::string&& line)
+		{
+			const auto it = this->addressIndex.find(address);
+			if (it == this->addressIndex.end())
+			{
+				this->addressIndex.emplace(std::move(address), this->lines.size());
+				this->size += line.length();
+				this->lines.push_back(std::move(line));
+			}
+			else
+			{
+				std::string& existing = this->lines.at(it->second);
+				this->size = this->size - existing.length() + line.length();
+				existing = std::move(line);
+			}
+		});
+}
+
+
+/**
+ * Append the changes of a collection pass to the journal, if the snapshot is complete. If the
+ * journal grows too large, it is applied to the snapshot first, which keeps only the last value
+ * of each address.
+ *
+ * @param data The collected data
+ */
+void ModelSnapshot::Append(const std::string& data)
+{
+	if (!this->isComplete)
+		return;
+	if (this->journal.length() + data.length() > MAX_JOURNAL_SIZE)
+		this->ApplyJournal();
+	this->journal.append(data);
+}
+
+
+/**
+ * Apply the changes of the journal to the snapshot.
+ */
+void ModelSnapshot::ApplyJournal()
+{
+	this->Update(this->journal);
+	this->journal.clear();
+}
+
+
+/**
+ * Format all values of the snapshot. Applies the journal first.
+ *
+ * @return The formatted data in OSC style separated by line separators
+ */
+std::string ModelSnapshot::Serialize()
+{
+	this->ApplyJournal();
+
+	std::string result;
+	result.reserve(this->size);
+	for (const std::string& line : this->lines)
+	{
+		result.append(line);
+		if (result.back() != '\n')
+			result.push_back('\n');
+	}
+	return result;
+}
+
+
+/**
+ * Remove all values.
+ */
+void ModelSnapshot::Clear() noexcept
+{
+	this->journal.clear();
+	this->lines.clear();
+	this->addressIndex.clear();
+	this->size = 0;
+	this->isComplete = false;
+}
+
+
+/**
+ * Compare the snapshot with the data of a dump. The journal must have been applied.
+ *
+ * @param data The data of a dump which was collected from Reaper
+ * @param firstDifference Set to the address of the first difference
+ * @return The number of addresses which are missing on one of the sides or have different values
+ */
+std::size_t ModelSnapshot::Compare(const std::string& data, std::string& firstDifference) const
+{
+	std::size_t differences{ 0 };
+	std::size_t found{ 0 };
+	ForEachLine(data, [&](std::string&& address, std::string&& line)
+		{
+			const auto it = this->addressIndex.find(address);
+			if (it != this->addressIndex.end())
+			{
+				found++;
+				const std::string& existing = this->lines.at(it->second);
+				if (existing.compare(0, existing.length() - (existing.back() == '\n' ? 1 : 0), line, 0, line.length() - (line.back() == '\n' ? 1 : 0)) == 0)
+					return;
+			}
+			if (differences++ == 0)
+				firstDifference = address;
+		});
+	// Addresses which are only in the snapshot
+	return differences + this->lines.size() - found;
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_MODELSNAPSHOT_H_
+#define _DBM_MODELSNAPSHOT_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * Keeps the last value which was sent for each address. This is the state which the Java side
+ * knows about and allows to send a full dump without querying Reaper again.
+ *
+ * The snapshot is filled from the data of a dump. The changes which are sent afterwards are only
+ * appended to a journal, which is applied when the snapshot is serialized or when the journal grows
+ * too large. Therefore, the size of the snapshot is bounded by the number of addresses of the model.
+ */
+class ModelSnapshot
+{
+public:
+	ModelSnapshot() = default;
+	ModelSnapshot(const ModelSnapshot&) = delete;
+	ModelSnapshot& operator=(const ModelSnapshot&) = delete;
+	ModelSnapshot(ModelSnapshot&&) = delete;
+	ModelSnapshot& operator=(ModelSnapshot&&) = delete;
+	~ModelSnapshot() {};
+
+	void Update(const std::string& data);
+	void Append(const std::string& data);
+	std::string Serialize();
+	void Clear() noexcept;
+	std::size_t Compare(const std::string& data, std::string& firstDifference) const;
+
+	/**
+	 * Check if the snapshot contains the full state, which is the case after a dump was sent completely.
+	 *
+	 * @return True if complete
+	 */
+	bool IsComplete() const noexcept
+	{
+		return this->isComplete;
+	}
+
+	/**
+	 * Mark the snapshot as containing the full state.
+	 */
+	void SetComplete() noexcept
+	{
+		this->isComplete = true;
+	}
+
+private:
+	/** The maximum size of the journal before it is applied to the snapshot. */
+	static const std::size_t MAX_JOURNAL_SIZE{ 4 * 1024 * 1024 };
+
+	void ApplyJournal();
+
+	bool isComplete{ false };
+	// The changes since the snapshot was complete, not yet applied
+	std::string journal;
+	std::size_t size{ 0 };
+	// The lines in the order in which the addresses were sent first
+	std::vector<std::string> lines;
+	std::unordered_map<std::string, std::size_t> addressIndex;
+};
+
+#endif /* _DBM_MODELSNAPSHOT_H_ */
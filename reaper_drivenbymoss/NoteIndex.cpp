@@ -0,0 +1,130 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+
+#include "NoteIndex.h"
+
+
+/**
+ * Get the index of a note of a certain pitch and position. If there are several notes within
+ * the resolution, the one with the lowest index is returned.
+ *
+ * @param take The MIDI take
+ * @param channel The MIDI channel of the note
+ * @param pitch The pitch of the note
+ * @param position The position of the note in PPQ
+ * @return The index of the note or -1 if not found
+ */
+int NoteIndex::Find(MediaItem_Take* take, int channel, int pitch, double position)
+{
+	const TakeNotes& takeNotes = this->GetNotes(take);
+	const Note first{ position - POSITION_RESOLUTION, 0, static_cast<std::uint8_t>(channel), static_cast<std::uint8_t>(pitch) };
+	auto it = std::lower_bound(takeNotes.notes.cbegin(), takeNotes.notes.cend(), first, [](const Note& a, const Note& b)
+		{
+			return std::tie(a.channel, a.pitch, a.position) < std::tie(b.channel, b.pitch, b.position);
+		});
+
+	int result{ -1 };
+	for (; it != takeNotes.notes.cend() && it->channel == channel && it->pitch == pitch && it->position < position + POSITION_RESOLUTION; ++it)
+	{
+		if (std::abs(it->position - position) < POSITION_RESOLUTION && (result < 0 || it->id < result))
+			result = it->id;
+	}
+	return result;
+}
+
+
+/**
+ * Get the indices of all notes of a channel which start at a certain position. If there are
+ * several notes with the same pitch only the one with the lowest index is included.
+ *
+ * @param take The MIDI take
+ * @param channel The MIDI channel of the notes
+ * @param position The position of the notes in PPQ
+ * @return The indices of the notes in descending order, which allows to delete them one by one
+ */
+std::vector<int> NoteIndex::FindAll(MediaItem_Take* take, int channel, double position)
+{
+	const TakeNotes& takeNotes = this->GetNotes(take);
+	const Note first{ position - POSITION_RESOLUTION, 0, static_cast<std::uint8_t>(channel), 0 };
+	auto it = std::lower_bound(takeNotes.positions.cbegin(), takeNotes.positions.cend(), first, [](const Note& a, const Note& b)
+		{
+			return std::tie(a.channel, a.position) < std::tie(b.channel, b.position);
+		});
+
+	std::array<int, 128> pitches;
+	pitches.fill(-1);
+	for (; it != takeNotes.positions.cend() && it->channel == channel && it->position < position + POSITION_RESOLUTION; ++it)
+	{
+		int& id = pitches.at(it->pitch);
+		if (std::abs(it->position - position) < POSITION_RESOLUTION && (id < 0 || it->id < id))
+			id = it->id;
+	}
+
+	std::vector<int> ids;
+	for (const int id : pitches)
+	{
+		if (id >= 0)
+			ids.push_back(id);
+	}
+	std::sort(ids.rbegin(), ids.rend());
+	return ids;
+}
+
+
+/**
+ * Get the index of the notes of a take. The notes are read again if they changed.
+ *
+ * @param take The MIDI take
+ * @return The index of the notes
+ */
+const NoteIndex::TakeNotes& NoteIndex::GetNotes(MediaItem_Take* take)
+{
+	char hash[128]{};
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	if (!MIDI_GetHash(take, true, hash, sizeof(hash)))
+		hash[0] = 0;
+
+	// Do not keep the index of takes which are no longer edited
+	if (this->takes.size() >= MAX_TAKES && this->takes.find(take) == this->takes.end())
+		this->takes.clear();
+
+	TakeNotes& takeNotes = this->takes[take];
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	const std::string currentHash{ hash };
+	if (!currentHash.empty() && takeNotes.hash == currentHash)
+		return takeNotes;
+
+	takeNotes.hash = currentHash;
+	takeNotes.notes.clear();
+	takeNotes.positions.clear();
+
+	int noteCount{ 0 };
+	if (MIDI_CountEvts(take, &noteCount, nullptr, nullptr) == 0)
+		return takeNotes;
+
+	int midiChannel{ 0 };
+	int notePitch{ 0 };
+	double startppqpos{ -1 };
+	takeNotes.notes.reserve(noteCount);
+	for (int id = 0; id < noteCount; id++)
+	{
+		if (MIDI_GetNote(take, id, nullptr, nullptr, &startppqpos, nullptr, &midiChannel, &notePitch, nullptr))
+			takeNotes.notes.push_back({ startppqpos, id, static_cast<std::uint8_t>(midiChannel & 0x0F), static_cast<std::uint8_t>(notePitch & 0x7F) });
+	}
+
+	takeNotes.positions = takeNotes.notes;
+	std::sort(takeNotes.notes.begin(), takeNotes.notes.end(), [](const Note& a, const Note& b)
+		{
+			return std::tie(a.channel, a.pitch, a.position, a.id) < std::tie(b.channel, b.pitch, b.position, b.id);
+		});
+	std::sort(takeNotes.positions.begin(), takeNotes.positions.end(), [](const Note& a, const Note& b)
+		{
+			return std::tie(a.channel, a.position, a.id) < std::tie(b.channel, b.position, b.id);
+		});
+	return takeNotes;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_NOTEINDEX_H_
+#define _DBM_NOTEINDEX_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ReaperUtils.h"
+
+
+/**
+ * Finds the index of a note in a MIDI take by its channel, pitch and start position without
+ * scanning all notes. The notes are kept sorted and found by a binary search, positions which
+ * differ less than POSITION_RESOLUTION are equal. The notes of a take are only read again if the
+ * MIDI hash of the take changed. Must only be used from the main thread.
+ */
+class NoteIndex
+{
+public:
+	NoteIndex() = default;
+	NoteIndex(const NoteIndex&) = delete;
+	NoteIndex& operator=(const NoteIndex&) = delete;
+	NoteIndex(NoteIndex&&) = delete;
+	NoteIndex& operator=(NoteIndex&&) = delete;
+	~NoteIndex() {};
+
+	int Find(MediaItem_Take* take, int channel, int pitch, double position);
+	std::vector<int> FindAll(MediaItem_Take* take, int channel, double position);
+
+private:
+	/** The maximum number of takes for which an index is kept. */
+	static const std::size_t MAX_TAKES{ 16 };
+	/** Positions which differ less are considered equal. */
+	static constexpr double POSITION_RESOLUTION{ 0.0001 };
+
+	struct Note
+	{
+		double position;
+		int id;
+		std::uint8_t channel;
+		std::uint8_t pitch;
+	};
+
+	struct TakeNotes
+	{
+		std::string hash;
+		// Sorted by channel, pitch, position and index
+		std::vector<Note> notes;
+		// Sorted by channel, position and index
+		std::vector<Note> positions;
+	};
+
+	std::unordered_map<MediaItem_Take*, TakeNotes> takes;
+
+	const TakeNotes& GetNotes(MediaItem_Take* take);
+};
+
+#endif /* _DBM_NOTEINDEX_H_ */
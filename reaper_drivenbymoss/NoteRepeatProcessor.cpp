@@ -21,7 +21,7 @@ NoteRepeatProcessor::NoteRepeatProcessor(Model& aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void NoteRepeatProcessor::Process(std::deque<std::string>& path, int value) noexcept
+void NoteRepeatProcessor::Process(const OscPath& path, int value) noexcept
 {
 	if (path.empty())
 		return;
@@ -44,7 +44,7 @@ void NoteRepeatProcessor::Process(std::deque<std::string>& path, int value) noex
 
 
 /** {@inheritDoc} */
-void NoteRepeatProcessor::Process(std::deque<std::string>& path, double value) noexcept
+void NoteRepeatProcessor::Process(const OscPath& path, double value) noexcept
 {
 	if (path.empty())
 		return;
@@ -54,31 +54,35 @@ void NoteRepeatProcessor::Process(std::deque<std::string>& path, double value) n
 	if (!track)
 		return;
 
-	const char* cmd = SafeGet(path, 0);
-
-	if (std::strcmp(cmd, "rate") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("rate"):
 	{
 		this->SetParameter(project, track, NoteRepeatProcessor::MIDI_ARP_PARAM_RATE, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "notelength") == 0)
+	case OscPath::Hash("notelength"):
 	{
 		this->SetParameter(project, track, NoteRepeatProcessor::MIDI_ARP_PARAM_NOTE_LENGTH, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "mode") == 0)
+	case OscPath::Hash("mode"):
 	{
 		this->SetParameter(project, track, NoteRepeatProcessor::MIDI_ARP_PARAM_MODE, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "velocity") == 0)
+	case OscPath::Hash("velocity"):
 	{
 		this->SetParameter(project, track, NoteRepeatProcessor::MIDI_ARP_PARAM_VELOCITY, static_cast<int> (value) == 0 ? 127 : 0);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
@@ -26,12 +26,17 @@ public:
 	NoteRepeatProcessor& operator=(NoteRepeatProcessor&&) = delete;
 	virtual ~NoteRepeatProcessor() = default;
 
-	void Process(std::deque<std::string>& path, int value) noexcept override;
-	void Process(std::deque<std::string>& path, double value) noexcept override;
+	void Process(const OscPath& path, int value) noexcept override;
+	void Process(const OscPath& path, double value) noexcept override;
 
-	void Process(std::deque<std::string>& path) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
 
 private:
 	void EnableRepeatPlugin(ReaProject* project, MediaTrack* track, bool enable) const noexcept;
@@ -1,10 +1,20 @@
 // Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
 // Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
 
+#include <algorithm>
+#include <cstring>
+
 #include "OscParser.h"
 #include "ReaDebug.h"
 
 
+namespace
+{
+	/** The dependency of all commands which change the project or depend on its changes. */
+	const char PROJECT_DEPENDENCY{ 0 };
+}
+
+
 /**
 * Constructor.
 *
@@ -33,6 +43,7 @@ OscParser::OscParser(Model& model) :
 	clipProcessor(model),
 	markerProcessor(model),
 	refreshProcessor(model),
+	captureProcessor(model),
 	sceneProcessor(model),
 	grooveProcessor(model),
 	iniFileProcessor(model),
@@ -40,31 +51,35 @@ OscParser::OscParser(Model& model) :
 {
 	try
 	{
-		this->processors["automation"] = &automationProcessor;
-		this->processors["play"] = &playProcessor;
-		this->processors["stop"] = &stopProcessor;
-		this->processors["record"] = &recordProcessor;
-		this->processors["repeat"] = &repeatProcessor;
-		this->processors["time"] = &timeProcessor;
-		this->processors["tempo"] = &tempoProcessor;
-		this->processors["action"] = &actionProcessor;
-		this->processors["quantize"] = &quantizeProcessor;
-		this->processors["metro_vol"] = &metronomeVolumeProcessor;
-		this->processors["undo"] = &undoProcessor;
-		this->processors["redo"] = &redoProcessor;
-		this->processors["cursor"] = &cursorProcessor;
-		this->processors["project"] = &projectProcessor;
-		this->processors["master"] = &mastertrackProcessor;
-		this->processors["track"] = &trackProcessor;
-		this->processors["noterepeat"] = &noteRepeatProcessor;
-		this->processors["device"] = &deviceProcessor;
-		this->processors["eq"] = &eqDeviceProcessor;
-		this->processors["clip"] = &clipProcessor;
-		this->processors["marker"] = &markerProcessor;
-		this->processors["refresh"] = &refreshProcessor;
-		this->processors["scene"] = &sceneProcessor;
-		this->processors["groove"] = &grooveProcessor;
-		this->processors["inifile"] = &iniFileProcessor;
+		this->processors = {
+			{ "automation", &automationProcessor },
+			{ "play", &playProcessor },
+			{ "stop", &stopProcessor },
+			{ "record", &recordProcessor },
+			{ "repeat", &repeatProcessor },
+			{ "time", &timeProcessor },
+			{ "tempo", &tempoProcessor },
+			{ "action", &actionProcessor },
+			{ "quantize", &quantizeProcessor },
+			{ "metro_vol", &metronomeVolumeProcessor },
+			{ "undo", &undoProcessor },
+			{ "redo", &redoProcessor },
+			{ "cursor", &cursorProcessor },
+			{ "project", &projectProcessor },
+			{ "master", &mastertrackProcessor },
+			{ "track", &trackProcessor },
+			{ "noterepeat", &noteRepeatProcessor },
+			{ "device", &deviceProcessor },
+			{ "eq", &eqDeviceProcessor },
+			{ "clip", &clipProcessor },
+			{ "marker", &markerProcessor },
+			{ "refresh", &refreshProcessor },
+			{ "capture", &captureProcessor },
+			{ "scene", &sceneProcessor },
+			{ "groove", &grooveProcessor },
+			{ "inifile", &iniFileProcessor }
+		};
+		std::sort(this->processors.begin(), this->processors.end());
 	}
 	catch (...)
 	{
@@ -79,30 +94,14 @@ OscParser::OscParser(Model& model) :
  * @param processor The processor
  * @param command   The command
  */
-void OscParser::Process(const std::string processor, const std::string command) const
+void OscParser::Process(const std::string& processor, const std::string& command) const
 {
-	this->theModel.AddFunction([this, processor, command]()
-		{
-			std::deque<std::string> elements = this->Split(command);
-			try
-			{
-				OscProcessor* oscProcessor = this->processors.at(processor);
-				if (oscProcessor != nullptr)
-					oscProcessor->Process(elements);
-			}
-			catch (const std::out_of_range& oor)
-			{
-				LogError(command, oor);
-			}
-			catch (const std::exception& ex)
-			{
-				ReaDebug() << "Could not process message: " << ex.what();
-			}
-			catch (...)
-			{
-				ReaDebug() << "Could not process message.";
-			}
-		});
+	OscProcessor* oscProcessor = this->GetProcessor(processor);
+	if (oscProcessor == nullptr)
+		return;
+	this->theModel.GetCommandCapture().Record(processor, command);
+	this->generation++;
+	this->theModel.AddFunction(QueuedCommand(*this, oscProcessor, command), IsBatched(oscProcessor, command), IsDeferrable(oscProcessor, command), GetDependency(oscProcessor, command));
 }
 
 
@@ -113,28 +112,14 @@ void OscParser::Process(const std::string processor, const std::string command)
  * @param command   The command
  * @param value     The value
  */
-void OscParser::Process(const std::string processor, const std::string command, const std::string value) const
+void OscParser::Process(const std::string& processor, const std::string& command, const std::string& value) const
 {
-	this->theModel.AddFunction([this, processor, command, value]()
-		{
-			std::deque<std::string> elements = this->Split(command);
-			try
-			{
-				this->processors.at(processor)->Process(elements, value);
-			}
-			catch (const std::out_of_range& oor)
-			{
-				LogError(command, oor);
-			}
-			catch (const std::exception& ex)
-			{
-				ReaDebug() << "Could not process message: " << ex.what();
-			}
-			catch (...)
-			{
-				ReaDebug() << "Could not process message.";
-			}
-		});
+	OscProcessor* oscProcessor = this->GetProcessor(processor);
+	if (oscProcessor == nullptr)
+		return;
+	this->theModel.GetCommandCapture().Record(processor, command, value);
+	this->generation++;
+	this->theModel.AddFunction(QueuedCommand(*this, oscProcessor, command, value), IsBatched(oscProcessor, command), IsDeferrable(oscProcessor, command), GetDependency(oscProcessor, command));
 }
 
 
@@ -145,28 +130,14 @@ void OscParser::Process(const std::string processor, const std::string command,
  * @param command   The command
  * @param values    The values
  */
-void OscParser::Process(const std::string processor, const std::string command, std::vector<std::string>& values) const
+void OscParser::Process(const std::string& processor, const std::string& command, std::vector<std::string>& values) const
 {
-	this->theModel.AddFunction([this, processor, command, values]()
-		{
-			std::deque<std::string> elements = this->Split(command);
-			try
-			{
-				this->processors.at(processor)->Process(elements, values);
-			}
-			catch (const std::out_of_range& oor)
-			{
-				LogError(command, oor);
-			}
-			catch (const std::exception& ex)
-			{
-				ReaDebug() << "Could not process message: " << ex.what();
-			}
-			catch (...)
-			{
-				ReaDebug() << "Could not process message.";
-			}
-		});
+	OscProcessor* oscProcessor = this->GetProcessor(processor);
+	if (oscProcessor == nullptr)
+		return;
+	this->theModel.GetCommandCapture().Record(processor, command, values);
+	this->generation++;
+	this->theModel.AddFunction(QueuedCommand(*this, oscProcessor, command, values), IsBatched(oscProcessor, command), IsDeferrable(oscProcessor, command), GetDependency(oscProcessor, command));
 }
 
 
@@ -177,28 +148,14 @@ void OscParser::Process(const std::string processor, const std::string command,
  * @param command   The command
  * @param value     The value
  */
-void OscParser::Process(const std::string processor, const std::string command, const int value) const
+void OscParser::Process(const std::string& processor, const std::string& command, const int value) const
 {
-	this->theModel.AddFunction([this, processor, command, value]()
-		{
-			std::deque<std::string> elements = this->Split(command);
-			try
-			{
-				this->processors.at(processor)->Process(elements, value);
-			}
-			catch (const std::out_of_range& oor)
-			{
-				LogError(command, oor);
-			}
-			catch (const std::exception& ex)
-			{
-				ReaDebug() << "Could not process message: " << ex.what();
-			}
-			catch (...)
-			{
-				ReaDebug() << "Could not process message.";
-			}
-		});
+	OscProcessor* oscProcessor = this->GetProcessor(processor);
+	if (oscProcessor == nullptr)
+		return;
+	this->theModel.GetCommandCapture().Record(processor, command, value);
+	this->generation++;
+	this->theModel.AddFunction(QueuedCommand(*this, oscProcessor, command, value), IsBatched(oscProcessor, command), IsDeferrable(oscProcessor, command), GetDependency(oscProcessor, command));
 }
 
 
@@ -209,38 +166,226 @@ void OscParser::Process(const std::string processor, const std::string command,
  * @param command   The command
  * @param value     The value
  */
-void OscParser::Process(const std::string processor, const std::string command, const double value) const
+void OscParser::Process(const std::string& processor, const std::string& command, const double value) const
+{
+	OscProcessor* oscProcessor = this->GetProcessor(processor);
+	if (oscProcessor == nullptr)
+		return;
+	this->theModel.GetCommandCapture().Record(processor, command, value);
+
+	QueuedCommand queuedCommand(*this, oscProcessor, command, value);
+	if (IsContinuousValue(command))
+	{
+		// Only the newest value of e.g. a volume is relevant. Each command stores its number in the
+		// slot of its target, a command is skipped if a newer one for the same target is waiting
+		this->continuousCommands++;
+		const std::uint64_t hash = this->GetTargetHash(processor, command);
+		std::atomic<std::uint64_t>& slot = this->latestCommands[hash & (LATEST_COMMAND_SLOTS - 1)];
+		queuedCommand.SetLatest(slot, MarkLatestCommand(slot, hash));
+	}
+	else
+		this->generation++;
+	this->theModel.AddFunction(std::move(queuedCommand), IsBatched(oscProcessor, command), IsDeferrable(oscProcessor, command), GetDependency(oscProcessor, command));
+}
+
+
+/**
+ * Get the processor with the given name. Called from the thread which received the command.
+ *
+ * @param processor The name of the processor
+ * @return The processor or null if there is no processor with that name
+ */
+OscProcessor* OscParser::GetProcessor(const std::string& processor) const noexcept
 {
-	this->theModel.AddFunction([this, processor, command, value]()
+	const auto it = std::lower_bound(this->processors.cbegin(), this->processors.cend(), processor, [](const std::pair<std::string, OscProcessor*>& entry, const std::string& name)
 		{
-			std::deque<std::string> elements = this->Split(command);
-			try
-			{
-				this->processors.at(processor)->Process(elements, value);
-			}
-			catch (const std::out_of_range& oor)
-			{
-				LogError(command, oor);
-			}
-			catch (const std::exception& ex)
-			{
-				ReaDebug() << "Could not process message: " << ex.what();
-			}
-			catch (...)
-			{
-				ReaDebug() << "Could not process message.";
-			}
+			return entry.first < name;
 		});
+	if (it != this->processors.cend() && it->first == processor)
+		return it->second;
+
+	try
+	{
+		ReaDebug() << "No processor " << processor << " registered!";
+	}
+	catch (...)
+	{
+		// Ignore
+	}
+	return nullptr;
 }
 
 
 /**
- * Get a processor for the command.
+ * Check if the command sets a continuous value, which are volumes, pans and parameter values
+ * (but not e.g. their touch states).
+ *
+ * @param command The command
+ * @return True if it is a continuous value
+ */
+bool OscParser::IsContinuousValue(const std::string& command) noexcept
+{
+	const std::size_t pos = command.rfind('/');
+	const char* last = command.c_str() + (pos == std::string::npos ? 0 : pos + 1);
+	return std::strcmp(last, "volume") == 0 || std::strcmp(last, "pan") == 0 || std::strcmp(last, "value") == 0;
+}
+
+
+/**
+ * Check if the command only changes the selection, navigates (e.g. scrolls or changes the page)
+ * or signals a touch. These commands never create an undo point.
+ *
+ * @param command The command
+ * @return True if it is a selection or navigation command
+ */
+bool OscParser::IsSelectionOrNavigation(const std::string& command) noexcept
+{
+	std::size_t start = 0;
+	while (start <= command.length())
+	{
+		std::size_t end = command.find('/', start);
+		if (end == std::string::npos)
+			end = command.length();
+		if (command.compare(start, end - start, "page") == 0)
+			return true;
+		start = end + 1;
+	}
+
+	const std::size_t pos = command.rfind('/');
+	const char* last = command.c_str() + (pos == std::string::npos ? 0 : pos + 1);
+	return std::strcmp(last, "select") == 0 || std::strcmp(last, "selected") == 0 || std::strcmp(last, "toggleMultiSelect") == 0 ||
+		std::strcmp(last, "scrollto") == 0 || std::strcmp(last, "touch") == 0 || std::strcmp(last, "+") == 0 || std::strcmp(last, "-") == 0;
+}
+
+
+/**
+ * Check if a command is executed as part of the undo batch of the current update. Only commands
+ * of processors which change the project are batched, but not their continuous values as well as
+ * selection and navigation.
+ *
+ * @param oscProcessor The processor of the command
+ * @param command The command
+ * @return True if the command is batched
+ */
+bool OscParser::IsBatched(const OscProcessor* oscProcessor, const std::string& command) noexcept
+{
+	return oscProcessor->IsUndoBatched() && !IsContinuousValue(command) && !IsSelectionOrNavigation(command);
+}
+
+
+/**
+ * Check if the execution of a command can be deferred to the next update if the time budget is
+ * used up. Commands which do not change the project (e.g. transport), continuous values as well
+ * as selection and navigation are never deferred because of the budget, but they still wait for
+ * deferred commands which were added before them, if they depend on them (see GetDependency).
+ *
+ * @param oscProcessor The processor of the command
+ * @param command The command
+ * @return True if the command can be deferred
+ */
+bool OscParser::IsDeferrable(const OscProcessor* oscProcessor, const std::string& command) noexcept
+{
+	return IsBatched(oscProcessor, command);
+}
+
+
+/**
+ * Get the dependency of a command. All commands which change the project or depend on its
+ * changes share one dependency and therefore keep their order across all processors, e.g. a
+ * device command which addresses a track which was selected after it was added. This includes
+ * all selection and navigation commands as well as actions and undo. The other commands (e.g.
+ * transport) have no dependency and are therefore never deferred.
+ *
+ * @param oscProcessor The processor of the command
+ * @param command The command
+ * @return The dependency, null if none
+ */
+const void* OscParser::GetDependency(const OscProcessor* oscProcessor, const std::string& command) noexcept
+{
+	return oscProcessor->DependsOnProject() || IsSelectionOrNavigation(command) ? &PROJECT_DEPENDENCY : nullptr;
+}
+
+
+/**
+ * Create a hash of the target of a continuous value command. Since many commands are relative to
+ * the current selection (e.g. device/param/N/value), the hash also contains the generation,
+ * which changes with every other command. Therefore, commands are only combined if there is no
+ * other command in between them which might change their target.
+ *
+ * @param processor The processor
+ * @param command   The command
+ * @return The hash
+ */
+std::uint64_t OscParser::GetTargetHash(const std::string& processor, const std::string& command) const noexcept
+{
+	std::uint64_t hash{ FNV_OFFSET_BASIS };
+	const std::uint64_t currentGeneration = this->generation.load();
+	for (int i = 0; i < 8; i++)
+	{
+		hash ^= (currentGeneration >> (i * 8)) & 0xFF;
+		hash *= FNV_PRIME;
+	}
+	for (const char c : processor)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= FNV_PRIME;
+	}
+	hash ^= '/';
+	hash *= FNV_PRIME;
+	for (const char c : command)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+
+/**
+ * Store a new command number for the target of a continuous value command in its slot. The
+ * table of slots has a fixed size, the slot is selected by the lower bits of the hash of the
+ * target. The number consists of the upper bits of the hash (the tag) and a sequence which is
+ * increased with each command stored in the slot. Does neither lock nor allocate.
+ *
+ * @param slot The slot of the target
+ * @param hash The hash of the target
+ * @return The number of the command
+ */
+std::uint64_t OscParser::MarkLatestCommand(std::atomic<std::uint64_t>& slot, std::uint64_t hash) noexcept
+{
+	const std::uint64_t tag = hash & ~SEQUENCE_MASK;
+	std::uint64_t previous = slot.load(std::memory_order_relaxed);
+	std::uint64_t latest;
+	do
+	{
+		latest = tag | ((previous + 1) & SEQUENCE_MASK);
+	} while (!slot.compare_exchange_weak(previous, latest, std::memory_order_acq_rel, std::memory_order_relaxed));
+	return latest;
+}
+
+
+/**
+ * Check if a continuous value command was replaced by a newer one for the same target. If the
+ * slot was taken over by a different target, the command is executed.
+ *
+ * @param slot   The slot of the target
+ * @param latest The number of the command
+ * @return True if the command can be skipped
+ */
+bool OscParser::IsReplaced(const std::atomic<std::uint64_t>& slot, std::uint64_t latest) noexcept
+{
+	const std::uint64_t current = slot.load(std::memory_order_acquire);
+	return current != latest && (current & ~SEQUENCE_MASK) == (latest & ~SEQUENCE_MASK);
+}
+
+
+/**
+ * Log an error about a command which could not be processed.
  *
  * @param command The command
  * @param oor     The out of range exception
  */
-void OscParser::LogError(const std::string command, const std::out_of_range& oor) const
+void OscParser::LogError(const char* command, const std::out_of_range& oor) const
 {
 	(void)oor; // Ignore not used
 	ReaDebug() << "No function " << command << " registered!";
@@ -248,18 +393,176 @@ void OscParser::LogError(const std::string command, const std::out_of_range& oor
 
 
 /**
- * Splits the given path (limiter is "/").
+ * Constructor. Copies the path into the inline buffer, if it fits.
+ *
+ * @param parser    The parser which received the command
+ * @param processor The processor which executes the command
+ * @param path      The path of the command
+ * @param type      The type of the value
+ */
+OscParser::QueuedCommand::QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, ValueType type) :
+	parser(&parser), processor(processor), length(static_cast<std::uint32_t>(path.length())), type(type)
+{
+	char* target;
+	if (path.length() < INLINE_PATH_LENGTH)
+	{
+		DISABLE_WARNING_ARRAY_POINTER_DECAY
+		target = this->inlinePath;
+	}
+	else
+	{
+		this->heapPath = std::make_unique<char[]>(path.length() + 1);
+		target = this->heapPath.get();
+	}
+	std::memcpy(target, path.c_str(), path.length() + 1);
+}
+
+
+/**
+ * Constructor for a command without a value.
+ *
+ * @param parser    The parser which received the command
+ * @param processor The processor which executes the command
+ * @param path      The path of the command
+ */
+OscParser::QueuedCommand::QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path) :
+	QueuedCommand(parser, processor, path, ValueType::NONE)
+{
+	// Intentionally empty
+}
+
+
+/**
+ * Constructor for a command with a text value, the text is stored on the heap.
+ *
+ * @param parser    The parser which received the command
+ * @param processor The processor which executes the command
+ * @param path      The path of the command
+ * @param value     The value
+ */
+OscParser::QueuedCommand::QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, const std::string& value) :
+	QueuedCommand(parser, processor, path, ValueType::TEXT)
+{
+	this->text = std::make_unique<std::string>(value);
+}
+
+
+/**
+ * Constructor for a command with several text values, the values are stored on the heap.
+ *
+ * @param parser    The parser which received the command
+ * @param processor The processor which executes the command
+ * @param path      The path of the command
+ * @param values    The values
+ */
+OscParser::QueuedCommand::QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, const std::vector<std::string>& values) :
+	QueuedCommand(parser, processor, path, ValueType::LIST)
+{
+	this->values = std::make_unique<std::vector<std::string>>(values);
+}
+
+
+/**
+ * Constructor for a command with an integer value.
+ *
+ * @param parser    The parser which received the command
+ * @param processor The processor which executes the command
+ * @param path      The path of the command
+ * @param value     The value
+ */
+OscParser::QueuedCommand::QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, int value) :
+	QueuedCommand(parser, processor, path, ValueType::INTEGER)
+{
+	this->intValue = value;
+}
+
+
+/**
+ * Constructor for a command with a double value.
  *
- * @param path The path to split
- * @return The parts in a queue
+ * @param parser    The parser which received the command
+ * @param processor The processor which executes the command
+ * @param path      The path of the command
+ * @param value     The value
+ */
+OscParser::QueuedCommand::QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, double value) :
+	QueuedCommand(parser, processor, path, ValueType::DOUBLE)
+{
+	this->doubleValue = value;
+}
+
+
+/**
+ * Mark the command as a continuous value which is skipped if a newer value for the same target
+ * was received before it is executed.
+ *
+ * @param latestSlot    The slot of the target
+ * @param latestCommand The number of the command
+ */
+void OscParser::QueuedCommand::SetLatest(const std::atomic<std::uint64_t>& latestSlot, std::uint64_t latestCommand) noexcept
+{
+	this->slot = &latestSlot;
+	this->latest = latestCommand;
+}
+
+
+/**
+ * Split the path into its elements and hand them to the processor. Called from the main thread.
+ * The path is split on the stack, therefore nested commands need no special handling.
  */
-std::deque<std::string> OscParser::Split(const std::string& path) const
+void OscParser::QueuedCommand::operator()()
 {
-	std::deque<std::string> elems;
-	std::istringstream ss(path);
-	std::string item;
-	std::back_insert_iterator<std::deque<std::string>> result = back_inserter(elems);
-	while (getline(ss, item, '/'))
-		*(result++) = item;
-	return elems;
+	if (this->slot != nullptr && IsReplaced(*this->slot, this->latest))
+	{
+		this->parser->coalescedCommands++;
+		return;
+	}
+
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	const char* command = this->heapPath ? this->heapPath.get() : this->inlinePath;
+	try
+	{
+		const OscPath path(command, this->length);
+		this->Process(path);
+	}
+	catch (const std::out_of_range& oor)
+	{
+		this->parser->LogError(command, oor);
+	}
+	catch (const std::exception& ex)
+	{
+		ReaDebug() << "Could not process message: " << ex.what();
+	}
+	catch (...)
+	{
+		ReaDebug() << "Could not process message.";
+	}
+}
+
+
+/**
+ * Hand the path elements and the value to the processor.
+ *
+ * @param path The elements of the path
+ */
+void OscParser::QueuedCommand::Process(const OscPath& path)
+{
+	switch (this->type)
+	{
+	case ValueType::INTEGER:
+		this->processor->Process(path, this->intValue);
+		break;
+	case ValueType::DOUBLE:
+		this->processor->Process(path, this->doubleValue);
+		break;
+	case ValueType::TEXT:
+		this->processor->Process(path, *this->text);
+		break;
+	case ValueType::LIST:
+		this->processor->Process(path, *this->values);
+		break;
+	default:
+		this->processor->Process(path);
+		break;
+	}
 }
@@ -4,11 +4,13 @@
 #ifndef _DBM_OSCPARSER_H_
 #define _DBM_OSCPARSER_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <sstream>
-#include <deque>
-#include <map>
-#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "Model.h"
 #include "OscProcessor.h"
@@ -41,17 +43,38 @@ public:
 	OscParser& operator=(OscParser&&) = delete;
 	virtual ~OscParser() = default;
 
-	virtual void Process(const std::string processor, const std::string path) const;
-	virtual void Process(const std::string processor, const std::string path, const std::string value) const;
-	virtual void Process(const std::string processor, const std::string command, std::vector<std::string>& values) const;
-	virtual void Process(const std::string processor, const std::string path, const int value) const;
-	virtual void Process(const std::string processor, const std::string path, const double value) const;
+	virtual void Process(const std::string& processor, const std::string& path) const;
+	virtual void Process(const std::string& processor, const std::string& path, const std::string& value) const;
+	virtual void Process(const std::string& processor, const std::string& command, std::vector<std::string>& values) const;
+	virtual void Process(const std::string& processor, const std::string& path, const int value) const;
+	virtual void Process(const std::string& processor, const std::string& path, const double value) const;
 
 	ActionProcessor& GetActionProcessor() noexcept
 	{
 		return this->actionProcessor;
 	};
 
+	/**
+	 * Get the number of continuous value commands which were replaced by a newer value before
+	 * they were executed.
+	 *
+	 * @return The number of dropped commands
+	 */
+	unsigned long long GetCoalescedCommands() const noexcept
+	{
+		return this->coalescedCommands.load();
+	}
+
+	/**
+	 * Get the number of all received continuous value commands.
+	 *
+	 * @return The number of commands
+	 */
+	unsigned long long GetContinuousCommands() const noexcept
+	{
+		return this->continuousCommands.load();
+	}
+
 
 private:
 	AutomationProcessor 			 automationProcessor;
@@ -76,15 +99,99 @@ private:
 	ClipProcessor 					 clipProcessor;
 	MarkerProcessor 				 markerProcessor;
 	RefreshProcessor 				 refreshProcessor;
+	CaptureProcessor 				 captureProcessor;
 	SceneProcessor 					 sceneProcessor;
 	GrooveProcessor 				 grooveProcessor;
 	IniFileProcessor                 iniFileProcessor;
 
-	std::map<std::string, OscProcessor*> processors;
+	/** Must be a power of 2. */
+	static const std::size_t LATEST_COMMAND_SLOTS{ 1024 };
+	/** The lower bits of a command number contain the sequence, the upper bits the tag. */
+	static const std::uint64_t SEQUENCE_MASK{ 0xFFFFFF };
+	static const std::uint64_t FNV_OFFSET_BASIS{ 14695981039346656037ULL };
+	static const std::uint64_t FNV_PRIME{ 1099511628211ULL };
+
+	// Sorted by name, never changed after construction and therefore safe to read from any thread
+	std::vector<std::pair<std::string, OscProcessor*>> processors;
 	Model& theModel;
 
-	std::deque<std::string> Split(const std::string& path) const;
-	void LogError(const std::string command, const std::out_of_range& oor) const;
+	// The number of the latest continuous value command per target
+	mutable std::array<std::atomic<std::uint64_t>, LATEST_COMMAND_SLOTS> latestCommands{};
+	// Changed by every command which is not a continuous value
+	mutable std::atomic<std::uint64_t> generation{ 0 };
+	mutable std::atomic<unsigned long long> coalescedCommands{ 0 };
+	mutable std::atomic<unsigned long long> continuousCommands{ 0 };
+
+	static bool IsContinuousValue(const std::string& command) noexcept;
+	static bool IsSelectionOrNavigation(const std::string& command) noexcept;
+	static bool IsBatched(const OscProcessor* oscProcessor, const std::string& command) noexcept;
+	static bool IsDeferrable(const OscProcessor* oscProcessor, const std::string& command) noexcept;
+	static const void* GetDependency(const OscProcessor* oscProcessor, const std::string& command) noexcept;
+	std::uint64_t GetTargetHash(const std::string& processor, const std::string& command) const noexcept;
+	static std::uint64_t MarkLatestCommand(std::atomic<std::uint64_t>& slot, std::uint64_t hash) noexcept;
+	static bool IsReplaced(const std::atomic<std::uint64_t>& slot, std::uint64_t latest) noexcept;
+
+	OscProcessor* GetProcessor(const std::string& processor) const noexcept;
+	void LogError(const char* command, const std::out_of_range& oor) const;
+
+
+	/**
+	 * A parsed command which waits in the queue of the function executor for its execution on the
+	 * main thread. Holds the processor, the path in an inline buffer and an integer or double
+	 * value, which fits into the inline storage of a task. Only paths longer than
+	 * INLINE_PATH_LENGTH and the values of text and list commands are stored on the heap.
+	 */
+	class QueuedCommand
+	{
+	public:
+		static const std::size_t INLINE_PATH_LENGTH{ 48 };
+
+
+		QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path);
+		QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, const std::string& value);
+		QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, const std::vector<std::string>& values);
+		QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, int value);
+		QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, double value);
+		QueuedCommand(const QueuedCommand&) = delete;
+		QueuedCommand& operator=(const QueuedCommand&) = delete;
+		QueuedCommand(QueuedCommand&&) noexcept = default;
+		QueuedCommand& operator=(QueuedCommand&&) noexcept = default;
+		~QueuedCommand() = default;
+
+		void SetLatest(const std::atomic<std::uint64_t>& latestSlot, std::uint64_t latestCommand) noexcept;
+		void operator()();
+
+	private:
+		enum class ValueType : std::uint8_t
+		{
+			NONE,
+			INTEGER,
+			DOUBLE,
+			TEXT,
+			LIST
+		};
+
+		const OscParser* parser;
+		OscProcessor* processor;
+		// Only set if the path does not fit into the inline buffer
+		std::unique_ptr<char[]> heapPath;
+		std::unique_ptr<std::string> text;
+		std::unique_ptr<std::vector<std::string>> values;
+		// Only set for continuous values, see MarkLatestCommand
+		const std::atomic<std::uint64_t>* slot{ nullptr };
+		std::uint64_t latest{ 0 };
+		double doubleValue{ 0 };
+		int intValue{ 0 };
+		std::uint32_t length;
+		ValueType type;
+		char inlinePath[INLINE_PATH_LENGTH];
+
+		QueuedCommand(const OscParser& parser, OscProcessor* processor, const std::string& path, ValueType type);
+		void Process(const OscPath& path);
+	};
+
+	// The queued commands must not be moved to the heap by the task
+	static_assert(sizeof(QueuedCommand) <= InlineTask::CAPACITY, "The queued command does not fit into a task.");
 };
 
 #endif /* _DBM_OSCPARSER_H_ */
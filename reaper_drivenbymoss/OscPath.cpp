@@ -0,0 +1,150 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <cstring>
+#include <stdexcept>
+
+#include "CodeAnalysis.h"
+#include "OscPath.h"
+
+
+/**
+ * Constructor.
+ *
+ * @param path The path to split, does not need to be null terminated
+ * @param length The number of characters of the path
+ */
+OscPath::OscPath(const char* path, std::size_t length)
+{
+	this->Split(path, length);
+}
+
+
+/**
+ * Constructor.
+ *
+ * @param path The path to split
+ */
+OscPath::OscPath(const std::string& path)
+{
+	this->Split(path.c_str(), path.length());
+}
+
+
+/**
+ * Get an element. Throws like the other containers if the index is out of range.
+ *
+ * @param index The index of the element
+ * @return The null terminated element
+ */
+const char* OscPath::at(std::size_t index) const
+{
+	if (index >= this->count)
+		throw std::out_of_range("Path has no element with that index.");
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	return this->elements[index].text;
+}
+
+
+/**
+ * Get an element.
+ *
+ * @param index The index of the element
+ * @return The null terminated element or an empty text if the index is out of range
+ */
+const char* OscPath::Get(std::size_t index) const noexcept
+{
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	return index < this->count ? this->elements[index].text : "";
+}
+
+
+/**
+ * Get the hash of an element to compare it with the result of Hash.
+ *
+ * @param index The index of the element
+ * @return The hash, the one of an empty text if the index is out of range
+ */
+std::uint64_t OscPath::GetHash(std::size_t index) const noexcept
+{
+	if (index >= this->count)
+		return Hash("");
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	return this->elements[index].hash;
+}
+
+
+/**
+ * Parse an element as an integer like std::atoi does: an optional sign followed by digits, all
+ * characters after them are ignored.
+ *
+ * @param index The index of the element
+ * @return The number, 0 if the element does not start with a number or the index is out of range
+ */
+int OscPath::GetInt(std::size_t index) const noexcept
+{
+	const char* text = this->Get(index);
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	const bool isNegative = *text == '-';
+	if (isNegative || *text == '+')
+		text++;
+	int value{ 0 };
+	for (; *text >= '0' && *text <= '9'; text++)
+		value = value * 10 + (*text - '0');
+	return isNegative ? -value : value;
+}
+
+
+/**
+ * Copy the path and split it into its elements. Same result as reading the elements with getline:
+ * a trailing delimiter does not add an empty element.
+ *
+ * @param path The path to split
+ * @param length The number of characters of the path
+ */
+void OscPath::Split(const char* path, std::size_t length)
+{
+	char* text;
+	if (length < INLINE_LENGTH)
+	{
+		DISABLE_WARNING_ARRAY_POINTER_DECAY
+		text = this->inlineText;
+	}
+	else
+	{
+		this->heapText = std::make_unique<char[]>(length + 1);
+		text = this->heapText.get();
+	}
+	if (length > 0)
+		std::memcpy(text, path, length);
+
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	text[length] = 0;
+
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	Element* target = this->inlineElements;
+	std::size_t start = 0;
+	while (start < length)
+	{
+		Element element{ text + start, FNV_OFFSET_BASIS };
+		std::size_t end = start;
+		for (; end < length && text[end] != '/'; end++)
+		{
+			element.hash ^= static_cast<unsigned char>(text[end]);
+			element.hash *= FNV_PRIME;
+		}
+		text[end] = 0;
+		start = end + 1;
+
+		if (this->count < INLINE_ELEMENTS)
+			target[this->count] = element;
+		else
+		{
+			if (this->heapElements.empty())
+				this->heapElements.assign(target, target + INLINE_ELEMENTS);
+			this->heapElements.push_back(element);
+		}
+		this->count++;
+	}
+	this->elements = this->heapElements.empty() ? target : this->heapElements.data();
+}
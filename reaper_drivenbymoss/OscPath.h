@@ -0,0 +1,110 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_OSCPATH_H_
+#define _DBM_OSCPATH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * The elements of a command path (e.g. "3/send/1/volume") split at "/". The elements are null
+ * terminated views into a copy of the path which is stored inside of the object, therefore no
+ * memory is allocated unless the path is longer than INLINE_LENGTH or has more than
+ * INLINE_ELEMENTS elements. The hash of each element is calculated while splitting, which allows
+ * the processors to dispatch a sub-command with a switch over the hashes of the known names
+ * (see Hash) instead of comparing the name with one after the other. Since the hashes are case
+ * labels, the compiler reports a collision of two known names as a duplicate case.
+ */
+class OscPath
+{
+public:
+	/** The maximum length of a path which is stored without allocation. */
+	static const std::size_t INLINE_LENGTH{ 128 };
+	/** The maximum number of elements which are stored without allocation. */
+	static const std::size_t INLINE_ELEMENTS{ 12 };
+
+
+	OscPath(const char* path, std::size_t length);
+	explicit OscPath(const std::string& path);
+	OscPath(const OscPath&) = delete;
+	OscPath& operator=(const OscPath&) = delete;
+	OscPath(OscPath&&) = delete;
+	OscPath& operator=(OscPath&&) = delete;
+	~OscPath() {};
+
+
+	/**
+	 * Get the number of elements.
+	 *
+	 * @return The number of elements
+	 */
+	std::size_t size() const noexcept
+	{
+		return this->count;
+	}
+
+
+	/**
+	 * Check if the path has no elements.
+	 *
+	 * @return True if empty
+	 */
+	bool empty() const noexcept
+	{
+		return this->count == 0;
+	}
+
+
+	const char* at(std::size_t index) const;
+	const char* Get(std::size_t index) const noexcept;
+	std::uint64_t GetHash(std::size_t index) const noexcept;
+	int GetInt(std::size_t index) const noexcept;
+
+
+	/**
+	 * Calculate the hash (64 bit FNV-1a) of a name. Used for the case labels of the dispatch of
+	 * sub-commands, e.g. case OscPath::Hash("volume").
+	 *
+	 * @param text The null terminated name
+	 * @return The hash
+	 */
+	static constexpr std::uint64_t Hash(const char* text) noexcept
+	{
+		std::uint64_t hash{ FNV_OFFSET_BASIS };
+		for (; *text != 0; text++)
+		{
+			hash ^= static_cast<unsigned char>(*text);
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+
+private:
+	static const std::uint64_t FNV_OFFSET_BASIS{ 14695981039346656037ULL };
+	static const std::uint64_t FNV_PRIME{ 1099511628211ULL };
+
+	struct Element
+	{
+		const char* text;
+		std::uint64_t hash;
+	};
+
+	char inlineText[INLINE_LENGTH];
+	Element inlineElements[INLINE_ELEMENTS];
+	// Only used for paths which do not fit into the inline storage
+	std::unique_ptr<char[]> heapText;
+	std::vector<Element> heapElements;
+
+	const Element* elements{ nullptr };
+	std::size_t count{ 0 };
+
+	void Split(const char* path, std::size_t length);
+};
+
+#endif /* _DBM_OSCPATH_H_ */
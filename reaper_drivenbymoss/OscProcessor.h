@@ -6,10 +6,10 @@
 
 #include <cstring>
 #include <string>
-#include <deque>
 #include <regex>
 
 #include "Model.h"
+#include "OscPath.h"
 
 // &1 to prevent track grouping, &2 to prevent selection ganging
 #define IGNORE_GROUP_FLAGS 0
@@ -33,25 +33,51 @@ public:
 	OscProcessor& operator=(OscProcessor&&) = delete;
 	virtual ~OscProcessor() = default;
 
-	virtual void Process(std::deque<std::string>& path) = 0;
+	virtual void Process(const OscPath& path) = 0;
 
-	virtual void Process(std::deque<std::string>& path, const std::string& value) = 0;
+	virtual void Process(const OscPath& path, const std::string& value) = 0;
 
-	virtual void Process(std::deque<std::string>& path, const std::vector<std::string>& values) = 0;
+	virtual void Process(const OscPath& path, const std::vector<std::string>& values) = 0;
 
-	virtual void Process(std::deque<std::string>& path, int value)
+	virtual void Process(const OscPath& path, int value)
 	{
 		if (value == 1)
 			this->Process(path);
 	};
 
-	virtual void Process(std::deque<std::string>& path, double value) = 0;
+	virtual void Process(const OscPath& path, double value) = 0;
 
-	virtual void Process(std::deque<std::string>& path, float value)
+	virtual void Process(const OscPath& path, float value)
 	{
 		this->Process(path, static_cast<double>(value));
 	};
 
+	/**
+	 * Should the commands of this processor be executed as part of the undo batch of the current
+	 * update? Processors which change the project should return true. Latency critical commands
+	 * like transport are executed immediately outside of the batch. Selection, navigation and
+	 * continuous values (e.g. volume) are never batched, even if this returns true.
+	 *
+	 * @return True to execute the commands in the undo batch
+	 */
+	virtual bool IsUndoBatched() const noexcept
+	{
+		return false;
+	}
+
+	/**
+	 * Do the commands of this processor depend on changes of the project made by earlier commands,
+	 * e.g. on the added tracks, the selection or the undo history? Such commands wait for the
+	 * deferred commands which were added before them. By default, these are the commands of all
+	 * processors which change the project.
+	 *
+	 * @return True if the commands need to keep their order with the changes of the project
+	 */
+	virtual bool DependsOnProject() const noexcept
+	{
+		return this->IsUndoBatched();
+	}
+
 protected:
 
 	/** Start playback. */
@@ -203,16 +229,9 @@ protected:
 	Model& model;
 
 
-	const char* SafeGet(std::deque<std::string>& path, const int index) noexcept
+	const char* SafeGet(const OscPath& path, const int index) noexcept
 	{
-		try
-		{
-			return path.at(index).c_str();
-		}
-		catch (...)
-		{
-			return "";
-		}
+		return path.Get(index);
 	}
 
 
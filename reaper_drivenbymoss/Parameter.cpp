@@ -37,39 +37,33 @@ Parameter::Parameter(const char* prefixPath, const int index) noexcept : paramet
  * Collect the (changed) parameter data.
  *
  * @param ss The stream where to append the formatted data
+ * @param fx The cached device, retrieved once for all of its parameters
  * @param track The track to which the device belongs
  * @param deviceIndex The index of the device to which the parameters belong
  * @param dump If true all data is collected not only the changed one since the last call
  */
-void Parameter::CollectData(std::ostringstream& ss, MediaTrack* track, const int& deviceIndex, const bool& dump)
+void Parameter::CollectData(std::ostringstream& ss, ParameterCache::FxMetadata* fx, MediaTrack* track, const int& deviceIndex, const bool& dump)
 {
-	CollectData(ss, track, deviceIndex, this->parameterIndex, dump);
+	CollectData(ss, fx, track, deviceIndex, this->parameterIndex, dump);
 }
 
 
 /**
- * Collect the (changed) parameter data.
+ * Collect the (changed) parameter data. Name and steps are taken from the cached FX, only the value
+ * is read each time and formatted only if it has changed.
  *
  * @param ss The stream where to append the formatted data
+ * @param fx The cached device, retrieved once for all of its parameters
  * @param track The track to which the device belongs
  * @param deviceIndex The index of the device to which the parameters belong
  * @param paramIndex The index of the parameter
  * @param dump If true all data is collected not only the changed one since the last call
  */
-void Parameter::CollectData(std::ostringstream& ss, MediaTrack* track, const int& deviceIndex, const int& paramIndex, const bool& dump)
+void Parameter::CollectData(std::ostringstream& ss, ParameterCache::FxMetadata* fx, MediaTrack* track, const int& deviceIndex, const int& paramIndex, const bool& dump)
 {
-	constexpr int LENGTH = 60;
-	std::string nameBuf(LENGTH, 0);
-	char* nameBufPointer = &*nameBuf.begin();
-
-	bool result = TrackFX_GetParamName(track, deviceIndex, paramIndex, nameBufPointer, LENGTH);
-	const std::string newName{ result ? nameBuf : "" };
-	this->name = Collectors::CollectStringValue(ss, this->addressName, this->name, newName, dump);
-
-	bool isToggle;
-	result = TrackFX_GetParameterStepSizes(track, deviceIndex, paramIndex, nullptr, nullptr, nullptr, &isToggle);
-	const int numSteps = result && isToggle ? 2 : -1;
-	this->numberOfSteps = Collectors::CollectIntValue(ss, this->addressNumberOfSteps, this->numberOfSteps, numSteps, dump);
+	const ParameterMetadata& metadata = ParameterCache::GetParameter(fx, track, deviceIndex, paramIndex);
+	this->name = Collectors::CollectStringValue(ss, this->addressName, this->name, metadata.name, dump);
+	this->numberOfSteps = Collectors::CollectIntValue(ss, this->addressNumberOfSteps, this->numberOfSteps, metadata.numberOfSteps, dump);
 
 	// Note: this seems to already respect the envelope!
 	const double paramValue = TrackFX_GetParamNormalized(track, deviceIndex, paramIndex);
@@ -78,10 +72,12 @@ void Parameter::CollectData(std::ostringstream& ss, MediaTrack* track, const int
 
 	if (dump || valueHasChanged)
 	{
-		const double realValue = TrackFX_GetParam(track, deviceIndex, paramIndex, nullptr, nullptr);
+		constexpr int LENGTH = 60;
+		char valueBuf[LENGTH]{};
+		const double realValue = metadata.minimum + paramValue * (metadata.maximum - metadata.minimum);
 		DISABLE_WARNING_ARRAY_POINTER_DECAY
-		result = TrackFX_FormatParamValue(track, deviceIndex, paramIndex, realValue, nameBufPointer, LENGTH);
-		const std::string newValue{ result ? nameBuf : "" };
+		const bool result = TrackFX_FormatParamValue(track, deviceIndex, paramIndex, realValue, valueBuf, LENGTH);
+		const std::string newValue{ result ? valueBuf : "" };
 		this->valueStr = Collectors::CollectStringValue(ss, this->addressValueStr, this->valueStr, newValue, dump);
 	}
 }
@@ -98,5 +94,5 @@ void Parameter::ClearData(std::ostringstream& ss, const bool& dump)
 	this->name = Collectors::CollectStringValue(ss, this->addressName, this->name, "", dump);
 	this->value = Collectors::CollectDoubleValue(ss, this->addressValue, this->value, 0.0, dump);
 	this->valueStr = Collectors::CollectStringValue(ss, this->addressValueStr, this->valueStr, "", dump);
-	this->addressNumberOfSteps = Collectors::CollectIntValue(ss, this->addressNumberOfSteps, this->numberOfSteps, -1, dump);
+	this->numberOfSteps = Collectors::CollectIntValue(ss, this->addressNumberOfSteps, this->numberOfSteps, -1, dump);
 }
@@ -7,6 +7,7 @@
 #include <string>
 
 #include "ReaperUtils.h"
+#include "ParameterCache.h"
 
 
 /**
@@ -23,8 +24,8 @@ public:
 
 	Parameter(const char* prefixPath, const int index) noexcept;
 
-	void CollectData(std::ostringstream &ss, MediaTrack *track, const int& deviceIndex, const bool &dump);
-	void CollectData(std::ostringstream& ss, MediaTrack* track, const int& deviceIndex, const int& paramIndex, const bool& dump);
+	void CollectData(std::ostringstream &ss, ParameterCache::FxMetadata* fx, MediaTrack *track, const int& deviceIndex, const bool &dump);
+	void CollectData(std::ostringstream& ss, ParameterCache::FxMetadata* fx, MediaTrack* track, const int& deviceIndex, const int& paramIndex, const bool& dump);
 	void ClearData(std::ostringstream& ss, const bool& dump);
 
 private:
@@ -0,0 +1,141 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <cstring>
+
+#include "CodeAnalysis.h"
+#include "ParameterCache.h"
+
+
+const ParameterMetadata ParameterCache::EMPTY_PARAMETER{};
+
+
+/**
+ * Constructor.
+ */
+ParameterCache::ParameterCache() noexcept
+{
+	// Intentionally empty
+}
+
+
+/**
+ * Get the metadata of a parameter. The metadata is read from Reaper only on the first request or
+ * after the FX changed.
+ *
+ * @param fx The cached FX retrieved with GetFx for the same track and FX index, might be null
+ * @param track The track which contains the FX
+ * @param fxIndex The index of the FX on the track
+ * @param paramIndex The index of the parameter
+ * @return The metadata, contains an empty name if the parameter does not exist
+ */
+const ParameterMetadata& ParameterCache::GetParameter(FxMetadata* fx, MediaTrack* track, int fxIndex, int paramIndex)
+{
+	if (fx == nullptr || paramIndex < 0 || paramIndex >= fx->paramCount)
+		return EMPTY_PARAMETER;
+
+	ParameterMetadata& parameter = fx->parameters.at(paramIndex);
+	if (parameter.isLoaded)
+		return parameter;
+
+	constexpr int LENGTH = 60;
+	char nameBuf[LENGTH]{};
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	if (TrackFX_GetParamName(track, fxIndex, paramIndex, nameBuf, LENGTH))
+		parameter.name = nameBuf;
+
+	bool isToggle{ false };
+	const bool result = TrackFX_GetParameterStepSizes(track, fxIndex, paramIndex, nullptr, nullptr, nullptr, &isToggle);
+	parameter.numberOfSteps = result && isToggle ? 2 : -1;
+
+	TrackFX_GetParam(track, fxIndex, paramIndex, &parameter.minimum, &parameter.maximum);
+
+	parameter.isLoaded = true;
+	return parameter;
+}
+
+
+/**
+ * Must be called once before each data collection pass. If the state of the project changed, all
+ * FX are validated again on their next request. Removes FX which were not requested for a while.
+ *
+ * @param aProject The current project
+ */
+void ParameterCache::NextTick(ReaProject* aProject)
+{
+	this->tick++;
+
+	const int count = aProject == nullptr ? 0 : GetProjectStateChangeCount(aProject);
+	if (aProject != this->project || count != this->stateChangeCount)
+	{
+		this->project = aProject;
+		this->stateChangeCount = count;
+		this->validation++;
+	}
+
+	if (this->tick % EXPIRE_TICKS != 0)
+		return;
+	for (auto it = this->fxCache.begin(); it != this->fxCache.end(); )
+	{
+		if (this->tick - it->second->lastUsed >= EXPIRE_TICKS)
+			it = this->fxCache.erase(it);
+		else
+			++it;
+	}
+}
+
+
+/**
+ * Remove all cached metadata.
+ */
+void ParameterCache::Clear() noexcept
+{
+	this->fxCache.clear();
+	this->validation++;
+}
+
+
+/**
+ * Get the cached FX data. Checks if the FX is still the same only after the state of the project
+ * has changed, otherwise the metadata of its parameters is dropped. Call it once per FX and data
+ * collection pass and hand the result to GetParameter for all of its parameters.
+ *
+ * @param track The track which contains the FX
+ * @param fxIndex The index of the FX on the track
+ * @return The FX data or null if the FX does not exist
+ */
+ParameterCache::FxMetadata* ParameterCache::GetFx(MediaTrack* track, int fxIndex)
+{
+	if (track == nullptr || fxIndex < 0)
+		return nullptr;
+
+	std::unique_ptr<FxMetadata>& entry = this->fxCache[std::make_pair(track, fxIndex)];
+	if (!entry)
+		entry = std::make_unique<FxMetadata>();
+	FxMetadata* fx = entry.get();
+	fx->lastUsed = this->tick;
+	if (fx->validation == this->validation)
+		return fx->exists ? fx : nullptr;
+	fx->validation = this->validation;
+
+	const GUID* guid = TrackFX_GetFXGUID(track, fxIndex);
+	fx->exists = guid != nullptr;
+	if (!fx->exists)
+		return nullptr;
+
+	constexpr int PRESET_LENGTH = 128;
+	char presetBuf[PRESET_LENGTH]{};
+	DISABLE_WARNING_ARRAY_POINTER_DECAY
+	TrackFX_GetPreset(track, fxIndex, presetBuf, PRESET_LENGTH);
+	const int paramCount = TrackFX_GetNumParams(track, fxIndex);
+
+	if (std::memcmp(&fx->guid, guid, sizeof(GUID)) != 0 || fx->paramCount != paramCount || fx->preset.compare(presetBuf) != 0)
+	{
+		fx->guid = *guid;
+		fx->paramCount = paramCount;
+		fx->preset = presetBuf;
+		fx->parameters.clear();
+		fx->parameters.resize(paramCount > 0 ? paramCount : 0);
+	}
+	return fx;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_PARAMETERCACHE_H_
+#define _DBM_PARAMETERCACHE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ReaperUtils.h"
+
+
+/**
+ * The static information of a FX parameter which only changes if the plugin or its preset changes.
+ */
+struct ParameterMetadata
+{
+	bool isLoaded{ false };
+	std::string name;
+	int numberOfSteps{ -1 };
+	double minimum{ 0.0 };
+	double maximum{ 1.0 };
+};
+
+
+/**
+ * Caches the parameter metadata (names, steps, value ranges) of all FX which are monitored. The data
+ * of a FX is stored by its track and index. It is only validated if the state of the project
+ * changed (e.g. FX were added, moved or their preset changed) and dropped if the GUID, the number of
+ * parameters or the preset of the FX at that position changed. FX which were not monitored for a
+ * while are removed from the cache.
+ */
+class ParameterCache
+{
+public:
+	ParameterCache() noexcept;
+	ParameterCache(const ParameterCache&) = delete;
+	ParameterCache& operator=(const ParameterCache&) = delete;
+	ParameterCache(ParameterCache&&) = delete;
+	ParameterCache& operator=(ParameterCache&&) = delete;
+	~ParameterCache() {};
+
+	/** The cached data of one FX. */
+	struct FxMetadata
+	{
+		GUID guid{};
+		std::string preset;
+		int paramCount{ 0 };
+		bool exists{ false };
+		unsigned int lastUsed{ 0 };
+		// The validation for which the FX was checked last
+		unsigned int validation{ 0 };
+		std::vector<ParameterMetadata> parameters;
+	};
+
+	FxMetadata* GetFx(MediaTrack* track, int fxIndex);
+	static const ParameterMetadata& GetParameter(FxMetadata* fx, MediaTrack* track, int fxIndex, int paramIndex);
+	void NextTick(ReaProject* project);
+	void Clear() noexcept;
+
+private:
+	/** Remove FX which were not requested for that number of ticks. */
+	static const unsigned int EXPIRE_TICKS{ 256 };
+
+	unsigned int tick{ 0 };
+	// Incremented when the FX need to be checked again
+	unsigned int validation{ 1 };
+	ReaProject* project{ nullptr };
+	int stateChangeCount{ -1 };
+	std::map<std::pair<MediaTrack*, int>, std::unique_ptr<FxMetadata>> fxCache;
+
+	static const ParameterMetadata EMPTY_PARAMETER;
+};
+
+#endif /* _DBM_PARAMETERCACHE_H_ */
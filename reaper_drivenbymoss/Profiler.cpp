@@ -0,0 +1,110 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "Profiler.h"
+
+
+namespace
+{
+	const std::array<const char*, Profiler::TIMER_COUNT> TIMER_NAMES{ { "run", "executeFunctions", "updateModel", "midiToJava", "processCommands", "audioBuffer" } };
+	const std::array<const char*, Profiler::COUNTER_COUNT> COUNTER_NAMES{ { "midiToJava", "midiDropped", "midiToOutputs", "bytesToJava", "updatesMerged" } };
+	const std::array<const char*, Profiler::HOP_COUNT> HOP_NAMES{ { "inputQueue", "toJava", "javaResponse", "outputQueue", "roundTrip" } };
+}
+
+
+/**
+ * Trace an incoming MIDI message which is handed to Java. Must be called from the thread which
+ * calls Java right before the call.
+ *
+ * @param traceId The trace ID of the message
+ * @param queued The time when the message was queued in the audio thread
+ * @param sent The time when the message was taken from the queue
+ */
+void Profiler::TraceToJava(std::uint32_t traceId, std::int64_t queued, std::int64_t sent) noexcept
+{
+	this->RecordHop(Hop::INPUT_QUEUE, queued, sent);
+
+	this->lastQueued.store(queued);
+	this->lastReturned.store(std::numeric_limits<std::int64_t>::max());
+	this->lastTraceId.store(traceId);
+	this->pendingResponse.store(traceId);
+	this->pendingRoundTrip.store(traceId);
+}
+
+
+/**
+ * Trace the return of the call which handed an incoming MIDI message to Java.
+ *
+ * @param sent The time when the message was sent to Java
+ * @param returned The time when the call to Java returned
+ */
+void Profiler::TraceReturnFromJava(std::int64_t sent, std::int64_t returned) noexcept
+{
+	this->RecordHop(Hop::TO_JAVA, sent, returned);
+	this->lastReturned.store(returned);
+}
+
+
+/**
+ * Get the trace ID for a message sent from Java. Measures the time until the first response to
+ * the incoming message which was last handed to Java. If Java responds while the call is still
+ * running the time is 0.
+ *
+ * @param now The current time
+ * @return The trace ID of the incoming message, 0 if there is none
+ */
+std::uint32_t Profiler::TraceJavaResponse(std::int64_t now) noexcept
+{
+	std::uint32_t traceId = this->lastTraceId.load();
+	if (traceId != 0 && this->pendingResponse.compare_exchange_strong(traceId, 0))
+	{
+		const std::int64_t returned = this->lastReturned.load();
+		this->RecordHop(Hop::JAVA_RESPONSE, now < returned ? now : returned, now);
+	}
+	return traceId;
+}
+
+
+/**
+ * Trace a MIDI message which was sent to an output port.
+ *
+ * @param traceId The trace ID of the incoming message to which this is the response, 0 if none
+ * @param queued The time when the message was queued by Java
+ * @param sent The time when the message was sent to the output port
+ */
+void Profiler::TraceOutput(std::uint32_t traceId, std::int64_t queued, std::int64_t sent) noexcept
+{
+	this->RecordHop(Hop::OUTPUT_QUEUE, queued, sent);
+
+	std::uint32_t expected = traceId;
+	if (traceId != 0 && this->pendingRoundTrip.compare_exchange_strong(expected, 0))
+		this->RecordHop(Hop::ROUND_TRIP, this->lastQueued.load(), sent);
+}
+
+
+/**
+ * Append the timers, counters and MIDI latencies as the members "timers", "counters" and
+ * "midiLatency" of a JSON object.
+ *
+ * @param ss The stream to append to
+ * @param reset If true, the timers are reset afterwards, counters are never reset
+ */
+void Profiler::WriteJson(std::ostringstream& ss, bool reset)
+{
+	ss << "\"timers\":{";
+	for (std::size_t i = 0; i < TIMER_COUNT; i++)
+	{
+		ss << (i == 0 ? "\"" : ",\"") << TIMER_NAMES[i] << "\":";
+		this->timers[i].GetValues(reset).WriteJson(ss);
+	}
+	ss << "},\"counters\":{";
+	for (std::size_t i = 0; i < COUNTER_COUNT; i++)
+		ss << (i == 0 ? "\"" : ",\"") << COUNTER_NAMES[i] << "\":" << this->counters[i].load();
+	ss << "},\"midiLatency\":{\"tracing\":" << (this->isMidiTracing.load() ? "true" : "false");
+	for (std::size_t i = 0; i < HOP_COUNT; i++)
+	{
+		ss << ",\"" << HOP_NAMES[i] << "\":";
+		this->hops[i].GetValues(reset).WriteJson(ss);
+	}
+	ss << "}";
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_PROFILER_H_
+#define _DBM_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+
+#include "StageTimer.h"
+
+
+/**
+ * Timers and counters of the main thread and audio thread tasks of the surface. Always enabled,
+ * recording does not lock or allocate.
+ *
+ * If MIDI tracing is enabled, the MIDI messages get a trace ID and the time when they were queued.
+ * The latency is measured for each hop: from the audio thread to the main thread, the call into
+ * Java, the time until Java sends the first response, the queue to the output port and from
+ * receiving a message to sending the response. Java does not pass the trace ID along, therefore
+ * outgoing messages are assigned to the incoming message which was last handed to Java.
+ */
+class Profiler
+{
+public:
+	/** The measured tasks. */
+	enum class Timer
+	{
+		RUN, EXECUTE_FUNCTIONS, UPDATE_MODEL, MIDI_TO_JAVA, PROCESS_COMMANDS, AUDIO_BUFFER
+	};
+	static const std::size_t TIMER_COUNT{ 6 };
+
+	/** The counted events. */
+	enum class Counter
+	{
+		MIDI_TO_JAVA, MIDI_DROPPED, MIDI_TO_OUTPUTS, BYTES_TO_JAVA, UPDATES_MERGED
+	};
+	static const std::size_t COUNTER_COUNT{ 5 };
+
+	/** The hops of a traced MIDI message. */
+	enum class Hop
+	{
+		INPUT_QUEUE, TO_JAVA, JAVA_RESPONSE, OUTPUT_QUEUE, ROUND_TRIP
+	};
+	static const std::size_t HOP_COUNT{ 5 };
+
+
+	Profiler() = default;
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+	Profiler(Profiler&&) = delete;
+	Profiler& operator=(Profiler&&) = delete;
+	~Profiler() {};
+
+	/**
+	 * Get the timer of a task.
+	 *
+	 * @param timer The task
+	 * @return The timer
+	 */
+	StageTimer& GetTimer(Timer timer) noexcept
+	{
+		return this->timers[static_cast<std::size_t>(timer)];
+	}
+
+	/**
+	 * Increase a counter.
+	 *
+	 * @param counter The counter
+	 * @param value The value to add
+	 */
+	void Count(Counter counter, unsigned long long value = 1) noexcept
+	{
+		this->counters[static_cast<std::size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Enable or disable the tracing of MIDI messages.
+	 *
+	 * @param enable True to enable
+	 */
+	void EnableMidiTracing(bool enable) noexcept
+	{
+		this->isMidiTracing.store(enable, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Get the current time for tracing MIDI messages.
+	 *
+	 * @return The time in nanoseconds of the monotonic clock
+	 */
+	static std::int64_t GetTimestamp() noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * Start tracing a MIDI message received from a device.
+	 *
+	 * @param message The message to which to assign the trace ID and timestamp
+	 */
+	template<typename T>
+	void TraceIncoming(T& message) noexcept
+	{
+		if (!this->isMidiTracing.load(std::memory_order_relaxed))
+			return;
+		message.traceId = this->nextTraceId.fetch_add(1, std::memory_order_relaxed);
+		message.timestamp = GetTimestamp();
+	}
+
+	/**
+	 * Start tracing a MIDI message sent from Java.
+	 *
+	 * @param message The message to which to assign the trace ID and timestamp
+	 */
+	template<typename T>
+	void TraceOutgoing(T& message) noexcept
+	{
+		if (!this->isMidiTracing.load(std::memory_order_relaxed))
+			return;
+		message.timestamp = GetTimestamp();
+		message.traceId = this->TraceJavaResponse(message.timestamp);
+	}
+
+	void TraceToJava(std::uint32_t traceId, std::int64_t queued, std::int64_t sent) noexcept;
+	void TraceReturnFromJava(std::int64_t sent, std::int64_t returned) noexcept;
+	void TraceOutput(std::uint32_t traceId, std::int64_t queued, std::int64_t sent) noexcept;
+
+	void WriteJson(std::ostringstream& ss, bool reset);
+
+private:
+	std::array<StageTimer, TIMER_COUNT> timers{};
+	std::array<std::atomic<unsigned long long>, COUNTER_COUNT> counters{};
+
+	std::array<StageTimer, HOP_COUNT> hops{};
+	std::atomic<bool> isMidiTracing{ false };
+	// Starts with 1 since 0 marks messages which are not assigned to an incoming message
+	std::atomic<std::uint32_t> nextTraceId{ 1 };
+	// The incoming message which was last handed to Java
+	std::atomic<std::uint32_t> lastTraceId{ 0 };
+	std::atomic<std::int64_t> lastQueued{ 0 };
+	// The time when the call to Java returned, INT64_MAX while the call is running
+	std::atomic<std::int64_t> lastReturned{ 0 };
+	// The incoming messages for which no response was measured yet
+	std::atomic<std::uint32_t> pendingResponse{ 0 };
+	std::atomic<std::uint32_t> pendingRoundTrip{ 0 };
+
+	std::uint32_t TraceJavaResponse(std::int64_t now) noexcept;
+
+	/**
+	 * Record the latency of a hop.
+	 *
+	 * @param hop The hop
+	 * @param start The time when the hop started
+	 * @param end The time when the hop ended
+	 */
+	void RecordHop(Hop hop, std::int64_t start, std::int64_t end) noexcept
+	{
+		this->hops[static_cast<std::size_t>(hop)].Record(end - start);
+	}
+};
+
+#endif /* _DBM_PROFILER_H_ */
@@ -21,7 +21,7 @@ ProjectProcessor::ProjectProcessor(Model &aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void ProjectProcessor::Process(std::deque<std::string>& path)
+void ProjectProcessor::Process(const OscPath& path)
 {
 	if (path.empty())
 		return;
@@ -37,7 +37,7 @@ void ProjectProcessor::Process(std::deque<std::string>& path)
 		if (sceneID >= 0)
 		{
 			const std::unique_ptr<Marker>& scene = this->model.GetRegion(sceneID);
-			SceneProcessor::DuplicateScene(project, sceneID, scene.get());
+			SceneProcessor::DuplicateScene(this->model.GetUndoBatch(), project, sceneID, scene.get());
 		}
 		return;
 	}
@@ -45,14 +45,14 @@ void ProjectProcessor::Process(std::deque<std::string>& path)
 
 
 /** {@inheritDoc} */
-void ProjectProcessor::Process(std::deque<std::string>& path, int value)
+void ProjectProcessor::Process(const OscPath& path, int value)
 {
 	if (path.empty())
 		return;
 
-	const char* cmd = SafeGet(path, 0);
-
-	if (std::strcmp(cmd, "engine") == 0)
+	switch (path.GetHash(0))
+	{
+	case OscPath::Hash("engine"):
 	{
 		if (value > 0)
 			Audio_Init();
@@ -61,7 +61,7 @@ void ProjectProcessor::Process(std::deque<std::string>& path, int value)
 		return;
 	}
 
-	if (std::strcmp(cmd, "createScene") == 0)
+	case OscPath::Hash("createScene"):
 	{
 		ReaProject* project = ReaperUtils::GetProject();
 		const std::vector<int> regions = Marker::GetRegions(project);
@@ -81,12 +81,16 @@ void ProjectProcessor::Process(std::deque<std::string>& path, int value)
 
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
 void ProjectProcessor::CreateRegion(ReaProject* project, double start, double length) noexcept
 {
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 	AddProjectMarker(project, true, start, start + length, nullptr, 0);
-	Undo_EndBlock2(project, "Add region marker", UNDO_STATE_ALL);
+	this->model.GetUndoBatch().EndBlock(project, "Add region marker", UNDO_STATE_ALL);
 }
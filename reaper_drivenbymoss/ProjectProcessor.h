@@ -15,12 +15,17 @@ class ProjectProcessor : public OscProcessor
 public:
 	ProjectProcessor(Model &aModel);
 
-	void Process(std::deque<std::string> &path) override;
-	void Process(std::deque<std::string>& path, int value) override;
+	void Process(const OscPath& path) override;
+	void Process(const OscPath& path, int value) override;
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
 
 private:
 	void CreateRegion(ReaProject* project, double start, double length) noexcept;
@@ -13,6 +13,7 @@
 constexpr bool ENABLE_EXTENSION{ true };
 constexpr bool ENABLE_JAVA{ true };
 constexpr bool ENABLE_JAVA_START{ true };
+constexpr bool ENABLE_CLASS_DATA_SHARING{ true };
 
 // Enable or disable for debugging. If debugging is enabled Reaper is waiting for a Java debugger
 // to be connected on port 8989, only then the start continues!
@@ -187,7 +187,20 @@ public:
 	 */
 	static double GetEnvelopeValueAtPosition(TrackEnvelope* envelope, double position) noexcept
 	{
-		const int sampleRate = ReaperUtils::GetIntConfigValue("projsrate");
+		return GetEnvelopeValueAtPosition(envelope, position, ReaperUtils::GetIntConfigValue("projsrate"));
+	}
+
+
+	/**
+	 * Calculates the value of the given envelope at the given timeline position.
+	 *
+	 * @param envelope The envelope
+	 * @param position A position on the timeline
+	 * @param sampleRate The sample rate of the project
+	 * @return The calculated value
+	 */
+	static double GetEnvelopeValueAtPosition(TrackEnvelope* envelope, double position, int sampleRate) noexcept
+	{
 		double value;
 		Envelope_Evaluate(envelope, position, sampleRate, 1, &value, nullptr, nullptr, nullptr);
 		return ScaleFromEnvelopeMode(GetEnvelopeScalingMode(envelope), value);
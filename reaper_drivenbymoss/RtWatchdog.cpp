@@ -0,0 +1,213 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <array>
+#include <atomic>
+
+#include "RtWatchdog.h"
+#include "ReaDebug.h"
+
+
+namespace
+{
+	const std::array<const char*, RtWatchdog::VIOLATION_COUNT> VIOLATION_NAMES{ { "allocations", "deallocations", "locks", "overruns" } };
+
+	// Set while the thread executes the audio hook
+	thread_local bool isInAudioHook{ false };
+	// All wrapped allocations of the thread, also outside of the audio hook
+	thread_local unsigned long long threadAllocations{ 0 };
+
+	std::array<std::atomic<unsigned long long>, RtWatchdog::VIOLATION_COUNT> violations{};
+	// The longest audio hook in 1/1000 of the block length
+	std::atomic<long long> maxBlockPermille{ 0 };
+	// The sum of all violations which were already logged
+	unsigned long long loggedViolations{ 0 };
+}
+
+
+/**
+ * Constructor.
+ *
+ * @param length The number of samples of the audio block
+ * @param sampleRate The sample rate
+ */
+RtWatchdog::Scope::Scope(int length, double sampleRate) noexcept :
+	blockNanos(sampleRate > 0 ? static_cast<long long>(length * 1000000000.0 / sampleRate) : 0)
+{
+	isInAudioHook = true;
+}
+
+
+/**
+ * Destructor. Checks the duration of the audio hook.
+ */
+RtWatchdog::Scope::~Scope()
+{
+	isInAudioHook = false;
+	if (this->blockNanos <= 0)
+		return;
+
+	const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+	const long long permille = nanos * 1000 / this->blockNanos;
+	long long max = maxBlockPermille.load(std::memory_order_relaxed);
+	while (permille > max && !maxBlockPermille.compare_exchange_weak(max, permille, std::memory_order_relaxed))
+	{
+		// Retry, max was updated
+	}
+	if (nanos > this->blockNanos * MAX_BLOCK_SHARE)
+		violations[static_cast<std::size_t>(Violation::OVERRUN)].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * Count a violation if the current thread is inside of the audio hook. Must neither allocate nor
+ * lock since it is called from the wrapped functions.
+ *
+ * @param violation The type of the violation
+ */
+void RtWatchdog::Check(Violation violation) noexcept
+{
+	if (violation == Violation::ALLOCATION)
+		threadAllocations++;
+	if (isInAudioHook)
+		violations[static_cast<std::size_t>(violation)].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * Get the number of allocations of the current thread. Only counted in the diagnostic build on
+ * Linux, 0 otherwise.
+ *
+ * @return The number of allocations since the start of the thread
+ */
+unsigned long long RtWatchdog::GetThreadAllocations() noexcept
+{
+	return threadAllocations;
+}
+
+
+/**
+ * Write the number of violations to the log if there were new ones. Must be called from the main
+ * thread.
+ */
+void RtWatchdog::LogNewViolations()
+{
+	unsigned long long sum{ 0 };
+	for (const std::atomic<unsigned long long>& count : violations)
+		sum += count.load(std::memory_order_relaxed);
+	if (sum == loggedViolations)
+		return;
+	loggedViolations = sum;
+
+	std::ostringstream ss;
+	WriteJson(ss, false);
+	ReaDebug() << "Real-time safety violations in the audio hook: " << ss.str();
+}
+
+
+/**
+ * Append the violations as a JSON object.
+ *
+ * @param ss The stream to append to
+ * @param reset If true, the maximum duration is reset afterwards, counters are never reset
+ */
+void RtWatchdog::WriteJson(std::ostringstream& ss, bool reset)
+{
+	ss << "{";
+	for (std::size_t i = 0; i < VIOLATION_COUNT; i++)
+		ss << (i == 0 ? "\"" : ",\"") << VIOLATION_NAMES[i] << "\":" << violations[i].load(std::memory_order_relaxed);
+	ss << ",\"maxBlockPermille\":" << (reset ? maxBlockPermille.exchange(0) : maxBlockPermille.load()) << "}";
+}
+
+
+#if defined(DBM_RT_WATCHDOG) && defined(LINUX)
+
+#include <cstdlib>
+#include <pthread.h>
+
+// The functions are wrapped with the linker option --wrap, see CMakeLists.txt. The original
+// functions are available with the prefix __real_
+extern "C"
+{
+	void* __real_malloc(std::size_t size);
+	void* __real_calloc(std::size_t count, std::size_t size);
+	void* __real_realloc(void* pointer, std::size_t size);
+	void __real_free(void* pointer);
+	void* __real__Znwm(std::size_t size);
+	void* __real__Znam(std::size_t size);
+	void __real__ZdlPv(void* pointer);
+	void __real__ZdlPvm(void* pointer, std::size_t size);
+	void __real__ZdaPv(void* pointer);
+	int __real_pthread_mutex_lock(pthread_mutex_t* mutex);
+
+	void* __wrap_malloc(std::size_t size)
+	{
+		RtWatchdog::Check(RtWatchdog::Violation::ALLOCATION);
+		return __real_malloc(size);
+	}
+
+	void* __wrap_calloc(std::size_t count, std::size_t size)
+	{
+		RtWatchdog::Check(RtWatchdog::Violation::ALLOCATION);
+		return __real_calloc(count, size);
+	}
+
+	void* __wrap_realloc(void* pointer, std::size_t size)
+	{
+		RtWatchdog::Check(RtWatchdog::Violation::ALLOCATION);
+		return __real_realloc(pointer, size);
+	}
+
+	void __wrap_free(void* pointer)
+	{
+		if (pointer != nullptr)
+			RtWatchdog::Check(RtWatchdog::Violation::DEALLOCATION);
+		__real_free(pointer);
+	}
+
+	// operator new(std::size_t)
+	void* __wrap__Znwm(std::size_t size)
+	{
+		RtWatchdog::Check(RtWatchdog::Violation::ALLOCATION);
+		return __real__Znwm(size);
+	}
+
+	// operator new[](std::size_t)
+	void* __wrap__Znam(std::size_t size)
+	{
+		RtWatchdog::Check(RtWatchdog::Violation::ALLOCATION);
+		return __real__Znam(size);
+	}
+
+	// operator delete(void*)
+	void __wrap__ZdlPv(void* pointer)
+	{
+		if (pointer != nullptr)
+			RtWatchdog::Check(RtWatchdog::Violation::DEALLOCATION);
+		__real__ZdlPv(pointer);
+	}
+
+	// operator delete(void*, std::size_t)
+	void __wrap__ZdlPvm(void* pointer, std::size_t size)
+	{
+		if (pointer != nullptr)
+			RtWatchdog::Check(RtWatchdog::Violation::DEALLOCATION);
+		__real__ZdlPvm(pointer, size);
+	}
+
+	// operator delete[](void*)
+	void __wrap__ZdaPv(void* pointer)
+	{
+		if (pointer != nullptr)
+			RtWatchdog::Check(RtWatchdog::Violation::DEALLOCATION);
+		__real__ZdaPv(pointer);
+	}
+
+	int __wrap_pthread_mutex_lock(pthread_mutex_t* mutex)
+	{
+		RtWatchdog::Check(RtWatchdog::Violation::LOCK);
+		return __real_pthread_mutex_lock(mutex);
+	}
+}
+
+#endif
@@ -0,0 +1,65 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_RTWATCHDOG_H_
+#define _DBM_RTWATCHDOG_H_
+
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+
+
+/**
+ * Detects violations of the real-time safety in the audio hook. Only used in a diagnostic build
+ * which is configured with -DDBM_RT_WATCHDOG=ON.
+ *
+ * On Linux the calls of the extension to malloc, free, operator new and delete and
+ * pthread_mutex_lock are wrapped by the linker and counted if they happen inside of the audio
+ * hook. Calls inside of Reaper or the C++ runtime are not seen. On all platforms the duration of
+ * the audio hook is compared to the length of the audio block.
+ *
+ * The wrapped allocations are also counted per thread on all threads, which allows the benchmark
+ * of the headless host to measure the allocations of the main thread.
+ */
+class RtWatchdog
+{
+public:
+	/** The types of violations. */
+	enum class Violation
+	{
+		ALLOCATION, DEALLOCATION, LOCK, OVERRUN
+	};
+	static const std::size_t VIOLATION_COUNT{ 4 };
+
+	/**
+	 * Marks the current thread as being inside of the audio hook until it is destroyed.
+	 */
+	class Scope
+	{
+	public:
+		Scope(int length, double sampleRate) noexcept;
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+		Scope& operator=(Scope&&) = delete;
+		~Scope();
+
+	private:
+		const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+		long long blockNanos;
+	};
+
+
+	RtWatchdog() = delete;
+
+	static void Check(Violation violation) noexcept;
+	static unsigned long long GetThreadAllocations() noexcept;
+	static void LogNewViolations();
+	static void WriteJson(std::ostringstream& ss, bool reset);
+
+private:
+	/** The audio hook should only take this share of the length of the audio block. */
+	static constexpr double MAX_BLOCK_SHARE{ 0.1 };
+};
+
+#endif /* _DBM_RTWATCHDOG_H_ */
@@ -1,6 +1,7 @@
 // Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
 // Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
 
+#include <algorithm>
 #include <sstream>
 
 #include "WrapperGSL.h"
@@ -21,19 +22,18 @@ SceneProcessor::SceneProcessor(Model& aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void SceneProcessor::Process(std::deque<std::string>& path)
+void SceneProcessor::Process(const OscPath& path)
 {
 	if (path.empty())
 		return;
-	const char* part = SafeGet(path, 0);
 
 	ReaProject* project = ReaperUtils::GetProject();
 
 	if (path.size() < 2)
 		return;
 
-	const int index = atoi(part);
-	const char* cmd = SafeGet(path, 1);
+	const int index = path.GetInt(0);
+	const std::uint64_t cmd = path.GetHash(1);
 
 	const std::vector<int> regions = Marker::GetRegions(project);
 	if (index < 0 || index >= gsl::narrow_cast<int>(regions.size()))
@@ -41,46 +41,51 @@ void SceneProcessor::Process(std::deque<std::string>& path)
 	const int sceneID = regions.at(index);
 	const std::unique_ptr<Marker>& scene = this->model.GetRegion(sceneID);
 
-	const bool isLaunch = std::strcmp(cmd, "launch") == 0;
-	if (std::strcmp(cmd, "select") == 0 || isLaunch)
+	switch (cmd)
+	{
+	case OscPath::Hash("select"):
+	case OscPath::Hash("launch"):
 	{
 		SetEditCurPos2(project, scene->position, true, true);
 		GetSet_LoopTimeRange2(project, true, true, &scene->position, &scene->endPosition, false);
-		if (isLaunch && (GetPlayStateEx(project) & 1) == 0)
+		if (cmd == OscPath::Hash("launch") && (GetPlayStateEx(project) & 1) == 0)
 			CSurf_OnPlay();
 		return;
 	}
 
-	if (std::strcmp(cmd, "remove") == 0)
+	case OscPath::Hash("remove"):
 	{
 		// Note: This method seems not to support Undo ...
 		DeleteProjectMarkerByIndex(project, sceneID);
 		// ... at least we can change the state, so the document state gets updated
-		Undo_OnStateChange2(project, "Delete region.");
+		this->model.GetUndoBatch().OnStateChange(project, "Delete region.", UNDO_STATE_MISCCFG);
 		return;
 	}
 
-	if (std::strcmp(cmd, "duplicate") == 0)
+	case OscPath::Hash("duplicate"):
 	{
-		DuplicateScene(project, sceneID, scene.get());
+		DuplicateScene(this->model.GetUndoBatch(), project, sceneID, scene.get());
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
 /** {@inheritDoc} */
-void SceneProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void SceneProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	if (path.empty())
 		return;
-	const char* part = SafeGet(path, 0);
 
 	ReaProject* project = ReaperUtils::GetProject();
 
 	if (path.size() < 2)
 		return;
 
-	const int index = atoi(part);
+	const int index = path.GetInt(0);
 	const char* cmd = SafeGet(path, 1);
 
 	const std::vector<int> scenes = Marker::GetRegions(project);
@@ -111,17 +116,17 @@ void SceneProcessor::Process(std::deque<std::string>& path, const std::string& v
 				return;
 			}
 
-			Undo_BeginBlock2(project);
+			this->model.GetUndoBatch().BeginBlock(project);
 			SetProjectMarker4(project, scene->markerOrRegionIndex, true, scene->position, scene->endPosition, "", ColorToNative(red, green, blue) | 0x1000000, 0);
-			Undo_EndBlock2(project, "Change region color", UNDO_STATE_ALL);
+			this->model.GetUndoBatch().EndBlock(project, "Change region color", UNDO_STATE_ALL);
 			return;
 		}
 
 		if (std::strcmp(cmd, "name") == 0)
 		{
-			Undo_BeginBlock2(project);
+			this->model.GetUndoBatch().BeginBlock(project);
 			SetProjectMarker4(project, scene->markerOrRegionIndex, true, scene->position, scene->endPosition, value.c_str(), scene->colorNumber ? scene->colorNumber | 0x1000000 : 0, value.length() == 0 ? 1 : 0);
-			Undo_EndBlock2(project, "Rename region", UNDO_STATE_ALL);
+			this->model.GetUndoBatch().EndBlock(project, "Rename region", UNDO_STATE_ALL);
 			return;
 		}
 	}
@@ -132,25 +137,47 @@ void SceneProcessor::Process(std::deque<std::string>& path, const std::string& v
 }
 
 
-void SceneProcessor::DuplicateScene(ReaProject* project, const int sceneID, Marker* scene)
+/**
+ * Duplicate a region. All content starting in the region or later is moved behind the region and
+ * the items in the region are copied into the gap. The selection of items, the time selection and
+ * the clipboard are not changed.
+ *
+ * @param undoBatch Where to register the undo point
+ * @param project The project
+ * @param sceneID The index of the region in the project
+ * @param scene The region to duplicate
+ */
+void SceneProcessor::DuplicateScene(UndoBatch& undoBatch, ReaProject* project, const int sceneID, Marker* scene)
 {
-	Undo_BeginBlock2(project);
+	const double start = scene->position;
+	const double end = scene->endPosition;
+	if (end <= start)
+		return;
+
+	undoBatch.BeginBlock(project);
 
-	// Set the time range to the region
-	SetEditCurPos2(project, scene->position, true, true);
-	GetSet_LoopTimeRange2(project, true, true, &scene->position, &scene->endPosition, false);
+	// Collect the items before they are moved by inserting the empty space
+	const std::vector<ItemCopy> itemCopies = CollectItems(project, start, end);
 
-	// Item: Select all items in current time selection
-	Main_OnCommandEx(40717, 0, project);
-	// Time selection : Insert empty space at time selection(moving later items)
+	// Time selection: Insert empty space at time selection (moving later items). Keeps automation,
+	// markers and tempo changes in sync with the items
+	double timeSelectionStart{ 0 };
+	double timeSelectionEnd{ 0 };
+	GetSet_LoopTimeRange2(project, false, false, &timeSelectionStart, &timeSelectionEnd, false);
+	const double cursorPosition = GetCursorPositionEx(project);
+	double regionStart = start;
+	double regionEnd = end;
+	GetSet_LoopTimeRange2(project, true, false, &regionStart, &regionEnd, false);
 	Main_OnCommandEx(40200, 0, project);
-	// Item: Copy items to time selection, trim / loop to fit
-	Main_OnCommandEx(41319, 0, project);
+	GetSet_LoopTimeRange2(project, true, false, &timeSelectionStart, &timeSelectionEnd, false);
+	SetEditCurPos2(project, cursorPosition, false, false);
 
-	// Get the new position of the region
-	double newPosition;
-	double newEndPosition;
-	EnumProjectMarkers2(project, sceneID, nullptr, &newPosition, &newEndPosition, nullptr, nullptr);
+	for (const ItemCopy& itemCopy : itemCopies)
+		PasteItem(itemCopy, start, end);
+
+	// The moved region now contains the original items
+	const double newPosition = end;
+	const double newEndPosition = end + end - start;
 
 	// Move the region back to its' original position
 	SetProjectMarkerByIndex2(project, sceneID, true, scene->position, scene->endPosition, scene->markerOrRegionIndex, scene->name.c_str(), 0, 0);
@@ -173,5 +200,108 @@ void SceneProcessor::DuplicateScene(ReaProject* project, const int sceneID, Mark
 		ReaDebug() << "ERROR: Could not add marker: " << e.what();
 	}
 
-	Undo_EndBlock2(project, "Duplicate region", UNDO_STATE_ALL);
+	undoBatch.EndBlock(project, "Duplicate region", UNDO_STATE_ALL);
+}
+
+
+/**
+ * Get the state of all items which overlap a range.
+ *
+ * @param project The project
+ * @param start The start of the range
+ * @param end The end of the range
+ * @return The states of the items
+ */
+std::vector<SceneProcessor::ItemCopy> SceneProcessor::CollectItems(ReaProject* project, double start, double end)
+{
+	std::vector<ItemCopy> itemCopies;
+	const int trackCount = CountTracks(project);
+	for (int trackIndex = 0; trackIndex < trackCount; trackIndex++)
+	{
+		MediaTrack* track = GetTrack(project, trackIndex);
+		if (track == nullptr)
+			continue;
+		const int itemCount = CountTrackMediaItems(track);
+		for (int itemIndex = 0; itemIndex < itemCount; itemIndex++)
+		{
+			MediaItem* item = GetTrackMediaItem(track, itemIndex);
+			if (item == nullptr)
+				continue;
+			const double position = GetMediaItemInfo_Value(item, "D_POSITION");
+			// The items of a track are sorted by their position
+			if (position >= end)
+				break;
+			const double length = GetMediaItemInfo_Value(item, "D_LENGTH");
+			if (position + length <= start)
+				continue;
+
+			char* chunk = GetSetObjectState(item, "");
+			if (chunk == nullptr)
+				continue;
+			itemCopies.push_back({ track, RemoveGuids(chunk), position, length });
+			FreeHeapPtr(chunk);
+		}
+	}
+	return itemCopies;
+}
+
+
+/**
+ * Create a copy of an item on its track. The copy is trimmed to a range.
+ *
+ * @param itemCopy The state of the item to copy
+ * @param start The start of the range
+ * @param end The end of the range
+ */
+void SceneProcessor::PasteItem(const ItemCopy& itemCopy, double start, double end)
+{
+	const double position = std::max(start, itemCopy.position);
+	const double length = std::min(end, itemCopy.position + itemCopy.length) - position;
+	if (length <= 0)
+		return;
+
+	MediaItem* item = AddMediaItemToTrack(itemCopy.track);
+	if (item == nullptr)
+		return;
+	SetItemStateChunk(item, itemCopy.chunk.c_str(), false);
+
+	// Trim the start of the takes if the item starts before the range
+	const double trimmed = position - itemCopy.position;
+	if (trimmed > 0)
+	{
+		const int takeCount = CountTakes(item);
+		for (int i = 0; i < takeCount; i++)
+		{
+			MediaItem_Take* take = GetTake(item, i);
+			if (take == nullptr)
+				continue;
+			const double offset = GetMediaItemTakeInfo_Value(take, "D_STARTOFFS");
+			SetMediaItemTakeInfo_Value(take, "D_STARTOFFS", offset + trimmed * GetMediaItemTakeInfo_Value(take, "D_PLAYRATE"));
+		}
+	}
+	SetMediaItemInfo_Value(item, "D_POSITION", position);
+	SetMediaItemInfo_Value(item, "D_LENGTH", length);
+}
+
+
+/**
+ * Remove the GUIDs from the state of an item, new ones are created when the state is applied.
+ * Pooled MIDI is unpooled.
+ *
+ * @param chunk The state of the item
+ * @return The state without the GUIDs
+ */
+std::string SceneProcessor::RemoveGuids(const char* chunk)
+{
+	std::istringstream input(chunk);
+	std::string result;
+	std::string line;
+	while (std::getline(input, line))
+	{
+		const std::size_t first = line.find_first_not_of(" \t");
+		if (first != std::string::npos && (line.compare(first, 6, "IGUID ") == 0 || line.compare(first, 5, "GUID ") == 0 || line.compare(first, 11, "POOLEDEVTS ") == 0))
+			continue;
+		result.append(line).append("\n");
+	}
+	return result;
 }
@@ -15,13 +15,32 @@ class SceneProcessor : public OscProcessor
 public:
 	SceneProcessor(Model &aModel);
 
-	void Process(std::deque<std::string> &path) override;
-
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override;
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
-
-	static void DuplicateScene(ReaProject* project, const int sceneID, Marker* scene);
+	void Process(const OscPath& path) override;
+
+	void Process(const OscPath& path, const std::string& value) noexcept override;
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
+
+	static void DuplicateScene(UndoBatch& undoBatch, ReaProject* project, const int sceneID, Marker* scene);
+
+private:
+	// The state of a media item which is copied
+	struct ItemCopy
+	{
+		MediaTrack* track;
+		std::string chunk;
+		double position;
+		double length;
+	};
+
+	static std::vector<ItemCopy> CollectItems(ReaProject* project, double start, double end);
+	static void PasteItem(const ItemCopy& itemCopy, double start, double end);
+	static std::string RemoveGuids(const char* chunk);
 };
 
 #endif /* _DBM_SCENEPROCESSOR_H_ */
@@ -38,12 +38,14 @@ Send::~Send()
  * Collect the (changed) send data.
  *
  * @param ss The stream where to append the formatted data
- * @param project The current Reaper project
  * @param track The track
  * @param sendIndex The index of the send
+ * @param trackAddress The OSC address of the track
+ * @param envelope The active volume envelope of the send or null
+ * @param context The automation context of the current data collection pass
  * @param dump If true all data is collected not only the changed one since the last call
  */
-void Send::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack* track, int sendIndex, const std::string& trackAddress, const bool& dump)
+void Send::CollectData(std::ostringstream& ss, MediaTrack* track, int sendIndex, const std::string& trackAddress, TrackEnvelope* envelope, const AutomationContext& context, const bool& dump)
 {
 	std::ostringstream stream;
 	stream << trackAddress << "send/" << sendIndex << "/";
@@ -63,7 +65,7 @@ void Send::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack*
 	this->name = Collectors::CollectStringValue(ss, sendAddress + "name", this->name, newName, dump);
 
 	// Get the volume
-	const double volDB = GetSendVolume(track, sendIndex, ReaperUtils::GetCursorPosition(project));
+	const double volDB = GetSendVolume(track, sendIndex, envelope, context);
 	this->volume = Collectors::CollectDoubleValue(ss, sendAddress + "volume", this->volume, DB2SLIDER(volDB) / 1000.0, dump);
 	this->volumeStr = Collectors::CollectStringValue(ss, sendAddress + "volume/str", this->volumeStr, Collectors::FormatDB(volDB).c_str(), dump);
 
@@ -79,24 +81,9 @@ void Send::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack*
 }
 
 
-double Send::GetSendVolume(MediaTrack* track, int sendCounter, double position) const noexcept
+double Send::GetSendVolume(MediaTrack* track, int sendCounter, TrackEnvelope* envelope, const AutomationContext& context) const noexcept
 {
-	const char* sendType = "<VOLENV";
-	if (GetMediaTrackInfo_Value(track, "I_AUTOMODE") > 0)
-	{
-		DISABLE_WARNING_NO_C_STYLE_CONVERSION
-		TrackEnvelope* envelope = static_cast<TrackEnvelope*> (GetSetTrackSendInfo(track, 0, sendCounter, "P_ENV", (void*)sendType));
-		if (envelope != nullptr)
-		{
-			// It seems there is always a send envelope, even if not active.
-			// Therefore, check if the envelope is active
-			for (int i = 0; i < CountTrackEnvelopes(track); i++)
-			{
-				const TrackEnvelope* te = GetTrackEnvelope(track, i);
-				if (envelope == te)
-					return ReaperUtils::ValueToDB(ReaperUtils::GetEnvelopeValueAtPosition(envelope, position));
-			}
-		}
-	}
+	if (envelope != nullptr)
+		return ReaperUtils::ValueToDB(ReaperUtils::GetEnvelopeValueAtPosition(envelope, context.position, context.sampleRate));
 	return ReaperUtils::ValueToDB(GetTrackSendInfo_Value(track, 0, sendCounter, "D_VOL"));
 }
@@ -7,6 +7,7 @@
 #include <string>
 
 #include "ReaperUtils.h"
+#include "TrackAutomation.h"
 
 
 /**
@@ -28,10 +29,10 @@ public:
 	Send& operator=(Send&&) = delete;
 	virtual ~Send();
 
-	void CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack* track, int sendIndex, const std::string& trackAddress, const bool& dump);
+	void CollectData(std::ostringstream& ss, MediaTrack* track, int sendIndex, const std::string& trackAddress, TrackEnvelope* envelope, const AutomationContext& context, const bool& dump);
 
 private:
-	double GetSendVolume(MediaTrack* track, int sendCounter, double position) const noexcept;
+	double GetSendVolume(MediaTrack* track, int sendCounter, TrackEnvelope* envelope, const AutomationContext& context) const noexcept;
 };
 
 #endif /* _DBM_SEND_H_ */
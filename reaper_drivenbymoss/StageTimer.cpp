@@ -0,0 +1,93 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+
+#include "StageTimer.h"
+
+
+/**
+ * Add a duration.
+ *
+ * @param nanos The duration in nanoseconds
+ */
+void StageTimer::Record(long long nanos) noexcept
+{
+	if (nanos < 0)
+		nanos = 0;
+
+	this->count.fetch_add(1, std::memory_order_relaxed);
+	this->totalNanos.fetch_add(static_cast<unsigned long long>(nanos), std::memory_order_relaxed);
+
+	long long current = this->minNanos.load(std::memory_order_relaxed);
+	while (nanos < current && !this->minNanos.compare_exchange_weak(current, nanos, std::memory_order_relaxed))
+	{
+		// current was updated, try again
+	}
+	current = this->maxNanos.load(std::memory_order_relaxed);
+	while (nanos > current && !this->maxNanos.compare_exchange_weak(current, nanos, std::memory_order_relaxed))
+	{
+		// current was updated, try again
+	}
+
+	// The bucket is the position of the highest bit
+	std::size_t bucket = 0;
+	for (unsigned long long value = static_cast<unsigned long long>(nanos) >> 1; value != 0 && bucket < BUCKETS - 1; value >>= 1)
+		bucket++;
+	this->histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * Get the values of the timer. While durations are recorded at the same time the values might
+ * not be fully consistent.
+ *
+ * @param reset If true, the timer is reset afterwards
+ * @return The values
+ */
+StageTimer::Values StageTimer::GetValues(bool reset)
+{
+	Values values;
+	values.count = reset ? this->count.exchange(0) : this->count.load();
+	const unsigned long long total = reset ? this->totalNanos.exchange(0) : this->totalNanos.load();
+	const long long minimum = reset ? this->minNanos.exchange(LLONG_MAX) : this->minNanos.load();
+	values.maxNanos = reset ? this->maxNanos.exchange(0) : this->maxNanos.load();
+
+	std::array<unsigned long long, BUCKETS> buckets{};
+	unsigned long long bucketTotal{ 0 };
+	for (std::size_t i = 0; i < BUCKETS; i++)
+	{
+		buckets[i] = reset ? this->histogram[i].exchange(0) : this->histogram[i].load();
+		bucketTotal += buckets[i];
+	}
+
+	if (values.count == 0)
+		return values;
+	values.minNanos = minimum == LLONG_MAX ? 0 : minimum;
+	values.averageNanos = static_cast<long long>(total / values.count);
+
+	// The upper limit of the bucket which contains the 99th percentile
+	const unsigned long long limit = bucketTotal - bucketTotal / 100;
+	unsigned long long sum{ 0 };
+	for (std::size_t i = 0; i < BUCKETS; i++)
+	{
+		sum += buckets[i];
+		if (sum >= limit)
+		{
+			values.p99Nanos = std::min(values.maxNanos, static_cast<long long>((2ULL << i) - 1));
+			break;
+		}
+	}
+	return values;
+}
+
+
+/**
+ * Append the values as a JSON object.
+ *
+ * @param ss The stream to append to
+ */
+void StageTimer::Values::WriteJson(std::ostringstream& ss) const
+{
+	ss << "{\"count\":" << this->count << ",\"minNanos\":" << this->minNanos << ",\"avgNanos\":" << this->averageNanos << ",\"p99Nanos\":" << this->p99Nanos << ",\"maxNanos\":" << this->maxNanos << "}";
+}
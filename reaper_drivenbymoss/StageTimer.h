@@ -0,0 +1,79 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_STAGETIMER_H_
+#define _DBM_STAGETIMER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <sstream>
+
+
+/**
+ * Measures the durations of a repeated task. Recording does not lock or allocate and can be done
+ * from several threads, e.g. the audio thread. The durations are kept in a histogram with one
+ * bucket per power of 2 of nanoseconds from which the 99th percentile is estimated.
+ */
+class StageTimer
+{
+public:
+	/** The number of buckets of the histogram, the last one covers about 9 minutes and more. */
+	static const std::size_t BUCKETS{ 40 };
+
+	/** The values of a timer. */
+	struct Values
+	{
+		unsigned long long count{ 0 };
+		long long minNanos{ 0 };
+		long long averageNanos{ 0 };
+		long long p99Nanos{ 0 };
+		long long maxNanos{ 0 };
+
+		void WriteJson(std::ostringstream& ss) const;
+	};
+
+	/**
+	 * Measures the time from its creation until it is destroyed.
+	 */
+	class Scope
+	{
+	public:
+		explicit Scope(StageTimer& aTimer) noexcept : timer(aTimer) {};
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+		Scope& operator=(Scope&&) = delete;
+
+		~Scope()
+		{
+			this->timer.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count());
+		};
+
+	private:
+		StageTimer& timer;
+		const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+	};
+
+
+	StageTimer() = default;
+	StageTimer(const StageTimer&) = delete;
+	StageTimer& operator=(const StageTimer&) = delete;
+	StageTimer(StageTimer&&) = delete;
+	StageTimer& operator=(StageTimer&&) = delete;
+	~StageTimer() {};
+
+	void Record(long long nanos) noexcept;
+	Values GetValues(bool reset);
+
+private:
+	std::atomic<unsigned long long> count{ 0 };
+	std::atomic<unsigned long long> totalNanos{ 0 };
+	std::atomic<long long> minNanos{ LLONG_MAX };
+	std::atomic<long long> maxNanos{ 0 };
+	std::array<std::atomic<unsigned long long>, BUCKETS> histogram{};
+};
+
+#endif /* _DBM_STAGETIMER_H_ */
@@ -0,0 +1,98 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "CodeAnalysis.h"
+#include "ReaDebug.h"
+#include "ThreadEnv.h"
+
+
+namespace
+{
+	/** The JNI environment of a thread. */
+	struct CachedEnv
+	{
+		JavaVM* jvm{ nullptr };
+		JNIEnv* env{ nullptr };
+		bool isAttached{ false };
+
+		void Reset() noexcept
+		{
+			this->jvm = nullptr;
+			this->env = nullptr;
+			this->isAttached = false;
+		}
+	};
+
+	thread_local CachedEnv cachedEnv;
+}
+
+
+/**
+ * Get the JNI environment of the current thread. If the thread is not yet attached to the JVM it
+ * is attached as a daemon.
+ *
+ * @param jvm The JVM
+ * @return The environment or null if the JVM is not running or the thread could not be attached
+ */
+JNIEnv* ThreadEnv::Get(JavaVM* jvm)
+{
+	if (jvm == nullptr)
+		return nullptr;
+	if (cachedEnv.jvm == jvm && cachedEnv.env != nullptr)
+		return cachedEnv.env;
+
+	// This is correct since it is a pointer to a pointer!
+	JNIEnv* env = nullptr;
+	DISABLE_WARNING_REINTERPRET_CAST
+	const jint result = jvm->GetEnv(reinterpret_cast<void**>(&env), CURRENT_JNI_VERSION);
+	if (result == JNI_OK)
+	{
+		cachedEnv.jvm = jvm;
+		cachedEnv.env = env;
+		return env;
+	}
+
+	if (result == JNI_EDETACHED)
+	{
+		// The JNI specification guarantees that JavaVM::AttachCurrentThreadAsDaemon() is thread-safe. 
+		// Each native thread can safely call it, even concurrently with others.
+		if (jvm->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), nullptr) != 0)
+		{
+			ReaDebug::Log("DrivenByMoss: Could not attach current thread to JVM!\n");
+			return nullptr;
+		}
+		SetAttached(jvm, env);
+		return env;
+	}
+
+	// JNI_EVERSION or other fatal error
+	return nullptr;
+}
+
+
+/**
+ * Set the environment of the current thread, which was attached to the JVM, e.g. by creating it.
+ *
+ * @param jvm The JVM
+ * @param env The environment of the current thread
+ */
+void ThreadEnv::SetAttached(JavaVM* jvm, JNIEnv* env) noexcept
+{
+	cachedEnv.jvm = jvm;
+	cachedEnv.env = env;
+	cachedEnv.isAttached = true;
+}
+
+
+/**
+ * Detach the current thread from the JVM, if it was attached by the extension. Must be called
+ * before a native thread, which is owned by the extension and called Java, ends.
+ *
+ * @param jvm The JVM
+ */
+void ThreadEnv::Detach(JavaVM* jvm) noexcept
+{
+	if (jvm != nullptr && cachedEnv.isAttached && cachedEnv.jvm == jvm)
+		jvm->DetachCurrentThread();
+	cachedEnv.Reset();
+}
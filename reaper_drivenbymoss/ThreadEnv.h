@@ -0,0 +1,32 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_THREADENV_H_
+#define _DBM_THREADENV_H_
+
+#include "WrapperJNI.h"
+
+#define CURRENT_JNI_VERSION  JNI_VERSION_21
+
+
+/**
+ * Caches the JNI environment of each thread, since looking it up in the JVM costs a call through
+ * the invocation interface on every call to Java.
+ *
+ * A thread which is not yet attached to the JVM is attached as a daemon, which does not prevent
+ * the JVM from shutting down. The thread is not detached when it ends: thread local destructors
+ * run while the loader lock is held on Windows and DetachCurrentThread can deadlock there. Threads,
+ * which are owned by the extension, detach explicitly before they end. Threads of Reaper (the main
+ * thread) are never detached, they stay attached until the process ends.
+ */
+class ThreadEnv
+{
+public:
+	ThreadEnv() = delete;
+
+	static JNIEnv* Get(JavaVM* jvm);
+	static void SetAttached(JavaVM* jvm, JNIEnv* env) noexcept;
+	static void Detach(JavaVM* jvm) noexcept;
+};
+
+#endif /* _DBM_THREADENV_H_ */
@@ -5,9 +5,6 @@
 #include "Collectors.h"
 #include "Track.h"
 
-const std::regex Track::LOCK_PATTERN{ "LOCK\\s+(\\d+)" };
-const std::regex Track::INPUT_QUANTIZE_PATTERN{ "INQ\\s+([0-9]+(\\.[0-9]+)?)\\s+(-?[0-9]+(\\.[0-9]+)?)\\s+([0-9]+(\\.[0-9]+)?)\\s+([0-9]+(\\.[0-9]+)?)\\s+" };
-
 
 /**
  * Constructor.
@@ -34,16 +31,17 @@ Track::Track() noexcept
  * @param project The current Reaper project
  * @param track The track
  * @param trackIndex The index of the track
+ * @param context The automation context of the current data collection pass
  * @param slowUpdate If true, also update the data on the slow thread
  * @param dump If true all data is collected not only the changed one since the last call
  */
-void Track::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack* track, int trackIndex, const bool& slowUpdate, const bool& dump)
+void Track::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack* track, int trackIndex, const AutomationContext& context, const bool& slowUpdate, const bool& dump)
 {
 	std::ostringstream das;
 	das << "/track/" << trackIndex << "/";
 	const std::string trackAddress = das.str();
 
-	const double cursorPos = ReaperUtils::GetCursorPosition(project);
+	this->automation.Update(track, context);
 
 	// Track exists flag and number of track
 	this->exists = Collectors::CollectIntValue(ss, (trackAddress + "exists").c_str(), this->exists, 1, dump);
@@ -66,7 +64,7 @@ void Track::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack*
 	this->isGroupExpanded = Collectors::CollectIntValue(ss, (trackAddress + "isGroupExpanded").c_str(), this->isGroupExpanded, folderCompact == 0 ? 1 : 0, dump);
 	const int selected = (trackState & 2) > 0 ? 1 : 0;
 	this->isSelected = Collectors::CollectIntValue(ss, (trackAddress + "select").c_str(), this->isSelected, selected, dump);
-	this->mute = Collectors::CollectIntValue(ss, (trackAddress + "mute").c_str(), this->mute, this->GetMute(track, cursorPos, trackState), dump);
+	this->mute = Collectors::CollectIntValue(ss, (trackAddress + "mute").c_str(), this->mute, this->GetMute(track, context, trackState), dump);
 	this->solo = Collectors::CollectIntValue(ss, (trackAddress + "solo").c_str(), this->solo, (trackState & 16) > 0 ? 1 : 0, dump);
 	this->recArmed = Collectors::CollectIntValue(ss, (trackAddress + "recarm").c_str(), this->recArmed, (trackState & 64) > 0 ? 1 : 0, dump);
 
@@ -87,10 +85,10 @@ void Track::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack*
 	this->color = Collectors::CollectStringValue(ss, trackAddress + "color", this->color, Collectors::FormatColor(red, green, blue), dump);
 
 	// Track volume and pan
-	const double volDB = this->GetVolume(track, cursorPos);
+	const double volDB = this->GetVolume(track, context);
 	this->volume = Collectors::CollectDoubleValue(ss, trackAddress + "volume", this->volume, DB2SLIDER(volDB) / 1000.0, dump);
 	this->volumeStr = Collectors::CollectStringValue(ss, trackAddress + "volume/str", this->volumeStr, Collectors::FormatDB(volDB), dump);
-	const double panVal = this->GetPan(track, cursorPos);
+	const double panVal = this->GetPan(track, context);
 	this->pan = Collectors::CollectDoubleValue(ss, trackAddress + "pan", this->pan, (panVal + 1) / 2, dump);
 	this->panStr = Collectors::CollectStringValue(ss, trackAddress + "pan/str", this->panStr, Collectors::FormatPan(panVal), dump);
 
@@ -109,7 +107,10 @@ void Track::CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack*
 	// Sends
 	const int numSends = GetTrackNumSends(track, 0);
 	for (int sendCounter = 0; sendCounter < numSends; sendCounter++)
-		this->GetSend(sendCounter)->CollectData(ss, project, track, sendCounter, trackAddress, dump);
+	{
+		TrackEnvelope* sendEnvelope = this->automation.automationMode > 0 ? this->automation.GetSendEnvelope(sendCounter) : nullptr;
+		this->GetSend(sendCounter)->CollectData(ss, track, sendCounter, trackAddress, sendEnvelope, context, dump);
+	}
 	this->sendCount = Collectors::CollectIntValue(ss, trackAddress + "send/count", this->sendCount, numSends, dump);
 }
 
@@ -134,52 +135,27 @@ std::unique_ptr<Send>& Track::GetSend(const int index)
 }
 
 
-double Track::GetVolume(MediaTrack* track, double position) const noexcept
+double Track::GetVolume(MediaTrack* track, const AutomationContext& context) const noexcept
 {
-	if (this->ShouldAddEnvelope(track))
-	{
-		TrackEnvelope* envelope = GetTrackEnvelopeByName(track, "Volume");
-		if (envelope != nullptr)
-			return ReaperUtils::ValueToDB(ReaperUtils::GetEnvelopeValueAtPosition(envelope, position));
-	}
+	if (this->automation.volumeEnvelope != nullptr && this->automation.IsReading(context))
+		return ReaperUtils::ValueToDB(ReaperUtils::GetEnvelopeValueAtPosition(this->automation.volumeEnvelope, context.position, context.sampleRate));
 	return ReaperUtils::ValueToDB(GetMediaTrackInfo_Value(track, "D_VOL"));
 }
 
 
-double Track::GetPan(MediaTrack* track, double position) const noexcept
+double Track::GetPan(MediaTrack* track, const AutomationContext& context) const noexcept
 {
-	if (this->ShouldAddEnvelope(track))
-	{
-		TrackEnvelope* envelope = GetTrackEnvelopeByName(track, "Pan");
-		if (envelope != nullptr)
-		{
-			// Higher values are left!
-			return -1 * ReaperUtils::GetEnvelopeValueAtPosition(envelope, position);
-		}
-	}
+	// Higher values are left!
+	if (this->automation.panEnvelope != nullptr && this->automation.IsReading(context))
+		return -1 * ReaperUtils::GetEnvelopeValueAtPosition(this->automation.panEnvelope, context.position, context.sampleRate);
 	return GetMediaTrackInfo_Value(track, "D_PAN");
 }
 
 
-int Track::GetMute(MediaTrack* track, double position, int trackState) const noexcept
+int Track::GetMute(MediaTrack* track, const AutomationContext& context, int trackState) const noexcept
 {
-	if (this->ShouldAddEnvelope(track))
-	{
-		TrackEnvelope* envelope = GetTrackEnvelopeByName(track, "Mute");
-		if (envelope != nullptr)
-		{
-			// The envelope is inverted!
-			return ReaperUtils::GetEnvelopeValueAtPosition(envelope, position) > 0 ? 0 : 1;
-		}
-	}
+	// The envelope is inverted!
+	if (this->automation.muteEnvelope != nullptr && this->automation.IsReading(context))
+		return ReaperUtils::GetEnvelopeValueAtPosition(this->automation.muteEnvelope, context.position, context.sampleRate) > 0 ? 0 : 1;
 	return (trackState & 8) > 0 ? 1 : 0;
 }
-
-
-bool Track::ShouldAddEnvelope(MediaTrack *track) const noexcept
-{
-	int mode = GetGlobalAutomationOverride();
-	if (mode == -1)
-		mode = static_cast<int> (GetMediaTrackInfo_Value(track, "I_AUTOMODE"));
-	return (mode > 0 && mode < 6);
-}
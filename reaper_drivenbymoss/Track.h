@@ -4,13 +4,14 @@
 #ifndef _DBM_TRACK_H_
 #define _DBM_TRACK_H_
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
-#include <regex>
 
 #include "ReaperUtils.h"
 #include "Send.h"
+#include "TrackAutomation.h"
 
 
 /**
@@ -20,8 +21,6 @@ class Track
 {
 public:
 	static const int NAME_LENGTH{ 20 };
-	static const std::regex LOCK_PATTERN;
-	static const std::regex INPUT_QUANTIZE_PATTERN;
 
 	int exists{ 0 };
 	int number{ 0 };
@@ -42,11 +41,9 @@ public:
 
 	double volume{ 0.0 };
 	std::string volumeStr;
-	bool isVolumeTouch{ false };
 
 	double pan{ 0.0 };
 	std::string panStr;
-	bool isPanTouch{ false };
 
 	double vu{ 0.0 };
 	double vuLeft{ 0.0 };
@@ -57,21 +54,29 @@ public:
 
 	Track() noexcept;
 
-	void CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack* track, int trackIndex, const bool& slowUpdate, const bool& dump);
+	void CollectData(std::ostringstream& ss, ReaProject* project, MediaTrack* track, int trackIndex, const AutomationContext& context, const bool& slowUpdate, const bool& dump);
 
 	std::unique_ptr<Send>& GetSend(const int index);
 
-	double GetVolume(MediaTrack* track, double position) const noexcept;
-	double GetPan(MediaTrack* track, double position) const noexcept;
-	int GetMute(MediaTrack* track, double position, int trackState) const noexcept;
+	/**
+	 * Get the number of sends which was sent last.
+	 *
+	 * @return The number of sends
+	 */
+	int GetSendCount() const noexcept
+	{
+		return this->sendCount;
+	}
+
+	double GetVolume(MediaTrack* track, const AutomationContext& context) const noexcept;
+	double GetPan(MediaTrack* track, const AutomationContext& context) const noexcept;
+	int GetMute(MediaTrack* track, const AutomationContext& context, int trackState) const noexcept;
 
 private:
 	int sendCount{ 0 };
 	std::vector<std::unique_ptr<Send>> sends;
 	std::mutex sendlock;
-
-
-	bool ShouldAddEnvelope(MediaTrack* track) const noexcept;
+	TrackAutomation automation;
 };
 
 #endif /* _DBM_TRACK_H_ */
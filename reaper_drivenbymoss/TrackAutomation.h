@@ -0,0 +1,130 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_TRACKAUTOMATION_H_
+#define _DBM_TRACKAUTOMATION_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "ReaperUtils.h"
+
+
+/**
+ * The values which are identical for all envelope evaluations of one data collection pass.
+ */
+struct AutomationContext
+{
+	double position{ 0.0 };
+	int sampleRate{ 0 };
+	int globalOverride{ -1 };
+	int stateChangeCount{ -1 };
+
+	/**
+	 * Read the current context from the project.
+	 *
+	 * @param project The current Reaper project
+	 * @return The context
+	 */
+	static AutomationContext Create(ReaProject* project) noexcept
+	{
+		AutomationContext context;
+		context.position = ReaperUtils::GetCursorPosition(project);
+		context.sampleRate = ReaperUtils::GetIntConfigValue("projsrate");
+		context.globalOverride = GetGlobalAutomationOverride();
+		context.stateChangeCount = GetProjectStateChangeCount(project);
+		return context;
+	}
+};
+
+
+/**
+ * Caches the automation mode and the envelopes of a track which are needed to get the automated
+ * volume, pan, mute and send volumes. They are only looked up again if the project state changed,
+ * since changing the automation mode as well as adding or removing an envelope are always undoable
+ * changes.
+ */
+class TrackAutomation
+{
+public:
+	TrackEnvelope* volumeEnvelope{ nullptr };
+	TrackEnvelope* panEnvelope{ nullptr };
+	TrackEnvelope* muteEnvelope{ nullptr };
+
+	/** The automation mode of the track. */
+	int automationMode{ 0 };
+
+
+	/**
+	 * Refresh the automation mode and the envelopes if necessary.
+	 *
+	 * @param track The track
+	 * @param context The context of the current data collection pass
+	 */
+	void Update(MediaTrack* track, const AutomationContext& context)
+	{
+		if (this->track == track && this->stateChangeCount == context.stateChangeCount)
+			return;
+		this->track = track;
+		this->stateChangeCount = context.stateChangeCount;
+
+		this->automationMode = static_cast<int> (GetMediaTrackInfo_Value(track, "I_AUTOMODE"));
+		this->volumeEnvelope = GetTrackEnvelopeByName(track, "Volume");
+		this->panEnvelope = GetTrackEnvelopeByName(track, "Pan");
+		this->muteEnvelope = GetTrackEnvelopeByName(track, "Mute");
+
+		// There is always a send envelope, even if not active. Therefore, only keep the ones which
+		// are in the envelope list of the track
+		const int envelopeCount = CountTrackEnvelopes(track);
+		std::vector<const TrackEnvelope*> activeEnvelopes;
+		activeEnvelopes.reserve(envelopeCount);
+		for (int i = 0; i < envelopeCount; i++)
+			activeEnvelopes.push_back(GetTrackEnvelope(track, i));
+		std::sort(activeEnvelopes.begin(), activeEnvelopes.end());
+
+		const char* sendType = "<VOLENV";
+		const int sendCount = GetTrackNumSends(track, 0);
+		this->sendEnvelopes.assign(sendCount, nullptr);
+		for (int sendIndex = 0; sendIndex < sendCount; sendIndex++)
+		{
+			DISABLE_WARNING_NO_C_STYLE_CONVERSION
+			TrackEnvelope* envelope = static_cast<TrackEnvelope*> (GetSetTrackSendInfo(track, 0, sendIndex, "P_ENV", (void*)sendType));
+			if (envelope != nullptr && std::binary_search(activeEnvelopes.cbegin(), activeEnvelopes.cend(), envelope))
+				this->sendEnvelopes.at(sendIndex) = envelope;
+		}
+	}
+
+
+	/**
+	 * Check if the track envelopes should be evaluated for the current automation mode.
+	 *
+	 * @param context The context of the current data collection pass
+	 * @return True if the envelopes are read
+	 */
+	bool IsReading(const AutomationContext& context) const noexcept
+	{
+		const int mode = context.globalOverride == -1 ? this->automationMode : context.globalOverride;
+		return mode > 0 && mode < 6;
+	}
+
+
+	/**
+	 * Get the active volume envelope of a send.
+	 *
+	 * @param sendIndex The index of the send
+	 * @return The envelope or null if the send has no active volume envelope
+	 */
+	TrackEnvelope* GetSendEnvelope(int sendIndex) const noexcept
+	{
+		if (sendIndex < 0 || sendIndex >= static_cast<int> (this->sendEnvelopes.size()))
+			return nullptr;
+		return this->sendEnvelopes[sendIndex];
+	}
+
+private:
+	MediaTrack* track{ nullptr };
+	int stateChangeCount{ -1 };
+	std::vector<TrackEnvelope*> sendEnvelopes;
+};
+
+#endif /* _DBM_TRACKAUTOMATION_H_ */
@@ -0,0 +1,159 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "TrackIndexMap.h"
+
+
+/**
+ * Constructor. Collects all tracks of the project which are not hidden.
+ *
+ * @param aProject The project
+ * @param aStateChangeCount The state change count of the project
+ * @param previous The previous visible tracks to keep their touch states, might be null
+ */
+VisibleTracks::VisibleTracks(ReaProject* aProject, int aStateChangeCount, const VisibleTracks* previous) : project(aProject), stateChangeCount(aStateChangeCount)
+{
+	if (aProject == nullptr)
+		return;
+
+	this->reaperTrackCount = CountTracks(aProject);
+	this->tracks.reserve(this->reaperTrackCount);
+	this->reaperIndices.reserve(this->reaperTrackCount);
+
+	int trackState{};
+	for (int index = 0; index < this->reaperTrackCount; index++)
+	{
+		MediaTrack* mediaTrack = ::GetTrack(aProject, index);
+		if (mediaTrack == nullptr)
+			continue;
+		// Ignore track if hidden
+		GetTrackState(mediaTrack, &trackState);
+		if ((trackState & 1024) > 0)
+			continue;
+
+		this->visibleIndices.emplace(mediaTrack, static_cast<int>(this->tracks.size()));
+		this->tracks.push_back(mediaTrack);
+		this->reaperIndices.push_back(index);
+	}
+
+	this->touchStates = std::vector<std::atomic<int>>(this->tracks.size());
+	if (previous == nullptr)
+		return;
+	for (std::size_t i = 0; i < this->tracks.size(); i++)
+	{
+		const int previousIndex = previous->GetVisibleIndex(this->tracks[i]);
+		if (previousIndex >= 0)
+			this->touchStates[i].store(previous->touchStates[previousIndex].load());
+	}
+}
+
+
+/**
+ * Get a visible track.
+ *
+ * @param visibleIndex The index of the track in the list of the visible tracks
+ * @return The track or null if the index is out of range
+ */
+MediaTrack* VisibleTracks::GetTrack(int visibleIndex) const noexcept
+{
+	if (visibleIndex < 0 || visibleIndex >= this->GetCount())
+		return nullptr;
+	return this->tracks[visibleIndex];
+}
+
+
+/**
+ * Get the index of a visible track in Reaper.
+ *
+ * @param visibleIndex The index of the track in the list of the visible tracks
+ * @return The index of the track in Reaper or -1 if the index is out of range
+ */
+int VisibleTracks::GetReaperIndex(int visibleIndex) const noexcept
+{
+	if (visibleIndex < 0 || visibleIndex >= this->GetCount())
+		return -1;
+	return this->reaperIndices[visibleIndex];
+}
+
+
+/**
+ * Get the index of a track in the list of the visible tracks.
+ *
+ * @param track The track
+ * @return The index or -1 if the track is hidden or not part of the project
+ */
+int VisibleTracks::GetVisibleIndex(MediaTrack* track) const noexcept
+{
+	const auto it = this->visibleIndices.find(track);
+	return it == this->visibleIndices.end() ? -1 : it->second;
+}
+
+
+/**
+ * Check if the volume or panorama of a track is touched on the controller. Does not access
+ * Reaper and can therefore be called from any thread.
+ *
+ * @param track The track
+ * @param isPan True to get the touch state of the panorama, otherwise of the volume
+ * @return True if touched, false if not or if the track is not visible
+ */
+bool VisibleTracks::IsTouched(MediaTrack* track, bool isPan) const noexcept
+{
+	const int visibleIndex = this->GetVisibleIndex(track);
+	if (visibleIndex < 0)
+		return false;
+	return (this->touchStates[visibleIndex].load() & (isPan ? PAN_TOUCH : VOLUME_TOUCH)) != 0;
+}
+
+
+/**
+ * Set if the volume or panorama of a track is touched on the controller. Must only be called
+ * from the main thread.
+ *
+ * @param visibleIndex The index of the track in the list of the visible tracks
+ * @param isPan True to set the touch state of the panorama, otherwise of the volume
+ * @param isTouched True if touched
+ */
+void VisibleTracks::SetTouched(int visibleIndex, bool isPan, bool isTouched) const noexcept
+{
+	if (visibleIndex < 0 || visibleIndex >= this->GetCount())
+		return;
+	const int flag = isPan ? PAN_TOUCH : VOLUME_TOUCH;
+	if (isTouched)
+		this->touchStates[visibleIndex].fetch_or(flag);
+	else
+		this->touchStates[visibleIndex].fetch_and(~flag);
+}
+
+
+/**
+ * Get the visible tracks of the project. Rebuilds the map if the track list changed. Must only be
+ * called from the main thread.
+ *
+ * @param project The project
+ * @return The visible tracks
+ */
+std::shared_ptr<const VisibleTracks> TrackIndexMap::Get(ReaProject* project)
+{
+	std::shared_ptr<const VisibleTracks> current = std::atomic_load(&this->visibleTracks);
+	const int stateChangeCount = project == nullptr ? 0 : GetProjectStateChangeCount(project);
+	const int trackCount = project == nullptr ? 0 : CountTracks(project);
+	if (!this->isInvalid.exchange(false) && current && current->IsValid(project, stateChangeCount, trackCount))
+		return current;
+
+	current = std::make_shared<const VisibleTracks>(project, stateChangeCount, current.get());
+	std::atomic_store(&this->visibleTracks, current);
+	return current;
+}
+
+
+/**
+ * Get the visible tracks as they were at the last update. Does not access Reaper and can
+ * therefore be called from any thread.
+ *
+ * @return The visible tracks, might be null if not yet created
+ */
+std::shared_ptr<const VisibleTracks> TrackIndexMap::GetCurrent() const
+{
+	return std::atomic_load(&this->visibleTracks);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_TRACKINDEXMAP_H_
+#define _DBM_TRACKINDEXMAP_H_
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "ReaperUtils.h"
+
+
+/**
+ * The tracks which are not hidden in the order of the project. The index of a track in this list
+ * is the index which is used by the controllers. Immutable after creation apart from the touch
+ * states of the tracks, which are atomic. They are set from the main thread and can be read from
+ * any thread.
+ */
+class VisibleTracks
+{
+public:
+	VisibleTracks(ReaProject* project, int stateChangeCount, const VisibleTracks* previous);
+	VisibleTracks(const VisibleTracks&) = delete;
+	VisibleTracks& operator=(const VisibleTracks&) = delete;
+	VisibleTracks(VisibleTracks&&) = delete;
+	VisibleTracks& operator=(VisibleTracks&&) = delete;
+	~VisibleTracks() {};
+
+	/**
+	 * Get the number of visible tracks.
+	 *
+	 * @return The number of tracks
+	 */
+	int GetCount() const noexcept
+	{
+		return static_cast<int>(this->tracks.size());
+	}
+
+	MediaTrack* GetTrack(int visibleIndex) const noexcept;
+	int GetReaperIndex(int visibleIndex) const noexcept;
+	int GetVisibleIndex(MediaTrack* track) const noexcept;
+	bool IsTouched(MediaTrack* track, bool isPan) const noexcept;
+	void SetTouched(int visibleIndex, bool isPan, bool isTouched) const noexcept;
+
+	/**
+	 * Check if the tracks are still up to date.
+	 *
+	 * @param aProject The current project
+	 * @param aStateChangeCount The current state change count of the project
+	 * @param trackCount The current number of tracks in the project
+	 * @return True if nothing changed
+	 */
+	bool IsValid(ReaProject* aProject, int aStateChangeCount, int trackCount) const noexcept
+	{
+		return this->project == aProject && this->stateChangeCount == aStateChangeCount && this->reaperTrackCount == trackCount;
+	}
+
+private:
+	static const int VOLUME_TOUCH{ 1 };
+	static const int PAN_TOUCH{ 2 };
+
+	ReaProject* project;
+	int stateChangeCount;
+	int reaperTrackCount{ 0 };
+	std::vector<MediaTrack*> tracks;
+	std::vector<int> reaperIndices;
+	std::unordered_map<MediaTrack*, int> visibleIndices;
+	mutable std::vector<std::atomic<int>> touchStates;
+};
+
+
+/**
+ * Maps between the index of a visible track and the index of the track in Reaper. The map is
+ * only rebuilt if the track list or the project changed. The current map can be read from any
+ * thread, updates must happen on the main thread.
+ */
+class TrackIndexMap
+{
+public:
+	TrackIndexMap() = default;
+	TrackIndexMap(const TrackIndexMap&) = delete;
+	TrackIndexMap& operator=(const TrackIndexMap&) = delete;
+	TrackIndexMap(TrackIndexMap&&) = delete;
+	TrackIndexMap& operator=(TrackIndexMap&&) = delete;
+	~TrackIndexMap() {};
+
+	std::shared_ptr<const VisibleTracks> Get(ReaProject* project);
+	std::shared_ptr<const VisibleTracks> GetCurrent() const;
+
+	/**
+	 * Rebuild the map on the next access.
+	 */
+	void Invalidate() noexcept
+	{
+		this->isInvalid.store(true);
+	}
+
+private:
+	std::shared_ptr<const VisibleTracks> visibleTracks;
+	std::atomic<bool> isInvalid{ true };
+};
+
+#endif /* _DBM_TRACKINDEXMAP_H_ */
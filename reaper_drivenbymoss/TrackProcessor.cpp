@@ -27,22 +27,21 @@ TrackProcessor::TrackProcessor(Model& aModel) : OscProcessor(aModel)
 
 
 /** {@inheritDoc} */
-void TrackProcessor::Process(std::deque<std::string>& path) noexcept
+void TrackProcessor::Process(const OscPath& path) noexcept
 {
 	if (path.empty())
 		return;
 
 	ReaProject* project = ReaperUtils::GetProject();
-	const char* param = SafeGet(path, 0);
-	const int dawIndex = atoi(param);
+	const int dawIndex = path.GetInt(0);
 	int trackIndex = GetTrackIndex(project, dawIndex);
 	MediaTrack* track = GetTrack(project, trackIndex);
 	if (!track)
 		return;
 
-	const char* cmd = SafeGet(path, 1);
-
-	if (std::strcmp(cmd, "scrollto") == 0)
+	switch (path.GetHash(1))
+	{
+	case OscPath::Hash("scrollto"):
 	{
 		SetOnlyTrackSelected(track);
 		ScrollTrackIntoView(track);
@@ -50,10 +49,10 @@ void TrackProcessor::Process(std::deque<std::string>& path) noexcept
 		return;
 	}
 
-	if (std::strcmp(cmd, "remove") == 0)
+	case OscPath::Hash("remove"):
 	{
 		PreventUIRefresh(1);
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		DeleteTrack(track);
 		// Make sure that a track is selected
 		if (GetSelectedTrack2(project, 0, true) == nullptr)
@@ -67,73 +66,73 @@ void TrackProcessor::Process(std::deque<std::string>& path) noexcept
 					SetTrackSelected(track, true);
 			}
 		}
-		UpdateArrange();
-		Undo_EndBlock2(project, "Delete track", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().UpdateArrange();
+		this->model.GetUndoBatch().EndBlock(project, "Delete track", UNDO_STATE_ALL);
 		PreventUIRefresh(-1);
 		return;
 	}
 
-	if (std::strcmp(cmd, "movePrev") == 0)
+	case OscPath::Hash("movePrev"):
 	{
 		if (trackIndex > 0)
 		{
 			PreventUIRefresh(1);
-			Undo_BeginBlock2(project);
+			this->model.GetUndoBatch().BeginBlock(project);
 			ReorderSelectedTracks(trackIndex - 1, 0);
-			UpdateArrange();
-			Undo_EndBlock2(project, "Move track", UNDO_STATE_ALL);
+			this->model.GetUndoBatch().UpdateArrange();
+			this->model.GetUndoBatch().EndBlock(project, "Move track", UNDO_STATE_ALL);
 			PreventUIRefresh(-1);
 		}
 		return;
 	}
 
-	if (std::strcmp(cmd, "moveNext") == 0)
+	case OscPath::Hash("moveNext"):
 	{
 		//if (trackIndex + 2 < CountTracks(project))
 		//{
 		PreventUIRefresh(1);
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		ReorderSelectedTracks(trackIndex + 2, 0);
-		UpdateArrange();
-		Undo_EndBlock2(project, "Move track", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().UpdateArrange();
+		this->model.GetUndoBatch().EndBlock(project, "Move track", UNDO_STATE_ALL);
 		PreventUIRefresh(-1);
 		//		}
 		return;
 	}
 
 	// Note: Currently not used and not tested...
-	if (std::strcmp(cmd, "clearAutomation") == 0)
+	case OscPath::Hash("clearAutomation"):
 	{
 		this->DeleteAllAutomationEnvelopes(project, track);
 		return;
 	}
 
-	if (std::strcmp(cmd, "recordClip") == 0)
+	case OscPath::Hash("recordClip"):
 	{
 		RecordMidiClip(project, track);
 		return;
 	}
 
-	if (std::strcmp(cmd, "clip") == 0)
+	case OscPath::Hash("clip"):
 	{
 		if (path.size() < 4)
 			return;
-		const int clipIndex = atoi(SafeGet(path, 2));
+		const int clipIndex = path.GetInt(2);
 		MediaItem* item = GetTrackMediaItem(track, clipIndex);
 		if (item == nullptr)
 			return;
 
-		const char* subcmd = SafeGet(path, 3);
-
-		if (std::strcmp(subcmd, "select") == 0)
+		switch (path.GetHash(3))
+		{
+		case OscPath::Hash("select"):
 		{
 			Main_OnCommandEx(UNSELECT_ALL_ITEMS, 0, project);
 			SetMediaItemSelected(item, true);
-			UpdateTimeline();
+			this->model.GetUndoBatch().UpdateTimeline();
 			return;
 		}
 
-		if (std::strcmp(subcmd, "launch") == 0)
+		case OscPath::Hash("launch"):
 		{
 			const double position = GetMediaItemInfo_Value(item, "D_POSITION");
 			SetEditCurPos2(project, position, true, true);
@@ -142,7 +141,7 @@ void TrackProcessor::Process(std::deque<std::string>& path) noexcept
 			return;
 		}
 
-		if (std::strcmp(subcmd, "record") == 0)
+		case OscPath::Hash("record"):
 		{
 			const double position = GetMediaItemInfo_Value(item, "D_POSITION");
 			SetEditCurPos2(project, position, true, true);
@@ -151,46 +150,54 @@ void TrackProcessor::Process(std::deque<std::string>& path) noexcept
 			return;
 		}
 
-		if (std::strcmp(subcmd, "remove") == 0)
+		case OscPath::Hash("remove"):
 		{
 			DeleteTrackMediaItem(track, item);
-			UpdateTimeline();
-			Undo_OnStateChangeEx("Delete item", UNDO_STATE_ITEMS, -1);
+			this->model.GetUndoBatch().UpdateTimeline();
+			this->model.GetUndoBatch().OnStateChange(project, "Delete item", UNDO_STATE_ITEMS);
 			return;
 		}
 
-		if (std::strcmp(subcmd, "duplicate") == 0)
+		case OscPath::Hash("duplicate"):
 		{
 			Main_OnCommandEx(UNSELECT_ALL_ITEMS, 0, project);
 			SetMediaItemSelected(item, true);
 			Main_OnCommandEx(DUPLICATE_ITEMS, 0, project);
-			UpdateTimeline();
-			Undo_OnStateChangeEx("Duplicate item", UNDO_STATE_ITEMS, -1);
+			this->model.GetUndoBatch().UpdateTimeline();
+			this->model.GetUndoBatch().OnStateChange(project, "Duplicate item", UNDO_STATE_ITEMS);
 			return;
 		}
 
+		default:
+			break;
+		}
+
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
 /** {@inheritDoc} */
-void TrackProcessor::Process(std::deque<std::string>& path, int value)
+void TrackProcessor::Process(const OscPath& path, int value)
 {
 	if (path.empty())
 		return;
 
 	ReaProject* project = ReaperUtils::GetProject();
-	const int trackIndex = GetTrackIndex(project, atoi(SafeGet(path, 0)));
+	const int trackIndex = GetTrackIndex(project, path.GetInt(0));
 	if (trackIndex < 0)
 		return;
 	MediaTrack* track = GetTrack(project, trackIndex);
 	if (!track)
 		return;
 
-	const char* cmd = SafeGet(path, 1);
-
-	if (std::strcmp(cmd, "select") == 0)
+	switch (path.GetHash(1))
+	{
+	case OscPath::Hash("select"):
 	{
 		SetOnlyTrackSelected(track);
 		ScrollTrackIntoView(track);
@@ -200,7 +207,7 @@ void TrackProcessor::Process(std::deque<std::string>& path, int value)
 		return;
 	}
 
-	if (std::strcmp(cmd, "toggleMultiSelect") == 0)
+	case OscPath::Hash("toggleMultiSelect"):
 	{
 		const bool isSelected = !IsTrackSelected(track);
 		SetTrackSelected(track, isSelected);
@@ -214,91 +221,96 @@ void TrackProcessor::Process(std::deque<std::string>& path, int value)
 		return;
 	}
 
-	if (std::strcmp(cmd, "isGroupExpanded") == 0)
+	case OscPath::Hash("isGroupExpanded"):
 	{
 		int folderCompact = value > 0 ? 0 : 2;
 		GetSetMediaTrackInfo(track, "I_FOLDERCOMPACT", &folderCompact);
 		return;
 	}
 
-	if (std::strcmp(cmd, "createClip") == 0)
+	case OscPath::Hash("createClip"):
 	{
 		CreateMidiClip(project, track, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "active") == 0)
+	case OscPath::Hash("active"):
 	{
 		SetIsActivated(project, value > 0);
 		return;
 	}
 
-	if (std::strcmp(cmd, "solo") == 0)
+	case OscPath::Hash("solo"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		SetTrackUISolo(track, value, IGNORE_GROUP_FLAGS);
-		Undo_EndBlock2(project, "Toggle track solo", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Toggle track solo", UNDO_STATE_ALL);
 		return;
 	}
 
-	if (std::strcmp(cmd, "mute") == 0)
+	case OscPath::Hash("mute"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		SetTrackUIMute(track, value, IGNORE_GROUP_FLAGS);
-		Undo_EndBlock2(project, "Toggle track mute", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Toggle track mute", UNDO_STATE_ALL);
 		return;
 	}
 
-	if (std::strcmp(cmd, "recarm") == 0)
+	case OscPath::Hash("recarm"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		SetTrackUIRecArm(track, value, IGNORE_GROUP_FLAGS);
-		Undo_EndBlock2(project, "Toggle track record arming", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Toggle track record arming", UNDO_STATE_ALL);
 		return;
 	}
 
-	if (std::strcmp(cmd, "monitor") == 0)
+	case OscPath::Hash("monitor"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		SetTrackUIInputMonitor(track, value > 0 ? 1 : 0, IGNORE_GROUP_FLAGS);
-		Undo_EndBlock2(project, "Toggle track recording monitor", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Toggle track recording monitor", UNDO_STATE_ALL);
 		return;
 	}
 
-	if (std::strcmp(cmd, "autoMonitor") == 0)
+	case OscPath::Hash("autoMonitor"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		SetTrackUIInputMonitor(track, value > 0 ? 2 : 0, IGNORE_GROUP_FLAGS);
-		Undo_EndBlock2(project, "Toggle track recording monitor", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Toggle track recording monitor", UNDO_STATE_ALL);
 		return;
 	}
 
-	if (std::strcmp(cmd, "pin") == 0)
+	case OscPath::Hash("pin"):
 	{
 		this->model.pinnedTrackIndex = value;
 		return;
 	}
 
-	if (std::strcmp(cmd, "overdub") == 0)
+	case OscPath::Hash("overdub"):
 	{
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 		SetMediaTrackInfo_Value(track, "I_RECMODE", value > 0 ? 7 : 8);
-		Undo_EndBlock2(project, "Toggle track recording parameters", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Toggle track recording parameters", UNDO_STATE_ALL);
 		return;
 	}
 
+	default:
+		break;
+	}
+
 	Process(path, static_cast<double>(value));
 }
 
 
 /** {@inheritDoc} */
-void TrackProcessor::Process(std::deque<std::string>& path, double value)
+void TrackProcessor::Process(const OscPath& path, double value)
 {
 	if (path.empty())
 		return;
 
 	ReaProject* project = ReaperUtils::GetProject();
-	const int trackIndex = GetTrackIndex(project, atoi(SafeGet(path, 0)));
+	const int dawIndex = path.GetInt(0);
+	const int trackIndex = GetTrackIndex(project, dawIndex);
 	if (trackIndex < 0)
 		return;
 	MediaTrack* track = GetTrack(project, trackIndex);
@@ -306,9 +318,9 @@ void TrackProcessor::Process(std::deque<std::string>& path, double value)
 		return;
 
 	const std::unique_ptr<Track>& trackData = this->model.GetTrack(trackIndex);
-	const char* cmd = SafeGet(path, 1);
-
-	if (std::strcmp(cmd, "volume") == 0)
+	switch (path.GetHash(1))
+	{
+	case OscPath::Hash("volume"):
 	{
 		if (path.size() == 2)
 		{
@@ -320,11 +332,11 @@ void TrackProcessor::Process(std::deque<std::string>& path, double value)
 
 		const char* touchCmd = SafeGet(path, 2);
 		if (std::strcmp(touchCmd, "touch") == 0)
-			trackData->isVolumeTouch = value > 0;
+			this->model.GetTrackIndexMap().Get(project)->SetTouched(dawIndex, false, value > 0);
 		return;
 	}
 
-	if (std::strcmp(cmd, "pan") == 0)
+	case OscPath::Hash("pan"):
 	{
 		if (path.size() == 2)
 		{
@@ -336,15 +348,16 @@ void TrackProcessor::Process(std::deque<std::string>& path, double value)
 
 		const char* touchCmd = SafeGet(path, 2);
 		if (std::strcmp(touchCmd, "touch") == 0)
-			trackData->isPanTouch = value > 0;
+			this->model.GetTrackIndexMap().Get(project)->SetTouched(dawIndex, true, value > 0);
 		return;
 	}
 
-	if (std::strcmp(cmd, "send") == 0)
+	case OscPath::Hash("send"):
 	{
-		const int sendIndex = atoi(SafeGet(path, 2));
-		const char* subcmd = SafeGet(path, 3);
-		if (std::strcmp(subcmd, "volume") == 0)
+		const int sendIndex = path.GetInt(2);
+		switch (path.GetHash(3))
+		{
+		case OscPath::Hash("volume"):
 		{
 			DISABLE_WARNING_DANGLING_POINTER
 				const std::unique_ptr<Send>& send = trackData->GetSend(sendIndex);
@@ -352,14 +365,20 @@ void TrackProcessor::Process(std::deque<std::string>& path, double value)
 			CSurf_OnSendVolumeChange(track, sendIndex, send->volume, false);
 			return;
 		}
-		if (std::strcmp(subcmd, "active") == 0)
+
+		case OscPath::Hash("active"):
 		{
 			ToggleTrackSendUIMute(track, sendIndex);
+			break;
+		}
+
+		default:
+			break;
 		}
 		return;
 	}
 
-	if (std::strcmp(cmd, "inQuantResolution") == 0)
+	case OscPath::Hash("inQuantResolution"):
 	{
 		if (value < 0 || value > 1)
 			return;
@@ -384,11 +403,11 @@ void TrackProcessor::Process(std::deque<std::string>& path, double value)
 	}
 
 	// Parse track fx parameter value
-	if (std::strcmp(cmd, "param") == 0)
+	case OscPath::Hash("param"):
 	{
 		if (path.empty())
 			return;
-		const int fxParamNo = atoi(SafeGet(path, 2));
+		const int fxParamNo = path.GetInt(2);
 		int fxindexOut;
 		int parmidxOut;
 		if (!GetTCPFXParm(project, track, fxParamNo, &fxindexOut, &parmidxOut))
@@ -397,17 +416,20 @@ void TrackProcessor::Process(std::deque<std::string>& path, double value)
 			TrackFX_SetParamNormalized(track, fxindexOut, parmidxOut, value);
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
-void TrackProcessor::Process(std::deque<std::string>& path, const std::string& value) noexcept
+void TrackProcessor::Process(const OscPath& path, const std::string& value) noexcept
 {
 	if (path.empty())
 		return;
 
 	ReaProject* project = ReaperUtils::GetProject();
-	const char* param = SafeGet(path, 0);
-	const int dawIndex = atoi(param);
+	const int dawIndex = path.GetInt(0);
 	const int trackIndex = GetTrackIndex(project, dawIndex);
 	if (trackIndex < 0)
 		return;
@@ -415,23 +437,24 @@ void TrackProcessor::Process(std::deque<std::string>& path, const std::string& v
 	if (!track)
 		return;
 
-	const char* cmd = SafeGet(path, 1);
-	if (std::strcmp(cmd, "color") == 0)
+	switch (path.GetHash(1))
+	{
+	case OscPath::Hash("color"):
 	{
 		SetColorOfTrack(project, track, value);
 		return;
 	}
 
-	if (std::strcmp(cmd, "name") == 0)
+	case OscPath::Hash("name"):
 	{
 		try
 		{
 			std::string val = value;
 
-			Undo_BeginBlock2(project);
+			this->model.GetUndoBatch().BeginBlock(project);
 			DISABLE_WARNING_USE_GSL_AT
 			GetSetMediaTrackInfo(track, "P_NAME", &val[0]);
-			Undo_EndBlock2(project, "Set track name", UNDO_STATE_ALL);
+			this->model.GetUndoBatch().EndBlock(project, "Set track name", UNDO_STATE_ALL);
 		}
 		catch (...)
 		{
@@ -442,11 +465,11 @@ void TrackProcessor::Process(std::deque<std::string>& path, const std::string& v
 		return;
 	}
 
-	if (std::strcmp(cmd, "clip") == 0)
+	case OscPath::Hash("clip"):
 	{
 		if (path.size() < 4)
 			return;
-		const int clipIndex = atoi(SafeGet(path, 2));
+		const int clipIndex = path.GetInt(2);
 		MediaItem* item = GetTrackMediaItem(track, clipIndex);
 		if (item == nullptr)
 			return;
@@ -462,10 +485,14 @@ void TrackProcessor::Process(std::deque<std::string>& path, const std::string& v
 
 		return;
 	}
+
+	default:
+		break;
+	}
 }
 
 
-void TrackProcessor::Process(std::deque<std::string>& path, const std::vector<std::string>& values)
+void TrackProcessor::Process(const OscPath& path, const std::vector<std::string>& values)
 {
 	if (path.empty())
 		return;
@@ -477,7 +504,7 @@ void TrackProcessor::Process(std::deque<std::string>& path, const std::vector<st
 	if (std::strcmp(cmd, "addTrack") == 0)
 	{
 		PreventUIRefresh(1);
-		Undo_BeginBlock2(project);
+		this->model.GetUndoBatch().BeginBlock(project);
 
 		// Add track
 		MediaTrack* track = GetSelectedTrack(project, 0);
@@ -551,7 +578,7 @@ void TrackProcessor::Process(std::deque<std::string>& path, const std::vector<st
 			}
 		}
 
-		Undo_EndBlock2(project, "Add track", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Add track", UNDO_STATE_ALL);
 		PreventUIRefresh(-1);
 		return;
 	}
@@ -560,7 +587,7 @@ void TrackProcessor::Process(std::deque<std::string>& path, const std::vector<st
 
 void TrackProcessor::CreateMidiClip(ReaProject* project, MediaTrack* track, int beats) noexcept
 {
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 
 	// Stop playback to update the play cursor position
 	Main_OnCommandEx(TRANSPORT_STOP, 0, project);
@@ -599,13 +626,13 @@ void TrackProcessor::CreateMidiClip(ReaProject* project, MediaTrack* track, int
 		Main_OnCommandEx(TRANSPORT_PLAY, 0, project);
 	}
 
-	Undo_EndBlock2(project, "Create Midi Clip and Record", UNDO_STATE_ALL);
+	this->model.GetUndoBatch().EndBlock(project, "Create Midi Clip and Record", UNDO_STATE_ALL);
 }
 
 
 void TrackProcessor::RecordMidiClip(ReaProject* project, MediaTrack* track) noexcept
 {
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 
 	// Stop playback to update the play cursor position
 	Main_OnCommandEx(TRANSPORT_STOP, 0, project);
@@ -620,7 +647,7 @@ void TrackProcessor::RecordMidiClip(ReaProject* project, MediaTrack* track) noex
 
 	Main_OnCommandEx(TRANSPORT_RECORD, 0, project);
 
-	Undo_EndBlock2(project, "Record Midi Clip", UNDO_STATE_ALL);
+	this->model.GetUndoBatch().EndBlock(project, "Record Midi Clip", UNDO_STATE_ALL);
 }
 
 
@@ -646,61 +673,42 @@ void TrackProcessor::SetColorOfTrack(ReaProject* project, MediaTrack* track, con
 		return;
 	}
 
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 	SetTrackColor(track, ColorToNative(red, green, blue));
-	Undo_EndBlock2(project, "Set track color", UNDO_STATE_ALL);
+	this->model.GetUndoBatch().EndBlock(project, "Set track color", UNDO_STATE_ALL);
 }
 
 
 void TrackProcessor::SetIsActivated(ReaProject* project, bool enable) noexcept
 {
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 	if (enable)
 	{
 		Main_OnCommandEx(UNLOCK_TRACK_CONTROLS, 0, project);
 		Main_OnCommandEx(SET_ALL_FX_ONLINE, 0, project);
 		Main_OnCommandEx(UNMUTE_TRACKS, 0, project);
-		Undo_EndBlock2(project, "Enable track", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Enable track", UNDO_STATE_ALL);
 	}
 	else
 	{
 		Main_OnCommandEx(MUTE_TRACKS, 0, project);
 		Main_OnCommandEx(SET_ALL_FX_OFFLINE, 0, project);
 		Main_OnCommandEx(LOCK_TRACK_CONTROLS, 0, project);
-		Undo_EndBlock2(project, "Disable track", UNDO_STATE_ALL);
+		this->model.GetUndoBatch().EndBlock(project, "Disable track", UNDO_STATE_ALL);
 	}
 }
 
 
-int TrackProcessor::GetTrackIndex(ReaProject* project, int dawTrackIndex) const noexcept
+int TrackProcessor::GetTrackIndex(ReaProject* project, int dawTrackIndex) const
 {
-	const int count = CountTracks(project);
-	if (dawTrackIndex < 0 || dawTrackIndex >= count)
-		return -1;
-
-	int trackIndex{ 0 };
-	int trackState{};
-	for (int index = 0; index < count; index++)
-	{
-		MediaTrack* mediaTrack = GetTrack(project, index);
-		if (mediaTrack == nullptr)
-			continue;
-		// Ignore track if hidden
-		GetTrackState(mediaTrack, &trackState);
-		if ((trackState & 1024) > 0)
-			continue;
-		if (dawTrackIndex == trackIndex)
-			return index;
-		trackIndex++;
-	}
-	return -1;
+	return this->model.GetTrackIndexMap().Get(project)->GetReaperIndex(dawTrackIndex);
 }
 
 
 void TrackProcessor::DeleteAllAutomationEnvelopes(ReaProject* project, MediaTrack* track) noexcept
 {
 	PreventUIRefresh(1);
-	Undo_BeginBlock2(project);
+	this->model.GetUndoBatch().BeginBlock(project);
 
 	const double end = GetProjectLength(project);
 
@@ -711,7 +719,7 @@ void TrackProcessor::DeleteAllAutomationEnvelopes(ReaProject* project, MediaTrac
 		DeleteEnvelopePointRange(envelope, 0, end);
 	}
 
-	Undo_EndBlock2(project, "Delete all automation envelopes of track.", UNDO_STATE_TRACKCFG);
+	this->model.GetUndoBatch().EndBlock(project, "Delete all automation envelopes of track.", UNDO_STATE_TRACKCFG);
 	PreventUIRefresh(-1);
 }
 
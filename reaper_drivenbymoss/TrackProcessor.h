@@ -15,11 +15,16 @@ class TrackProcessor : public OscProcessor
 public:
 	TrackProcessor(Model& aModel);
 
-	void Process(std::deque<std::string>& path) noexcept override;
-	void Process(std::deque<std::string>& path, int value) override;
-	void Process(std::deque<std::string>& path, double value) override;
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override;
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) override;
+	void Process(const OscPath& path) noexcept override;
+	void Process(const OscPath& path, int value) override;
+	void Process(const OscPath& path, double value) override;
+	void Process(const OscPath& path, const std::string& value) noexcept override;
+	void Process(const OscPath& path, const std::vector<std::string>& values) override;
+
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
 
 private:
 	void CreateMidiClip(ReaProject* project, MediaTrack* track, int beats) noexcept;
@@ -29,7 +34,7 @@ private:
 	void SetColorOfTrack(ReaProject* project, MediaTrack* track, const std::string& value) noexcept;
 	void SetIsActivated(ReaProject* project, bool enable) noexcept;
 	void DeleteAllAutomationEnvelopes(ReaProject* project, MediaTrack* track) noexcept;
-	int GetTrackIndex(ReaProject* project, int dawTrackIndex) const noexcept;
+	int GetTrackIndex(ReaProject* project, int dawTrackIndex) const;
 };
 
 #endif /* _DBM_TRACKPROCESSOR_H_ */
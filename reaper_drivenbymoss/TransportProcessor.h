@@ -6,6 +6,7 @@
 
 #include "WrapperGSL.h"
 #include "OscProcessor.h"
+#include "MidiTransform.h"
 #include "ReaperUtils.h"
 #include "StringUtils.h"
 
@@ -20,16 +21,16 @@ public:
 	AutomationProcessor& operator=(AutomationProcessor&&) = delete;
 	~AutomationProcessor() {};
 
-	void Process(std::deque<std::string>& path) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
 
-	void Process(std::deque<std::string>& path, int value) noexcept override
+	void Process(const OscPath& path, int value) noexcept override
 	{
 		SetGlobalAutomationOverride(value);
 	};
 
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class PlayProcessor : public OscProcessor
@@ -42,7 +43,7 @@ public:
 	PlayProcessor& operator=(PlayProcessor&&) = delete;
 	~PlayProcessor() {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		const int playState = GetPlayStateEx(ReaperUtils::GetProject());
 		if (playState & 1)
@@ -55,9 +56,9 @@ public:
 		}
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class StopProcessor : public OscProcessor
@@ -70,14 +71,14 @@ public:
 	StopProcessor& operator=(StopProcessor&&) = delete;
 	~StopProcessor() {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		CSurf_OnStop();
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class RecordProcessor : public OscProcessor
@@ -85,14 +86,14 @@ class RecordProcessor : public OscProcessor
 public:
 	RecordProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		CSurf_OnRecord();
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class RepeatProcessor : public OscProcessor
@@ -100,14 +101,14 @@ class RepeatProcessor : public OscProcessor
 public:
 	RepeatProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		Main_OnCommandEx(TRANSPORT_REPEAT, 0, ReaperUtils::GetProject());
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class TimeProcessor : public OscProcessor
@@ -115,12 +116,12 @@ class TimeProcessor : public OscProcessor
 public:
 	TimeProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path, int value) noexcept override
+	void Process(const OscPath& path, int value) noexcept override
 	{
 		this->Process(path, static_cast<double> (value));
 	};
 
-	void Process(std::deque<std::string>& path, double value) noexcept override
+	void Process(const OscPath& path, double value) noexcept override
 	{
 		ReaProject* const project = ReaperUtils::GetProject();
 
@@ -159,9 +160,9 @@ public:
 		}
 	};
 
-	void Process(std::deque<std::string>& path) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
 };
 
 class TempoProcessor : public OscProcessor
@@ -169,7 +170,7 @@ class TempoProcessor : public OscProcessor
 public:
 	TempoProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		if (path.empty())
 			return;
@@ -185,18 +186,18 @@ public:
 			Main_OnCommandEx(TEMPO_DEC, 0, project);
 	};
 
-	void Process(std::deque<std::string>& path, int value) noexcept override
+	void Process(const OscPath& path, int value) noexcept override
 	{
 		CSurf_OnTempoChange(value);
 	}
 
-	void Process(std::deque<std::string>& path, double value) noexcept override
+	void Process(const OscPath& path, double value) noexcept override
 	{
 		CSurf_OnTempoChange(value);
 	}
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
 };
 
 class QuantizeProcessor : public OscProcessor
@@ -204,31 +205,45 @@ class QuantizeProcessor : public OscProcessor
 public:
 	QuantizeProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path, double value) noexcept override
+	bool IsUndoBatched() const noexcept override
+	{
+		return true;
+	}
+
+	void Process(const OscPath& path, double value) noexcept override
 	{
 		if (!path.empty())
 			return;
 
-		// Amount value currently not possible to use
-
-		HWND activeMidiEditor = MIDIEditor_GetActive();
-		const bool isNotOpen = activeMidiEditor == nullptr;
-
-		// MAIN section action 40153: "open selected item in MIDI editor"
-		Main_OnCommand(40153, 0);
-		activeMidiEditor = MIDIEditor_GetActive();
-		// Select all notes
-		MIDIEditor_OnCommand(activeMidiEditor, 40003);
-		// Quantize all notes
-		MIDIEditor_OnCommand(activeMidiEditor, 40728);
-		// Close Window (only if it was not open before)
-		if (isNotOpen)
-			MIDIEditor_OnCommand(activeMidiEditor, 2);
+		// Quantize the notes of all selected items to the grid of the MIDI editor without opening it
+		// The value is the quantize amount (0..1)
+		ReaProject* project = ReaperUtils::GetProject();
+		const int count = CountSelectedMediaItems(project);
+		for (int i = 0; i < count; i++)
+		{
+			MediaItem* item = GetSelectedMediaItem(project, i);
+			MediaItem_Take* take = item == nullptr ? nullptr : GetActiveTake(item);
+			if (take == nullptr || !TakeIsMIDI(take))
+				continue;
+
+			double swing{ 0 };
+			const double grid = MIDI_GetGrid(take, &swing, nullptr);
+			const double origin = MIDI_GetPPQPosFromProjQN(take, 0);
+			const double ppqPerQuarter = MIDI_GetPPQPosFromProjQN(take, 1) - origin;
+
+			MidiTransform transform;
+			transform.Quantize(origin, grid * ppqPerQuarter, swing, value);
+			if (transform.Apply(take))
+			{
+				UpdateItemInProject(item);
+				this->model.GetUndoBatch().OnItemStateChange(project, "Quantize notes", item);
+			}
+		}
 	};
 
-	void Process(std::deque<std::string>& path) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
 };
 
 class MetronomeVolumeProcessor : public OscProcessor
@@ -236,7 +251,7 @@ class MetronomeVolumeProcessor : public OscProcessor
 public:
 	MetronomeVolumeProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		if (path.empty())
 			return;
@@ -246,15 +261,15 @@ public:
 		KBD_OnMainActionEx(999, 0x40 + val, -1, 2, GetMainHwnd(), nullptr);
 	};
 
-	void Process(std::deque<std::string>& path, int value) noexcept override
+	void Process(const OscPath& path, int value) noexcept override
 	{
 		// 0 = absolute
 		KBD_OnMainActionEx(999, value, -1, 0, GetMainHwnd(), nullptr);
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class UndoProcessor : public OscProcessor
@@ -262,14 +277,19 @@ class UndoProcessor : public OscProcessor
 public:
 	UndoProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	bool DependsOnProject() const noexcept override
+	{
+		return true;
+	}
+
+	void Process(const OscPath& path) noexcept override
 	{
 		Undo_DoUndo2(ReaperUtils::GetProject());
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class RedoProcessor : public OscProcessor
@@ -277,14 +297,19 @@ class RedoProcessor : public OscProcessor
 public:
 	RedoProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	bool DependsOnProject() const noexcept override
+	{
+		return true;
+	}
+
+	void Process(const OscPath& path) noexcept override
 	{
 		Undo_DoRedo2(ReaperUtils::GetProject());
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class CursorProcessor : public OscProcessor
@@ -292,15 +317,15 @@ class CursorProcessor : public OscProcessor
 public:
 	CursorProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path, int value) noexcept override
+	void Process(const OscPath& path, int value) noexcept override
 	{
 		CSurf_OnArrow(value, 0);
 	};
 
-	void Process(std::deque<std::string>& path) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path) noexcept override {};
+	void Process(const OscPath& path, const std::string& value) noexcept override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
 };
 
 class RefreshProcessor : public OscProcessor
@@ -308,7 +333,7 @@ class RefreshProcessor : public OscProcessor
 public:
 	RefreshProcessor(Model& aModel) : OscProcessor(aModel) {};
 
-	void Process(std::deque<std::string>& path) noexcept override
+	void Process(const OscPath& path) noexcept override
 	{
 		try
 		{
@@ -320,9 +345,93 @@ public:
 		}
 	};
 
-	void Process(std::deque<std::string>& path, const std::string& value) noexcept  override {};
-	void Process(std::deque<std::string>& path, const std::vector<std::string>& values) noexcept override {};
-	void Process(std::deque<std::string>& path, double value) noexcept override {};
+	void Process(const OscPath& path, int value) noexcept override
+	{
+		switch (path.GetHash(0))
+		{
+		case OscPath::Hash("budget"):
+			this->model.dumpBudget = value < 0 ? 0 : value;
+			return;
+		case OscPath::Hash("executionBudget"):
+			this->model.executionBudget = value < 0 ? 0 : value;
+			return;
+		case OscPath::Hash("statisticsInterval"):
+			this->model.statisticsInterval = value < 0 ? 0 : value;
+			return;
+		case OscPath::Hash("midiTracing"):
+			this->model.midiTracing = value > 0;
+			return;
+		default:
+			break;
+		}
+		if (value == 1)
+			this->Process(path);
+	};
+
+	void Process(const OscPath& path, const std::string& value) noexcept  override {};
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+	void Process(const OscPath& path, double value) noexcept override {};
+};
+
+/**
+ * Records the received commands and MIDI messages into a file or plays back such a capture.
+ */
+class CaptureProcessor : public OscProcessor
+{
+public:
+	CaptureProcessor(Model& aModel) : OscProcessor(aModel) {};
+
+	void Process(const OscPath& path) noexcept override
+	{
+		if (std::strcmp(SafeGet(path, 0), "stop") != 0)
+			return;
+		try
+		{
+			CommandCapture& capture = this->model.GetCommandCapture();
+			capture.StopRecording();
+			capture.StopReplay();
+		}
+		catch (...)
+		{
+			// Ignore
+		}
+	};
+
+	void Process(const OscPath& path, const std::string& value) noexcept override
+	{
+		try
+		{
+			const char* cmd = SafeGet(path, 0);
+			if (std::strcmp(cmd, "start") == 0)
+				this->model.GetCommandCapture().StartRecording(value);
+			else if (std::strcmp(cmd, "replay") == 0)
+				this->model.GetCommandCapture().StartReplay(value, this->speed);
+		}
+		catch (...)
+		{
+			// Ignore
+		}
+	};
+
+	void Process(const OscPath& path, int value) noexcept override
+	{
+		if (std::strcmp(SafeGet(path, 0), "speed") == 0)
+			this->Process(path, static_cast<double>(value));
+		else if (value == 1)
+			this->Process(path);
+	};
+
+	void Process(const OscPath& path, double value) noexcept override
+	{
+		if (std::strcmp(SafeGet(path, 0), "speed") == 0 && value > 0)
+			this->speed = value;
+	};
+
+	void Process(const OscPath& path, const std::vector<std::string>& values) noexcept override {};
+
+private:
+	// The speed of the next playback, 1 is the original speed
+	double speed{ 1.0 };
 };
 
 #endif /* _DBM_TRANSPORTPROCESSOR_H_ */
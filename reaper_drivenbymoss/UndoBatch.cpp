@@ -0,0 +1,178 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "UndoBatch.h"
+
+
+/**
+ * Open a new batch, if not already open. Reaper is not called before the first change is
+ * registered.
+ */
+void UndoBatch::Open()
+{
+	if (this->isOpen)
+		return;
+
+	this->isOpen = true;
+	this->isStarted = false;
+	this->description.clear();
+	this->flags = 0;
+	this->changes = 0;
+}
+
+
+/**
+ * Close the current batch, if any. Commits one undo point for all registered changes and
+ * refreshes the UI.
+ */
+void UndoBatch::Close()
+{
+	if (!this->isOpen)
+		return;
+	this->isOpen = false;
+
+	if (this->isStarted)
+	{
+		this->isStarted = false;
+
+		// The undo block also contains the changes which Reaper registered itself, e.g. from
+		// actions which were executed after the first change
+		std::string combined = this->description;
+		if (this->changes > 1)
+			combined.append(" (+").append(std::to_string(this->changes - 1)).append(" more)");
+		Undo_EndBlock2(this->project, combined.empty() ? "DrivenByMoss" : combined.c_str(), this->flags);
+		PreventUIRefresh(-1);
+
+		this->batchCount++;
+		this->changeCount += this->changes;
+	}
+
+	// Updating the timeline includes the arrange view
+	if (this->needsTimelineUpdate)
+		::UpdateTimeline();
+	else if (this->needsArrangeUpdate)
+		::UpdateArrange();
+	this->needsArrangeUpdate = false;
+	this->needsTimelineUpdate = false;
+}
+
+
+/**
+ * Start an undo block. If a batch is open, the undo block of the batch is started instead (if not
+ * already running) and the changes become part of it.
+ *
+ * @param project The project in which the changes happen
+ */
+void UndoBatch::BeginBlock(ReaProject* project)
+{
+	if (this->isOpen)
+		this->Start();
+	else
+		Undo_BeginBlock2(project);
+}
+
+
+/**
+ * End an undo block. If a batch is open the description and flags are added to it.
+ *
+ * @param project The project in which the changes happened
+ * @param description The description of the changes
+ * @param flags The UNDO_STATE_* flags of the changes
+ */
+void UndoBatch::EndBlock(ReaProject* project, const char* description, int flags)
+{
+	if (this->isOpen)
+		this->Register(description, flags);
+	else
+		Undo_EndBlock2(project, description, flags);
+}
+
+
+/**
+ * Signal a change of the project state. If a batch is open the description and flags are added
+ * to it.
+ *
+ * @param project The project in which the changes happened
+ * @param description The description of the changes
+ * @param flags The UNDO_STATE_* flags of the changes
+ */
+void UndoBatch::OnStateChange(ReaProject* project, const char* description, int flags)
+{
+	if (this->isOpen)
+		this->Register(description, flags);
+	else
+		Undo_OnStateChangeEx2(project, description, flags, -1);
+}
+
+
+/**
+ * Signal a change of a media item. If a batch is open the description is added to it.
+ *
+ * @param project The project in which the changes happened
+ * @param description The description of the changes
+ * @param item The media item which was changed
+ */
+void UndoBatch::OnItemStateChange(ReaProject* project, const char* description, MediaItem* item)
+{
+	if (this->isOpen)
+		this->Register(description, UNDO_STATE_ITEMS);
+	else
+		Undo_OnStateChange_Item(project, description, item);
+}
+
+
+/**
+ * Redraw the arrange view. If a batch is open, it is redrawn once when it is closed.
+ */
+void UndoBatch::UpdateArrange()
+{
+	if (this->isOpen)
+		this->needsArrangeUpdate = true;
+	else
+		::UpdateArrange();
+}
+
+
+/**
+ * Redraw the arrange view and ruler. If a batch is open, it is redrawn once when it is closed.
+ */
+void UndoBatch::UpdateTimeline()
+{
+	if (this->isOpen)
+		this->needsTimelineUpdate = true;
+	else
+		::UpdateTimeline();
+}
+
+
+/**
+ * Stop the UI refresh and start the undo block of the open batch on the current project, if not
+ * already started.
+ */
+void UndoBatch::Start()
+{
+	if (this->isStarted)
+		return;
+
+	this->isStarted = true;
+	this->project = ReaperUtils::GetProject();
+	PreventUIRefresh(1);
+	Undo_BeginBlock2(this->project);
+}
+
+
+/**
+ * Add a change to the open batch. The first description is used for the undo point.
+ *
+ * @param description The description of the changes
+ * @param flags The UNDO_STATE_* flags of the changes
+ */
+void UndoBatch::Register(const char* description, int flags)
+{
+	this->Start();
+
+	if (this->changes == 0 && description != nullptr)
+		this->description = description;
+	this->flags |= flags;
+	this->changes++;
+}
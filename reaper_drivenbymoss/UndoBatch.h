@@ -0,0 +1,87 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_UNDOBATCH_H_
+#define _DBM_UNDOBATCH_H_
+
+#include <string>
+
+#include "ReaperUtils.h"
+
+
+/**
+ * Combines the changes of all commands which are executed in one call of the function executor
+ * into one undo point and prevents UI refreshes in between. The processors register their undo
+ * descriptions and flags instead of committing undo points. If no batch is open, the changes are
+ * committed immediately. The undo block and the UI refresh prevention are only started with the
+ * first registered change of a batch, therefore a batch without changes does not call Reaper at
+ * all. Must only be used from the main thread.
+ */
+class UndoBatch
+{
+public:
+	UndoBatch() = default;
+	UndoBatch(const UndoBatch&) = delete;
+	UndoBatch& operator=(const UndoBatch&) = delete;
+	UndoBatch(UndoBatch&&) = delete;
+	UndoBatch& operator=(UndoBatch&&) = delete;
+	~UndoBatch() {};
+
+	void Open();
+	void Close();
+
+	void BeginBlock(ReaProject* project);
+	void EndBlock(ReaProject* project, const char* description, int flags);
+	void OnStateChange(ReaProject* project, const char* description, int flags);
+	void OnItemStateChange(ReaProject* project, const char* description, MediaItem* item);
+	void UpdateArrange();
+	void UpdateTimeline();
+
+	/**
+	 * Check if a batch is open.
+	 *
+	 * @return True if open
+	 */
+	bool IsOpen() const noexcept
+	{
+		return this->isOpen;
+	}
+
+	/**
+	 * Get the number of closed batches.
+	 *
+	 * @return The number of batches
+	 */
+	unsigned long long GetBatchCount() const noexcept
+	{
+		return this->batchCount;
+	}
+
+	/**
+	 * Get the number of changes which were combined into the undo points of the batches.
+	 *
+	 * @return The number of changes
+	 */
+	unsigned long long GetChangeCount() const noexcept
+	{
+		return this->changeCount;
+	}
+
+private:
+	bool isOpen{ false };
+	bool isStarted{ false };
+	ReaProject* project{ nullptr };
+	std::string description;
+	int flags{ 0 };
+	int changes{ 0 };
+	bool needsArrangeUpdate{ false };
+	bool needsTimelineUpdate{ false };
+
+	unsigned long long batchCount{ 0 };
+	unsigned long long changeCount{ 0 };
+
+	void Start();
+	void Register(const char* description, int flags);
+};
+
+#endif /* _DBM_UNDOBATCH_H_ */
@@ -153,6 +153,22 @@ JNIEXPORT void JNICALL Java_de_mossgrabers_reaper_MainApp_setNoteInputKeyTransla
 JNIEXPORT void JNICALL Java_de_mossgrabers_reaper_MainApp_setNoteInputVelocityTranslationTable
   (JNIEnv *, jobject, jint, jint, jintArray);
 
+/*
+ * Class:     de_mossgrabers_reaper_MainApp
+ * Method:    processCommands
+ * Signature: (Ljava/nio/ByteBuffer;I)V
+ */
+JNIEXPORT void JNICALL Java_de_mossgrabers_reaper_MainApp_processCommands
+  (JNIEnv *, jobject, jobject, jint);
+
+/*
+ * Class:     de_mossgrabers_reaper_MainApp
+ * Method:    getStatistics
+ * Signature: (Z)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_de_mossgrabers_reaper_MainApp_getStatistics
+  (JNIEnv *, jobject, jboolean);
+
 #ifdef __cplusplus
 }
 #endif
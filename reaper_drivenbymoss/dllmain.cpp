@@ -11,16 +11,15 @@
 #include <numeric>
 #include <set>
 #include <thread>
-#include <unordered_map>
 #include <wdltypes.h>
 #include <lineparse.h>
 
 #include "resource.h"
 
 #include "CodeAnalysis.h"
+#include "CommandDecoder.h"
 #include "DrivenByMossSurface.h"
-#include "LocalMidiEventDispatcher.h"
-#include "MidiProcessingStructures.h"
+#include "MidiInputHook.h"
 #include "ReaDebug.h"
 #include "StringUtils.h"
 
@@ -40,18 +39,13 @@ std::unique_ptr <JvmManager> jvmManager;
 
 // MIDI port handling
 std::set<int> activeMidiOutputs;
-std::set<int> activeMidiInputs;
 
 // The audio hook for MIDI communication
 audio_hook_register_t audioHook;
+MidiInputHook midiInputHook;
 
-// Atomic shared snapshot (lock-free access)
-using DeviceMap = std::unordered_map<int, DeviceNoteData>;
-std::shared_ptr<DeviceMap> deviceDataSnapshot;
-std::mutex deviceDataMutex; // only needed for writes, not reads
-
-// Java to internal Reaper
-LocalMidiEventDispatcher localMidiEventDispatcher{};
+// Decodes the binary commands, keeps the defined IDs as long as the extension is loaded
+CommandDecoder commandDecoder;
 
 // Defined in DrivenByMossSurface.cpp
 extern DrivenByMossSurface* surfaceInstance;
@@ -215,6 +209,54 @@ static void ProcessDoubleArgCPP(JNIEnv* env, jobject object, jstring processor,
 }
 
 
+/**
+ * Java callback for a batch of binary encoded commands to be executed in Reaper. See
+ * CommandDecoder for the format.
+ *
+ * @param env    The JNI environment
+ * @param object The JNI object
+ * @param buffer The direct byte buffer which contains the encoded commands
+ * @param length The number of bytes which are used in the buffer
+ */
+static void ProcessCommandsCPP(JNIEnv* env, jobject object, jobject buffer, jint length)
+{
+	if (env == nullptr || surfaceInstance == nullptr || buffer == nullptr || length <= 0)
+		return;
+	void* address = env->GetDirectBufferAddress(buffer);
+	const jlong capacity = env->GetDirectBufferCapacity(buffer);
+	if (address == nullptr || capacity < length)
+	{
+		ReaDebug() << "Binary commands need a direct buffer with at least " << length << " bytes.";
+		return;
+	}
+	surfaceInstance->ProcessCommands(commandDecoder, static_cast<const std::uint8_t*>(address), static_cast<std::size_t>(length));
+}
+
+
+/**
+ * Java callback to get the statistics of the measured tasks.
+ *
+ * @param env    The JNI environment
+ * @param object The JNI object
+ * @param reset  True to reset the timers afterwards
+ * @return The statistics formatted as a JSON object
+ */
+static jstring GetStatisticsCPP(JNIEnv* env, jobject object, jboolean reset)
+{
+	if (env == nullptr || surfaceInstance == nullptr)
+		return nullptr;
+	try
+	{
+		return env->NewStringUTF(surfaceInstance->GetStatistics(reset == JNI_TRUE).c_str());
+	}
+	catch (const std::exception& ex)
+	{
+		ReaDebug() << "Could not create statistics: " << ex.what();
+		return nullptr;
+	}
+}
+
+
 /**
  * Java callback to dis-/enable updates for a specific processor.
  *
@@ -278,7 +320,7 @@ static void ProcessMidiArgCPP(const JNIEnv* env, jobject object, jint deviceID,
 	event.midi_message[0] = gsl::narrow_cast<unsigned char>(status);
 	event.midi_message[1] = gsl::narrow_cast<unsigned char>(data1);
 	event.midi_message[2] = gsl::narrow_cast<unsigned char>(data2);
-	localMidiEventDispatcher.Push(deviceID, event);
+	midiInputHook.SendToReaper(deviceID, event);
 }
 
 
@@ -357,7 +399,7 @@ static jboolean OpenMidiInputCPP(JNIEnv* env, jobject object, jint deviceID)
 	const int id = gsl::narrow_cast<int>(deviceID);
 	if (id >= 0 && id < GetNumMIDIInputs())
 	{
-		activeMidiInputs.insert(deviceID);
+		midiInputHook.OpenInput(deviceID);
 		return JNI_TRUE;
 	}
 	return JNI_FALSE;
@@ -393,7 +435,7 @@ static jboolean OpenMidiOutputCPP(JNIEnv* env, jobject object, jint deviceID)
  */
 static void CloseMidiInputCPP(JNIEnv* env, jobject object, jint deviceID) noexcept
 {
-	activeMidiInputs.erase(deviceID);
+	midiInputHook.CloseInput(deviceID);
 }
 
 
@@ -442,6 +484,7 @@ static void SendMidiDataCPP(JNIEnv* env, jobject object, jint deviceID, jbyteArr
 		m->status = gsl::narrow_cast<uint8_t>(source[0]);
 		m->data1 = length > 1 ? gsl::narrow_cast<uint8_t>(gsl::at(spanSource, 1)) : 0;
 		m->data2 = length > 2 ? gsl::narrow_cast<uint8_t>(gsl::at(spanSource, 2)) : 0;
+		surfaceInstance->GetProfiler().TraceOutgoing(*m);
 		surfaceInstance->outgoingMidiQueue3.push(std::move(m));
 	}
 	else if (length <= kSyx1k_Max)
@@ -451,6 +494,7 @@ static void SendMidiDataCPP(JNIEnv* env, jobject object, jint deviceID, jbyteArr
 		m->deviceId = gsl::narrow_cast<uint32_t>(deviceID);
 		m->size = gsl::narrow_cast<uint32_t>(length);
 		std::memcpy(m->data, source, length);
+		surfaceInstance->GetProfiler().TraceOutgoing(*m);
 		surfaceInstance->outgoingMidiQueue1k.push(std::move(m));
 	}
 	else if (length <= kSyx64k_Max)
@@ -460,6 +504,7 @@ static void SendMidiDataCPP(JNIEnv* env, jobject object, jint deviceID, jbyteArr
 		m->deviceId = gsl::narrow_cast<uint32_t>(deviceID);
 		m->size = gsl::narrow_cast<uint32_t>(length);
 		std::memcpy(m->data, source, length);
+		surfaceInstance->GetProfiler().TraceOutgoing(*m);
 		surfaceInstance->outgoingMidiQueue64k.push(std::move(m));
 	}
 	else
@@ -524,18 +569,7 @@ static void SetFiltersCPP(JNIEnv* env, jobject object, jint deviceID, jint noteI
 			parsed.push_back(ParseHexFilter(hex));
 	}
 
-	const std::lock_guard<std::mutex> lock(deviceDataMutex);
-	DISABLE_WARNING_PREFER_LOCAL_OBJECTS
-	std::shared_ptr<DeviceMap> current = std::atomic_load(&deviceDataSnapshot);
-	if (!current)
-		current = std::make_shared<DeviceMap>();
-	std::shared_ptr<DeviceMap> updated = std::make_shared<DeviceMap>(*current);
-
-	DeviceNoteData& deviceData = (*updated)[deviceID];
-	deviceData.noteInputs[noteInputIndex].filters = std::move(parsed);
-	deviceData.BuildFilterLookup();
-
-	std::atomic_store(&deviceDataSnapshot, updated);
+	midiInputHook.SetFilters(deviceID, noteInputIndex, std::move(parsed));
 }
 
 
@@ -580,18 +614,7 @@ static void SetKeyTranslationTableCPP(JNIEnv* env, jobject object, jint deviceID
 	if (!CopyJIntArray128(env, table, parsed))
 		return;
 
-	const std::lock_guard<std::mutex> lock(deviceDataMutex);
-	std::shared_ptr<DeviceMap> current = std::atomic_load(&deviceDataSnapshot);
-	if (!current)
-		current = std::make_shared<DeviceMap>();
-	std::shared_ptr<DeviceMap> updated = std::make_shared<DeviceMap>(*current);
-
-	DeviceNoteData& deviceData = (*updated)[deviceID];
-	NoteInputData& noteData = deviceData.noteInputs[noteInputIndex];
-	noteData.keyTable = parsed;
-	deviceData.BuildKeyLookup();
-
-	std::atomic_store(&deviceDataSnapshot, updated);
+	midiInputHook.SetKeyTranslationTable(deviceID, noteInputIndex, parsed);
 }
 
 
@@ -617,17 +640,7 @@ static void SetVelocityTranslationTableCPP(JNIEnv* env, jobject object, jint dev
 	if (!CopyJIntArray128(env, table, parsed))
 		return;
 
-	std::shared_ptr<DeviceMap> current = std::atomic_load(&deviceDataSnapshot);
-	if (!current)
-		current = std::make_shared<DeviceMap>();
-	std::shared_ptr<DeviceMap> updated = std::make_shared<DeviceMap>(*current);
-
-	DeviceNoteData& deviceData = (*updated)[deviceID];
-	NoteInputData& noteData = deviceData.noteInputs[noteInputIndex];
-	noteData.velocityTable = parsed;
-	deviceData.BuildVelocityLookup();
-
-	std::atomic_store(&deviceDataSnapshot, updated);
+	midiInputHook.SetVelocityTranslationTable(deviceID, noteInputIndex, parsed);
 }
 
 
@@ -639,7 +652,8 @@ static void SetVelocityTranslationTableCPP(JNIEnv* env, jobject object, jint dev
  */
 static bool HookCommandProc(int command, int flag)
 {
-	if (!jvmManager || !jvmManager->IsRunning())
+	// Calls are deferred while the JVM starts
+	if (!jvmManager || !(jvmManager->IsRunning() || jvmManager->IsStarting()))
 		return false;
 
 	if (openDBMConfigureWindowAccel.accel.cmd != 0 && openDBMConfigureWindowAccel.accel.cmd == command)
@@ -707,7 +721,7 @@ static WDL_DLGRET dlgProc(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARAM lParam)
 		switch (value)
 		{
 		case IDC_BUTTON_CONFIGURE:
-			if (jvmManager && jvmManager->IsRunning())
+			if (jvmManager && (jvmManager->IsRunning() || jvmManager->IsStarting()))
 				jvmManager->DisplayWindow();
 			break;
 		default:
@@ -747,7 +761,7 @@ static IReaperControlSurface* createFunc(const char* type_string, const char* co
 
 		// Satisfying C API
 		DISABLE_WARNING_REINTERPRET_CAST
-		void* functions[18] = {
+		void* functions[20] = {
 			reinterpret_cast<void*>(&ProcessNoArgCPP),
 			reinterpret_cast<void*>(&ProcessStringArgCPP),
 			reinterpret_cast<void*>(&ProcessStringArgsCPP),
@@ -765,10 +779,12 @@ static IReaperControlSurface* createFunc(const char* type_string, const char* co
 			reinterpret_cast<void*>(&SendMidiDataCPP),
 			reinterpret_cast<void*>(&SetFiltersCPP),
 			reinterpret_cast<void*>(&SetKeyTranslationTableCPP),
-			reinterpret_cast<void*>(&SetVelocityTranslationTableCPP)
+			reinterpret_cast<void*>(&SetVelocityTranslationTableCPP),
+			reinterpret_cast<void*>(&ProcessCommandsCPP),
+			reinterpret_cast<void*>(&GetStatisticsCPP)
 		};
 
-		jvmManager->Init(functions);
+		jvmManager->InitAsync(functions);
 	}
 
 	ReaDebug::Log("DrivenByMoss: Creating surface.\n");
@@ -815,7 +831,7 @@ static bool ProcessExtensionLine(const char* line, ProjectStateContext* ctx, boo
 	if (ctx == nullptr)
 		return false;
 
-	if (!jvmManager || !jvmManager->IsRunning())
+	if (!jvmManager || !(jvmManager->IsRunning() || jvmManager->IsStarting()))
 		return false;
 
 	// Parse the line and check if it is valid and belongs to this extension
@@ -864,10 +880,13 @@ static void SaveExtensionConfig(ProjectStateContext* ctx, bool isUndo, struct pr
 	if (ctx == nullptr)
 		return;
 
-	if (!jvmManager || !jvmManager->IsRunning())
+	if (!jvmManager || !(jvmManager->IsRunning() || jvmManager->IsStarting()))
 		return;
 
+	// While the JVM starts these are the settings of the loaded project
 	std::string line = jvmManager->GetFormattedDocumentSettings();
+	if (line.empty() && !jvmManager->IsRunning())
+		return;
 
 	ctx->AddLine("<DRIVEN_BY_MOSS");
 	ctx->AddLine("%s", line.c_str());
@@ -890,7 +909,7 @@ static void BeginLoadProjectState(bool isUndo, struct project_config_extension_t
 	// Called on project load/undo before any (possible) ProcessExtensionLine. NULL is OK too
 	// also called on "new project" (wont be followed by ProcessExtensionLine calls in that case)
 	// Defaults could be set here but are already set by the controller instances
-	if (jvmManager && jvmManager->IsRunning())
+	if (jvmManager && (jvmManager->IsRunning() || jvmManager->IsStarting()))
 		jvmManager->SetDefaultDocumentSettings();
 
 	ReaDebug::Log("DrivenByMoss: Project settings loaded.\n");
@@ -906,61 +925,6 @@ project_config_extension_t pcreg =
 };
 
 
-/**
- * Matches the incoming MIDI event against the registered note input filters.
- *
- * @param deviceData The ID of the device to which to match the event
- * @param event The event to match/filter
- */
-inline static bool ProcessMidiEvents(const DeviceNoteData& deviceData, MIDI_event_t* event) noexcept
-{
-	const unsigned char data1 = event->size > 1 ? event->midi_message[1] : 0;
-	if (data1 >= 128)
-		return false;
-
-	// Do not use gsl:at for performance reasons!
-	DISABLE_WARNING_USE_GSL_AT
-	DISABLE_WARNING_ACCESS_ARRAYS_WITH_CONST
-
-	const unsigned char status = event->midi_message[0];
-	const int statusType = status & 0xF0;
-	const bool isNote = statusType == 0x90 || statusType == 0x80 || statusType == 0xA0;
-
-	for (size_t noteIdx = 0; noteIdx < MAX_NOTE_INPUTS; ++noteIdx)
-	{
-		// Note: to be 100% correct this would require the creation of a new MIDI event since
-		// theoretically multiple note inputs could be present and events could be modified differently
-		// If this becomes a use-case it would need to be implemented with a pre-allocated pool or ring 
-		// buffer of MIDI_event_t
-
-		if (deviceData.filterMatch[noteIdx][status][data1])
-		{
-			if (isNote)
-			{
-				if (deviceData.keyLookup[noteIdx][data1] < 0)
-					continue;
-
-				event->midi_message[1] = deviceData.keyLookup[noteIdx][data1];
-
-				const unsigned char data2 = event->size > 2 ? event->midi_message[2] : 0;
-
-				if (deviceData.velocityLookup[noteIdx][data2] < 0)
-					continue;
-
-				if (data2 >= 128)
-					return false;
-
-				event->midi_message[2] = deviceData.velocityLookup[noteIdx][data2];
-			}
-
-			return true;
-		}
-	}
-
-	return false;
-}
-
-
 static void OnExit() noexcept
 {
 	if (surfaceInstance != nullptr)
@@ -969,81 +933,19 @@ static void OnExit() noexcept
 
 
 /**
- * Audio hook. Reads from registered MIDI inputs and queues the events to be sent to Java as well
- * as matching them against the registered note input filters and sends the matches to Reaper.
- * Adds additional MIDI events intended for Reaper.
+ * Audio hook. Handles the MIDI inputs, see MidiInputHook.
  * The method is called before and after the update of the audio buffer
  *
  * @param isPost True if the call is after the update of the audio buffer
- * @param len    The length of the buffer (not used)
- * @param srate  The sample rate (not used)
+ * @param len    The length of the buffer (only used by the watchdog)
+ * @param srate  The sample rate (only used by the watchdog)
  * @param reg    Pointer to the registered audio hook structure (not used)
  */
 static void OnAudioBuffer(bool isPost, int len, double srate, struct audio_hook_register_t* reg)
 {
 	if (surfaceInstance == nullptr || isPost)
 		return;
-
-	for (const auto& deviceID : activeMidiInputs)
-	{
-		midi_Input* midiin = GetMidiInput(deviceID);
-		if (!midiin)
-			continue;
-
-		auto snapshot = std::atomic_load(&deviceDataSnapshot);
-		if (!snapshot)
-			continue;
-
-		const auto deviceIt = snapshot->find(deviceID);
-		if (deviceIt == snapshot->end())
-			continue;
-
-		MIDI_eventlist* list = midiin->GetReadBuf();
-		if (!list)
-			continue;
-
-		const auto& deviceData = deviceIt->second;
-
-		int position = 0;
-		int nextPosition = 0;
-		MIDI_event_t* event;
-		// Copy the events out of the audio thread to be sent to the Java side
-		while ((event = list->EnumItems(&nextPosition)) != nullptr)
-		{
-			const int size = event->size;
-			if (size == 0)
-				continue;
-
-			if (size > 3)
-			{
-				if (size < 1024)
-					surfaceInstance->EnqueueSysex1k(deviceID, event->midi_message, event->size);
-				else
-					surfaceInstance->EnqueueSysex64k(deviceID, event->midi_message, event->size);
-				continue;
-			}
-
-			const uint8_t status = event->midi_message[0];
-			// Ignore active sensing
-			if (status == 0 || status == 0xFE)
-				continue;
-
-			const uint8_t data1 = (size > 1) ? event->midi_message[1] : 0;
-			const uint8_t data2 = (size > 2) ? event->midi_message[2] : 0;
-			surfaceInstance->EnqueueMidi3(deviceID, status, data1, data2);
-			// Apply note input filters
-			if (!ProcessMidiEvents(deviceData, event))
-			{
-				list->DeleteItem(position);
-				nextPosition = position;
-			}
-			else
-				position = nextPosition;
-		}
-
-		// Add events to be sent to Reaper
-		localMidiEventDispatcher.ProcessDeviceQueue(deviceID, list);
-	}
+	midiInputHook.OnAudioBuffer(*surfaceInstance, len, srate);
 }
 
 
@@ -1084,7 +986,6 @@ extern "C"
 
 		pluginInstanceHandle = hInstance;
 		ReaperUtils::mainWindowHandle = rec->hwnd_main;
-		deviceDataSnapshot = std::make_shared<DeviceMap>();
 
 		if (rec->caller_version != REAPER_PLUGIN_VERSION || rec->GetFunc == nullptr)
 			return 0;
@@ -1132,6 +1033,7 @@ extern "C"
 			ReaDebug() << "GetMidiOutput is not available.";
 			return 0;
 		}
+		midiInputHook.SetMidiInputFunction(GetMidiInput);
 
 		// Register audio hook
 		audioHook.userdata1 = nullptr;
@@ -0,0 +1,244 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DataCollector.h"
+#include "FunctionExecutor.h"
+#include "Model.h"
+#include "OscParser.h"
+#include "ReaDebug.h"
+#include "RtWatchdog.h"
+#include "SyntheticProject.h"
+
+
+namespace
+{
+	/** The most collection passes to wait for the end of a dump. */
+	const int MAX_DUMP_PASSES{ 100000 };
+
+	/** The sizes of the projects, every combination is measured. */
+	struct Sweep
+	{
+		std::vector<int> tracks{ 8, 64, 512, 2048 };
+		std::vector<int> sends{ 0, 4, 16 };
+		std::vector<int> devices{ 2 };
+		std::vector<int> params{ 10, 200, 2000 };
+		std::vector<int> notes{ 0, 500, 5000 };
+		int ticks{ 20 };
+		int changes{ 8 };
+	};
+
+	/** The measurements of a number of collection passes. */
+	struct PassStatistics
+	{
+		int count{ 0 };
+		long long totalNanos{ 0 };
+		long long maxNanos{ 0 };
+		unsigned long long allocations{ 0 };
+		unsigned long long maxAllocations{ 0 };
+		std::size_t bytes{ 0 };
+
+		void WriteJson(std::ostringstream& ss) const
+		{
+			const long long divisor = this->count > 0 ? this->count : 1;
+			ss << "{\"count\":" << this->count << ",\"avgNanos\":" << this->totalNanos / divisor << ",\"maxNanos\":" << this->maxNanos
+				<< ",\"allocations\":" << this->allocations << ",\"avgAllocations\":" << this->allocations / divisor << ",\"maxAllocations\":" << this->maxAllocations
+				<< ",\"bytes\":" << this->bytes << "}";
+		}
+	};
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: dbm_collect_bench [--tracks list] [--sends list] [--devices list] [--params list] [--notes list] [--ticks n] [--changes n]\n";
+	}
+
+	/**
+	 * Parse a comma separated list of numbers.
+	 *
+	 * @param text The text
+	 * @param values Filled with the numbers
+	 * @return False if the list is empty
+	 */
+	bool ParseList(const std::string& text, std::vector<int>& values)
+	{
+		values.clear();
+		std::istringstream stream(text);
+		std::string value;
+		while (std::getline(stream, value, ','))
+		{
+			if (!value.empty())
+				values.push_back(std::max(0, std::atoi(value.c_str())));
+		}
+		return !values.empty();
+	}
+
+	bool ParseArguments(int argc, char* argv[], Sweep& sweep)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument{ argv[i] };
+			if (i + 1 >= argc)
+				return false;
+			const std::string value{ argv[++i] };
+			bool isValid{ true };
+			if (argument == "--tracks")
+				isValid = ParseList(value, sweep.tracks);
+			else if (argument == "--sends")
+				isValid = ParseList(value, sweep.sends);
+			else if (argument == "--devices")
+				isValid = ParseList(value, sweep.devices);
+			else if (argument == "--params")
+				isValid = ParseList(value, sweep.params);
+			else if (argument == "--notes")
+				isValid = ParseList(value, sweep.notes);
+			else if (argument == "--ticks")
+				sweep.ticks = std::atoi(value.c_str());
+			else if (argument == "--changes")
+				sweep.changes = std::atoi(value.c_str());
+			else
+				return false;
+			if (!isValid)
+				return false;
+		}
+		return sweep.ticks > 0 && sweep.changes >= 0;
+	}
+
+
+	/**
+	 * Execute one collection pass and add its measurements.
+	 *
+	 * @param dataCollector The collector
+	 * @param model The model
+	 * @param actionProcessor The processor of the actions
+	 * @param statistics Where to add the measurements
+	 * @return The collected data
+	 */
+	std::string Collect(DataCollector& dataCollector, Model& model, ActionProcessor& actionProcessor, PassStatistics& statistics)
+	{
+		const unsigned long long allocationsBefore = RtWatchdog::GetThreadAllocations();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::string data = dataCollector.CollectData(model.ShouldDump(), actionProcessor);
+		const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		const unsigned long long allocations = RtWatchdog::GetThreadAllocations() - allocationsBefore;
+
+		statistics.count++;
+		statistics.totalNanos += nanos;
+		statistics.maxNanos = std::max(statistics.maxNanos, nanos);
+		statistics.allocations += allocations;
+		statistics.maxAllocations = std::max(statistics.maxAllocations, allocations);
+		statistics.bytes += data.size();
+		return data;
+	}
+
+
+	/**
+	 * Measure the first dump and the following update passes of one project size.
+	 *
+	 * @param settings The size of the project
+	 * @param sweep The number of passes and changes per pass
+	 * @param ss Where to write the result as JSON
+	 */
+	void Measure(const SyntheticProject::Settings& settings, const Sweep& sweep, std::ostringstream& ss)
+	{
+		SyntheticProject project(settings);
+		project.Install();
+		// Meters and the play position change on every pass
+		project.playState = 1;
+
+		FunctionExecutor functionExecutor;
+		Model model(functionExecutor);
+		ReaDebug::setModel(&model);
+		OscParser oscParser(model);
+		DataCollector dataCollector(model);
+		ActionProcessor& actionProcessor = oscParser.GetActionProcessor();
+
+		// Java requests a dump on startup, it might take several passes
+		PassStatistics dump;
+		model.SetDump();
+		for (int i = 0; i < MAX_DUMP_PASSES; i++)
+		{
+			project.Tick();
+			if (Collect(dataCollector, model, actionProcessor, dump).find("/dump/end ") != std::string::npos)
+				break;
+		}
+
+		PassStatistics update;
+		for (int i = 0; i < sweep.ticks; i++)
+		{
+			project.Tick();
+			project.ChangeValues(sweep.changes);
+			Collect(dataCollector, model, actionProcessor, update);
+		}
+
+		ss << "{\"tracks\":" << settings.tracks << ",\"sends\":" << settings.sendsPerTrack << ",\"devices\":" << settings.devicesPerTrack << ",\"params\":" << settings.parametersPerDevice
+			<< ",\"notes\":" << settings.notesPerItem << ",\"dump\":";
+		dump.WriteJson(ss);
+		ss << ",\"update\":";
+		update.WriteJson(ss);
+		ss << ",\"apiCalls\":" << project.GetCalls() << "}";
+
+		ReaDebug::setModel(nullptr);
+	}
+}
+
+
+/**
+ * Measures the data collection against synthetic projects of different sizes. For every
+ * combination of the numbers of tracks, sends per track, devices per track, parameters per
+ * device and notes per clip, a dump is collected first, followed by the given number of update
+ * passes, each after some values of the project were changed. Each track has 1 clip and by
+ * default 2 devices, large FX chains are measured with e.g. --devices 2,32,128 --params 200,2000.
+ *
+ * The heap allocations of the main thread are counted with the functions which are wrapped for
+ * the real-time watchdog, see RtWatchdog.cpp. They are only counted if the executable was linked
+ * with these wrappers, otherwise 0 is reported.
+ *
+ * Usage: dbm_collect_bench [--tracks list] [--sends list] [--devices list] [--params list]
+ *        [--notes list] [--ticks n] [--changes n]
+ *
+ * The lists are comma separated. Prints one JSON object per line and combination.
+ */
+int main(int argc, char* argv[])
+{
+	Sweep sweep;
+	if (!ParseArguments(argc, argv, sweep))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	SyntheticProject::Settings settings;
+	settings.itemsPerTrack = 1;
+	for (const int tracks : sweep.tracks)
+	{
+		for (const int sends : sweep.sends)
+		{
+			for (const int devices : sweep.devices)
+			{
+				for (const int params : sweep.params)
+				{
+					for (const int notes : sweep.notes)
+					{
+						settings.tracks = tracks;
+						settings.sendsPerTrack = sends;
+						settings.devicesPerTrack = devices;
+						settings.parametersPerDevice = params;
+						settings.notesPerItem = notes;
+
+						std::ostringstream ss;
+						Measure(settings, sweep, ss);
+						std::cout << ss.str() << std::endl;
+					}
+				}
+			}
+		}
+	}
+	return 0;
+}
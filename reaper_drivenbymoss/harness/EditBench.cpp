@@ -0,0 +1,353 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Marker.h"
+#include "MidiTransform.h"
+#include "ReaperUtils.h"
+#include "RtWatchdog.h"
+#include "SceneProcessor.h"
+#include "SyntheticProject.h"
+#include "UndoBatch.h"
+
+
+namespace
+{
+	/** The resolution of the takes in PPQ per quarter note. */
+	const int PPQ{ 960 };
+	/** The grid of the generated notes and of the quantization, a 16th. */
+	const int GRID{ PPQ / 4 };
+
+	/** The options of the command line. */
+	struct Options
+	{
+		int notes{ 10000 };
+		int runs{ 20 };
+		int tracks{ 32 };
+		std::vector<int> items{ 4, 16, 64 };
+	};
+
+	/** The measurements of a number of runs of an edit. */
+	struct RunStatistics
+	{
+		int count{ 0 };
+		long long totalNanos{ 0 };
+		long long maxNanos{ 0 };
+		unsigned long long allocations{ 0 };
+
+		void WriteJson(std::ostringstream& ss) const
+		{
+			const long long divisor = this->count > 0 ? this->count : 1;
+			ss << "{\"count\":" << this->count << ",\"avgNanos\":" << this->totalNanos / divisor << ",\"maxNanos\":" << this->maxNanos
+				<< ",\"avgAllocations\":" << this->allocations / static_cast<unsigned long long> (divisor) << "}";
+		}
+	};
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: dbm_edit_bench [--notes n] [--runs n] [--tracks n] [--items list]\n";
+	}
+
+	bool ParseList(const char* value, std::vector<int>& list)
+	{
+		list.clear();
+		std::istringstream input(value);
+		std::string token;
+		while (std::getline(input, token, ','))
+		{
+			const int number = std::atoi(token.c_str());
+			if (number <= 0)
+				return false;
+			list.push_back(number);
+		}
+		return !list.empty();
+	}
+
+	bool ParseArguments(int argc, char* argv[], Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument{ argv[i] };
+			if (i + 1 >= argc)
+				return false;
+			const char* value = argv[++i];
+			if (argument == "--notes")
+				options.notes = std::atoi(value);
+			else if (argument == "--runs")
+				options.runs = std::atoi(value);
+			else if (argument == "--tracks")
+				options.tracks = std::atoi(value);
+			else if (argument == "--items")
+			{
+				if (!ParseList(value, options.items))
+					return false;
+			}
+			else
+				return false;
+		}
+		return options.notes > 0 && options.runs > 0 && options.tracks > 0;
+	}
+
+
+	/**
+	 * Append an event in the format of MIDI_GetAllEvts.
+	 *
+	 * @param buffer Where to append the event
+	 * @param offset The distance to the previous event in PPQ
+	 * @param status The status byte
+	 * @param data1 The first data byte
+	 * @param data2 The second data byte
+	 */
+	void AppendEvent(std::vector<char>& buffer, int offset, int status, int data1, int data2)
+	{
+		const char flags{ 0 };
+		const int length{ 3 };
+		const char message[] = { static_cast<char> (status), static_cast<char> (data1), static_cast<char> (data2) };
+		const std::size_t start = buffer.size();
+		buffer.resize(start + sizeof(int) + 1 + sizeof(int) + length);
+		std::memcpy(&buffer[start], &offset, sizeof(int));
+		buffer[start + sizeof(int)] = flags;
+		std::memcpy(&buffer[start + sizeof(int) + 1], &length, sizeof(int));
+		std::memcpy(&buffer[start + 2 * sizeof(int) + 1], message, length);
+	}
+
+
+	/**
+	 * Create the events of a take like MIDI_GetAllEvts returns them. The notes are a drum pattern
+	 * of 4 voices which are played slightly off the 16th grid, with a modulation CC on every
+	 * quarter. The take ends with the all-notes-off which marks the end of the source.
+	 *
+	 * @param notes The number of notes
+	 * @return The events
+	 */
+	std::vector<char> CreateTake(int notes)
+	{
+		struct TimedEvent
+		{
+			long long position;
+			int status;
+			int data1;
+			int data2;
+		};
+
+		std::vector<TimedEvent> events;
+		events.reserve(notes * 2 + notes / 4 + 1);
+		unsigned int random{ 1 };
+		for (int i = 0; i < notes; i++)
+		{
+			random = random * 1103515245u + 12345u;
+			const long long start = static_cast<long long> (i / 4) * GRID + static_cast<long long> ((random >> 8) % 41) - 20;
+			const int pitch = 36 + (i % 4) * 2;
+			events.push_back({ std::max(0LL, start), 0x99, pitch, 40 + static_cast<int> ((random >> 16) % 88) });
+			events.push_back({ std::max(0LL, start) + GRID / 2, 0x89, pitch, 0 });
+			if (i % 16 == 0)
+				events.push_back({ static_cast<long long> (i / 4) * GRID, 0xB0, 1, static_cast<int> ((random >> 12) % 128) });
+		}
+		std::stable_sort(events.begin(), events.end(), [](const TimedEvent& a, const TimedEvent& b)
+			{
+				return a.position < b.position;
+			});
+		events.push_back({ events.empty() ? 0 : events.back().position, 0xB0, 123, 0 });
+
+		std::vector<char> buffer;
+		long long position{ 0 };
+		for (const TimedEvent& event : events)
+		{
+			AppendEvent(buffer, static_cast<int> (event.position - position), event.status, event.data1, event.data2);
+			position = event.position;
+		}
+		return buffer;
+	}
+
+
+	/**
+	 * Measure the given edit on copies of a take.
+	 *
+	 * @param take The events of the take
+	 * @param runs The number of runs
+	 * @param edit Adds the transformations to measure
+	 * @return The measurements
+	 */
+	RunStatistics MeasureTransform(const std::vector<char>& take, int runs, const std::function<void(MidiTransform&)>& edit)
+	{
+		RunStatistics statistics;
+		std::vector<char> buffer;
+		buffer.reserve(take.size() * 2);
+		for (int i = 0; i < runs; i++)
+		{
+			buffer.assign(take.begin(), take.end());
+
+			const unsigned long long allocationsBefore = RtWatchdog::GetThreadAllocations();
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			MidiTransform transform;
+			edit(transform);
+			if (!transform.Apply(buffer))
+				std::cerr << "Transform did not change the take.\n";
+			const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+			statistics.count++;
+			statistics.totalNanos += nanos;
+			statistics.maxNanos = std::max(statistics.maxNanos, nanos);
+			statistics.allocations += RtWatchdog::GetThreadAllocations() - allocationsBefore;
+		}
+		return statistics;
+	}
+
+
+	/**
+	 * Measure the bulk edits of a MIDI take, see MidiTransform. Each edit reads and writes the
+	 * whole take like it is done with MIDI_GetAllEvts and MIDI_SetAllEvts.
+	 *
+	 * @param options The number of notes and runs
+	 * @param ss Where to write the result as JSON
+	 */
+	void BenchmarkMidi(const Options& options, std::ostringstream& ss)
+	{
+		const std::vector<char> take = CreateTake(options.notes);
+
+		ss << "\"midi\":{\"notes\":" << options.notes << ",\"bytes\":" << take.size() << ",\"transpose\":";
+		MeasureTransform(take, options.runs, [](MidiTransform& transform) { transform.Transpose(7); }).WriteJson(ss);
+		ss << ",\"quantize\":";
+		MeasureTransform(take, options.runs, [](MidiTransform& transform) { transform.Quantize(0, GRID, 0.3, 1.0); }).WriteJson(ss);
+		ss << ",\"velocity\":";
+		MeasureTransform(take, options.runs, [](MidiTransform& transform) { transform.ScaleVelocity(0.8); }).WriteJson(ss);
+		ss << ",\"combined\":";
+		MeasureTransform(take, options.runs, [](MidiTransform& transform) { transform.Transpose(-5).Quantize(0, GRID, 0.0, 0.5).ScaleVelocity(1.2); }).WriteJson(ss);
+		ss << "}";
+	}
+
+
+	/**
+	 * Measure the duplication of a region, see SceneProcessor::DuplicateScene. The region covers
+	 * the middle half of the items of all tracks. Each run duplicates the region in a new project.
+	 *
+	 * @param tracks The number of tracks
+	 * @param items The number of items per track
+	 * @param runs The number of runs
+	 * @param ss Where to write the result as JSON
+	 */
+	void BenchmarkRegion(int tracks, int items, int runs, std::ostringstream& ss)
+	{
+		SyntheticProject::Settings settings;
+		settings.tracks = tracks;
+		settings.itemsPerTrack = items;
+		settings.markers = 0;
+
+		RunStatistics statistics;
+		std::size_t copiedItems{ 0 };
+		unsigned long long calls{ 0 };
+		for (int i = 0; i < runs; i++)
+		{
+			SyntheticProject project(settings);
+			project.Install();
+
+			// The items are 8 seconds long and placed one after the other
+			SyntheticProject::MarkerData region;
+			region.isRegion = true;
+			region.position = (items / 4) * 8.0;
+			region.end = region.position + std::max(1, items / 2) * 8.0;
+			region.number = 1;
+			region.name = "Verse";
+			project.markers.push_back(region);
+
+			Marker scene;
+			scene.position = region.position;
+			scene.endPosition = region.end;
+			scene.markerOrRegionIndex = region.number;
+			scene.name = region.name;
+
+			std::size_t itemsBefore{ 0 };
+			for (const std::unique_ptr<SyntheticProject::TrackData>& track : project.tracks)
+				itemsBefore += track->items.size();
+
+			UndoBatch undoBatch;
+			const unsigned long long callsBefore = project.GetCalls();
+			const unsigned long long allocationsBefore = RtWatchdog::GetThreadAllocations();
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			SceneProcessor::DuplicateScene(undoBatch, ReaperUtils::GetProject(), 0, &scene);
+			const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+			statistics.count++;
+			statistics.totalNanos += nanos;
+			statistics.maxNanos = std::max(statistics.maxNanos, nanos);
+			statistics.allocations += RtWatchdog::GetThreadAllocations() - allocationsBefore;
+			calls = project.GetCalls() - callsBefore;
+
+			std::size_t itemsAfter{ 0 };
+			for (const std::unique_ptr<SyntheticProject::TrackData>& track : project.tracks)
+				itemsAfter += track->items.size();
+			copiedItems = itemsAfter - itemsBefore;
+			if (project.markers.size() != 2)
+				std::cerr << "The copy of the region was not added.\n";
+		}
+
+		ss << "{\"tracks\":" << tracks << ",\"itemsPerTrack\":" << items << ",\"copiedItems\":" << copiedItems << ",\"apiCalls\":" << calls << ",\"duplicate\":";
+		statistics.WriteJson(ss);
+		ss << "}";
+	}
+
+
+	/**
+	 * Measure the duplication of regions with the given numbers of items per track.
+	 *
+	 * @param options The number of tracks, items and runs
+	 * @param ss Where to write the result as JSON
+	 */
+	void BenchmarkRegions(const Options& options, std::ostringstream& ss)
+	{
+		ss << "\"regions\":[";
+		for (std::size_t i = 0; i < options.items.size(); i++)
+		{
+			if (i > 0)
+				ss << ",";
+			BenchmarkRegion(options.tracks, options.items.at(i), options.runs, ss);
+		}
+		ss << "]";
+	}
+}
+
+
+/**
+ * Measures the bulk edits. A MIDI take with the given number of notes is transposed, quantized
+ * (with swing) and its velocities are scaled, each separately and all together. Each edit works
+ * on a buffer in the format of MIDI_GetAllEvts and is repeated the given number of times.
+ *
+ * Furthermore, a region is duplicated in a synthetic project with the given number of tracks for
+ * each of the given numbers of items per track. The region covers half of the items of each
+ * track, e.g. 32 tracks with 64 items each copy 1024 items.
+ *
+ * The heap allocations of the main thread are counted with the functions which are wrapped for
+ * the real-time watchdog, see RtWatchdog.cpp. They are only counted if the executable was linked
+ * with these wrappers, otherwise 0 is reported.
+ *
+ * Usage: dbm_edit_bench [--notes n] [--runs n] [--tracks n] [--items list]
+ *
+ * Prints the result as one JSON object.
+ */
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::ostringstream ss;
+	ss << "{";
+	BenchmarkMidi(options, ss);
+	ss << ",";
+	BenchmarkRegions(options, ss);
+	ss << "}";
+	std::cout << ss.str() << std::endl;
+	return 0;
+}
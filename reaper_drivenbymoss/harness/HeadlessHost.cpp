@@ -0,0 +1,682 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommandCapture.h"
+#include "CommandDecoder.h"
+#include "DataCollector.h"
+#include "DrivenByMossSurface.h"
+#include "FunctionExecutor.h"
+#include "JvmManagerStub.h"
+#include "MidiInputHook.h"
+#include "Model.h"
+#include "ModelSnapshot.h"
+#include "OscParser.h"
+#include "ReaDebug.h"
+#include "SyntheticProject.h"
+
+
+extern DrivenByMossSurface* surfaceInstance;
+
+
+namespace
+{
+	/** The interval of the updates of the surface in Reaper. */
+	const std::chrono::milliseconds UPDATE_INTERVAL{ 33 };
+
+	/** The number of commands which are parsed before they are executed in the benchmark. */
+	const int COMMAND_BATCH{ 256 };
+	/** The most collection passes to wait for the end of a dump. */
+	const int MAX_DUMP_PASSES{ 100000 };
+	/** The length of an audio buffer, 128 samples at 48 kHz. */
+	const std::chrono::microseconds AUDIO_BUFFER{ 2667 };
+	const int AUDIO_BUFFER_SAMPLES{ 128 };
+	const double SAMPLE_RATE{ 48000 };
+	/** The most events which are read from the simulated MIDI input in one audio buffer. */
+	const std::size_t MAX_INPUT_EVENTS{ 256 };
+	/** The number of tracks which change their volume with every update of the surface. */
+	const int COMMANDS_PER_UPDATE{ 4 };
+	/** The number of updates after the audio thread has stopped to send the remaining MIDI. */
+	const int DRAIN_UPDATES{ 10 };
+
+	/** The options of the command line. */
+	struct Options
+	{
+		std::string path;
+		double speed{ 1.0 };
+		int commands{ 0 };
+		bool verifyDump{ false };
+		int ticks{ 0 };
+		double surfaceSeconds{ 0 };
+		int midiRate{ 1000 };
+		SyntheticProject::Settings settings;
+	};
+
+	/** The measurements of the simulated audio thread. */
+	struct AudioStatistics
+	{
+		unsigned long long buffers{ 0 };
+		unsigned long long messages{ 0 };
+		unsigned long long toReaper{ 0 };
+		long long totalNanos{ 0 };
+		long long maxNanos{ 0 };
+	};
+
+	/**
+	 * The read buffer of a MIDI input with a fixed capacity, which does not allocate in the
+	 * simulated audio thread. Only short messages are supported, the position of an event is its
+	 * index.
+	 */
+	class EventList : public MIDI_eventlist
+	{
+	public:
+		void AddItem(MIDI_event_t* evt) override
+		{
+			if (evt != nullptr && this->count < this->events.size() && evt->size <= 4)
+				this->events[this->count++] = *evt;
+		}
+
+		MIDI_event_t* EnumItems(int* bpos) override
+		{
+			if (bpos == nullptr || *bpos < 0 || static_cast<std::size_t>(*bpos) >= this->count)
+				return nullptr;
+			return &this->events[(*bpos)++];
+		}
+
+		void DeleteItem(int bpos) override
+		{
+			if (bpos < 0 || static_cast<std::size_t>(bpos) >= this->count)
+				return;
+			std::copy(this->events.begin() + bpos + 1, this->events.begin() + this->count, this->events.begin() + bpos);
+			this->count--;
+		}
+
+		int GetSize() override
+		{
+			return static_cast<int>(this->count * sizeof(MIDI_event_t));
+		}
+
+		void Empty() override
+		{
+			this->count = 0;
+		}
+
+		std::size_t GetCount() const noexcept
+		{
+			return this->count;
+		}
+
+	private:
+		std::array<MIDI_event_t, MAX_INPUT_EVENTS> events{};
+		std::size_t count{ 0 };
+	};
+
+	/**
+	 * A MIDI input which is filled by the simulated audio thread.
+	 */
+	class SimulatedMidiInput : public midi_Input
+	{
+	public:
+		void start() override
+		{
+			// Intentionally empty
+		}
+
+		void stop() override
+		{
+			// Intentionally empty
+		}
+
+		void SwapBufs(unsigned int timestamp) override
+		{
+			// Intentionally empty
+		}
+
+		MIDI_eventlist* GetReadBuf() override
+		{
+			return &this->readBuffer;
+		}
+
+		EventList readBuffer;
+	};
+
+	SimulatedMidiInput midiInput;
+
+	midi_Input* GetMidiInput(int index)
+	{
+		return index == 0 ? &midiInput : nullptr;
+	}
+
+
+	/**
+	 * Encodes commands like Java does it, see CommandDecoder. The processors and commands are
+	 * defined when they are used the first time.
+	 */
+	class CommandEncoder
+	{
+	public:
+		void AddDoubleArg(const std::string& processor, const std::string& command, double value)
+		{
+			const std::uint16_t processorID = this->GetID(processor);
+			const std::uint16_t commandID = this->GetID(command);
+			this->Append(static_cast<std::uint8_t>(CommandDecoder::RecordType::DOUBLE_ARG));
+			this->Append(processorID);
+			this->Append(commandID);
+			this->Append(value);
+		}
+
+		const std::vector<std::uint8_t>& GetData() const noexcept
+		{
+			return this->data;
+		}
+
+		void Clear() noexcept
+		{
+			this->data.clear();
+		}
+
+	private:
+		std::vector<std::uint8_t> data;
+		std::vector<std::string> strings;
+
+		template<typename T>
+		void Append(T value)
+		{
+			const std::size_t position = this->data.size();
+			this->data.resize(position + sizeof(T));
+			std::memcpy(&this->data[position], &value, sizeof(T));
+		}
+
+		std::uint16_t GetID(const std::string& text)
+		{
+			const auto it = std::find(this->strings.begin(), this->strings.end(), text);
+			if (it != this->strings.end())
+				return static_cast<std::uint16_t>(it - this->strings.begin());
+			const std::uint16_t id = static_cast<std::uint16_t>(this->strings.size());
+			this->strings.push_back(text);
+			this->Append(static_cast<std::uint8_t>(CommandDecoder::RecordType::DEFINE));
+			this->Append(id);
+			this->Append(static_cast<std::uint16_t>(text.size()));
+			this->data.insert(this->data.end(), text.begin(), text.end());
+			return id;
+		}
+	};
+
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: dbm_headless_host (capture-file [--speed factor] | --commands n | --verify-dump [--ticks n] | --surface seconds [--midi rate]) [--tracks n] [--sends n] [--devices n] [--params n] [--items n] [--notes n] [--markers n]\n";
+	}
+
+	bool ParseArguments(int argc, char* argv[], Options& options)
+	{
+		SyntheticProject::Settings& settings = options.settings;
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument{ argv[i] };
+			if (argument.compare(0, 2, "--") != 0)
+			{
+				options.path = argument;
+				continue;
+			}
+			if (argument == "--verify-dump")
+			{
+				options.verifyDump = true;
+				continue;
+			}
+			if (i + 1 >= argc)
+				return false;
+			const char* value = argv[++i];
+			if (argument == "--speed")
+				options.speed = std::atof(value);
+			else if (argument == "--commands")
+				options.commands = std::atoi(value);
+			else if (argument == "--ticks")
+				options.ticks = std::atoi(value);
+			else if (argument == "--surface")
+				options.surfaceSeconds = std::atof(value);
+			else if (argument == "--midi")
+				options.midiRate = std::atoi(value);
+			else if (argument == "--tracks")
+				settings.tracks = std::atoi(value);
+			else if (argument == "--sends")
+				settings.sendsPerTrack = std::atoi(value);
+			else if (argument == "--devices")
+				settings.devicesPerTrack = std::atoi(value);
+			else if (argument == "--params")
+				settings.parametersPerDevice = std::atoi(value);
+			else if (argument == "--items")
+				settings.itemsPerTrack = std::atoi(value);
+			else if (argument == "--notes")
+				settings.notesPerItem = std::atoi(value);
+			else if (argument == "--markers")
+				settings.markers = std::atoi(value);
+			else
+				return false;
+		}
+		return (!options.path.empty() || options.commands > 0 || options.verifyDump || options.surfaceSeconds > 0) && options.speed > 0 && options.midiRate >= 0 && options.ticks >= 0;
+	}
+
+
+	/**
+	 * Simulates the audio thread of Reaper. For each audio buffer the MIDI messages which are due
+	 * are written to the read buffer of the simulated MIDI input and the audio hook is called,
+	 * which queues them for Java and applies the note input filters. The messages alternate
+	 * between note-on and note-off of the pads of a controller. The aftertouch messages in
+	 * between do not match the note input and are therefore removed from the input.
+	 *
+	 * @param surface The surface
+	 * @param midiInputHook The audio hook part which handles the MIDI inputs
+	 * @param midiRate The number of messages per second
+	 * @param isRunning The thread stops when this is set to false
+	 * @param statistics Where to store the measurements
+	 */
+	void RunAudioThread(DrivenByMossSurface& surface, MidiInputHook& midiInputHook, int midiRate, const std::atomic<bool>& isRunning, AudioStatistics& statistics)
+	{
+		const double messagesPerBuffer = midiRate * std::chrono::duration<double>(AUDIO_BUFFER).count();
+		double dueMessages{ 0 };
+		EventList& readBuffer = midiInput.readBuffer;
+		std::chrono::steady_clock::time_point nextBuffer = std::chrono::steady_clock::now();
+		while (isRunning.load())
+		{
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			readBuffer.Empty();
+			dueMessages += messagesPerBuffer;
+			for (; dueMessages >= 1; dueMessages--)
+			{
+				const unsigned long long message = statistics.messages++;
+				MIDI_event_t event{};
+				event.size = 3;
+				if (message % 4 == 3)
+				{
+					event.midi_message[0] = 0xA0;
+					event.midi_message[1] = static_cast<unsigned char>(36 + (message / 4) % 64);
+					event.midi_message[2] = 64;
+				}
+				else
+				{
+					event.midi_message[0] = 0x90;
+					event.midi_message[1] = static_cast<unsigned char>(36 + (message / 2) % 64);
+					event.midi_message[2] = message % 2 == 0 ? 127 : 0;
+				}
+				readBuffer.AddItem(&event);
+			}
+			midiInputHook.OnAudioBuffer(surface, AUDIO_BUFFER_SAMPLES, SAMPLE_RATE);
+			statistics.toReaper += readBuffer.GetCount();
+			const long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			statistics.totalNanos += nanos;
+			statistics.maxNanos = std::max(statistics.maxNanos, nanos);
+			statistics.buffers++;
+
+			nextBuffer += AUDIO_BUFFER;
+			std::this_thread::sleep_until(nextBuffer);
+		}
+	}
+
+
+	/**
+	 * Run the surface with the stub of the JVM for the given time. The main thread sends a batch of
+	 * encoded commands and calls Run of the surface on every update. The simulated audio thread
+	 * calls the audio hook which reads the incoming MIDI, the sender thread hands it to the stub
+	 * which echoes it to the outputs.
+	 *
+	 * @param options The options with the duration and the MIDI rate
+	 * @param project The project
+	 * @param ss Where to write the result as JSON
+	 */
+	void RunSurface(const Options& options, SyntheticProject& project, std::ostringstream& ss)
+	{
+		std::unique_ptr<JvmManager> jvmManager = std::make_unique<JvmManager>(false);
+		jvmManager->InitAsync(nullptr);
+		std::unique_ptr<DrivenByMossSurface> surface = std::make_unique<DrivenByMossSurface>(jvmManager, &JvmManagerStub::GetMidiOutput);
+		surfaceInstance = surface.get();
+
+		// Java enables the tracing and requests a dump on startup
+		surface->GetOscParser().Process("refresh", "midiTracing", 1);
+		surface->GetOscParser().Process("refresh", "");
+
+		// Java opens the MIDI input of the controller and creates a note input for the pads
+		MidiInputHook midiInputHook;
+		midiInputHook.SetMidiInputFunction(&GetMidiInput);
+		midiInputHook.OpenInput(0);
+		midiInputHook.SetFilters(0, 0, { { 0x90 }, { 0x80 } });
+
+		std::atomic<bool> isAudioRunning{ true };
+		AudioStatistics audio;
+		std::thread audioThread(RunAudioThread, std::ref(*surface), std::ref(midiInputHook), options.midiRate, std::cref(isAudioRunning), std::ref(audio));
+
+		CommandDecoder decoder;
+		CommandEncoder encoder;
+		const int tracks = std::max(1, options.settings.tracks);
+
+		unsigned long long updates{ 0 };
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const std::chrono::steady_clock::time_point end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.surfaceSeconds));
+		std::chrono::steady_clock::time_point nextUpdate = start;
+		for (int drain = 0; drain < DRAIN_UPDATES; updates++)
+		{
+			encoder.Clear();
+			for (int i = 0; i < COMMANDS_PER_UPDATE; i++)
+			{
+				const int track = static_cast<int>((updates * COMMANDS_PER_UPDATE + i) % tracks);
+				encoder.AddDoubleArg("track", std::to_string(track) + "/volume", (updates % 100) / 100.0);
+			}
+			surface->ProcessCommands(decoder, encoder.GetData().data(), encoder.GetData().size());
+
+			project.Tick();
+			surface->Run();
+
+			if (std::chrono::steady_clock::now() >= end)
+			{
+				// Stop the audio thread and let the remaining messages pass
+				if (audioThread.joinable())
+				{
+					isAudioRunning.store(false);
+					audioThread.join();
+				}
+				drain++;
+			}
+			nextUpdate += UPDATE_INTERVAL;
+			std::this_thread::sleep_until(nextUpdate);
+		}
+		const long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		const JvmManagerStub::Counts java = JvmManagerStub::GetCounts();
+		ss << "{\"surface\":{\"millis\":" << millis << ",\"updates\":" << updates
+			<< ",\"commands\":" << decoder.GetDecodedCommands()
+			<< ",\"audio\":{\"buffers\":" << audio.buffers << ",\"messages\":" << audio.messages << ",\"toReaper\":" << audio.toReaper
+			<< ",\"averageNanos\":" << (audio.buffers > 0 ? audio.totalNanos / static_cast<long long>(audio.buffers) : 0) << ",\"maxNanos\":" << audio.maxNanos << "}"
+			<< ",\"java\":{\"midiEvents\":" << java.midiEvents << ",\"updates\":" << java.updates << ",\"updateBytes\":" << java.updateBytes << "}"
+			<< ",\"midiToOutputs\":" << JvmManagerStub::GetSentToOutputs() << ",\"statistics\":" << surface->GetStatistics(false) << "}";
+
+		surface->Shutdown();
+		surface.reset();
+	}
+
+
+	/**
+	 * Request a dump and collect until it has finished, which might take several passes.
+	 *
+	 * @param dataCollector The collector
+	 * @param model The model
+	 * @param actionProcessor The processor of the actions
+	 * @return The collected data of all passes
+	 */
+	std::string CollectDump(DataCollector& dataCollector, Model& model, ActionProcessor& actionProcessor)
+	{
+		model.SetDump();
+		std::string data;
+		for (int i = 0; i < MAX_DUMP_PASSES; i++)
+		{
+			const std::string pass = dataCollector.CollectData(model.ShouldDump(), actionProcessor);
+			data.append(pass);
+			if (pass.find("/dump/end ") != std::string::npos)
+				break;
+		}
+		return data;
+	}
+
+
+	/**
+	 * Check that a dump which is created from the snapshot of the sent data is the same as a dump
+	 * which is collected from Reaper. Between the first dump and the compared ones, the project
+	 * plays for the given number of update passes in which some values are changed, which fills
+	 * the journal of the snapshot. The project is not changed between the compared dumps.
+	 *
+	 * @param project The project
+	 * @param dataCollector The collector
+	 * @param model The model
+	 * @param actionProcessor The processor of the actions
+	 * @param ticks The number of update passes between the dumps
+	 * @param ss Where to write the result as JSON
+	 * @return The number of addresses which are different
+	 */
+	std::size_t VerifyDump(SyntheticProject& project, DataCollector& dataCollector, Model& model, ActionProcessor& actionProcessor, int ticks, std::ostringstream& ss)
+	{
+		// The first dump is always collected from Reaper and fills the snapshot
+		CollectDump(dataCollector, model, actionProcessor);
+
+		std::size_t updateBytes{ 0 };
+		project.playState = ticks > 0 ? 1 : 0;
+		for (int i = 0; i < ticks; i++)
+		{
+			project.Tick();
+			project.ChangeValues(8);
+			updateBytes += dataCollector.CollectData(model.ShouldDump(), actionProcessor).size();
+		}
+
+		ModelSnapshot fromSnapshot;
+		fromSnapshot.Update(CollectDump(dataCollector, model, actionProcessor));
+		dataCollector.EnableDumpFromSnapshot(false);
+		ModelSnapshot fromReaper;
+		fromReaper.Update(CollectDump(dataCollector, model, actionProcessor));
+		dataCollector.EnableDumpFromSnapshot(true);
+
+		const std::string expected = fromReaper.Serialize();
+		std::string firstDifference;
+		const std::size_t differences = fromSnapshot.Compare(expected, firstDifference);
+		ss << "{\"verifyDump\":{\"bytes\":" << expected.size() << ",\"updateBytes\":" << updateBytes << ",\"differences\":" << differences << ",\"firstDifference\":\"" << firstDifference << "\"}";
+		return differences;
+	}
+
+
+	/**
+	 * Send the given number of commands, a mix of the ones which a controller sends most often,
+	 * through the parser and execute them. The commands are executed in batches like the
+	 * surface does it on every update.
+	 *
+	 * @param oscParser The parser
+	 * @param functionExecutor The executor of the parsed commands
+	 * @param model The model
+	 * @param tracks The number of tracks of the project
+	 * @param count The number of commands
+	 * @param ss Where to write the result as JSON
+	 */
+	void BenchmarkCommands(OscParser& oscParser, FunctionExecutor& functionExecutor, Model& model, int tracks, int count, std::ostringstream& ss)
+	{
+		const int targets = tracks > 0 ? tracks : 1;
+		std::string commands[6];
+		long long parseNanos{ 0 };
+		long long executeNanos{ 0 };
+		for (int i = 0; i < count; i += COMMAND_BATCH)
+		{
+			const std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
+			const int end = std::min(count, i + COMMAND_BATCH);
+			for (int c = i; c < end; c++)
+			{
+				const std::string track = std::to_string(c % targets);
+				const double value = (c % 100) / 100.0;
+				switch (c % 8)
+				{
+				case 0:
+					oscParser.Process("track", track + "/volume", value);
+					break;
+				case 1:
+					oscParser.Process("track", track + "/pan", value);
+					break;
+				case 2:
+					oscParser.Process("track", track + "/send/0/volume", value);
+					break;
+				case 3:
+					oscParser.Process("track", track + "/mute", c % 2);
+					break;
+				case 4:
+					oscParser.Process("device", "param/" + std::to_string(c % 8) + "/value", value);
+					break;
+				case 5:
+					oscParser.Process("master", "volume", value);
+					break;
+				case 6:
+					oscParser.Process("track", track + "/select", 1);
+					break;
+				default:
+					oscParser.Process("groove", "amount", value);
+					break;
+				}
+			}
+			const std::chrono::steady_clock::time_point executeStart = std::chrono::steady_clock::now();
+			functionExecutor.ExecuteFunctions(model.GetUndoBatch(), 0);
+			const std::chrono::steady_clock::time_point executeEnd = std::chrono::steady_clock::now();
+			parseNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(executeStart - parseStart).count();
+			executeNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(executeEnd - executeStart).count();
+		}
+
+		const long long totalNanos = parseNanos + executeNanos;
+		ss << "{\"commands\":{\"count\":" << count << ",\"parseNanos\":" << parseNanos << ",\"executeNanos\":" << executeNanos
+			<< ",\"perSecond\":" << (totalNanos > 0 ? static_cast<long long>(count * 1e9 / totalNanos) : 0) << ",\"coalesced\":" << oscParser.GetCoalescedCommands() << "}";
+	}
+}
+
+
+/**
+ * Plays back a capture, which was recorded with the capture processor, against a synthetic project
+ * without Reaper and Java. The commands are decoded, parsed and executed on the main thread and
+ * the data is collected like the surface does it every 2nd update. The collected data is discarded.
+ * The incoming MIDI of the capture is only counted since there is no Java side which handles it
+ * and the audio hook is not simulated.
+ *
+ * With --commands the given number of generated commands is parsed and executed as fast as
+ * possible instead, which measures the throughput of the command dispatch.
+ *
+ * With --verify-dump a dump is created from the snapshot of the sent data and compared with a
+ * dump which is collected from Reaper. Exits with 2 if they are different. With --ticks the
+ * project plays and changes for the given number of update passes before.
+ *
+ * With --surface the surface itself runs for the given number of seconds with a stub of the JVM,
+ * see JvmManagerStub. The commands are sent as encoded batches. A simulated audio thread calls
+ * the MIDI input handling of the audio hook, see MidiInputHook, with the given rate of incoming
+ * MIDI messages per second on a simulated MIDI input. The real-time watchdog checks these calls.
+ * Only the plugin entry point and the JNI registration in dllmain.cpp are not simulated.
+ *
+ * Usage: dbm_headless_host (capture-file [--speed factor] | --commands n | --verify-dump
+ *        [--ticks n] | --surface seconds [--midi rate]) [--tracks n] [--sends n] [--devices n]
+ *        [--params n] [--items n] [--notes n] [--markers n]
+ *
+ * Prints the statistics as JSON when the playback has finished.
+ */
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	SyntheticProject project(options.settings);
+	project.Install();
+
+	FunctionExecutor functionExecutor;
+	Model model(functionExecutor);
+	ReaDebug::setModel(&model);
+	OscParser oscParser(model);
+	DataCollector dataCollector(model);
+	CommandDecoder decoder;
+
+	if (options.surfaceSeconds > 0)
+	{
+		std::ostringstream ss;
+		RunSurface(options, project, ss);
+		ss << ",\"apiCalls\":" << project.GetCalls() << "}";
+		std::cout << ss.str() << std::endl;
+		ReaDebug::setModel(nullptr);
+		return 0;
+	}
+
+	if (options.verifyDump)
+	{
+		std::ostringstream ss;
+		const std::size_t differences = VerifyDump(project, dataCollector, model, oscParser.GetActionProcessor(), options.ticks, ss);
+		ss << ",\"apiCalls\":" << project.GetCalls() << "}";
+		std::cout << ss.str() << std::endl;
+		ReaDebug::setModel(nullptr);
+		return differences == 0 ? 0 : 2;
+	}
+
+	if (options.path.empty())
+	{
+		std::ostringstream ss;
+		BenchmarkCommands(oscParser, functionExecutor, model, options.settings.tracks, options.commands, ss);
+		ss << ",\"apiCalls\":" << project.GetCalls() << "}";
+		std::cout << ss.str() << std::endl;
+		ReaDebug::setModel(nullptr);
+		return 0;
+	}
+
+	CommandCapture& capture = model.GetCommandCapture();
+	if (!capture.StartReplay(options.path, options.speed))
+	{
+		std::cerr << "Could not read capture: " << options.path << "\n";
+		return 1;
+	}
+
+	// Java requests a dump on startup
+	model.SetDump();
+
+	unsigned long long updates{ 0 };
+	unsigned long long midiInputs{ 0 };
+	bool finished{ false };
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point nextUpdate = start;
+	while (!finished)
+	{
+		finished = capture.Replay([&decoder, &oscParser, &midiInputs](const CommandCapture::Frame& frame)
+			{
+				if (frame.type == CommandCapture::FrameType::COMMANDS)
+					decoder.Decode(frame.data.data(), frame.data.size(), oscParser);
+				else if (frame.type == CommandCapture::FrameType::MIDI_INPUT)
+					midiInputs++;
+			});
+		functionExecutor.ExecuteFunctions(model.GetUndoBatch(), finished ? 0 : model.executionBudget);
+		project.Tick();
+
+		// The surface only collects on every 2nd update
+		if (updates % 2 == 0 || finished)
+			dataCollector.CollectData(model.ShouldDump(), oscParser.GetActionProcessor());
+		updates++;
+
+		nextUpdate += UPDATE_INTERVAL;
+		std::this_thread::sleep_until(nextUpdate);
+	}
+	const long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::ostringstream ss;
+	ss << "{\"capture\":{\"millis\":" << millis << ",\"updates\":" << updates << ",\"commands\":" << decoder.GetDecodedCommands()
+		<< ",\"midiInputs\":" << midiInputs << ",\"apiCalls\":" << project.GetCalls() << "}";
+
+	const DataCollector::Statistics collect = dataCollector.GetStatistics(false);
+	ss << ",\"collect\":{\"delta\":";
+	collect.delta.WriteJson(ss);
+	ss << ",\"dump\":";
+	collect.dump.WriteJson(ss);
+	ss << ",\"bytes\":" << collect.bytes << ",\"maxBytes\":" << collect.maxBytes << ",\"stages\":{";
+	for (std::size_t i = 0; i < DataCollector::STAGE_COUNT; i++)
+	{
+		ss << (i == 0 ? "\"" : ",\"") << DataCollector::GetStageName(i) << "\":";
+		collect.stages[i].WriteJson(ss);
+	}
+	ss << "}}";
+
+	const FunctionExecutor::Statistics executor = functionExecutor.GetStatistics(false);
+	ss << ",\"executor\":{\"maxDepth\":" << executor.maxDepth << ",\"maxWaitMicros\":" << executor.maxWaitMicros << ",\"executed\":" << executor.executed
+		<< ",\"overflowed\":" << executor.overflowed << ",\"deferred\":" << executor.deferred << ",\"coalesced\":" << oscParser.GetCoalescedCommands() << "}";
+
+	UndoBatch& undoBatch = model.GetUndoBatch();
+	ss << ",\"undo\":{\"batches\":" << undoBatch.GetBatchCount() << ",\"changes\":" << undoBatch.GetChangeCount() << "}}";
+	std::cout << ss.str() << std::endl;
+
+	ReaDebug::setModel(nullptr);
+	return 0;
+}
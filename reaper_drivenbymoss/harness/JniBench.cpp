@@ -0,0 +1,392 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "JavaSender.h"
+#include "JvmManager.h"
+#include "JvmManagerStub.h"
+#include "Profiler.h"
+#include "ThreadEnv.h"
+
+
+namespace
+{
+	/** The longest time to wait for the sender thread to hand over an update. */
+	const std::chrono::seconds MAX_DELIVERY_WAIT{ 5 };
+
+	/** The options of the command line. */
+	struct Options
+	{
+		int iterations{ 1000000 };
+		int threads{ 100 };
+		int updates{ 1000 };
+	};
+
+	/** The measurements of a timed loop. */
+	struct LoopStatistics
+	{
+		long long count{ 0 };
+		long long totalNanos{ 0 };
+		long long maxNanos{ 0 };
+
+		void WriteJson(std::ostringstream& ss) const
+		{
+			const double divisor = this->count > 0 ? static_cast<double>(this->count) : 1.0;
+			ss << "{\"count\":" << this->count << ",\"totalNanos\":" << this->totalNanos << ",\"avgNanos\":" << static_cast<double>(this->totalNanos) / divisor;
+			if (this->maxNanos > 0)
+				ss << ",\"maxNanos\":" << this->maxNanos;
+			ss << "}";
+		}
+	};
+
+	// Keeps the compiler from removing the timed loops
+	std::atomic<std::uintptr_t> sink{ 0 };
+
+	long long NanosSince(const std::chrono::steady_clock::time_point& start) noexcept
+	{
+		return static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	/**
+	 * A JVM which only implements the invocation interface. A thread is detached until it calls
+	 * one of the attach functions, the environment is a dummy which must not be used.
+	 */
+	class FakeJvm
+	{
+	public:
+		std::atomic<unsigned long long> getEnvCalls{ 0 };
+		std::atomic<unsigned long long> attaches{ 0 };
+		std::atomic<unsigned long long> detaches{ 0 };
+
+		FakeJvm() noexcept
+		{
+			this->functions.DestroyJavaVM = &FakeJvm::DestroyJavaVM;
+			this->functions.AttachCurrentThread = &FakeJvm::AttachCurrentThread;
+			this->functions.DetachCurrentThread = &FakeJvm::DetachCurrentThread;
+			this->functions.GetEnv = &FakeJvm::GetEnv;
+			this->functions.AttachCurrentThreadAsDaemon = &FakeJvm::AttachCurrentThread;
+			this->vm.functions = &this->functions;
+			instance = this;
+		}
+
+		FakeJvm(const FakeJvm&) = delete;
+		FakeJvm& operator=(const FakeJvm&) = delete;
+		FakeJvm(FakeJvm&&) = delete;
+		FakeJvm& operator=(FakeJvm&&) = delete;
+		~FakeJvm()
+		{
+			instance = nullptr;
+		}
+
+		JavaVM* Get() noexcept
+		{
+			return &this->vm;
+		}
+
+	private:
+		static FakeJvm* instance;
+		static thread_local bool isAttached;
+		static int dummyEnv;
+
+		JNIInvokeInterface_ functions{};
+		JavaVM vm{};
+
+		static jint JNICALL DestroyJavaVM(JavaVM* jvm)
+		{
+			return JNI_OK;
+		}
+
+		static jint JNICALL AttachCurrentThread(JavaVM* jvm, void** penv, void* args)
+		{
+			if (!isAttached)
+			{
+				isAttached = true;
+				instance->attaches.fetch_add(1, std::memory_order_relaxed);
+			}
+			*penv = &dummyEnv;
+			return JNI_OK;
+		}
+
+		static jint JNICALL DetachCurrentThread(JavaVM* jvm)
+		{
+			isAttached = false;
+			instance->detaches.fetch_add(1, std::memory_order_relaxed);
+			return JNI_OK;
+		}
+
+		static jint JNICALL GetEnv(JavaVM* jvm, void** penv, jint version)
+		{
+			instance->getEnvCalls.fetch_add(1, std::memory_order_relaxed);
+			if (!isAttached)
+			{
+				*penv = nullptr;
+				return JNI_EDETACHED;
+			}
+			*penv = &dummyEnv;
+			return JNI_OK;
+		}
+	};
+
+	FakeJvm* FakeJvm::instance{ nullptr };
+	thread_local bool FakeJvm::isAttached{ false };
+	int FakeJvm::dummyEnv{ 0 };
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: dbm_jni_bench [--iterations n] [--threads n] [--updates n]\n";
+	}
+
+	bool ParseArguments(int argc, char* argv[], Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument{ argv[i] };
+			if (i + 1 >= argc)
+				return false;
+			const int value = std::max(1, std::atoi(argv[++i]));
+			if (argument == "--iterations")
+				options.iterations = value;
+			else if (argument == "--threads")
+				options.threads = value;
+			else if (argument == "--updates")
+				options.updates = value;
+			else
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Time a loop over GetEnv of the JVM, which is what every call into Java did before the
+	 * environment was cached, and a loop over the cached environment.
+	 *
+	 * @param jvm The JVM, the current thread must be attached
+	 * @param iterations The number of calls
+	 * @param ss Where to write the result
+	 */
+	void BenchmarkGetEnv(JavaVM* jvm, int iterations, std::ostringstream& ss)
+	{
+		LoopStatistics raw;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+		{
+			JNIEnv* env = nullptr;
+			DISABLE_WARNING_REINTERPRET_CAST
+			jvm->GetEnv(reinterpret_cast<void**>(&env), CURRENT_JNI_VERSION);
+			sink.fetch_add(reinterpret_cast<std::uintptr_t>(env), std::memory_order_relaxed);
+		}
+		raw.count = iterations;
+		raw.totalNanos = NanosSince(start);
+
+		LoopStatistics cached;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+		{
+			DISABLE_WARNING_REINTERPRET_CAST
+			sink.fetch_add(reinterpret_cast<std::uintptr_t>(ThreadEnv::Get(jvm)), std::memory_order_relaxed);
+		}
+		cached.count = iterations;
+		cached.totalNanos = NanosSince(start);
+
+		ss << "\"getEnv\":";
+		raw.WriteJson(ss);
+		ss << ",\"threadEnv\":";
+		cached.WriteJson(ss);
+	}
+
+	/**
+	 * Time the first call of a new thread which attaches it, the following cached calls and the
+	 * detach at its end.
+	 *
+	 * @param jvm The JVM
+	 * @param threads The number of threads to start one after the other
+	 * @param ss Where to write the result
+	 */
+	void BenchmarkAttach(JavaVM* jvm, int threads, std::ostringstream& ss)
+	{
+		LoopStatistics attach;
+		LoopStatistics detach;
+		bool isCached = true;
+		for (int i = 0; i < threads; i++)
+		{
+			std::thread thread([&]()
+				{
+					auto start = std::chrono::steady_clock::now();
+					JNIEnv* env = ThreadEnv::Get(jvm);
+					const long long attachNanos = NanosSince(start);
+					attach.count++;
+					attach.totalNanos += attachNanos;
+					attach.maxNanos = std::max(attach.maxNanos, attachNanos);
+					if (env == nullptr || ThreadEnv::Get(jvm) != env)
+						isCached = false;
+
+					start = std::chrono::steady_clock::now();
+					ThreadEnv::Detach(jvm);
+					const long long detachNanos = NanosSince(start);
+					detach.count++;
+					detach.totalNanos += detachNanos;
+					detach.maxNanos = std::max(detach.maxNanos, detachNanos);
+				});
+			thread.join();
+		}
+
+		ss << "\"attach\":";
+		attach.WriteJson(ss);
+		ss << ",\"detach\":";
+		detach.WriteJson(ss);
+		ss << ",\"isCached\":" << (isCached ? "true" : "false");
+	}
+
+	/**
+	 * Time the hand over of model updates from the main thread through the sender thread to the
+	 * JVM manager, which only counts them, see JvmManagerStub.
+	 *
+	 * @param updates The number of updates, each one is awaited before the next is queued
+	 * @param ss Where to write the result
+	 */
+	void BenchmarkSender(int updates, std::ostringstream& ss)
+	{
+		std::unique_ptr<JvmManager> jvmManager = std::make_unique<JvmManager>(false);
+		jvmManager->InitAsync(nullptr);
+		Profiler profiler;
+		JavaSender sender(jvmManager, profiler);
+		sender.Start();
+
+		LoopStatistics delivery;
+		int timeouts = 0;
+		for (int i = 0; i < updates; i++)
+		{
+			const unsigned long long before = JvmManagerStub::GetCounts().updates;
+			const auto start = std::chrono::steady_clock::now();
+			sender.QueueUpdate("/track/1/volume " + std::to_string(i % 128) + "\n");
+			sender.Flush();
+			while (JvmManagerStub::GetCounts().updates == before)
+			{
+				if (std::chrono::steady_clock::now() - start > MAX_DELIVERY_WAIT)
+				{
+					timeouts++;
+					break;
+				}
+				std::this_thread::yield();
+			}
+			const long long nanos = NanosSince(start);
+			delivery.count++;
+			delivery.totalNanos += nanos;
+			delivery.maxNanos = std::max(delivery.maxNanos, nanos);
+		}
+		sender.Stop();
+
+		ss << "\"sender\":";
+		delivery.WriteJson(ss);
+		ss << ",\"senderTimeouts\":" << timeouts;
+	}
+
+#ifdef DBM_JNI_BENCH_JVM
+	/**
+	 * Time GetEnv and a static call into Java on a real JVM. Only built if the JDK was found, see
+	 * CMakeLists.txt.
+	 *
+	 * @param iterations The number of calls
+	 * @param ss Where to write the result
+	 */
+	void BenchmarkJvm(int iterations, std::ostringstream& ss)
+	{
+		JavaVMInitArgs args{};
+		args.version = CURRENT_JNI_VERSION;
+		args.nOptions = 0;
+		args.options = nullptr;
+		args.ignoreUnrecognized = JNI_TRUE;
+
+		JavaVM* jvm = nullptr;
+		JNIEnv* env = nullptr;
+		auto start = std::chrono::steady_clock::now();
+		DISABLE_WARNING_REINTERPRET_CAST
+		if (JNI_CreateJavaVM(&jvm, reinterpret_cast<void**>(&env), &args) != JNI_OK || jvm == nullptr)
+		{
+			ss << "\"jvm\":null";
+			return;
+		}
+		const long long createNanos = NanosSince(start);
+		ThreadEnv::SetAttached(jvm, env);
+
+		ss << "\"jvm\":{\"createNanos\":" << createNanos << ",";
+		BenchmarkGetEnv(jvm, iterations, ss);
+
+		const jclass systemClass = env->FindClass("java/lang/System");
+		const jmethodID nanoTime = systemClass == nullptr ? nullptr : env->GetStaticMethodID(systemClass, "nanoTime", "()J");
+		if (nanoTime != nullptr)
+		{
+			LoopStatistics call;
+			start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; i++)
+			{
+				JNIEnv* callEnv = ThreadEnv::Get(jvm);
+				sink.fetch_add(static_cast<std::uintptr_t>(callEnv->CallStaticLongMethod(systemClass, nanoTime)), std::memory_order_relaxed);
+			}
+			call.count = iterations;
+			call.totalNanos = NanosSince(start);
+			ss << ",\"staticCall\":";
+			call.WriteJson(ss);
+		}
+		ss << ",";
+		BenchmarkAttach(jvm, 10, ss);
+		ss << "}";
+
+		// The main thread was attached by creating the JVM, only forget its environment
+		ThreadEnv::Detach(nullptr);
+		jvm->DestroyJavaVM();
+	}
+#endif
+}
+
+
+/**
+ * Measures the cost of getting the JNI environment of a thread and of handing data to the thread
+ * which calls Java. Without a JDK the JVM is faked, only the invocation interface is implemented.
+ * The result is written as JSON.
+ */
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::ostringstream ss;
+	ss << "{\"fake\":{";
+	{
+		FakeJvm fakeJvm;
+		JavaVM* jvm = fakeJvm.Get();
+		JNIEnv* env = ThreadEnv::Get(jvm);
+		if (env == nullptr)
+		{
+			std::cerr << "Could not attach to the fake JVM.\n";
+			return 1;
+		}
+		BenchmarkGetEnv(jvm, options.iterations, ss);
+		ss << ",";
+		BenchmarkAttach(jvm, options.threads, ss);
+		ThreadEnv::Detach(jvm);
+		ss << ",\"getEnvCalls\":" << fakeJvm.getEnvCalls.load() << ",\"attaches\":" << fakeJvm.attaches.load() << ",\"detaches\":" << fakeJvm.detaches.load() << "}";
+	}
+	ss << ",";
+	BenchmarkSender(options.updates, ss);
+#ifdef DBM_JNI_BENCH_JVM
+	ss << ",";
+	BenchmarkJvm(options.iterations, ss);
+#endif
+	ss << "}";
+	std::cout << ss.str() << std::endl;
+	return 0;
+}
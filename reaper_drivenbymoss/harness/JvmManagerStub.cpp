@@ -0,0 +1,172 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#include "DrivenByMossSurface.h"
+#include "JvmManager.h"
+#include "JvmManagerStub.h"
+
+
+extern DrivenByMossSurface* surfaceInstance;
+
+
+namespace
+{
+	// Written by the sender thread, read by the main thread
+	std::atomic<unsigned long long> midiEvents{ 0 };
+	std::atomic<unsigned long long> updates{ 0 };
+	std::atomic<unsigned long long> updateBytes{ 0 };
+	// Only written from the main thread
+	std::atomic<unsigned long long> sentToOutputs{ 0 };
+
+	/**
+	 * A MIDI output which only counts the sent messages.
+	 */
+	class CountingMidiOutput : public midi_Output
+	{
+	public:
+		void SendMsg(MIDI_event_t* msg, int frame_offset) override
+		{
+			sentToOutputs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Send(unsigned char status, unsigned char d1, unsigned char d2, int frame_offset) override
+		{
+			sentToOutputs.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	CountingMidiOutput midiOutput;
+}
+
+
+/**
+ * Get the numbers of the calls which would have gone to Java.
+ *
+ * @return The numbers
+ */
+JvmManagerStub::Counts JvmManagerStub::GetCounts() noexcept
+{
+	Counts counts;
+	counts.midiEvents = midiEvents.load();
+	counts.updates = updates.load();
+	counts.updateBytes = updateBytes.load();
+	return counts;
+}
+
+
+/**
+ * Get the MIDI output of a device. All devices share one output which counts the messages.
+ *
+ * @param index The index of the device
+ * @return The output
+ */
+midi_Output* JvmManagerStub::GetMidiOutput(int index)
+{
+	return &midiOutput;
+}
+
+
+/**
+ * Get the number of messages which were sent to the MIDI outputs.
+ *
+ * @return The number of messages
+ */
+unsigned long long JvmManagerStub::GetSentToOutputs() noexcept
+{
+	return sentToOutputs.load();
+}
+
+
+JvmManager::JvmManager(bool enableDebug) : jvm(nullptr), jvmLibHandle(nullptr)
+{
+	this->debug = enableDebug;
+	for (std::atomic<long long>& nanos : this->startupNanos)
+		nanos.store(-1);
+}
+
+
+JvmManager::~JvmManager()
+{
+	// Intentionally empty
+}
+
+
+DISABLE_WARNING_ARRAY_POINTER_DECAY
+void JvmManager::InitAsync(void* functions[])
+{
+	this->isInitialised = true;
+	this->isRunning.store(true);
+}
+
+
+void JvmManager::ShutdownControllers()
+{
+	this->isCleanShutdown = true;
+}
+
+
+void JvmManager::StartInfrastructure()
+{
+	// Intentionally empty
+}
+
+
+void JvmManager::WriteStartupJson(std::ostringstream& ss) const
+{
+	ss << "{}";
+}
+
+
+/**
+ * Count the update, there is no model on the Java side.
+ *
+ * @param data The changed values
+ */
+void JvmManager::UpdateModel(const std::string& data)
+{
+	updates.fetch_add(1, std::memory_order_relaxed);
+	updateBytes.fetch_add(data.size(), std::memory_order_relaxed);
+}
+
+
+/**
+ * Echo a message to the outputs of the same device, like Java does it in the callback of the
+ * surface.
+ *
+ * @param deviceID The ID of the device which received the message
+ * @param message The bytes of the message
+ * @param size The number of bytes
+ */
+void JvmManager::OnMIDIEvent(int deviceID, unsigned char* message, int size)
+{
+	midiEvents.fetch_add(1, std::memory_order_relaxed);
+	if (surfaceInstance == nullptr || size <= 0 || size > 3)
+		return;
+
+	DISABLE_WARNING_NO_POINTER_ARITHMETIC
+	std::unique_ptr<Midi3> m = std::make_unique<Midi3>();
+	m->deviceId = static_cast<uint32_t>(deviceID);
+	m->status = message[0];
+	m->data1 = size > 1 ? message[1] : 0;
+	m->data2 = size > 2 ? message[2] : 0;
+	surfaceInstance->GetProfiler().TraceOutgoing(*m);
+	surfaceInstance->outgoingMidiQueue3.push(std::move(m));
+}
+
+
+void JvmManager::DetachCurrentThread()
+{
+	// Intentionally empty
+}
+
+
+JvmManager::LocalFrame::LocalFrame(JvmManager& jvmManager, jint capacity) : env(nullptr)
+{
+	// Intentionally empty
+}
+
+
+JvmManager::LocalFrame::~LocalFrame()
+{
+	// Intentionally empty
+}
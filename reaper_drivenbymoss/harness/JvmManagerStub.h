@@ -0,0 +1,32 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_JVMMANAGERSTUB_H_
+#define _DBM_JVMMANAGERSTUB_H_
+
+#include "WrapperReaperFunctions.h"
+
+
+/**
+ * Replaces the JVM in the headless host. JvmManagerStub.cpp implements the members of JvmManager
+ * which are used by the surface and the sender thread. The JVM is running as soon as InitAsync
+ * is called. Incoming MIDI is echoed to the outgoing queues of the surface like a controller
+ * script which lights the pressed pads, model updates are only counted.
+ */
+class JvmManagerStub
+{
+public:
+	/** The numbers of the calls which would have gone to Java. */
+	struct Counts
+	{
+		unsigned long long midiEvents{ 0 };
+		unsigned long long updates{ 0 };
+		unsigned long long updateBytes{ 0 };
+	};
+
+	static Counts GetCounts() noexcept;
+	static midi_Output* GetMidiOutput(int index);
+	static unsigned long long GetSentToOutputs() noexcept;
+};
+
+#endif /* _DBM_JVMMANAGERSTUB_H_ */
@@ -0,0 +1,1608 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#define REAPERAPI_IMPLEMENT
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "SyntheticProject.h"
+
+
+extern "C" int SWELL_dllMain(HINSTANCE hInst, DWORD callMode, LPVOID _GetFunc);
+
+namespace
+{
+	/** The project which is currently installed. */
+	SyntheticProject* current{ nullptr };
+
+	/** The PPQ resolution of the MIDI items. */
+	const double PPQ{ 960.0 };
+	/** The range of the volume faders in dB, the stand-in for the Reaper slider is linear. */
+	const double MIN_DB{ -150.0 };
+	const double MAX_DB{ 12.0 };
+
+	/**
+	 * Get the installed project and count the call.
+	 *
+	 * @return The project
+	 */
+	SyntheticProject& Project() noexcept
+	{
+		current->calls++;
+		return *current;
+	}
+
+	ReaProject* ToProject(SyntheticProject& project) noexcept
+	{
+		return reinterpret_cast<ReaProject*>(&project);
+	}
+
+	SyntheticProject::TrackData* ToTrack(MediaTrack* track) noexcept
+	{
+		return reinterpret_cast<SyntheticProject::TrackData*>(track);
+	}
+
+	MediaTrack* ToMediaTrack(SyntheticProject::TrackData* track) noexcept
+	{
+		return reinterpret_cast<MediaTrack*>(track);
+	}
+
+	SyntheticProject::ItemData* ToItem(void* item) noexcept
+	{
+		return static_cast<SyntheticProject::ItemData*>(item);
+	}
+
+	SyntheticProject::DeviceData* GetDevice(MediaTrack* track, int fx) noexcept
+	{
+		SyntheticProject::TrackData* trackData = ToTrack(track);
+		if (trackData == nullptr || fx < 0 || fx >= static_cast<int>(trackData->devices.size()))
+			return nullptr;
+		return &trackData->devices[fx];
+	}
+
+	SyntheticProject::SendData* GetSend(MediaTrack* track, int category, int sendIndex) noexcept
+	{
+		SyntheticProject::TrackData* trackData = ToTrack(track);
+		if (trackData == nullptr || category != 0 || sendIndex < 0 || sendIndex >= static_cast<int>(trackData->sends.size()))
+			return nullptr;
+		return &trackData->sends[sendIndex];
+	}
+
+	void CopyText(const std::string& text, char* buffer, int size) noexcept
+	{
+		if (buffer == nullptr || size <= 0)
+			return;
+		const std::size_t length = std::min(text.length(), static_cast<std::size_t>(size - 1));
+		std::memcpy(buffer, text.c_str(), length);
+		buffer[length] = 0;
+	}
+
+	double Clamp(double value, double minimum, double maximum) noexcept
+	{
+		return std::max(minimum, std::min(maximum, value));
+	}
+
+	/**
+	 * Move an item whose position has changed to its place, Reaper keeps the items of a track
+	 * sorted by their position.
+	 *
+	 * @param item The item
+	 */
+	void SortItem(const SyntheticProject::ItemData* item)
+	{
+		std::vector<std::unique_ptr<SyntheticProject::ItemData>>& items = static_cast<SyntheticProject::TrackData*>(item->track)->items;
+		const auto it = std::find_if(items.begin(), items.end(), [item](const std::unique_ptr<SyntheticProject::ItemData>& other)
+			{
+				return other.get() == item;
+			});
+		if (it == items.end())
+			return;
+		const auto lessPosition = [](const std::unique_ptr<SyntheticProject::ItemData>& a, const std::unique_ptr<SyntheticProject::ItemData>& b)
+			{
+				return a->position < b->position;
+			};
+		const auto later = std::upper_bound(it + 1, items.end(), *it, lessPosition);
+		if (later != it + 1)
+		{
+			std::rotate(it, it + 1, later);
+			return;
+		}
+		const auto earlier = std::upper_bound(items.begin(), it, *it, lessPosition);
+		std::rotate(earlier, it, it + 1);
+	}
+
+	/** Storage for the pointers to unknown parameters, which must be dereferenceable. */
+	double zeroValue{ 0 };
+
+	/**
+	 * Replaces all functions without stand-in, see SWELL's dummyFunc.
+	 *
+	 * @return Always 0
+	 */
+	int ReturnZero() noexcept
+	{
+		if (current != nullptr)
+			current->calls++;
+		return 0;
+	}
+
+
+	/** The replacements of the Reaper API functions. */
+	namespace standin
+	{
+		ReaProject* EnumProjects(int idx, char* projfnOutOptional, int projfnOutOptional_sz)
+		{
+			SyntheticProject& project = Project();
+			if (idx > 0)
+				return nullptr;
+			CopyText("synthetic.rpp", projfnOutOptional, projfnOutOptional_sz);
+			return ToProject(project);
+		}
+
+		void GetProjectName(ReaProject* proj, char* bufOut, int bufOut_sz)
+		{
+			Project();
+			CopyText("synthetic.rpp", bufOut, bufOut_sz);
+		}
+
+		int GetProjectStateChangeCount(ReaProject* proj)
+		{
+			return Project().stateChangeCount;
+		}
+
+		int CountTracks(ReaProject* proj)
+		{
+			return static_cast<int>(Project().tracks.size());
+		}
+
+		int GetNumTracks()
+		{
+			return static_cast<int>(Project().tracks.size());
+		}
+
+		MediaTrack* GetTrack(ReaProject* proj, int trackidx)
+		{
+			SyntheticProject& project = Project();
+			if (trackidx < 0 || trackidx >= static_cast<int>(project.tracks.size()))
+				return nullptr;
+			return ToMediaTrack(project.tracks[trackidx].get());
+		}
+
+		MediaTrack* GetMasterTrack(ReaProject* proj)
+		{
+			return ToMediaTrack(&Project().master);
+		}
+
+		MediaTrack* GetSelectedTrack2(ReaProject* proj, int seltrackidx, bool wantmaster)
+		{
+			SyntheticProject& project = Project();
+			if (wantmaster && project.master.isSelected)
+			{
+				if (seltrackidx == 0)
+					return ToMediaTrack(&project.master);
+				seltrackidx--;
+			}
+			for (const std::unique_ptr<SyntheticProject::TrackData>& track : project.tracks)
+			{
+				if (track->isSelected && seltrackidx-- == 0)
+					return ToMediaTrack(track.get());
+			}
+			return nullptr;
+		}
+
+		MediaTrack* GetSelectedTrack(ReaProject* proj, int seltrackidx)
+		{
+			return GetSelectedTrack2(proj, seltrackidx, false);
+		}
+
+		bool IsTrackSelected(MediaTrack* track)
+		{
+			Project();
+			return ToTrack(track)->isSelected;
+		}
+
+		void SetTrackSelected(MediaTrack* track, bool selected)
+		{
+			Project().stateChangeCount++;
+			ToTrack(track)->isSelected = selected;
+		}
+
+		void SetOnlyTrackSelected(MediaTrack* track)
+		{
+			SyntheticProject& project = Project();
+			project.stateChangeCount++;
+			project.master.isSelected = false;
+			for (const std::unique_ptr<SyntheticProject::TrackData>& t : project.tracks)
+				t->isSelected = false;
+			ToTrack(track)->isSelected = true;
+		}
+
+		int CSurf_TrackToID(MediaTrack* track, bool mcpView)
+		{
+			Project();
+			return ToTrack(track)->number;
+		}
+
+		const char* GetTrackState(MediaTrack* track, int* flagsOut)
+		{
+			Project();
+			const SyntheticProject::TrackData* trackData = ToTrack(track);
+			if (flagsOut != nullptr)
+				*flagsOut = (trackData->isSelected ? 2 : 0) | (trackData->isMuted ? 8 : 0) | (trackData->isSoloed ? 16 : 0) | (trackData->isRecArmed ? 64 : 0);
+			return trackData->name.c_str();
+		}
+
+		bool GetTrackName(MediaTrack* track, char* bufOut, int bufOut_sz)
+		{
+			Project();
+			CopyText(ToTrack(track)->name, bufOut, bufOut_sz);
+			return true;
+		}
+
+		int GetTrackColor(MediaTrack* track)
+		{
+			Project();
+			return ToTrack(track)->color;
+		}
+
+		void SetTrackColor(MediaTrack* track, int color)
+		{
+			Project().stateChangeCount++;
+			ToTrack(track)->color = color | 0x1000000;
+		}
+
+		int GetTrackDepth(MediaTrack* track)
+		{
+			Project();
+			return 0;
+		}
+
+		double GetMediaTrackInfo_Value(MediaTrack* tr, const char* parmname)
+		{
+			Project();
+			const SyntheticProject::TrackData* track = ToTrack(tr);
+			if (std::strcmp(parmname, "D_VOL") == 0)
+				return track->volume;
+			if (std::strcmp(parmname, "D_PAN") == 0)
+				return track->pan;
+			if (std::strcmp(parmname, "B_MUTE") == 0)
+				return track->isMuted ? 1 : 0;
+			if (std::strcmp(parmname, "I_SOLO") == 0)
+				return track->isSoloed ? 1 : 0;
+			if (std::strcmp(parmname, "I_RECARM") == 0)
+				return track->isRecArmed ? 1 : 0;
+			if (std::strcmp(parmname, "I_SELECTED") == 0)
+				return track->isSelected ? 1 : 0;
+			if (std::strcmp(parmname, "I_CUSTOMCOLOR") == 0)
+				return track->color;
+			if (std::strcmp(parmname, "IP_TRACKNUMBER") == 0)
+				return track->number == 0 ? -1 : track->number;
+			if (std::strcmp(parmname, "B_SHOWINMIXER") == 0 || std::strcmp(parmname, "B_SHOWINTCP") == 0)
+				return 1;
+			return 0;
+		}
+
+		bool SetMediaTrackInfo_Value(MediaTrack* tr, const char* parmname, double newvalue)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* track = ToTrack(tr);
+			if (std::strcmp(parmname, "D_VOL") == 0)
+				track->volume = newvalue;
+			else if (std::strcmp(parmname, "D_PAN") == 0)
+				track->pan = newvalue;
+			else if (std::strcmp(parmname, "B_MUTE") == 0)
+				track->isMuted = newvalue > 0;
+			else if (std::strcmp(parmname, "I_SOLO") == 0)
+				track->isSoloed = newvalue > 0;
+			else if (std::strcmp(parmname, "I_RECARM") == 0)
+				track->isRecArmed = newvalue > 0;
+			else if (std::strcmp(parmname, "I_SELECTED") == 0)
+				track->isSelected = newvalue > 0;
+			else if (std::strcmp(parmname, "I_CUSTOMCOLOR") == 0)
+				track->color = static_cast<int>(newvalue);
+			return true;
+		}
+
+		void* GetSetMediaTrackInfo(MediaTrack* tr, const char* parmname, void* setNewValue)
+		{
+			Project();
+			SyntheticProject::TrackData* track = ToTrack(tr);
+			if (std::strcmp(parmname, "I_FOLDERCOMPACT") == 0)
+			{
+				if (setNewValue != nullptr)
+					track->folderCompact = *static_cast<int*>(setNewValue);
+				return &track->folderCompact;
+			}
+			if (std::strcmp(parmname, "P_NAME") == 0)
+			{
+				if (setNewValue != nullptr)
+					track->name = static_cast<const char*>(setNewValue);
+				return const_cast<char*>(track->name.c_str());
+			}
+			zeroValue = 0;
+			return &zeroValue;
+		}
+
+		bool GetSetMediaTrackInfo_String(MediaTrack* tr, const char* parmname, char* stringNeedBig, bool setNewValue)
+		{
+			Project();
+			if (std::strcmp(parmname, "P_NAME") != 0)
+				return false;
+			SyntheticProject::TrackData* track = ToTrack(tr);
+			if (setNewValue)
+				track->name = stringNeedBig;
+			else
+				CopyText(track->name, stringNeedBig, 256);
+			return true;
+		}
+
+		double CSurf_OnVolumeChange(MediaTrack* trackid, double volume, bool relative)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* track = ToTrack(trackid);
+			track->volume = std::max(0.0, relative ? track->volume + volume : volume);
+			return track->volume;
+		}
+
+		double CSurf_OnPanChange(MediaTrack* trackid, double pan, bool relative)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* track = ToTrack(trackid);
+			track->pan = Clamp(relative ? track->pan + pan : pan, -1.0, 1.0);
+			return track->pan;
+		}
+
+		double SetTrackUIVolume(MediaTrack* track, double volume, bool relative, bool done, int igngroupflags)
+		{
+			return CSurf_OnVolumeChange(track, volume, relative);
+		}
+
+		double SetTrackUIPan(MediaTrack* track, double pan, bool relative, bool done, int igngroupflags)
+		{
+			return CSurf_OnPanChange(track, pan, relative);
+		}
+
+		int SetTrackUIMute(MediaTrack* track, int mute, int igngroupflags)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* trackData = ToTrack(track);
+			trackData->isMuted = mute < 0 ? !trackData->isMuted : mute > 0;
+			return trackData->isMuted ? 1 : 0;
+		}
+
+		int SetTrackUISolo(MediaTrack* track, int solo, int igngroupflags)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* trackData = ToTrack(track);
+			trackData->isSoloed = solo < 0 ? !trackData->isSoloed : solo > 0;
+			return trackData->isSoloed ? 1 : 0;
+		}
+
+		int SetTrackUIRecArm(MediaTrack* track, int recarm, int igngroupflags)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* trackData = ToTrack(track);
+			trackData->isRecArmed = recarm < 0 ? !trackData->isRecArmed : recarm > 0;
+			return trackData->isRecArmed ? 1 : 0;
+		}
+
+		double Track_GetPeakInfo(MediaTrack* track, int channel)
+		{
+			Project();
+			return ToTrack(track)->peak * (channel == 0 ? 1.0 : 0.9);
+		}
+
+		double Track_GetPeakHoldDB(MediaTrack* track, int channel, bool clear)
+		{
+			Project();
+			const double peak = ToTrack(track)->peak;
+			// Returns dB / 100
+			return peak > 0 ? 20.0 * std::log10(peak) / 100.0 : -1.5;
+		}
+
+		int GetTrackNumSends(MediaTrack* tr, int category)
+		{
+			Project();
+			return category == 0 ? static_cast<int>(ToTrack(tr)->sends.size()) : 0;
+		}
+
+		void* GetSetTrackSendInfo(MediaTrack* tr, int category, int sendidx, const char* parmname, void* setNewValue)
+		{
+			SyntheticProject& project = Project();
+			const SyntheticProject::SendData* send = GetSend(tr, category, sendidx);
+			if (send != nullptr && std::strcmp(parmname, "P_DESTTRACK") == 0)
+				return project.tracks[send->destination].get();
+			zeroValue = 0;
+			return &zeroValue;
+		}
+
+		double GetTrackSendInfo_Value(MediaTrack* tr, int category, int sendidx, const char* parmname)
+		{
+			Project();
+			const SyntheticProject::SendData* send = GetSend(tr, category, sendidx);
+			if (send == nullptr)
+				return 0;
+			if (std::strcmp(parmname, "D_VOL") == 0)
+				return send->volume;
+			if (std::strcmp(parmname, "D_PAN") == 0)
+				return send->pan;
+			if (std::strcmp(parmname, "B_MUTE") == 0)
+				return send->isMuted ? 1 : 0;
+			return 0;
+		}
+
+		bool GetTrackSendName(MediaTrack* track, int send_index, char* bufOut, int bufOut_sz)
+		{
+			SyntheticProject& project = Project();
+			const SyntheticProject::SendData* send = GetSend(track, 0, send_index);
+			if (send == nullptr)
+				return false;
+			CopyText(project.tracks[send->destination]->name, bufOut, bufOut_sz);
+			return true;
+		}
+
+		bool GetTrackSendUIMute(MediaTrack* track, int send_index, bool* muteOut)
+		{
+			Project();
+			const SyntheticProject::SendData* send = GetSend(track, 0, send_index);
+			if (send == nullptr)
+				return false;
+			if (muteOut != nullptr)
+				*muteOut = send->isMuted;
+			return true;
+		}
+
+		double CSurf_OnSendVolumeChange(MediaTrack* trackid, int send_index, double volume, bool relative)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::SendData* send = GetSend(trackid, 0, send_index);
+			if (send == nullptr)
+				return 0;
+			send->volume = std::max(0.0, relative ? send->volume + volume : volume);
+			return send->volume;
+		}
+
+		int TrackFX_GetCount(MediaTrack* track)
+		{
+			Project();
+			return static_cast<int>(ToTrack(track)->devices.size());
+		}
+
+		int TrackFX_GetNumParams(MediaTrack* track, int fx)
+		{
+			Project();
+			const SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			return device == nullptr ? 0 : static_cast<int>(device->values.size());
+		}
+
+		double TrackFX_GetParamNormalized(MediaTrack* track, int fx, int param)
+		{
+			Project();
+			const SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			if (device == nullptr || param < 0 || param >= static_cast<int>(device->values.size()))
+				return 0;
+			return device->values[param];
+		}
+
+		double TrackFX_GetParam(MediaTrack* track, int fx, int param, double* minvalOut, double* maxvalOut)
+		{
+			if (minvalOut != nullptr)
+				*minvalOut = 0;
+			if (maxvalOut != nullptr)
+				*maxvalOut = 1;
+			return TrackFX_GetParamNormalized(track, fx, param);
+		}
+
+		bool TrackFX_SetParamNormalized(MediaTrack* track, int fx, int param, double value)
+		{
+			Project();
+			SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			if (device == nullptr || param < 0 || param >= static_cast<int>(device->values.size()))
+				return false;
+			device->values[param] = Clamp(value, 0.0, 1.0);
+			return true;
+		}
+
+		bool TrackFX_GetParamName(MediaTrack* track, int fx, int param, char* bufOut, int bufOut_sz)
+		{
+			Project();
+			if (GetDevice(track, fx) == nullptr)
+				return false;
+			CopyText("Param " + std::to_string(param + 1), bufOut, bufOut_sz);
+			return true;
+		}
+
+		bool TrackFX_FormatParamValue(MediaTrack* track, int fx, int param, double val, char* bufOut, int bufOut_sz)
+		{
+			Project();
+			if (bufOut == nullptr || bufOut_sz <= 0)
+				return false;
+			std::snprintf(bufOut, bufOut_sz, "%.1f %%", val * 100.0);
+			return true;
+		}
+
+		bool TrackFX_GetFXName(MediaTrack* track, int fx, char* bufOut, int bufOut_sz)
+		{
+			Project();
+			const SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			if (device == nullptr)
+				return false;
+			CopyText(device->name, bufOut, bufOut_sz);
+			return true;
+		}
+
+		GUID* TrackFX_GetFXGUID(MediaTrack* track, int fx)
+		{
+			Project();
+			SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			return device == nullptr ? nullptr : &device->guid;
+		}
+
+		bool TrackFX_GetPreset(MediaTrack* track, int fx, char* presetnameOut, int presetnameOut_sz)
+		{
+			Project();
+			CopyText("Default", presetnameOut, presetnameOut_sz);
+			return GetDevice(track, fx) != nullptr;
+		}
+
+		int TrackFX_GetPresetIndex(MediaTrack* track, int fx, int* numberOfPresetsOut)
+		{
+			Project();
+			if (numberOfPresetsOut != nullptr)
+				*numberOfPresetsOut = 0;
+			return -1;
+		}
+
+		void TrackFX_GetUserPresetFilename(MediaTrack* track, int fx, char* fnOut, int fnOut_sz)
+		{
+			Project();
+			CopyText("", fnOut, fnOut_sz);
+		}
+
+		bool TrackFX_GetEnabled(MediaTrack* track, int fx)
+		{
+			Project();
+			const SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			return device != nullptr && device->isEnabled;
+		}
+
+		void TrackFX_SetEnabled(MediaTrack* track, int fx, bool enabled)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::DeviceData* device = GetDevice(track, fx);
+			if (device != nullptr)
+				device->isEnabled = enabled;
+		}
+
+		int TrackFX_GetEQ(MediaTrack* track, bool instantiate)
+		{
+			Project();
+			return -1;
+		}
+
+		int TrackFX_GetInstrument(MediaTrack* track)
+		{
+			Project();
+			return -1;
+		}
+
+		int TrackFX_GetChainVisible(MediaTrack* track)
+		{
+			Project();
+			return -1;
+		}
+
+		int CountProjectMarkers(ReaProject* proj, int* num_markersOut, int* num_regionsOut)
+		{
+			SyntheticProject& project = Project();
+			int regions{ 0 };
+			for (const SyntheticProject::MarkerData& marker : project.markers)
+			{
+				if (marker.isRegion)
+					regions++;
+			}
+			const int total = static_cast<int>(project.markers.size());
+			if (num_markersOut != nullptr)
+				*num_markersOut = total - regions;
+			if (num_regionsOut != nullptr)
+				*num_regionsOut = regions;
+			return total;
+		}
+
+		int EnumProjectMarkers3(ReaProject* proj, int idx, bool* isrgnOut, double* posOut, double* rgnendOut, const char** nameOut, int* markrgnindexnumberOut, int* colorOut)
+		{
+			SyntheticProject& project = Project();
+			if (idx < 0 || idx >= static_cast<int>(project.markers.size()))
+				return 0;
+			const SyntheticProject::MarkerData& marker = project.markers[idx];
+			if (isrgnOut != nullptr)
+				*isrgnOut = marker.isRegion;
+			if (posOut != nullptr)
+				*posOut = marker.position;
+			if (rgnendOut != nullptr)
+				*rgnendOut = marker.end;
+			if (nameOut != nullptr)
+				*nameOut = marker.name.c_str();
+			if (markrgnindexnumberOut != nullptr)
+				*markrgnindexnumberOut = marker.number;
+			if (colorOut != nullptr)
+				*colorOut = marker.color;
+			return idx + 1;
+		}
+
+		int EnumProjectMarkers2(ReaProject* proj, int idx, bool* isrgnOut, double* posOut, double* rgnendOut, const char** nameOut, int* markrgnindexnumberOut)
+		{
+			return EnumProjectMarkers3(proj, idx, isrgnOut, posOut, rgnendOut, nameOut, markrgnindexnumberOut, nullptr);
+		}
+
+		bool SetProjectMarkerByIndex2(ReaProject* proj, int markrgnidx, bool isrgn, double pos, double rgnend, int IDnumber, const char* name, int color, int flags)
+		{
+			SyntheticProject& project = Project();
+			project.stateChangeCount++;
+			if (markrgnidx < 0 || markrgnidx >= static_cast<int>(project.markers.size()))
+				return false;
+			SyntheticProject::MarkerData& marker = project.markers[markrgnidx];
+			marker.isRegion = isrgn;
+			marker.position = pos;
+			marker.end = isrgn ? rgnend : 0;
+			marker.number = IDnumber;
+			if (name != nullptr)
+				marker.name = name;
+			if (color != 0)
+				marker.color = color;
+			return true;
+		}
+
+		int AddProjectMarker2(ReaProject* proj, bool isrgn, double pos, double rgnend, const char* name, int wantidx, int color)
+		{
+			SyntheticProject& project = Project();
+			project.stateChangeCount++;
+			SyntheticProject::MarkerData marker;
+			marker.isRegion = isrgn;
+			marker.position = pos;
+			marker.end = isrgn ? rgnend : 0;
+			marker.color = color;
+			marker.name = name == nullptr ? "" : name;
+			for (const SyntheticProject::MarkerData& existing : project.markers)
+				marker.number = std::max(marker.number, existing.number);
+			marker.number++;
+			// Markers and regions are sorted by their position
+			const auto it = std::upper_bound(project.markers.begin(), project.markers.end(), pos, [](double position, const SyntheticProject::MarkerData& existing)
+				{
+					return position < existing.position;
+				});
+			project.markers.insert(it, marker);
+			return marker.number;
+		}
+
+		void GetLastMarkerAndCurRegion(ReaProject* proj, double time, int* markeridxOut, int* regionidxOut)
+		{
+			Project();
+			if (markeridxOut != nullptr)
+				*markeridxOut = -1;
+			if (regionidxOut != nullptr)
+				*regionidxOut = -1;
+		}
+
+		int CountTrackMediaItems(MediaTrack* track)
+		{
+			Project();
+			return static_cast<int>(ToTrack(track)->items.size());
+		}
+
+		MediaItem* GetTrackMediaItem(MediaTrack* tr, int itemidx)
+		{
+			Project();
+			SyntheticProject::TrackData* track = ToTrack(tr);
+			if (itemidx < 0 || itemidx >= static_cast<int>(track->items.size()))
+				return nullptr;
+			return reinterpret_cast<MediaItem*>(track->items[itemidx].get());
+		}
+
+		double GetMediaItemInfo_Value(MediaItem* item, const char* parmname)
+		{
+			Project();
+			const SyntheticProject::ItemData* itemData = ToItem(item);
+			if (std::strcmp(parmname, "D_POSITION") == 0)
+				return itemData->position;
+			if (std::strcmp(parmname, "D_LENGTH") == 0)
+				return itemData->length;
+			if (std::strcmp(parmname, "B_MUTE") == 0)
+				return itemData->isMuted ? 1 : 0;
+			if (std::strcmp(parmname, "B_UISEL") == 0)
+				return itemData->isSelected ? 1 : 0;
+			return 0;
+		}
+
+		bool SetMediaItemInfo_Value(MediaItem* item, const char* parmname, double newvalue)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::ItemData* itemData = ToItem(item);
+			if (std::strcmp(parmname, "D_POSITION") == 0)
+			{
+				itemData->position = newvalue;
+				SortItem(itemData);
+			}
+			else if (std::strcmp(parmname, "D_LENGTH") == 0)
+				itemData->length = newvalue;
+			else if (std::strcmp(parmname, "B_MUTE") == 0)
+				itemData->isMuted = newvalue > 0;
+			else if (std::strcmp(parmname, "B_UISEL") == 0)
+				itemData->isSelected = newvalue > 0;
+			return true;
+		}
+
+		void* GetSetMediaItemInfo(MediaItem* item, const char* parmname, void* setNewValue)
+		{
+			Project();
+			SyntheticProject::ItemData* itemData = ToItem(item);
+			bool* value = nullptr;
+			if (std::strcmp(parmname, "B_MUTE") == 0)
+				value = &itemData->isMuted;
+			else if (std::strcmp(parmname, "B_UISEL") == 0)
+				value = &itemData->isSelected;
+			else if (std::strcmp(parmname, "P_TRACK") == 0)
+				return itemData->track;
+			if (value == nullptr)
+			{
+				zeroValue = 0;
+				return &zeroValue;
+			}
+			if (setNewValue != nullptr)
+				*value = *static_cast<bool*>(setNewValue);
+			return value;
+		}
+
+		void SetMediaItemSelected(MediaItem* item, bool selected)
+		{
+			Project();
+			ToItem(item)->isSelected = selected;
+		}
+
+		MediaItem* AddMediaItemToTrack(MediaTrack* tr)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::TrackData* track = ToTrack(tr);
+			std::unique_ptr<SyntheticProject::ItemData> item = std::make_unique<SyntheticProject::ItemData>();
+			item->track = track;
+			item->position = track->items.empty() ? 0 : track->items.back()->position;
+			track->items.push_back(std::move(item));
+			return reinterpret_cast<MediaItem*>(track->items.back().get());
+		}
+
+		char* GetSetObjectState(void* obj, const char* str)
+		{
+			Project();
+			if (str != nullptr && str[0] != 0)
+				return nullptr;
+			// The state of an item with its MIDI source, the notes are stored as note-on and -off
+			const SyntheticProject::ItemData* itemData = ToItem(obj);
+			std::string chunk = "<ITEM\nPOSITION " + std::to_string(itemData->position) + "\nLENGTH " + std::to_string(itemData->length) +
+				"\nIGUID {00000000-0000-0000-0000-000000000001}\nNAME \"" + itemData->name + "\"\n<SOURCE MIDI\nHASDATA 1 960 QN\n";
+			char line[64];
+			double position{ 0 };
+			for (const SyntheticProject::NoteData& note : itemData->notes)
+			{
+				std::snprintf(line, sizeof(line), "E %d 9%x %02x %02x\n", static_cast<int>(note.start - position), note.channel, note.pitch, note.velocity);
+				chunk.append(line);
+				std::snprintf(line, sizeof(line), "E %d 8%x %02x 00\n", static_cast<int>(note.end - note.start), note.channel, note.pitch);
+				chunk.append(line);
+				position = note.end;
+			}
+			chunk.append("GUID {00000000-0000-0000-0000-000000000002}\n>\n>\n");
+			char* result = static_cast<char*>(std::malloc(chunk.size() + 1));
+			if (result != nullptr)
+				std::memcpy(result, chunk.c_str(), chunk.size() + 1);
+			return result;
+		}
+
+		void FreeHeapPtr(void* ptr)
+		{
+			Project();
+			std::free(ptr);
+		}
+
+		bool SetItemStateChunk(MediaItem* item, const char* str, bool isundoOptional)
+		{
+			Project().stateChangeCount++;
+			if (str == nullptr)
+				return false;
+			// Restore the name and the notes, the position and length are set afterwards anyway
+			SyntheticProject::ItemData* itemData = ToItem(item);
+			itemData->notes.clear();
+			std::istringstream input(str);
+			std::string line;
+			double position{ 0 };
+			SyntheticProject::NoteData note;
+			while (std::getline(input, line))
+			{
+				int offset{ 0 };
+				unsigned int status{ 0 };
+				unsigned int pitch{ 0 };
+				unsigned int velocity{ 0 };
+				if (line.compare(0, 6, "NAME \"") == 0 && line.length() > 6)
+					itemData->name = line.substr(6, line.length() - 7);
+				else if (std::sscanf(line.c_str(), "E %d %x %x %x", &offset, &status, &pitch, &velocity) == 4)
+				{
+					position += offset;
+					if ((status & 0xF0) == 0x90)
+					{
+						note.start = position;
+						note.channel = static_cast<int>(status & 0x0F);
+						note.pitch = static_cast<int>(pitch);
+						note.velocity = static_cast<int>(velocity);
+					}
+					else
+					{
+						note.end = position;
+						itemData->notes.push_back(note);
+					}
+				}
+			}
+			return true;
+		}
+
+		int CountTakes(MediaItem* item)
+		{
+			Project();
+			return 1;
+		}
+
+		MediaItem_Take* GetMediaItemTake(MediaItem* item, int tk)
+		{
+			Project();
+			return tk == 0 ? reinterpret_cast<MediaItem_Take*>(item) : nullptr;
+		}
+
+		MediaItem_Take* GetTake(MediaItem* item, int takeidx)
+		{
+			return GetMediaItemTake(item, takeidx);
+		}
+
+		MediaItem_Take* GetActiveTake(MediaItem* item)
+		{
+			return GetMediaItemTake(item, 0);
+		}
+
+		bool TakeIsMIDI(MediaItem_Take* take)
+		{
+			Project();
+			return take != nullptr;
+		}
+
+		void* GetSetMediaItemTakeInfo(MediaItem_Take* tk, const char* parmname, void* setNewValue)
+		{
+			Project();
+			SyntheticProject::ItemData* itemData = ToItem(tk);
+			if (std::strcmp(parmname, "P_NAME") == 0)
+			{
+				if (setNewValue != nullptr)
+					itemData->name = static_cast<const char*>(setNewValue);
+				return const_cast<char*>(itemData->name.c_str());
+			}
+			if (std::strcmp(parmname, "P_ITEM") == 0)
+				return itemData;
+			zeroValue = 0;
+			return &zeroValue;
+		}
+
+		bool GetSetMediaItemTakeInfo_String(MediaItem_Take* tk, const char* parmname, char* stringNeedBig, bool setNewValue)
+		{
+			Project();
+			if (std::strcmp(parmname, "P_NAME") != 0)
+				return false;
+			SyntheticProject::ItemData* itemData = ToItem(tk);
+			if (setNewValue)
+				itemData->name = stringNeedBig;
+			else
+				CopyText(itemData->name, stringNeedBig, 256);
+			return true;
+		}
+
+		double GetMediaItemTakeInfo_Value(MediaItem_Take* take, const char* parmname)
+		{
+			Project();
+			if (std::strcmp(parmname, "D_PLAYRATE") == 0)
+				return 1;
+			return 0;
+		}
+
+		bool SetMediaItemTakeInfo_Value(MediaItem_Take* take, const char* parmname, double newvalue)
+		{
+			Project().stateChangeCount++;
+			return true;
+		}
+
+		int MIDI_CountEvts(MediaItem_Take* take, int* notecntOut, int* ccevtcntOut, int* textsyxevtcntOut)
+		{
+			Project();
+			const int notes = static_cast<int>(ToItem(take)->notes.size());
+			if (notecntOut != nullptr)
+				*notecntOut = notes;
+			if (ccevtcntOut != nullptr)
+				*ccevtcntOut = 0;
+			if (textsyxevtcntOut != nullptr)
+				*textsyxevtcntOut = 0;
+			return notes;
+		}
+
+		bool MIDI_GetNote(MediaItem_Take* take, int noteidx, bool* selectedOut, bool* mutedOut, double* startppqposOut, double* endppqposOut, int* chanOut, int* pitchOut, int* velOut)
+		{
+			Project();
+			const SyntheticProject::ItemData* itemData = ToItem(take);
+			if (noteidx < 0 || noteidx >= static_cast<int>(itemData->notes.size()))
+				return false;
+			const SyntheticProject::NoteData& note = itemData->notes[noteidx];
+			if (selectedOut != nullptr)
+				*selectedOut = note.isSelected;
+			if (mutedOut != nullptr)
+				*mutedOut = note.isMuted;
+			if (startppqposOut != nullptr)
+				*startppqposOut = note.start;
+			if (endppqposOut != nullptr)
+				*endppqposOut = note.end;
+			if (chanOut != nullptr)
+				*chanOut = note.channel;
+			if (pitchOut != nullptr)
+				*pitchOut = note.pitch;
+			if (velOut != nullptr)
+				*velOut = note.velocity;
+			return true;
+		}
+
+		bool MIDI_SetNote(MediaItem_Take* take, int noteidx, const bool* selectedInOptional, const bool* mutedInOptional, const double* startppqposInOptional, const double* endppqposInOptional, const int* chanInOptional, const int* pitchInOptional, const int* velInOptional, const bool* noSortInOptional)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::ItemData* itemData = ToItem(take);
+			if (noteidx < 0 || noteidx >= static_cast<int>(itemData->notes.size()))
+				return false;
+			SyntheticProject::NoteData& note = itemData->notes[noteidx];
+			if (selectedInOptional != nullptr)
+				note.isSelected = *selectedInOptional;
+			if (mutedInOptional != nullptr)
+				note.isMuted = *mutedInOptional;
+			if (startppqposInOptional != nullptr)
+				note.start = *startppqposInOptional;
+			if (endppqposInOptional != nullptr)
+				note.end = *endppqposInOptional;
+			if (chanInOptional != nullptr)
+				note.channel = *chanInOptional;
+			if (pitchInOptional != nullptr)
+				note.pitch = *pitchInOptional;
+			if (velInOptional != nullptr)
+				note.velocity = *velInOptional;
+			return true;
+		}
+
+		bool MIDI_InsertNote(MediaItem_Take* take, bool selected, bool muted, double startppqpos, double endppqpos, int chan, int pitch, int vel, const bool* noSortInOptional)
+		{
+			Project().stateChangeCount++;
+			SyntheticProject::NoteData note;
+			note.isSelected = selected;
+			note.isMuted = muted;
+			note.start = startppqpos;
+			note.end = endppqpos;
+			note.channel = chan;
+			note.pitch = pitch;
+			note.velocity = vel;
+			ToItem(take)->notes.push_back(note);
+			return true;
+		}
+
+		bool MIDI_DeleteNote(MediaItem_Take* take, int noteidx)
+		{
+			Project().stateChangeCount++;
+			std::vector<SyntheticProject::NoteData>& notes = ToItem(take)->notes;
+			if (noteidx < 0 || noteidx >= static_cast<int>(notes.size()))
+				return false;
+			notes.erase(notes.begin() + noteidx);
+			return true;
+		}
+
+		bool MIDI_GetHash(MediaItem_Take* take, bool notesonly, char* hashOut, int hashOut_sz)
+		{
+			Project();
+			std::size_t hash{ 0 };
+			for (const SyntheticProject::NoteData& note : ToItem(take)->notes)
+				hash = hash * 31 + static_cast<std::size_t>(note.start) * 127 + static_cast<std::size_t>(note.pitch * 131 + note.velocity);
+			CopyText(std::to_string(hash), hashOut, hashOut_sz);
+			return true;
+		}
+
+		double MIDI_GetProjTimeFromPPQPos(MediaItem_Take* take, double ppqpos)
+		{
+			SyntheticProject& project = Project();
+			return ToItem(take)->position + ppqpos / PPQ * 60.0 / project.tempo;
+		}
+
+		double MIDI_GetPPQPosFromProjQN(MediaItem_Take* take, double projqn)
+		{
+			SyntheticProject& project = Project();
+			return (projqn - ToItem(take)->position * project.tempo / 60.0) * PPQ;
+		}
+
+		double MIDI_GetGrid(MediaItem_Take* take, double* swingOutOptional, double* noteLenOutOptional)
+		{
+			Project();
+			if (swingOutOptional != nullptr)
+				*swingOutOptional = 0;
+			if (noteLenOutOptional != nullptr)
+				*noteLenOutOptional = 0.25;
+			return 0.25;
+		}
+
+		int GetPlayStateEx(ReaProject* proj)
+		{
+			return Project().playState;
+		}
+
+		double GetPlayPositionEx(ReaProject* proj)
+		{
+			return Project().playPosition;
+		}
+
+		double GetCursorPositionEx(ReaProject* proj)
+		{
+			return Project().cursorPosition;
+		}
+
+		void SetEditCurPos2(ReaProject* proj, double time, bool moveview, bool seekplay)
+		{
+			Project().cursorPosition = std::max(0.0, time);
+		}
+
+		void CSurf_OnPlay()
+		{
+			Project().playState = 1;
+		}
+
+		void CSurf_OnStop()
+		{
+			Project().playState = 0;
+		}
+
+		void CSurf_OnPause()
+		{
+			Project().playState = 2;
+		}
+
+		void CSurf_OnRecord()
+		{
+			Project().playState = 5;
+		}
+
+		double Master_GetTempo()
+		{
+			return Project().tempo;
+		}
+
+		void CSurf_OnTempoChange(double bpm)
+		{
+			Project().tempo = Clamp(bpm, 1.0, 960.0);
+		}
+
+		void TimeMap_GetTimeSigAtTime(ReaProject* proj, double time, int* timesig_numOut, int* timesig_denomOut, double* tempoOut)
+		{
+			SyntheticProject& project = Project();
+			if (timesig_numOut != nullptr)
+				*timesig_numOut = 4;
+			if (timesig_denomOut != nullptr)
+				*timesig_denomOut = 4;
+			if (tempoOut != nullptr)
+				*tempoOut = project.tempo;
+		}
+
+		void GetProjectTimeSignature2(ReaProject* proj, double* bpmOut, double* bpiOut)
+		{
+			SyntheticProject& project = Project();
+			if (bpmOut != nullptr)
+				*bpmOut = project.tempo;
+			if (bpiOut != nullptr)
+				*bpiOut = 4;
+		}
+
+		double GetProjectLength(ReaProject* proj)
+		{
+			Project();
+			return 300;
+		}
+
+		double GetProjectTimeOffset(ReaProject* proj, bool rndframe)
+		{
+			Project();
+			return 0;
+		}
+
+		double GetHZoomLevel()
+		{
+			Project();
+			return 100;
+		}
+
+		double SnapToGrid(ReaProject* project, double time_pos)
+		{
+			Project();
+			return time_pos;
+		}
+
+		void GetSet_LoopTimeRange2(ReaProject* proj, bool isSet, bool isLoop, double* startOut, double* endOut, bool allowautoseek)
+		{
+			SyntheticProject& project = Project();
+			if (startOut == nullptr || endOut == nullptr)
+				return;
+			if (isSet)
+			{
+				project.timeSelectionStart = *startOut;
+				project.timeSelectionEnd = *endOut;
+				return;
+			}
+			*startOut = project.timeSelectionStart;
+			*endOut = project.timeSelectionEnd;
+		}
+
+		void GetSet_LoopTimeRange(bool isSet, bool isLoop, double* startOut, double* endOut, bool allowautoseek)
+		{
+			GetSet_LoopTimeRange2(nullptr, isSet, isLoop, startOut, endOut, allowautoseek);
+		}
+
+		int GetSetProjectGrid(ReaProject* project, bool set, double* divisionInOutOptional, int* swingmodeInOutOptional, double* swingamtInOutOptional)
+		{
+			Project();
+			if (set)
+				return 0;
+			if (divisionInOutOptional != nullptr)
+				*divisionInOutOptional = 0.25;
+			if (swingmodeInOutOptional != nullptr)
+				*swingmodeInOutOptional = 0;
+			if (swingamtInOutOptional != nullptr)
+				*swingamtInOutOptional = 0;
+			return 0;
+		}
+
+		bool GetTouchedOrFocusedFX(int mode, int* trackidxOut, int* itemidxOut, int* takeidxOut, int* fxidxOut, int* parmOut)
+		{
+			Project();
+			return false;
+		}
+
+		bool GetTCPFXParm(ReaProject* project, MediaTrack* track, int index, int* fxindexOut, int* parmidxOut)
+		{
+			Project();
+			return false;
+		}
+
+		int Envelope_Evaluate(TrackEnvelope* envelope, double time, double samplerate, int samplesRequested, double* valueOut, double* dVdSOut, double* ddVdSOut, double* dddVdSOut)
+		{
+			Project();
+			for (double* value : { valueOut, dVdSOut, ddVdSOut, dddVdSOut })
+			{
+				if (value != nullptr)
+					*value = 0;
+			}
+			return 0;
+		}
+
+		double DB2SLIDER(double x)
+		{
+			Project();
+			return Clamp((x - MIN_DB) / (MAX_DB - MIN_DB), 0.0, 1.0) * 1000.0;
+		}
+
+		double SLIDER2DB(double y)
+		{
+			Project();
+			return MIN_DB + Clamp(y / 1000.0, 0.0, 1.0) * (MAX_DB - MIN_DB);
+		}
+
+		double ScaleFromEnvelopeMode(int scaling_mode, double val)
+		{
+			Project();
+			return val;
+		}
+
+		void ColorFromNative(int col, int* rOut, int* gOut, int* bOut)
+		{
+			Project();
+			if (rOut != nullptr)
+				*rOut = col & 0xFF;
+			if (gOut != nullptr)
+				*gOut = (col >> 8) & 0xFF;
+			if (bOut != nullptr)
+				*bOut = (col >> 16) & 0xFF;
+		}
+
+		int ColorToNative(int r, int g, int b)
+		{
+			Project();
+			return (r & 0xFF) | ((g & 0xFF) << 8) | ((b & 0xFF) << 16);
+		}
+
+		void format_timestr_len(double tpos, char* buf, int buf_sz, double offset, int modeoverride)
+		{
+			Project();
+			if (buf != nullptr && buf_sz > 0)
+				std::snprintf(buf, buf_sz, "%.3f", tpos);
+		}
+
+		void format_timestr_pos(double tpos, char* buf, int buf_sz, int modeoverride)
+		{
+			format_timestr_len(tpos, buf, buf_sz, 0, modeoverride);
+		}
+
+		void format_timestr(double tpos, char* buf, int buf_sz)
+		{
+			format_timestr_len(tpos, buf, buf_sz, 0, -1);
+		}
+
+		void Main_OnCommandEx(int command, int flag, ReaProject* proj)
+		{
+			SyntheticProject& project = Project();
+			// Only 'Time selection: Insert empty space at time selection (moving later items)', the
+			// items and markers which start in or after the time selection are moved
+			const double start = project.timeSelectionStart;
+			const double length = project.timeSelectionEnd - start;
+			if (command != 40200 || length <= 0)
+				return;
+			project.stateChangeCount++;
+			for (const std::unique_ptr<SyntheticProject::TrackData>& track : project.tracks)
+			{
+				for (const std::unique_ptr<SyntheticProject::ItemData>& item : track->items)
+				{
+					if (item->position >= start)
+						item->position += length;
+				}
+			}
+			for (SyntheticProject::MarkerData& marker : project.markers)
+			{
+				if (marker.position >= start)
+				{
+					marker.position += length;
+					if (marker.isRegion)
+						marker.end += length;
+				}
+			}
+		}
+
+		int Audio_IsRunning()
+		{
+			Project();
+			return 1;
+		}
+
+		const char* GetResourcePath()
+		{
+			Project();
+			return ".";
+		}
+
+		void ShowConsoleMsg(const char* msg)
+		{
+			Project();
+			std::cerr << msg;
+		}
+	}
+
+
+	/**
+	 * Get the stand-ins of the Reaper API functions by their name.
+	 *
+	 * @return The functions
+	 */
+	const std::unordered_map<std::string, void*>& GetStandIns()
+	{
+#define DBM_STAND_IN(name) { #name, reinterpret_cast<void*>(&standin::name) }
+		static const std::unordered_map<std::string, void*> standIns
+		{
+			DBM_STAND_IN(EnumProjects),
+			DBM_STAND_IN(GetProjectName),
+			DBM_STAND_IN(GetProjectStateChangeCount),
+			DBM_STAND_IN(CountTracks),
+			DBM_STAND_IN(GetNumTracks),
+			DBM_STAND_IN(GetTrack),
+			DBM_STAND_IN(GetMasterTrack),
+			DBM_STAND_IN(GetSelectedTrack),
+			DBM_STAND_IN(GetSelectedTrack2),
+			DBM_STAND_IN(IsTrackSelected),
+			DBM_STAND_IN(SetTrackSelected),
+			DBM_STAND_IN(SetOnlyTrackSelected),
+			DBM_STAND_IN(CSurf_TrackToID),
+			DBM_STAND_IN(GetTrackState),
+			DBM_STAND_IN(GetTrackName),
+			DBM_STAND_IN(GetTrackColor),
+			DBM_STAND_IN(SetTrackColor),
+			DBM_STAND_IN(GetTrackDepth),
+			DBM_STAND_IN(GetMediaTrackInfo_Value),
+			DBM_STAND_IN(SetMediaTrackInfo_Value),
+			DBM_STAND_IN(GetSetMediaTrackInfo),
+			DBM_STAND_IN(GetSetMediaTrackInfo_String),
+			DBM_STAND_IN(CSurf_OnVolumeChange),
+			DBM_STAND_IN(CSurf_OnPanChange),
+			DBM_STAND_IN(SetTrackUIVolume),
+			DBM_STAND_IN(SetTrackUIPan),
+			DBM_STAND_IN(SetTrackUIMute),
+			DBM_STAND_IN(SetTrackUISolo),
+			DBM_STAND_IN(SetTrackUIRecArm),
+			DBM_STAND_IN(Track_GetPeakInfo),
+			DBM_STAND_IN(Track_GetPeakHoldDB),
+			DBM_STAND_IN(GetTrackNumSends),
+			DBM_STAND_IN(GetSetTrackSendInfo),
+			DBM_STAND_IN(GetTrackSendInfo_Value),
+			DBM_STAND_IN(GetTrackSendName),
+			DBM_STAND_IN(GetTrackSendUIMute),
+			DBM_STAND_IN(CSurf_OnSendVolumeChange),
+			DBM_STAND_IN(TrackFX_GetCount),
+			DBM_STAND_IN(TrackFX_GetNumParams),
+			DBM_STAND_IN(TrackFX_GetParam),
+			DBM_STAND_IN(TrackFX_GetParamNormalized),
+			DBM_STAND_IN(TrackFX_SetParamNormalized),
+			DBM_STAND_IN(TrackFX_GetParamName),
+			DBM_STAND_IN(TrackFX_FormatParamValue),
+			DBM_STAND_IN(TrackFX_GetFXName),
+			DBM_STAND_IN(TrackFX_GetFXGUID),
+			DBM_STAND_IN(TrackFX_GetPreset),
+			DBM_STAND_IN(TrackFX_GetPresetIndex),
+			DBM_STAND_IN(TrackFX_GetUserPresetFilename),
+			DBM_STAND_IN(TrackFX_GetEnabled),
+			DBM_STAND_IN(TrackFX_SetEnabled),
+			DBM_STAND_IN(TrackFX_GetEQ),
+			DBM_STAND_IN(TrackFX_GetInstrument),
+			DBM_STAND_IN(TrackFX_GetChainVisible),
+			DBM_STAND_IN(CountProjectMarkers),
+			DBM_STAND_IN(EnumProjectMarkers2),
+			DBM_STAND_IN(EnumProjectMarkers3),
+			DBM_STAND_IN(SetProjectMarkerByIndex2),
+			DBM_STAND_IN(AddProjectMarker2),
+			DBM_STAND_IN(GetLastMarkerAndCurRegion),
+			DBM_STAND_IN(CountTrackMediaItems),
+			DBM_STAND_IN(GetTrackMediaItem),
+			DBM_STAND_IN(GetMediaItemInfo_Value),
+			DBM_STAND_IN(SetMediaItemInfo_Value),
+			DBM_STAND_IN(GetSetMediaItemInfo),
+			DBM_STAND_IN(SetMediaItemSelected),
+			DBM_STAND_IN(AddMediaItemToTrack),
+			DBM_STAND_IN(GetSetObjectState),
+			DBM_STAND_IN(FreeHeapPtr),
+			DBM_STAND_IN(SetItemStateChunk),
+			DBM_STAND_IN(CountTakes),
+			DBM_STAND_IN(GetMediaItemTake),
+			DBM_STAND_IN(GetTake),
+			DBM_STAND_IN(GetActiveTake),
+			DBM_STAND_IN(TakeIsMIDI),
+			DBM_STAND_IN(GetSetMediaItemTakeInfo),
+			DBM_STAND_IN(GetSetMediaItemTakeInfo_String),
+			DBM_STAND_IN(GetMediaItemTakeInfo_Value),
+			DBM_STAND_IN(SetMediaItemTakeInfo_Value),
+			DBM_STAND_IN(MIDI_CountEvts),
+			DBM_STAND_IN(MIDI_GetNote),
+			DBM_STAND_IN(MIDI_SetNote),
+			DBM_STAND_IN(MIDI_InsertNote),
+			DBM_STAND_IN(MIDI_DeleteNote),
+			DBM_STAND_IN(MIDI_GetHash),
+			DBM_STAND_IN(MIDI_GetProjTimeFromPPQPos),
+			DBM_STAND_IN(MIDI_GetPPQPosFromProjQN),
+			DBM_STAND_IN(MIDI_GetGrid),
+			DBM_STAND_IN(GetPlayStateEx),
+			DBM_STAND_IN(GetPlayPositionEx),
+			DBM_STAND_IN(GetCursorPositionEx),
+			DBM_STAND_IN(SetEditCurPos2),
+			DBM_STAND_IN(CSurf_OnPlay),
+			DBM_STAND_IN(CSurf_OnStop),
+			DBM_STAND_IN(CSurf_OnPause),
+			DBM_STAND_IN(CSurf_OnRecord),
+			DBM_STAND_IN(Master_GetTempo),
+			DBM_STAND_IN(CSurf_OnTempoChange),
+			DBM_STAND_IN(TimeMap_GetTimeSigAtTime),
+			DBM_STAND_IN(GetProjectTimeSignature2),
+			DBM_STAND_IN(GetProjectLength),
+			DBM_STAND_IN(GetProjectTimeOffset),
+			DBM_STAND_IN(GetHZoomLevel),
+			DBM_STAND_IN(SnapToGrid),
+			DBM_STAND_IN(GetSet_LoopTimeRange),
+			DBM_STAND_IN(GetSet_LoopTimeRange2),
+			DBM_STAND_IN(GetSetProjectGrid),
+			DBM_STAND_IN(GetTouchedOrFocusedFX),
+			DBM_STAND_IN(GetTCPFXParm),
+			DBM_STAND_IN(Envelope_Evaluate),
+			DBM_STAND_IN(DB2SLIDER),
+			DBM_STAND_IN(SLIDER2DB),
+			DBM_STAND_IN(ScaleFromEnvelopeMode),
+			DBM_STAND_IN(ColorFromNative),
+			DBM_STAND_IN(ColorToNative),
+			DBM_STAND_IN(format_timestr),
+			DBM_STAND_IN(format_timestr_pos),
+			DBM_STAND_IN(format_timestr_len),
+			DBM_STAND_IN(Main_OnCommandEx),
+			DBM_STAND_IN(Audio_IsRunning),
+			DBM_STAND_IN(GetResourcePath),
+			DBM_STAND_IN(ShowConsoleMsg)
+		};
+#undef DBM_STAND_IN
+		return standIns;
+	}
+}
+
+
+/**
+ * Constructor. Creates all tracks, devices, sends, clips and markers.
+ *
+ * @param settings The size of the project
+ */
+SyntheticProject::SyntheticProject(const Settings& settings)
+{
+	this->master.name = "Master";
+	this->master.devices.resize(1);
+	this->master.devices[0].name = "VST3: Master Limiter (Synthetic)";
+	this->master.devices[0].values.assign(settings.parametersPerDevice, 0.5);
+
+	const int trackCount = std::max(0, settings.tracks);
+	for (int index = 0; index < trackCount; index++)
+	{
+		std::unique_ptr<TrackData> track = std::make_unique<TrackData>();
+		track->number = index + 1;
+		track->name = "Track " + std::to_string(index + 1);
+		track->color = 0x1000000 | static_cast<int>(this->NextRandom() & 0xFFFFFF);
+		track->volume = 0.5 + (this->NextRandom() % 100) / 100.0;
+		track->pan = ((this->NextRandom() % 200) / 100.0) - 1.0;
+
+		for (int d = 0; d < settings.devicesPerTrack; d++)
+		{
+			DeviceData device;
+			device.name = "VST3: Device " + std::to_string(d + 1) + " (Synthetic)";
+			device.guid.Data1 = static_cast<unsigned int>(index * 1000 + d + 1);
+			device.values.resize(std::max(0, settings.parametersPerDevice));
+			for (double& value : device.values)
+				value = (this->NextRandom() % 1000) / 1000.0;
+			track->devices.push_back(std::move(device));
+		}
+
+		for (int s = 0; s < settings.sendsPerTrack && trackCount > 1; s++)
+		{
+			SendData send;
+			send.destination = (index + 1 + s) % trackCount;
+			send.volume = (this->NextRandom() % 100) / 100.0;
+			track->sends.push_back(send);
+		}
+
+		for (int i = 0; i < settings.itemsPerTrack; i++)
+		{
+			std::unique_ptr<ItemData> item = std::make_unique<ItemData>();
+			item->track = track.get();
+			item->position = i * 8.0;
+			item->length = 8.0;
+			item->name = track->name + " Clip " + std::to_string(i + 1);
+			for (int n = 0; n < settings.notesPerItem; n++)
+			{
+				NoteData note;
+				note.start = n * PPQ / 4;
+				note.end = note.start + PPQ / 8;
+				note.pitch = 36 + static_cast<int>(this->NextRandom() % 48);
+				note.velocity = 1 + static_cast<int>(this->NextRandom() % 127);
+				item->notes.push_back(note);
+			}
+			track->items.push_back(std::move(item));
+		}
+		this->tracks.push_back(std::move(track));
+	}
+	if (!this->tracks.empty())
+		this->tracks[0]->isSelected = true;
+
+	for (int index = 0; index < settings.markers; index++)
+	{
+		MarkerData marker;
+		marker.isRegion = index % 4 == 3;
+		marker.position = index * 4.0;
+		marker.end = marker.isRegion ? marker.position + 4.0 : 0;
+		marker.number = index + 1;
+		marker.name = (marker.isRegion ? "Region " : "Marker ") + std::to_string(index + 1);
+		this->markers.push_back(marker);
+	}
+}
+
+
+/**
+ * Destructor. Uninstalls the project.
+ */
+SyntheticProject::~SyntheticProject()
+{
+	if (current == this)
+		current = nullptr;
+}
+
+
+/**
+ * Install the project as the replacement of the Reaper API and SWELL.
+ */
+void SyntheticProject::Install()
+{
+	if (current != nullptr && current != this)
+		throw std::logic_error("Another synthetic project is already installed.");
+	current = this;
+	REAPERAPI_LoadAPI(&SyntheticProject::GetFunction);
+	SWELL_dllMain(nullptr, DLL_PROCESS_ATTACH, reinterpret_cast<LPVOID>(&SyntheticProject::GetFunction));
+}
+
+
+/**
+ * Get the installed project.
+ *
+ * @return The project
+ */
+SyntheticProject& SyntheticProject::Get()
+{
+	if (current == nullptr)
+		throw std::logic_error("No synthetic project is installed.");
+	return *current;
+}
+
+
+/**
+ * Get the replacement of a function of the Reaper API or SWELL.
+ *
+ * @param name The name of the function
+ * @return The stand-in or a function which returns 0
+ */
+void* SyntheticProject::GetFunction(const char* name)
+{
+	const std::unordered_map<std::string, void*>& standIns = GetStandIns();
+	const auto it = standIns.find(name);
+	return it == standIns.end() ? reinterpret_cast<void*>(&ReturnZero) : it->second;
+}
+
+
+/**
+ * Advance the project by one update of the surface. Moves the play position and the meters if the
+ * transport is playing.
+ */
+void SyntheticProject::Tick() noexcept
+{
+	const bool isPlaying = (this->playState & 1) > 0;
+	if (isPlaying)
+		this->playPosition += 1.0 / 30.0;
+	for (const std::unique_ptr<TrackData>& track : this->tracks)
+		track->peak = isPlaying ? (this->NextRandom() % 1000) / 1000.0 : 0;
+	this->master.peak = isPlaying ? (this->NextRandom() % 1000) / 1000.0 : 0;
+}
+
+
+/**
+ * Change some volumes and parameters like a user would, to create changes to collect.
+ *
+ * @param count The number of values to change
+ */
+void SyntheticProject::ChangeValues(int count) noexcept
+{
+	if (this->tracks.empty())
+		return;
+	for (int i = 0; i < count; i++)
+	{
+		TrackData& track = *this->tracks[this->NextRandom() % this->tracks.size()];
+		if (track.devices.empty() || track.devices[0].values.empty() || i % 2 == 0)
+			track.volume = (this->NextRandom() % 1000) / 500.0;
+		else
+		{
+			std::vector<double>& values = track.devices[0].values;
+			values[this->NextRandom() % values.size()] = (this->NextRandom() % 1000) / 1000.0;
+		}
+	}
+	this->stateChangeCount++;
+}
+
+
+/**
+ * Get the next value of the deterministic random generator, the project is always the same.
+ *
+ * @return The value
+ */
+unsigned int SyntheticProject::NextRandom() noexcept
+{
+	this->random = this->random * 1103515245u + 12345u;
+	return (this->random >> 8) & 0xFFFFFF;
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2018-2026 by Jürgen Moßgraber (www.mossgrabers.de)
+// Licensed under LGPLv3 - http://www.gnu.org/licenses/lgpl-3.0.txt
+
+#ifndef _DBM_SYNTHETICPROJECT_H_
+#define _DBM_SYNTHETICPROJECT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "WrapperReaperFunctions.h"
+
+
+/**
+ * An in-memory Reaper project which replaces the Reaper API for the headless host and the
+ * benchmark. The functions which are needed to collect the data of tracks, sends, devices,
+ * markers and clips and to apply the commands of the processors are implemented on the project.
+ * All other functions are replaced with a function which returns 0, like the functions which are
+ * missing in the host are replaced by SWELL. Note that this is only valid for functions which
+ * return an integer or a pointer, all used functions which return a double are implemented.
+ *
+ * Only one project can be installed at a time and it must only be used from one thread.
+ */
+class SyntheticProject
+{
+public:
+	/** The size of the project. */
+	struct Settings
+	{
+		int tracks{ 8 };
+		int sendsPerTrack{ 2 };
+		int devicesPerTrack{ 2 };
+		int parametersPerDevice{ 16 };
+		int itemsPerTrack{ 2 };
+		int notesPerItem{ 16 };
+		int markers{ 8 };
+	};
+
+	/** A device (FX) of a track with its parameter values. */
+	struct DeviceData
+	{
+		std::string name;
+		GUID guid{};
+		bool isEnabled{ true };
+		std::vector<double> values;
+	};
+
+	/** A send to another track. */
+	struct SendData
+	{
+		int destination{ 0 };
+		double volume{ 1.0 };
+		double pan{ 0.0 };
+		bool isMuted{ false };
+	};
+
+	/** A MIDI note of an item. */
+	struct NoteData
+	{
+		double start{ 0 };
+		double end{ 0 };
+		int channel{ 0 };
+		int pitch{ 60 };
+		int velocity{ 100 };
+		bool isSelected{ false };
+		bool isMuted{ false };
+	};
+
+	/** A MIDI item with one take. The item is also used as the take. */
+	struct ItemData
+	{
+		void* track{ nullptr };
+		double position{ 0 };
+		double length{ 0 };
+		bool isMuted{ false };
+		bool isSelected{ false };
+		std::string name;
+		std::vector<NoteData> notes;
+	};
+
+	/** A track, the master track is a track as well. */
+	struct TrackData
+	{
+		int number{ 0 };
+		std::string name;
+		int color{ 0 };
+		double volume{ 1.0 };
+		double pan{ 0.0 };
+		bool isMuted{ false };
+		bool isSoloed{ false };
+		bool isRecArmed{ false };
+		bool isSelected{ false };
+		int folderCompact{ 0 };
+		double peak{ 0 };
+		std::vector<DeviceData> devices;
+		std::vector<SendData> sends;
+		std::vector<std::unique_ptr<ItemData>> items;
+	};
+
+	/** A marker or region. */
+	struct MarkerData
+	{
+		bool isRegion{ false };
+		double position{ 0 };
+		double end{ 0 };
+		int number{ 0 };
+		int color{ 0 };
+		std::string name;
+	};
+
+
+	explicit SyntheticProject(const Settings& settings);
+	SyntheticProject(const SyntheticProject&) = delete;
+	SyntheticProject& operator=(const SyntheticProject&) = delete;
+	SyntheticProject(SyntheticProject&&) = delete;
+	SyntheticProject& operator=(SyntheticProject&&) = delete;
+	~SyntheticProject();
+
+	void Install();
+	void Tick() noexcept;
+	void ChangeValues(int count) noexcept;
+
+	/**
+	 * Get the number of calls of the replaced Reaper functions.
+	 *
+	 * @return The number of calls
+	 */
+	unsigned long long GetCalls() const noexcept
+	{
+		return this->calls;
+	}
+
+	static void* GetFunction(const char* name);
+	static SyntheticProject& Get();
+
+	// Accessed by the functions which replace the Reaper API
+	std::vector<std::unique_ptr<TrackData>> tracks;
+	TrackData master;
+	std::vector<MarkerData> markers;
+	int stateChangeCount{ 1 };
+	int playState{ 0 };
+	double playPosition{ 0 };
+	double cursorPosition{ 0 };
+	double timeSelectionStart{ 0 };
+	double timeSelectionEnd{ 0 };
+	double tempo{ 120 };
+	unsigned long long calls{ 0 };
+
+private:
+	unsigned int random{ 1 };
+
+	unsigned int NextRandom() noexcept;
+};
+
+#endif /* _DBM_SYNTHETICPROJECT_H_ */